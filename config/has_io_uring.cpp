@@ -0,0 +1,33 @@
+//  Copyright 2026 Andrey Semashev
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+#include "platform_config.hpp"
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <linux/io_uring.h>
+
+#if !defined(__NR_io_uring_setup) || !defined(__NR_io_uring_enter)
+#error "No io_uring syscalls"
+#endif
+
+int main()
+{
+    struct io_uring_params params = {};
+    int fd = syscall(__NR_io_uring_setup, 8u, &params);
+    struct io_uring_sqe sqe = {};
+    sqe.opcode = IORING_OP_STATX;
+    sqe.statx_flags = AT_NO_AUTOMOUNT;
+    sqe.off = params.sq_off.array + params.cq_off.cqes;
+    unsigned int features = params.features & IORING_FEAT_SINGLE_MMAP;
+    void* p = mmap(0, 4096u, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, IORING_OFF_SQ_RING);
+    return syscall(__NR_io_uring_enter, fd, 1u, 1u, IORING_ENTER_GETEVENTS, 0, 0) + features + (p != MAP_FAILED);
+}
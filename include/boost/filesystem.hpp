@@ -16,6 +16,13 @@
 #include <boost/filesystem/path.hpp>
 #include <boost/filesystem/exception.hpp>
 #include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/directory_tree.hpp>
+#include <boost/filesystem/directory_snapshot.hpp>
+#include <boost/filesystem/directory_watcher.hpp>
+#include <boost/filesystem/glob.hpp>
+#include <boost/filesystem/executor.hpp>
+#include <boost/filesystem/async.hpp>
+#include <boost/filesystem/coroutine.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/file_status.hpp>
 
@@ -0,0 +1,152 @@
+//  boost/filesystem/async.hpp  -------------------------------------------------------//
+
+//  Copyright Andrey Semashev 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_ASYNC_HPP
+#define BOOST_FILESYSTEM_ASYNC_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/executor.hpp>
+
+#include <functional>
+
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+//--------------------------------------------------------------------------------------//
+
+namespace boost {
+namespace filesystem {
+
+namespace detail {
+
+struct async_context_imp;
+
+} // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                   async_context                                      //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+/*!
+ * \brief Runs filesystem operations asynchronously and reports their results to completion handlers
+ *
+ * On Linux, the operations that have an io_uring counterpart supported by the running kernel (\c status,
+ * \c symlink_status, \c create_directory, \c remove and \c rename) are submitted to an io_uring instance.
+ * Other operations, and all operations on systems where io_uring is not available, are run on a thread pool.
+ *
+ * Completion handlers are called on the internal threads of the context and must not throw. The handlers
+ * of the operations submitted to io_uring are called by a single thread, so they should not block.
+ * The destructor waits for all operations to complete.
+ */
+class async_context
+{
+public:
+    //! Handler of the operations that return file status
+    typedef std::function< void (file_status, system::error_code const&) > status_handler;
+    //! Handler of the operations that return whether a file was created, removed or copied
+    typedef std::function< void (bool, system::error_code const&) > result_handler;
+    //! Handler of the operations that return a number of files
+    typedef std::function< void (boost::uintmax_t, system::error_code const&) > count_handler;
+    //! Handler of the operations that do not return a value
+    typedef std::function< void (system::error_code const&) > completion_handler;
+
+    //! Default maximum number of operations submitted to io_uring at a time
+    static constexpr unsigned int default_queue_depth = 256u;
+
+    class batch;
+
+private:
+    detail::async_context_imp* m_imp;
+
+public:
+    /*!
+     * \brief Creates the thread pool with \a thread_count threads and, if supported, an io_uring instance for \a queue_depth operations
+     *
+     * If \a thread_count is 0, the number of threads is equal to the number of CPUs.
+     */
+    explicit async_context(unsigned int thread_count = 0u, unsigned int queue_depth = default_queue_depth) :
+        m_imp(nullptr)
+    {
+        init(thread_count, queue_depth);
+    }
+
+    async_context(async_context const&) = delete;
+    async_context& operator=(async_context const&) = delete;
+
+    ~async_context() { destroy(); }
+
+    //! Returns the thread pool of the context, which can be used to run other blocking operations
+    BOOST_FILESYSTEM_DECL thread_pool_executor& get_executor() noexcept;
+
+    //! Returns \c true if some of the operations are submitted to io_uring
+    BOOST_FILESYSTEM_DECL bool uses_io_uring() const noexcept;
+
+    //! Queries file status, following symlinks. Not found files are reported as in \c status(p, ec).
+    BOOST_FILESYSTEM_DECL void async_status(path p, status_handler handler);
+    //! Queries file status, not following symlinks. Not found files are reported as in \c symlink_status(p, ec).
+    BOOST_FILESYSTEM_DECL void async_symlink_status(path p, status_handler handler);
+    //! Creates a directory, as \c create_directory(p, ec)
+    BOOST_FILESYSTEM_DECL void async_create_directory(path p, result_handler handler);
+    //! Creates a directory and any missing parent directories, as \c create_directories(p, ec)
+    BOOST_FILESYSTEM_DECL void async_create_directories(path p, result_handler handler);
+    //! Removes a file or an empty directory, as \c remove(p, ec)
+    BOOST_FILESYSTEM_DECL void async_remove(path p, result_handler handler);
+    //! Removes a file or a directory with all its contents, as \c remove_all(p, ec)
+    BOOST_FILESYSTEM_DECL void async_remove_all(path p, count_handler handler);
+    //! Renames a file, as \c rename(from, to, ec)
+    BOOST_FILESYSTEM_DECL void async_rename(path from, path to, completion_handler handler);
+    //! Copies a file, as \c copy_file(from, to, opts, ec)
+    BOOST_FILESYSTEM_DECL void async_copy_file(path from, path to, copy_options opts, result_handler handler);
+
+private:
+    BOOST_FILESYSTEM_DECL void init(unsigned int thread_count, unsigned int queue_depth);
+    BOOST_FILESYSTEM_DECL void destroy() noexcept;
+    BOOST_FILESYSTEM_DECL void begin_batch() noexcept;
+    BOOST_FILESYSTEM_DECL void end_batch() noexcept;
+};
+
+/*!
+ * \brief Defers submitting operations to io_uring while the object exists
+ *
+ * The operations started on the context while the batch exists are submitted to io_uring with a single system call
+ * when the batch is destroyed, which reduces the overhead of bursts of small operations. Batches can be nested.
+ */
+class async_context::batch
+{
+private:
+    async_context& m_context;
+
+public:
+    explicit batch(async_context& ctx) noexcept :
+        m_context(ctx)
+    {
+        ctx.begin_batch();
+    }
+
+    batch(batch const&) = delete;
+    batch& operator=(batch const&) = delete;
+
+    ~batch() { m_context.end_batch(); }
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_ASYNC_HPP
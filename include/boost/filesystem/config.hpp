@@ -174,4 +174,11 @@ BOOST_PRAGMA_MESSAGE("Boost.Filesystem: Platform API mismatch between Boost.Syst
 #define BOOST_FILESYSTEM_DETAIL_CXX23_STRING_VIEW_HAS_IMPLICIT_RANGE_CTOR
 #endif
 
+#if defined(__cpp_impl_coroutine) && (__cpp_impl_coroutine >= 201902L) && defined(__has_include)
+#if __has_include(<coroutine>)
+// Indicates that C++20 coroutines are supported by the compiler and the standard library.
+#define BOOST_FILESYSTEM_DETAIL_HAS_COROUTINES
+#endif
+#endif
+
 #endif // BOOST_FILESYSTEM_CONFIG_HPP
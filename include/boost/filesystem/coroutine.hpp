@@ -0,0 +1,428 @@
+//  boost/filesystem/coroutine.hpp  ---------------------------------------------------//
+
+//  Copyright Andrey Semashev 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_COROUTINE_HPP
+#define BOOST_FILESYSTEM_COROUTINE_HPP
+
+#include <boost/filesystem/config.hpp>
+
+#if defined(BOOST_FILESYSTEM_DETAIL_HAS_COROUTINES)
+
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/executor.hpp>
+
+#include <cstddef>
+#include <coroutine>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <vector>
+#include <utility> // std::move
+
+#include <boost/system/error_code.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+//--------------------------------------------------------------------------------------//
+
+namespace boost {
+namespace filesystem {
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                             directory_entry_generator                                //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+/*!
+ * \brief A coroutine that lazily produces directory entries
+ *
+ * The generator is a single-pass range of <tt>directory_entry const&</tt>. The body of the coroutine runs
+ * when the range is iterated, and every entry is only valid until the iterator is incremented. Exceptions
+ * thrown by the coroutine body are rethrown from \c begin and the iterator increment.
+ */
+class directory_entry_generator
+{
+public:
+    class promise_type
+    {
+        friend class directory_entry_generator;
+
+    private:
+        directory_entry const* m_entry = nullptr;
+        std::exception_ptr m_exception;
+
+    public:
+        directory_entry_generator get_return_object() noexcept
+        {
+            return directory_entry_generator(std::coroutine_handle< promise_type >::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        std::suspend_always final_suspend() const noexcept { return {}; }
+
+        std::suspend_always yield_value(directory_entry const& entry) noexcept
+        {
+            m_entry = &entry;
+            return {};
+        }
+
+        void return_void() const noexcept {}
+        void unhandled_exception() noexcept { m_exception = std::current_exception(); }
+
+        //! The generator is synchronous, so awaiting inside it is not allowed
+        template< typename T >
+        std::suspend_never await_transform(T&&) = delete;
+    };
+
+    class iterator
+    {
+        friend class directory_entry_generator;
+
+    public:
+        typedef std::input_iterator_tag iterator_category;
+        typedef directory_entry value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef directory_entry const* pointer;
+        typedef directory_entry const& reference;
+
+    private:
+        std::coroutine_handle< promise_type > m_handle;
+
+    public:
+        iterator() noexcept = default;
+
+        reference operator*() const noexcept { return *m_handle.promise().m_entry; }
+        pointer operator->() const noexcept { return m_handle.promise().m_entry; }
+
+        iterator& operator++()
+        {
+            directory_entry_generator::resume(m_handle);
+            return *this;
+        }
+
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(iterator const& it, std::default_sentinel_t) noexcept
+        {
+            return !it.m_handle || it.m_handle.done();
+        }
+
+    private:
+        explicit iterator(std::coroutine_handle< promise_type > handle) noexcept :
+            m_handle(handle)
+        {
+        }
+    };
+
+private:
+    std::coroutine_handle< promise_type > m_handle;
+
+public:
+    directory_entry_generator() noexcept = default;
+
+    directory_entry_generator(directory_entry_generator&& that) noexcept :
+        m_handle(that.m_handle)
+    {
+        that.m_handle = nullptr;
+    }
+
+    directory_entry_generator& operator=(directory_entry_generator&& that) noexcept
+    {
+        if (this != &that)
+        {
+            if (m_handle)
+                m_handle.destroy();
+            m_handle = that.m_handle;
+            that.m_handle = nullptr;
+        }
+
+        return *this;
+    }
+
+    directory_entry_generator(directory_entry_generator const&) = delete;
+    directory_entry_generator& operator=(directory_entry_generator const&) = delete;
+
+    ~directory_entry_generator()
+    {
+        if (m_handle)
+            m_handle.destroy();
+    }
+
+    //! Runs the coroutine until it produces the first entry. Must be called at most once.
+    iterator begin()
+    {
+        if (m_handle)
+            resume(m_handle);
+        return iterator(m_handle);
+    }
+
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+    explicit directory_entry_generator(std::coroutine_handle< promise_type > handle) noexcept :
+        m_handle(handle)
+    {
+    }
+
+    static void resume(std::coroutine_handle< promise_type > handle)
+    {
+        handle.resume();
+        promise_type& promise = handle.promise();
+        if (promise.m_exception)
+        {
+            std::exception_ptr ex(std::move(promise.m_exception));
+            promise.m_exception = nullptr;
+            std::rethrow_exception(ex);
+        }
+    }
+};
+
+//! Produces the entries of the directory
+inline directory_entry_generator directory_entries(path dir_path, directory_options opts = directory_options::none)
+{
+    for (directory_iterator it(dir_path, opts), end; it != end; ++it)
+        co_yield *it;
+}
+
+/*!
+ * \brief Produces the entries of the directory
+ *
+ * Iteration stops on the first error, which is reported in \a ec. The error code must stay alive until
+ * the generator is destroyed.
+ */
+inline directory_entry_generator directory_entries(path dir_path, directory_options opts, system::error_code& ec)
+{
+    directory_iterator it(dir_path, opts, ec);
+    while (!ec && it != directory_iterator())
+    {
+        co_yield *it;
+        it.increment(ec);
+    }
+}
+
+//! Produces the entries of the directory tree, in the order of recursive_directory_iterator
+inline directory_entry_generator recursive_directory_entries(path dir_path, directory_options opts = directory_options::none)
+{
+    for (recursive_directory_iterator it(dir_path, opts), end; it != end; ++it)
+        co_yield *it;
+}
+
+/*!
+ * \brief Produces the entries of the directory tree, in the order of recursive_directory_iterator
+ *
+ * Iteration stops on the first error, which is reported in \a ec. The error code must stay alive until
+ * the generator is destroyed.
+ */
+inline directory_entry_generator recursive_directory_entries(path dir_path, directory_options opts, system::error_code& ec)
+{
+    recursive_directory_iterator it(dir_path, opts, ec);
+    while (!ec && it != recursive_directory_iterator())
+    {
+        co_yield *it;
+        it.increment(ec);
+    }
+}
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                              async_directory_scanner                                 //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+/*!
+ * \brief Recursive directory traversal for coroutines that does not block the awaiting thread
+ *
+ * Awaiting \c next returns a pointer to the next entry of the directory tree, or \c nullptr when the traversal
+ * is complete. Directory entries are read in batches by a recursive_directory_iterator on the executor,
+ * so all blocking calls, including opening directories and querying file status, are made by the executor
+ * threads. The awaiting coroutine is resumed on an executor thread when a batch is ready, and the following
+ * entries of the batch are returned without suspending.
+ *
+ * \c Executor must have a member function \c post that accepts a <tt>std::function< void() ></tt>.
+ * The executor must outlive the scanner, and the scanner must not be destroyed while \c next is being awaited.
+ */
+template< typename Executor = thread_pool_executor >
+class async_directory_scanner
+{
+public:
+    typedef Executor executor_type;
+    typedef std::function< bool (directory_entry const&) > filter_type;
+
+    //! Default number of entries read in one batch
+    static constexpr std::size_t default_batch_size = 256u;
+
+private:
+    class next_awaiter
+    {
+    private:
+        async_directory_scanner* m_scanner;
+        system::error_code* m_ec;
+
+    public:
+        next_awaiter(async_directory_scanner* scanner, system::error_code* ec) noexcept :
+            m_scanner(scanner),
+            m_ec(ec)
+        {
+        }
+
+        bool await_ready() const noexcept
+        {
+            return m_scanner->m_pos < m_scanner->m_batch.size() || m_scanner->m_finished;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle)
+        {
+            async_directory_scanner* scanner = m_scanner;
+            scanner->m_executor.post([scanner, handle]()
+            {
+                scanner->read_batch();
+                handle.resume();
+            });
+        }
+
+        directory_entry const* await_resume()
+        {
+            return m_scanner->take_next(m_ec);
+        }
+    };
+
+private:
+    executor_type& m_executor;
+    path m_root;
+    directory_options m_options;
+    filter_type m_filter;
+    std::size_t m_batch_size;
+    recursive_directory_iterator m_it;
+    std::vector< directory_entry > m_batch;
+    std::size_t m_pos;
+    system::error_code m_error;
+    std::exception_ptr m_exception;
+    bool m_started;
+    bool m_finished;
+
+public:
+    async_directory_scanner(executor_type& ex, path root, directory_options opts = directory_options::none, std::size_t batch_size = default_batch_size) :
+        m_executor(ex),
+        m_root(std::move(root)),
+        m_options(opts),
+        m_batch_size(batch_size > 0u ? batch_size : 1u),
+        m_pos(0u),
+        m_started(false),
+        m_finished(false)
+    {
+    }
+
+    //! Constructs a scanner that only recurses into directories for which \a filter returns \c true. The filter is called on the executor threads.
+    async_directory_scanner(executor_type& ex, path root, directory_options opts, filter_type filter, std::size_t batch_size = default_batch_size) :
+        m_executor(ex),
+        m_root(std::move(root)),
+        m_options(opts),
+        m_filter(std::move(filter)),
+        m_batch_size(batch_size > 0u ? batch_size : 1u),
+        m_pos(0u),
+        m_started(false),
+        m_finished(false)
+    {
+    }
+
+    async_directory_scanner(async_directory_scanner const&) = delete;
+    async_directory_scanner& operator=(async_directory_scanner const&) = delete;
+
+    executor_type& get_executor() const noexcept { return m_executor; }
+    path const& root() const noexcept { return m_root; }
+
+    /*!
+     * \brief Returns an awaitable that produces a pointer to the next entry, or \c nullptr at the end of the traversal
+     *
+     * The entry remains valid until \c next is called again. Errors are reported by throwing \c filesystem_error,
+     * after which the traversal is complete.
+     */
+    next_awaiter next() noexcept { return next_awaiter(this, nullptr); }
+
+    //! Returns an awaitable that produces a pointer to the next entry, or \c nullptr at the end of the traversal or on error
+    next_awaiter next(system::error_code& ec) noexcept { return next_awaiter(this, &ec); }
+
+private:
+    //! Reads the next batch of entries. Called on an executor thread.
+    void read_batch() noexcept
+    {
+        m_batch.clear();
+        m_pos = 0u;
+        try
+        {
+            if (!m_started)
+            {
+                m_started = true;
+                if (m_filter)
+                    m_it = recursive_directory_iterator(m_root, m_options, m_filter, m_error);
+                else
+                    m_it = recursive_directory_iterator(m_root, m_options, m_error);
+            }
+
+            const recursive_directory_iterator end;
+            while (!m_error && m_it != end && m_batch.size() < m_batch_size)
+            {
+                m_batch.push_back(*m_it);
+                m_it.increment(m_error);
+            }
+
+            if (m_error || m_it == end)
+            {
+                m_finished = true;
+                m_it = end;
+            }
+        }
+        catch (...)
+        {
+            m_exception = std::current_exception();
+            m_finished = true;
+        }
+    }
+
+    directory_entry const* take_next(system::error_code* ec)
+    {
+        if (ec)
+            ec->clear();
+
+        if (m_pos < m_batch.size())
+            return &m_batch[m_pos++];
+
+        if (m_exception)
+        {
+            std::exception_ptr ex(std::move(m_exception));
+            m_exception = nullptr;
+            std::rethrow_exception(ex);
+        }
+
+        if (m_error)
+        {
+            system::error_code err = m_error;
+            m_error.clear();
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::async_directory_scanner::next", m_root, err));
+            *ec = err;
+        }
+
+        return nullptr;
+    }
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // defined(BOOST_FILESYSTEM_DETAIL_HAS_COROUTINES)
+
+#endif // BOOST_FILESYSTEM_COROUTINE_HPP
@@ -22,10 +22,17 @@
 #include <boost/filesystem/detail/path_traits.hpp>
 
 #include <cstddef>
+#include <ctime>
 #include <string>
 #include <vector>
+#include <type_traits>
+#if !defined(BOOST_NO_CXX17_HDR_STRING_VIEW)
+#include <string_view>
+#endif
 
 #include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/core/addressof.hpp>
 #include <boost/detail/bitmask.hpp>
 #include <boost/system/error_code.hpp>
 #include <boost/smart_ptr/intrusive_ptr.hpp>
@@ -55,12 +62,77 @@ enum class directory_options : unsigned int
     skip_dangling_symlinks = 1u << 2u,   // non-standard extension for recursive_directory_iterator: don't follow dangling directory symlinks,
     pop_on_error = 1u << 3u,             // non-standard extension for recursive_directory_iterator: instead of producing an end iterator on errors,
                                          // repeatedly invoke pop() until it succeeds or the iterator becomes equal to end iterator
-    _detail_no_follow = 1u << 4u,        // internal use only
-    _detail_no_push = 1u << 5u           // internal use only
+    cache_entry_attributes = 1u << 4u,   // non-standard extension: obtain and cache entry_attributes of every directory entry during iteration
+    inode_ordered_attributes = 1u << 5u, // non-standard extension for directory_iterator::next_batch: implies cache_entry_attributes,
+                                         // obtain attributes of the entries of a batch in the order of their inode numbers
+    prefetch_attributes = 1u << 6u,      // non-standard extension for directory_iterator::next_batch: implies cache_entry_attributes,
+                                         // obtain attributes of the entries of a batch concurrently
+    _detail_no_follow = 1u << 7u,        // internal use only
+    _detail_no_push = 1u << 8u           // internal use only
 };
 
 BOOST_BITMASK(directory_options)
 
+//! Attributes of a file that can be cached in directory_entry
+enum class entry_attributes : unsigned int
+{
+    none = 0u,
+    file_size = 1u,                      // size of a regular file, in bytes
+    last_write_time = 1u << 1u,          // last modification time
+    hard_link_count = 1u << 2u,          // number of hard links
+    inode = 1u << 3u,                    // file serial number (inode number) within its filesystem
+    allocated_size = 1u << 4u,           // size of storage allocated for the file, in bytes
+    all = file_size | last_write_time | hard_link_count | inode | allocated_size
+};
+
+BOOST_BITMASK(entry_attributes)
+
+//! Parameters of the parallel_walk algorithm
+struct parallel_walk_options
+{
+    //! Directory iteration options
+    directory_options options;
+    //! Maximum number of threads to use for the walk, including the calling thread. Zero means the number of hardware threads.
+    unsigned int thread_count;
+
+    parallel_walk_options(directory_options opts = directory_options::none, unsigned int threads = 0u) noexcept :
+        options(opts),
+        thread_count(threads)
+    {
+    }
+};
+
+//! Disk usage of a directory tree
+struct disk_usage_info
+{
+    //! Total size of the files in the tree, in bytes
+    boost::uintmax_t apparent_size;
+    //! Total size of storage allocated for the files in the tree, in bytes
+    boost::uintmax_t allocated_size;
+    //! Number of files in the tree, other than directories
+    boost::uintmax_t file_count;
+    //! Number of subdirectories in the tree
+    boost::uintmax_t directory_count;
+
+    disk_usage_info() noexcept :
+        apparent_size(0u),
+        allocated_size(0u),
+        file_count(0u),
+        directory_count(0u)
+    {
+    }
+};
+
+//! Disk usage of a directory tree rooted at a directory
+struct directory_usage
+{
+    //! Path of the directory
+    path dir_path;
+    //! Disk usage of the directory and its contents
+    disk_usage_info usage;
+};
+
+class directory_entry;
 class directory_iterator;
 class recursive_directory_iterator;
 
@@ -68,15 +140,53 @@ namespace detail {
 
 struct directory_iterator_params;
 
+//! Cached attributes of a directory entry
+struct entry_attributes_cache
+{
+    //! Attributes that have valid values
+    entry_attributes mask;
+    boost::uintmax_t file_size;
+    std::time_t last_write_time;
+    //! Nanoseconds part of the last modification time, zero if the filesystem or the platform does not provide it
+    boost::uint32_t last_write_time_nsec;
+    boost::uintmax_t hard_link_count;
+    boost::uintmax_t inode;
+    boost::uintmax_t allocated_size;
+
+    entry_attributes_cache() noexcept :
+        mask(entry_attributes::none),
+        file_size(0u),
+        last_write_time(0),
+        last_write_time_nsec(0u),
+        hard_link_count(0u),
+        inode(0u),
+        allocated_size(0u)
+    {
+    }
+};
+
 BOOST_FILESYSTEM_DECL void directory_iterator_construct(directory_iterator& it, path const& p, directory_options opts, directory_iterator_params* params, system::error_code* ec);
 BOOST_FILESYSTEM_DECL void directory_iterator_increment(directory_iterator& it, system::error_code* ec);
+BOOST_FILESYSTEM_DECL std::size_t directory_iterator_next_batch(directory_iterator& it, directory_entry* entries, std::size_t count, system::error_code* ec);
+//! Obtains the attributes of the current entry of the iterator relative to the open directory and caches them in the entry
+BOOST_FILESYSTEM_DECL void directory_iterator_refresh_attributes(directory_iterator& it, entry_attributes mask, system::error_code* ec);
+//! Returns the cached last write time of the entry, including the nanoseconds part. Returns \c false if the time is not cached.
+BOOST_FILESYSTEM_DECL bool directory_entry_cached_last_write_time(directory_entry const& entry, std::time_t& sec, boost::uint32_t& nsec) noexcept;
 
 struct recur_dir_itr_imp;
+struct recursion_filter_base;
 
-BOOST_FILESYSTEM_DECL void recursive_directory_iterator_construct(recursive_directory_iterator& it, path const& dir_path, directory_options opts, system::error_code* ec);
+BOOST_FILESYSTEM_DECL void recursive_directory_iterator_construct(recursive_directory_iterator& it, path const& dir_path, directory_options opts, recursion_filter_base* filter, system::error_code* ec);
 BOOST_FILESYSTEM_DECL void recursive_directory_iterator_increment(recursive_directory_iterator& it, system::error_code* ec);
 BOOST_FILESYSTEM_DECL void recursive_directory_iterator_pop(recursive_directory_iterator& it, system::error_code* ec);
 
+//! Function that is called by parallel_walk for every directory entry
+typedef void parallel_walk_visitor_t(void* context, directory_entry const& entry);
+
+BOOST_FILESYSTEM_DECL void parallel_walk(path const& root, parallel_walk_options const& opts, parallel_walk_visitor_t* visitor, void* context, system::error_code* ec);
+
+BOOST_FILESYSTEM_DECL void disk_usage(path const& root, parallel_walk_options const& opts, std::vector< directory_usage >& usage, system::error_code* ec);
+
 } // namespace detail
 
 //--------------------------------------------------------------------------------------//
@@ -93,8 +203,12 @@ class directory_entry
 {
     friend BOOST_FILESYSTEM_DECL void detail::directory_iterator_construct(directory_iterator& it, path const& p, directory_options opts, detail::directory_iterator_params* params, system::error_code* ec);
     friend BOOST_FILESYSTEM_DECL void detail::directory_iterator_increment(directory_iterator& it, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL std::size_t detail::directory_iterator_next_batch(directory_iterator& it, directory_entry* entries, std::size_t count, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL void detail::directory_iterator_refresh_attributes(directory_iterator& it, entry_attributes mask, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL bool detail::directory_entry_cached_last_write_time(directory_entry const& entry, std::time_t& sec, boost::uint32_t& nsec) noexcept;
 
     friend BOOST_FILESYSTEM_DECL void detail::recursive_directory_iterator_increment(recursive_directory_iterator& it, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL void detail::parallel_walk(path const& root, parallel_walk_options const& opts, detail::parallel_walk_visitor_t* visitor, void* context, system::error_code* ec);
 
 public:
     typedef boost::filesystem::path::value_type value_type; // enables class path ctor taking directory_entry
@@ -119,7 +233,7 @@ public:
 #endif
 
     directory_entry(directory_entry const& rhs) :
-        m_path(rhs.m_path), m_status(rhs.m_status), m_symlink_status(rhs.m_symlink_status)
+        m_path(rhs.m_path), m_status(rhs.m_status), m_symlink_status(rhs.m_symlink_status), m_attributes(rhs.m_attributes)
     {
     }
 
@@ -128,13 +242,15 @@ public:
         m_path = rhs.m_path;
         m_status = rhs.m_status;
         m_symlink_status = rhs.m_symlink_status;
+        m_attributes = rhs.m_attributes;
         return *this;
     }
 
     directory_entry(directory_entry&& rhs) noexcept :
         m_path(static_cast< boost::filesystem::path&& >(rhs.m_path)),
         m_status(static_cast< file_status&& >(rhs.m_status)),
-        m_symlink_status(static_cast< file_status&& >(rhs.m_symlink_status))
+        m_symlink_status(static_cast< file_status&& >(rhs.m_symlink_status)),
+        m_attributes(rhs.m_attributes)
     {
     }
 
@@ -143,6 +259,7 @@ public:
         m_path = static_cast< boost::filesystem::path&& >(rhs.m_path);
         m_status = static_cast< file_status&& >(rhs.m_status);
         m_symlink_status = static_cast< file_status&& >(rhs.m_symlink_status);
+        m_attributes = rhs.m_attributes;
         return *this;
     }
 
@@ -203,6 +320,92 @@ public:
     void refresh() { refresh_impl(); }
     void refresh(system::error_code& ec) noexcept { refresh_impl(&ec); }
 
+    // Obtains and caches the specified attributes, also updates the cached file status
+    void refresh(entry_attributes mask) { refresh_attributes_impl(mask); }
+    void refresh(entry_attributes mask, system::error_code& ec) noexcept { refresh_attributes_impl(mask, &ec); }
+
+    entry_attributes cached_attributes() const noexcept { return m_attributes.mask; }
+
+    boost::uintmax_t file_size() const
+    {
+        if ((m_attributes.mask & entry_attributes::file_size) == entry_attributes::none)
+            refresh_attributes_impl(entry_attributes::file_size);
+        return m_attributes.file_size;
+    }
+
+    boost::uintmax_t file_size(system::error_code& ec) const noexcept
+    {
+        ec.clear();
+
+        if ((m_attributes.mask & entry_attributes::file_size) == entry_attributes::none)
+            refresh_attributes_impl(entry_attributes::file_size, &ec);
+        return m_attributes.file_size;
+    }
+
+    std::time_t last_write_time() const
+    {
+        if ((m_attributes.mask & entry_attributes::last_write_time) == entry_attributes::none)
+            refresh_attributes_impl(entry_attributes::last_write_time);
+        return m_attributes.last_write_time;
+    }
+
+    std::time_t last_write_time(system::error_code& ec) const noexcept
+    {
+        ec.clear();
+
+        if ((m_attributes.mask & entry_attributes::last_write_time) == entry_attributes::none)
+            refresh_attributes_impl(entry_attributes::last_write_time, &ec);
+        return m_attributes.last_write_time;
+    }
+
+    boost::uintmax_t hard_link_count() const
+    {
+        if ((m_attributes.mask & entry_attributes::hard_link_count) == entry_attributes::none)
+            refresh_attributes_impl(entry_attributes::hard_link_count);
+        return m_attributes.hard_link_count;
+    }
+
+    boost::uintmax_t hard_link_count(system::error_code& ec) const noexcept
+    {
+        ec.clear();
+
+        if ((m_attributes.mask & entry_attributes::hard_link_count) == entry_attributes::none)
+            refresh_attributes_impl(entry_attributes::hard_link_count, &ec);
+        return m_attributes.hard_link_count;
+    }
+
+    boost::uintmax_t inode() const
+    {
+        if ((m_attributes.mask & entry_attributes::inode) == entry_attributes::none)
+            refresh_attributes_impl(entry_attributes::inode);
+        return m_attributes.inode;
+    }
+
+    boost::uintmax_t inode(system::error_code& ec) const noexcept
+    {
+        ec.clear();
+
+        if ((m_attributes.mask & entry_attributes::inode) == entry_attributes::none)
+            refresh_attributes_impl(entry_attributes::inode, &ec);
+        return m_attributes.inode;
+    }
+
+    boost::uintmax_t allocated_size() const
+    {
+        if ((m_attributes.mask & entry_attributes::allocated_size) == entry_attributes::none)
+            refresh_attributes_impl(entry_attributes::allocated_size);
+        return m_attributes.allocated_size;
+    }
+
+    boost::uintmax_t allocated_size(system::error_code& ec) const noexcept
+    {
+        ec.clear();
+
+        if ((m_attributes.mask & entry_attributes::allocated_size) == entry_attributes::none)
+            refresh_attributes_impl(entry_attributes::allocated_size, &ec);
+        return m_attributes.allocated_size;
+    }
+
     file_status status() const
     {
         if (!filesystem::status_known(m_status))
@@ -382,12 +585,14 @@ public:
 
 private:
     BOOST_FILESYSTEM_DECL void refresh_impl(system::error_code* ec = nullptr) const;
+    BOOST_FILESYSTEM_DECL void refresh_attributes_impl(entry_attributes mask, system::error_code* ec = nullptr) const;
 
     void assign_with_status(boost::filesystem::path&& p, file_status st, file_status symlink_st)
     {
         m_path = static_cast< boost::filesystem::path&& >(p);
         m_status = static_cast< file_status&& >(st);
         m_symlink_status = static_cast< file_status&& >(symlink_st);
+        m_attributes.mask = entry_attributes::none;
     }
 
     void assign_with_status(boost::filesystem::path const& p, file_status st, file_status symlink_st)
@@ -395,6 +600,7 @@ private:
         m_path = p;
         m_status = static_cast< file_status&& >(st);
         m_symlink_status = static_cast< file_status&& >(symlink_st);
+        m_attributes.mask = entry_attributes::none;
     }
 
     void replace_filename_with_status(boost::filesystem::path const& p, file_status st, file_status symlink_st)
@@ -402,12 +608,14 @@ private:
         m_path.replace_filename(p);
         m_status = static_cast< file_status&& >(st);
         m_symlink_status = static_cast< file_status&& >(symlink_st);
+        m_attributes.mask = entry_attributes::none;
     }
 
 private:
     boost::filesystem::path m_path;
     mutable file_status m_status;         // stat()-like
     mutable file_status m_symlink_status; // lstat()-like
+    mutable detail::entry_attributes_cache m_attributes;
 };
 
 #if !defined(BOOST_FILESYSTEM_SOURCE)
@@ -428,6 +636,7 @@ inline void directory_entry::assign(boost::filesystem::path&& p)
 #else
     m_status = file_status();
     m_symlink_status = file_status();
+    m_attributes.mask = entry_attributes::none;
 #endif
 }
 
@@ -439,6 +648,7 @@ inline void directory_entry::assign(boost::filesystem::path const& p)
 #else
     m_status = file_status();
     m_symlink_status = file_status();
+    m_attributes.mask = entry_attributes::none;
 #endif
 }
 
@@ -450,6 +660,7 @@ inline void directory_entry::replace_filename(boost::filesystem::path const& p)
 #else
     m_status = file_status();
     m_symlink_status = file_status();
+    m_attributes.mask = entry_attributes::none;
 #endif
 }
 
@@ -636,7 +847,10 @@ struct dir_itr_imp :
     bool close_handle;
     unsigned char extra_data_format;
     std::size_t current_offset;
+#else
+    unsigned char extra_data_format;
 #endif
+    directory_options options;
     directory_entry dir_entry;
     void* handle;
 
@@ -645,7 +859,10 @@ struct dir_itr_imp :
         close_handle(false),
         extra_data_format(0u),
         current_offset(0u),
+#else
+        extra_data_format(0u),
 #endif
+        options(directory_options::none),
         handle(nullptr)
     {
     }
@@ -675,8 +892,11 @@ class directory_iterator :
 
     friend BOOST_FILESYSTEM_DECL void detail::directory_iterator_construct(directory_iterator& it, path const& p, directory_options opts, detail::directory_iterator_params* params, system::error_code* ec);
     friend BOOST_FILESYSTEM_DECL void detail::directory_iterator_increment(directory_iterator& it, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL std::size_t detail::directory_iterator_next_batch(directory_iterator& it, directory_entry* entries, std::size_t count, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL void detail::directory_iterator_refresh_attributes(directory_iterator& it, entry_attributes mask, system::error_code* ec);
 
     friend BOOST_FILESYSTEM_DECL void detail::recursive_directory_iterator_increment(recursive_directory_iterator& it, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL void detail::parallel_walk(path const& root, parallel_walk_options const& opts, detail::parallel_walk_visitor_t* visitor, void* context, system::error_code* ec);
 
 public:
     directory_iterator() noexcept {} // creates the "end" iterator
@@ -718,6 +938,17 @@ public:
         return *this;
     }
 
+    //! Copies up to \a count entries, starting with the current one, to \a entries and advances the iterator past them. Returns the number of copied entries.
+    std::size_t next_batch(directory_entry* entries, std::size_t count)
+    {
+        return detail::directory_iterator_next_batch(*this, entries, count, nullptr);
+    }
+
+    std::size_t next_batch(directory_entry* entries, std::size_t count, system::error_code& ec) noexcept
+    {
+        return detail::directory_iterator_next_batch(*this, entries, count, &ec);
+    }
+
 private:
     boost::iterator_facade<
         directory_iterator,
@@ -820,6 +1051,175 @@ struct range_const_iterator< boost::filesystem::directory_iterator, void >
 
 namespace filesystem {
 
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                directory_reader                                      //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+/*!
+ * \brief Reads names and types of directory entries
+ *
+ * Unlike \c directory_iterator, the reader does not construct a \c directory_entry with the full path of every entry.
+ * Where supported, the name of the current entry refers directly to the buffer of directory entries obtained from
+ * the operating system, and the full path is only constructed on request. The dot and dot-dot entries are skipped.
+ */
+class directory_reader
+{
+private:
+    boost::intrusive_ptr< detail::dir_itr_imp > m_imp;
+    path m_dir;
+    //! Buffer for the entry name, on systems where the name cannot be referenced in the buffer of directory entries
+    path m_filename;
+    path::value_type const* m_name;
+    std::size_t m_name_size;
+    file_type m_type;
+    file_type m_symlink_type;
+    //! Indicates that the entry in \c m_filename was read when the directory was opened and has not been returned yet
+    bool m_pending;
+
+public:
+    directory_reader() noexcept :
+        m_name(nullptr),
+        m_name_size(0u),
+        m_type(status_error),
+        m_symlink_type(status_error),
+        m_pending(false)
+    {
+    }
+
+    explicit directory_reader(path const& p, directory_options opts = directory_options::none) :
+        m_name(nullptr),
+        m_name_size(0u),
+        m_type(status_error),
+        m_symlink_type(status_error),
+        m_pending(false)
+    {
+        open_impl(p, opts, nullptr);
+    }
+
+    directory_reader(path const& p, directory_options opts, system::error_code& ec) :
+        m_name(nullptr),
+        m_name_size(0u),
+        m_type(status_error),
+        m_symlink_type(status_error),
+        m_pending(false)
+    {
+        open_impl(p, opts, &ec);
+    }
+
+    directory_reader(directory_reader&& that) noexcept :
+        m_imp(static_cast< boost::intrusive_ptr< detail::dir_itr_imp >&& >(that.m_imp)),
+        m_dir(static_cast< path&& >(that.m_dir)),
+        m_name(nullptr),
+        m_name_size(that.m_name_size),
+        m_type(that.m_type),
+        m_symlink_type(that.m_symlink_type),
+        m_pending(that.m_pending)
+    {
+        move_name_from(that);
+    }
+
+    directory_reader& operator=(directory_reader&& that) noexcept
+    {
+        if (BOOST_LIKELY(this != &that))
+        {
+            m_imp = static_cast< boost::intrusive_ptr< detail::dir_itr_imp >&& >(that.m_imp);
+            m_dir = static_cast< path&& >(that.m_dir);
+            m_name_size = that.m_name_size;
+            m_type = that.m_type;
+            m_symlink_type = that.m_symlink_type;
+            m_pending = that.m_pending;
+            move_name_from(that);
+        }
+
+        return *this;
+    }
+
+    directory_reader(directory_reader const&) = delete;
+    directory_reader& operator=(directory_reader const&) = delete;
+
+    //! Closes the current directory, if any, and opens the directory \a p
+    void open(path const& p, directory_options opts = directory_options::none)
+    {
+        open_impl(p, opts, nullptr);
+    }
+
+    void open(path const& p, directory_options opts, system::error_code& ec)
+    {
+        open_impl(p, opts, &ec);
+    }
+
+    //! Closes the directory
+    void close() noexcept
+    {
+        m_imp.reset();
+        m_name = nullptr;
+        m_name_size = 0u;
+        m_pending = false;
+    }
+
+    //! Returns \c true if the directory is open and the end of the directory has not been reached
+    bool is_open() const noexcept { return !!m_imp; }
+
+    //! Returns the path of the directory
+    path const& directory_path() const noexcept { return m_dir; }
+
+    /*!
+     * \brief Advances to the next entry
+     *
+     * Returns \c false when there are no more entries, in which case the directory is closed. Invalidates the name of the previous entry.
+     */
+    bool next()
+    {
+        return next_impl(nullptr);
+    }
+
+    bool next(system::error_code& ec)
+    {
+        return next_impl(&ec);
+    }
+
+    //! Returns the file name of the current entry, as a zero-terminated string
+    path::value_type const* name_c_str() const noexcept { return m_name; }
+    //! Returns the length of the file name of the current entry
+    std::size_t name_size() const noexcept { return m_name_size; }
+#if !defined(BOOST_NO_CXX17_HDR_STRING_VIEW)
+    //! Returns the file name of the current entry
+    std::basic_string_view< path::value_type > name() const noexcept { return std::basic_string_view< path::value_type >(m_name, m_name_size); }
+#endif
+    //! Returns the file name of the current entry
+    path filename() const { return path(m_name, m_name + m_name_size); }
+    //! Returns the full path of the current entry, which is the directory path followed by the file name
+    path full_path() const
+    {
+        path p(m_dir);
+        detail::path_algorithms::append_v4(p, m_name, m_name + m_name_size);
+        return p;
+    }
+
+    //! Returns the file type of the current entry, as would be reported by \c status, or \c status_error if it is not known
+    file_type type() const noexcept { return m_type; }
+    //! Returns the file type of the current entry, as would be reported by \c symlink_status, or \c status_error if it is not known
+    file_type symlink_type() const noexcept { return m_symlink_type; }
+
+private:
+    //! Moves the entry name from \a that, which may refer to the name buffer that is moved
+    void move_name_from(directory_reader& that) noexcept
+    {
+        const bool name_in_filename = that.m_name == that.m_filename.c_str();
+        m_filename = static_cast< path&& >(that.m_filename);
+        m_name = name_in_filename ? m_filename.c_str() : that.m_name;
+
+        that.m_name = nullptr;
+        that.m_name_size = 0u;
+        that.m_pending = false;
+    }
+
+    BOOST_FILESYSTEM_DECL void open_impl(path const& p, directory_options opts, system::error_code* ec);
+    BOOST_FILESYSTEM_DECL bool next_impl(system::error_code* ec);
+};
+
 //--------------------------------------------------------------------------------------//
 //                                                                                      //
 //                      recursive_directory_iterator helpers                            //
@@ -828,14 +1228,72 @@ namespace filesystem {
 
 namespace detail {
 
+//! Base class for user-specified filters that tell recursive_directory_iterator whether to recurse into a directory
+struct recursion_filter_base
+{
+    virtual ~recursion_filter_base() {}
+    //! Returns \c true if the iterator should recurse into the directory
+    virtual bool operator()(directory_entry const& entry) = 0;
+};
+
+template< typename Filter >
+struct recursion_filter final :
+    public recursion_filter_base
+{
+    Filter m_filter;
+
+    template< typename F >
+    explicit recursion_filter(F&& filter) : m_filter(static_cast< F&& >(filter)) {}
+
+    bool operator()(directory_entry const& entry) override
+    {
+        return !!m_filter(entry);
+    }
+};
+
+template< typename Filter >
+inline recursion_filter_base* make_recursion_filter(Filter&& filter)
+{
+    return new recursion_filter< typename std::decay< Filter >::type >(static_cast< Filter&& >(filter));
+}
+
+//! Position in a directory that was closed by recursive_directory_iterator to limit the number of open directories
+struct recur_dir_itr_closed_level
+{
+    //! Path of the entry the directory iterator pointed to
+    path entry_path;
+    //! Position of the next entry in the directory, valid if \c has_cookie is \c true
+    boost::int64_t cookie;
+    bool has_cookie;
+    //! Indicates that the entry may be a symlink to the directory at the next level of the stack, which must be followed when reopening that directory
+    bool follow_entry;
+
+    recur_dir_itr_closed_level() noexcept :
+        cookie(0),
+        has_cookie(false),
+        follow_entry(false)
+    {
+    }
+};
+
 struct recur_dir_itr_imp :
     public boost::intrusive_ref_counter< recur_dir_itr_imp >
 {
     typedef directory_iterator element_type;
     std::vector< element_type > m_stack;
     directory_options m_options;
-
-    explicit recur_dir_itr_imp(directory_options opts) noexcept : m_options(opts) {}
+    //! Optional filter that tells whether to recurse into a directory, owned by the iterator
+    recursion_filter_base* m_filter;
+    //! Maximum number of directories kept open by the iterator, zero means no limit
+    std::size_t m_max_open_dirs;
+    //! Positions in the leading levels of m_stack, which were closed to stay within m_max_open_dirs. These levels hold end iterators.
+    std::vector< recur_dir_itr_closed_level > m_closed_levels;
+
+    explicit recur_dir_itr_imp(directory_options opts, recursion_filter_base* filter = nullptr) noexcept : m_options(opts), m_filter(filter), m_max_open_dirs(0u) {}
+    ~recur_dir_itr_imp() { delete m_filter; }
+
+    recur_dir_itr_imp(recur_dir_itr_imp const&) = delete;
+    recur_dir_itr_imp& operator=(recur_dir_itr_imp const&) = delete;
 };
 
 } // namespace detail
@@ -855,7 +1313,7 @@ class recursive_directory_iterator :
 {
     friend class boost::iterator_core_access;
 
-    friend BOOST_FILESYSTEM_DECL void detail::recursive_directory_iterator_construct(recursive_directory_iterator& it, path const& dir_path, directory_options opts, system::error_code* ec);
+    friend BOOST_FILESYSTEM_DECL void detail::recursive_directory_iterator_construct(recursive_directory_iterator& it, path const& dir_path, directory_options opts, detail::recursion_filter_base* filter, system::error_code* ec);
     friend BOOST_FILESYSTEM_DECL void detail::recursive_directory_iterator_increment(recursive_directory_iterator& it, system::error_code* ec);
     friend BOOST_FILESYSTEM_DECL void detail::recursive_directory_iterator_pop(recursive_directory_iterator& it, system::error_code* ec);
 
@@ -864,22 +1322,38 @@ public:
 
     explicit recursive_directory_iterator(path const& dir_path)
     {
-        detail::recursive_directory_iterator_construct(*this, dir_path, directory_options::none, nullptr);
+        detail::recursive_directory_iterator_construct(*this, dir_path, directory_options::none, nullptr, nullptr);
     }
 
     recursive_directory_iterator(path const& dir_path, system::error_code& ec)
     {
-        detail::recursive_directory_iterator_construct(*this, dir_path, directory_options::none, &ec);
+        detail::recursive_directory_iterator_construct(*this, dir_path, directory_options::none, nullptr, &ec);
     }
 
     recursive_directory_iterator(path const& dir_path, directory_options opts)
     {
-        detail::recursive_directory_iterator_construct(*this, dir_path, opts, nullptr);
+        detail::recursive_directory_iterator_construct(*this, dir_path, opts, nullptr, nullptr);
     }
 
     recursive_directory_iterator(path const& dir_path, directory_options opts, system::error_code& ec)
     {
-        detail::recursive_directory_iterator_construct(*this, dir_path, opts, &ec);
+        detail::recursive_directory_iterator_construct(*this, dir_path, opts, nullptr, &ec);
+    }
+
+    //! Constructs an iterator that only recurses into directories for which \a filter returns \c true
+    template<
+        typename Filter,
+        typename = typename std::enable_if< !std::is_same< typename std::decay< Filter >::type, system::error_code >::value >::type
+    >
+    recursive_directory_iterator(path const& dir_path, directory_options opts, Filter&& filter)
+    {
+        detail::recursive_directory_iterator_construct(*this, dir_path, opts, detail::make_recursion_filter(static_cast< Filter&& >(filter)), nullptr);
+    }
+
+    template< typename Filter >
+    recursive_directory_iterator(path const& dir_path, directory_options opts, Filter&& filter, system::error_code& ec)
+    {
+        detail::recursive_directory_iterator_construct(*this, dir_path, opts, detail::make_recursion_filter(static_cast< Filter&& >(filter)), &ec);
     }
 
     recursive_directory_iterator(recursive_directory_iterator const&) = default;
@@ -924,6 +1398,25 @@ public:
         detail::recursive_directory_iterator_pop(*this, &ec);
     }
 
+    //! Returns the maximum number of directories kept open by the iterator. Zero means no limit.
+    std::size_t max_open_directories() const noexcept
+    {
+        BOOST_ASSERT_MSG(!is_end(), "max_open_directories() on end recursive_directory_iterator");
+        return m_imp->m_max_open_dirs;
+    }
+
+    /*!
+     * \brief Limits the number of directories kept open by the iterator
+     *
+     * When the iterator descends into a directory and the limit is exceeded, the outermost open directories are closed.
+     * They are reopened and repositioned when the iterator ascends back to them. Zero means no limit.
+     */
+    void max_open_directories(std::size_t count) noexcept
+    {
+        BOOST_ASSERT_MSG(!is_end(), "max_open_directories() on end recursive_directory_iterator");
+        m_imp->m_max_open_dirs = count;
+    }
+
     void disable_recursion_pending(bool value = true) noexcept
     {
         BOOST_ASSERT_MSG(!is_end(), "disable_recursion_pending() on end recursive_directory_iterator");
@@ -1024,6 +1517,82 @@ inline recursive_directory_iterator range_end(recursive_directory_iterator const
     return recursive_directory_iterator();
 }
 
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                   parallel_walk                                      //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+namespace detail {
+
+template< typename Visitor >
+struct parallel_walk_visitor_invoker
+{
+    static void invoke(void* context, directory_entry const& entry)
+    {
+        (*static_cast< Visitor* >(context))(entry);
+    }
+};
+
+} // namespace detail
+
+//! Recursively walks the directory tree rooted at \a root using multiple threads and calls \a visitor for every directory entry.
+//! The visitor is called concurrently from multiple threads in an unspecified order.
+template< typename Visitor >
+inline void parallel_walk(path const& root, parallel_walk_options const& opts, Visitor&& visitor)
+{
+    typedef typename std::remove_reference< Visitor >::type visitor_type;
+    detail::parallel_walk
+    (
+        root,
+        opts,
+        &detail::parallel_walk_visitor_invoker< visitor_type >::invoke,
+        const_cast< void* >(static_cast< const volatile void* >(boost::addressof(visitor))),
+        nullptr
+    );
+}
+
+template< typename Visitor >
+inline void parallel_walk(path const& root, parallel_walk_options const& opts, Visitor&& visitor, system::error_code& ec)
+{
+    typedef typename std::remove_reference< Visitor >::type visitor_type;
+    detail::parallel_walk
+    (
+        root,
+        opts,
+        &detail::parallel_walk_visitor_invoker< visitor_type >::invoke,
+        const_cast< void* >(static_cast< const volatile void* >(boost::addressof(visitor))),
+        &ec
+    );
+}
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                     disk_usage                                       //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+/*!
+ * \brief Computes disk usage of the directory tree rooted at \a root using multiple threads
+ *
+ * Returns the disk usage of \a root and every directory in the tree, sorted by path. Each element describes the directory
+ * and all of its contents. Symlinks are not followed and are accounted as files. Files with multiple hard links are
+ * accounted once, in one of the directories that contain them.
+ */
+inline std::vector< directory_usage > disk_usage(path const& root, parallel_walk_options const& opts = parallel_walk_options())
+{
+    std::vector< directory_usage > usage;
+    detail::disk_usage(root, opts, usage, nullptr);
+    return usage;
+}
+
+inline std::vector< directory_usage > disk_usage(path const& root, parallel_walk_options const& opts, system::error_code& ec)
+{
+    std::vector< directory_usage > usage;
+    detail::disk_usage(root, opts, usage, &ec);
+    return usage;
+}
+
 } // namespace filesystem
 
 //  namespace boost template specializations
@@ -0,0 +1,546 @@
+//  boost/filesystem/directory_snapshot.hpp  ------------------------------------------//
+
+//  Copyright Andrey Semashev 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_DIRECTORY_SNAPSHOT_HPP
+#define BOOST_FILESYSTEM_DIRECTORY_SNAPSHOT_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/directory.hpp>
+
+#include <cstddef>
+#include <ctime>
+#include <vector>
+#include <utility> // std::swap
+#include <type_traits>
+#if !defined(BOOST_NO_CXX17_HDR_STRING_VIEW)
+#include <string_view>
+#endif
+
+#include <boost/cstdint.hpp>
+#include <boost/core/addressof.hpp>
+#include <boost/detail/bitmask.hpp>
+#include <boost/system/error_code.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+#include <boost/iterator/iterator_categories.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+//--------------------------------------------------------------------------------------//
+
+namespace boost {
+namespace filesystem {
+
+class directory_snapshot;
+
+namespace detail {
+
+//! Header of a directory snapshot. The layout is part of the snapshot file format.
+struct directory_snapshot_header
+{
+    char magic[8];
+    boost::uint32_t version;
+    //! Marker value that is used to detect snapshots written on a system with a different byte order
+    boost::uint32_t byte_order;
+    //! Size of a path character, in bytes
+    boost::uint32_t char_size;
+    //! Size of a record, in bytes
+    boost::uint32_t record_size;
+    //! Directory iteration options used to build the snapshot
+    boost::uint32_t options;
+    boost::uint32_t reserved;
+    //! Number of records, including the record of the root directory
+    boost::uint64_t record_count;
+    //! Size of the name table, in characters
+    boost::uint64_t name_table_size;
+};
+
+//! An entry of a directory snapshot. The layout is part of the snapshot file format.
+struct directory_snapshot_record
+{
+    //! Offset of the zero-terminated file name in the name table, in characters
+    boost::uint64_t name_offset;
+    //! Size of the regular file, in bytes
+    boost::uint64_t file_size;
+    //! File serial number
+    boost::uint64_t inode;
+    //! Last write time, in seconds and nanoseconds since the POSIX epoch
+    boost::int64_t mtime;
+    //! For directories, last status change time, in seconds and nanoseconds since the POSIX epoch
+    boost::int64_t ctime;
+    boost::uint32_t mtime_nsec;
+    boost::uint32_t ctime_nsec;
+    boost::uint32_t name_size;
+    //! Index of the record of the parent directory
+    boost::uint32_t parent;
+    //! For listed directories, index of the first record of the directory contents. Contents of a directory are stored contiguously.
+    boost::uint32_t first_child;
+    //! For listed directories, number of entries in the directory
+    boost::uint32_t child_count;
+    boost::uint8_t type;
+    boost::uint8_t symlink_type;
+    //! Record flags
+    boost::uint8_t flags;
+    boost::uint8_t reserved[5];
+};
+
+} // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                              directory_snapshot_entry                                //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+//! A reference to an entry of a directory snapshot. The object is only valid as long as the snapshot is not modified or destroyed.
+class directory_snapshot_entry
+{
+    friend class directory_snapshot;
+
+private:
+    directory_snapshot const* m_snapshot;
+    boost::uint32_t m_index;
+
+public:
+    directory_snapshot_entry(directory_snapshot const* snapshot, std::size_t index) noexcept :
+        m_snapshot(snapshot),
+        m_index(static_cast< boost::uint32_t >(index))
+    {
+    }
+
+    //! Returns \c true if the entry is not in the root directory of the snapshot
+    bool has_parent() const noexcept;
+    //! Returns the entry of the parent directory. Requires <tt>has_parent()</tt>.
+    directory_snapshot_entry parent() const noexcept;
+
+    //! Returns the file name of the entry, as a zero-terminated string
+    path::value_type const* name_c_str() const noexcept;
+    //! Returns the length of the file name of the entry
+    std::size_t name_size() const noexcept;
+#if !defined(BOOST_NO_CXX17_HDR_STRING_VIEW)
+    //! Returns the file name of the entry
+    std::basic_string_view< path::value_type > name() const noexcept
+    {
+        return std::basic_string_view< path::value_type >(name_c_str(), name_size());
+    }
+#endif
+    //! Returns the file name of the entry
+    path filename() const
+    {
+        path::value_type const* const name = name_c_str();
+        return path(name, name + name_size());
+    }
+
+    //! Returns the file type, as would be reported by \c status, or \c status_error if it is not known
+    file_type type() const noexcept;
+    //! Returns the file type, as would be reported by \c symlink_status, or \c status_error if it is not known
+    file_type symlink_type() const noexcept;
+    //! Returns the size of the regular file, or 0 for other file types
+    boost::uintmax_t file_size() const noexcept;
+    //! Returns the last write time of the file
+    std::time_t last_write_time() const noexcept;
+    //! Returns the file serial number (inode number) within its filesystem
+    boost::uintmax_t inode() const noexcept;
+
+    friend bool operator==(directory_snapshot_entry const& left, directory_snapshot_entry const& right) noexcept
+    {
+        return left.m_snapshot == right.m_snapshot && left.m_index == right.m_index;
+    }
+
+    friend bool operator!=(directory_snapshot_entry const& left, directory_snapshot_entry const& right) noexcept
+    {
+        return !(left == right);
+    }
+
+private:
+    detail::directory_snapshot_record const& record() const noexcept;
+};
+
+//! Kinds of differences between two directory snapshots
+enum class snapshot_change : unsigned int
+{
+    added,          // the entry only exists in the new snapshot
+    removed,        // the entry only exists in the old snapshot
+    modified,       // the entry exists in both snapshots, but its size, last write time or inode number differ
+    type_changed    // the entry exists in both snapshots, but its file type differs
+};
+
+//! Options of directory_snapshot::rescan
+enum class snapshot_rescan_options : unsigned int
+{
+    none = 0u,
+    refresh_file_attributes = 1u    // obtain sizes and last write times of the files in the directories that did not change,
+                                    // instead of copying them from the previous snapshot
+};
+
+BOOST_BITMASK(snapshot_rescan_options)
+
+namespace detail {
+
+//! Function that is called by diff for every difference between snapshots. One of the entry pointers may be \c nullptr.
+typedef void snapshot_diff_visitor_t(void* context, snapshot_change change, directory_snapshot_entry const* old_entry, directory_snapshot_entry const* new_entry);
+
+BOOST_FILESYSTEM_DECL void diff(directory_snapshot const& from, directory_snapshot const& to, snapshot_diff_visitor_t* visitor, void* context);
+
+} // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                 directory_snapshot                                   //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+/*!
+ * \brief A compact listing of a directory tree that can be saved to a file and used for incremental rescans
+ *
+ * The snapshot stores names, file types, sizes and last write times of the entries in a directory tree, as well as
+ * the identity and modification times of every directory. The in-memory representation of the snapshot is the same
+ * as its file format, which allows to load a saved snapshot by mapping the file into memory.
+ *
+ * Entries are stored in breadth-first order, where contents of every directory are stored contiguously. A rescan
+ * only reads the directories whose inode number, last write time or status change time have changed since the
+ * previous snapshot; the contents of other directories are copied from the previous snapshot.
+ */
+class directory_snapshot
+{
+    friend class directory_snapshot_entry;
+    friend BOOST_FILESYSTEM_DECL void detail::diff(directory_snapshot const& from, directory_snapshot const& to, detail::snapshot_diff_visitor_t* visitor, void* context);
+
+public:
+    class const_iterator :
+        public boost::iterator_facade<
+            const_iterator,
+            directory_snapshot_entry const,
+            boost::random_access_traversal_tag,
+            directory_snapshot_entry
+        >
+    {
+        friend class boost::iterator_core_access;
+        friend class directory_snapshot;
+
+    private:
+        directory_snapshot const* m_snapshot;
+        std::size_t m_index;
+
+    public:
+        const_iterator() noexcept :
+            m_snapshot(nullptr),
+            m_index(0u)
+        {
+        }
+
+    private:
+        const_iterator(directory_snapshot const* snapshot, std::size_t index) noexcept :
+            m_snapshot(snapshot),
+            m_index(index)
+        {
+        }
+
+        directory_snapshot_entry dereference() const noexcept { return directory_snapshot_entry(m_snapshot, m_index); }
+        bool equal(const_iterator const& that) const noexcept { return m_index == that.m_index; }
+        void increment() noexcept { ++m_index; }
+        void decrement() noexcept { --m_index; }
+        void advance(std::ptrdiff_t n) noexcept { m_index += n; }
+        std::ptrdiff_t distance_to(const_iterator const& that) const noexcept
+        {
+            return static_cast< std::ptrdiff_t >(that.m_index) - static_cast< std::ptrdiff_t >(m_index);
+        }
+    };
+
+    typedef directory_snapshot_entry value_type;
+    typedef directory_snapshot_entry reference;
+    typedef directory_snapshot_entry const_reference;
+    typedef const_iterator iterator;
+    typedef std::size_t size_type;
+
+private:
+    path m_root;
+    //! Storage of the snapshot built in memory
+    std::vector< unsigned char > m_buffer;
+    //! Address and size of the mapped snapshot file
+    void* m_mapping;
+    std::size_t m_mapping_size;
+    detail::directory_snapshot_header const* m_header;
+    detail::directory_snapshot_record const* m_records;
+    path::value_type const* m_names;
+    //! Number of directories that were read from the filesystem when the snapshot was built
+    size_type m_listed_directory_count;
+
+public:
+    directory_snapshot() noexcept :
+        m_mapping(nullptr),
+        m_mapping_size(0u),
+        m_header(nullptr),
+        m_records(nullptr),
+        m_names(nullptr),
+        m_listed_directory_count(0u)
+    {
+    }
+
+    explicit directory_snapshot(path const& root, directory_options opts = directory_options::none) :
+        m_mapping(nullptr),
+        m_mapping_size(0u),
+        m_header(nullptr),
+        m_records(nullptr),
+        m_names(nullptr),
+        m_listed_directory_count(0u)
+    {
+        build_impl(root, opts, nullptr, snapshot_rescan_options::none, nullptr);
+    }
+
+    directory_snapshot(path const& root, directory_options opts, system::error_code& ec) :
+        m_mapping(nullptr),
+        m_mapping_size(0u),
+        m_header(nullptr),
+        m_records(nullptr),
+        m_names(nullptr),
+        m_listed_directory_count(0u)
+    {
+        build_impl(root, opts, nullptr, snapshot_rescan_options::none, &ec);
+    }
+
+    directory_snapshot(directory_snapshot&& that) noexcept :
+        m_mapping(nullptr),
+        m_mapping_size(0u),
+        m_header(nullptr),
+        m_records(nullptr),
+        m_names(nullptr),
+        m_listed_directory_count(0u)
+    {
+        swap(that);
+    }
+
+    directory_snapshot& operator=(directory_snapshot&& that) noexcept
+    {
+        if (this != &that)
+        {
+            clear();
+            swap(that);
+        }
+
+        return *this;
+    }
+
+    directory_snapshot(directory_snapshot const&) = delete;
+    directory_snapshot& operator=(directory_snapshot const&) = delete;
+
+    ~directory_snapshot() { clear(); }
+
+    //! Clears the snapshot and fills it by walking the directory tree rooted at \a root
+    void assign(path const& root, directory_options opts = directory_options::none)
+    {
+        build_impl(root, opts, nullptr, snapshot_rescan_options::none, nullptr);
+    }
+
+    void assign(path const& root, directory_options opts, system::error_code& ec)
+    {
+        build_impl(root, opts, nullptr, snapshot_rescan_options::none, &ec);
+    }
+
+    //! Returns a new snapshot of the same directory tree, reusing the contents of the directories that have not changed
+    directory_snapshot rescan(snapshot_rescan_options opts = snapshot_rescan_options::none) const
+    {
+        directory_snapshot snapshot;
+        snapshot.build_impl(m_root, options(), this, opts, nullptr);
+        return snapshot;
+    }
+
+    directory_snapshot rescan(system::error_code& ec) const
+    {
+        directory_snapshot snapshot;
+        snapshot.build_impl(m_root, options(), this, snapshot_rescan_options::none, &ec);
+        return snapshot;
+    }
+
+    directory_snapshot rescan(snapshot_rescan_options opts, system::error_code& ec) const
+    {
+        directory_snapshot snapshot;
+        snapshot.build_impl(m_root, options(), this, opts, &ec);
+        return snapshot;
+    }
+
+    //! Writes the snapshot to a file
+    void save(path const& file) const
+    {
+        save_impl(file, nullptr);
+    }
+
+    void save(path const& file, system::error_code& ec) const
+    {
+        save_impl(file, &ec);
+    }
+
+    //! Clears the snapshot and maps the snapshot file into memory
+    void load(path const& file)
+    {
+        load_impl(file, nullptr);
+    }
+
+    void load(path const& file, system::error_code& ec)
+    {
+        load_impl(file, &ec);
+    }
+
+    BOOST_FILESYSTEM_DECL void clear() noexcept;
+
+    void swap(directory_snapshot& that) noexcept
+    {
+        m_root.swap(that.m_root);
+        m_buffer.swap(that.m_buffer);
+        std::swap(m_mapping, that.m_mapping);
+        std::swap(m_mapping_size, that.m_mapping_size);
+        std::swap(m_header, that.m_header);
+        std::swap(m_records, that.m_records);
+        std::swap(m_names, that.m_names);
+        std::swap(m_listed_directory_count, that.m_listed_directory_count);
+    }
+
+    //! Returns the path of the root directory of the snapshot
+    path const& root() const noexcept { return m_root; }
+    //! Returns the directory iteration options used to build the snapshot
+    directory_options options() const noexcept
+    {
+        return m_header ? static_cast< directory_options >(m_header->options) : directory_options::none;
+    }
+
+    //! Returns \c true if the snapshot was loaded from a file mapped into memory
+    bool is_mapped() const noexcept { return m_mapping != nullptr; }
+
+    /*!
+     * \brief Returns the number of directories whose contents were read from the filesystem when the snapshot was built
+     *
+     * For a rescanned snapshot, the contents of the remaining directories were copied from the previous snapshot.
+     * For a loaded snapshot, returns 0.
+     */
+    size_type listed_directory_count() const noexcept { return m_listed_directory_count; }
+
+    bool empty() const noexcept { return size() == 0u; }
+    size_type size() const noexcept { return m_header ? static_cast< size_type >(m_header->record_count - 1u) : 0u; }
+
+    const_iterator begin() const noexcept { return const_iterator(this, 1u); }
+    const_iterator end() const noexcept { return const_iterator(this, size() + 1u); }
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    //! Returns the path of the entry relative to the root directory
+    path relative_path(directory_snapshot_entry const& entry) const
+    {
+        return build_path(path(), entry.m_index);
+    }
+
+    //! Returns the full path of the entry, which is the root directory path followed by the relative path of the entry
+    path full_path(directory_snapshot_entry const& entry) const
+    {
+        return build_path(m_root, entry.m_index);
+    }
+
+private:
+    BOOST_FILESYSTEM_DECL void build_impl(path const& root, directory_options opts, directory_snapshot const* previous, snapshot_rescan_options rescan_opts, system::error_code* ec);
+    BOOST_FILESYSTEM_DECL void save_impl(path const& file, system::error_code* ec) const;
+    BOOST_FILESYSTEM_DECL void load_impl(path const& file, system::error_code* ec);
+    BOOST_FILESYSTEM_DECL path build_path(path const& base, std::size_t index) const;
+};
+
+inline void swap(directory_snapshot& left, directory_snapshot& right) noexcept
+{
+    left.swap(right);
+}
+
+namespace detail {
+
+template< typename Visitor >
+struct snapshot_diff_visitor_invoker
+{
+    static void invoke(void* context, snapshot_change change, directory_snapshot_entry const* old_entry, directory_snapshot_entry const* new_entry)
+    {
+        (*static_cast< Visitor* >(context))(change, old_entry, new_entry);
+    }
+};
+
+} // namespace detail
+
+/*!
+ * \brief Compares two snapshots and calls \a visitor for every difference
+ *
+ * The visitor is called as <tt>visitor(change, old_entry, new_entry)</tt>, where \c old_entry and \c new_entry are
+ * pointers to the entries in \a from and \a to, respectively, or \c nullptr if the entry does not exist in the snapshot.
+ * Entries are matched by their paths relative to the snapshot roots.
+ */
+template< typename Visitor >
+inline void diff(directory_snapshot const& from, directory_snapshot const& to, Visitor&& visitor)
+{
+    typedef typename std::remove_reference< Visitor >::type visitor_type;
+    detail::diff
+    (
+        from,
+        to,
+        &detail::snapshot_diff_visitor_invoker< visitor_type >::invoke,
+        const_cast< void* >(static_cast< const volatile void* >(boost::addressof(visitor)))
+    );
+}
+
+inline detail::directory_snapshot_record const& directory_snapshot_entry::record() const noexcept
+{
+    return m_snapshot->m_records[m_index];
+}
+
+inline bool directory_snapshot_entry::has_parent() const noexcept
+{
+    return record().parent != 0u;
+}
+
+inline directory_snapshot_entry directory_snapshot_entry::parent() const noexcept
+{
+    return directory_snapshot_entry(m_snapshot, record().parent);
+}
+
+inline path::value_type const* directory_snapshot_entry::name_c_str() const noexcept
+{
+    return m_snapshot->m_names + record().name_offset;
+}
+
+inline std::size_t directory_snapshot_entry::name_size() const noexcept
+{
+    return record().name_size;
+}
+
+inline file_type directory_snapshot_entry::type() const noexcept
+{
+    return static_cast< file_type >(record().type);
+}
+
+inline file_type directory_snapshot_entry::symlink_type() const noexcept
+{
+    return static_cast< file_type >(record().symlink_type);
+}
+
+inline boost::uintmax_t directory_snapshot_entry::file_size() const noexcept
+{
+    return static_cast< boost::uintmax_t >(record().file_size);
+}
+
+inline std::time_t directory_snapshot_entry::last_write_time() const noexcept
+{
+    return static_cast< std::time_t >(record().mtime);
+}
+
+inline boost::uintmax_t directory_snapshot_entry::inode() const noexcept
+{
+    return static_cast< boost::uintmax_t >(record().inode);
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_DIRECTORY_SNAPSHOT_HPP
@@ -0,0 +1,250 @@
+//  boost/filesystem/directory_tree.hpp  ----------------------------------------------//
+
+//  Copyright Andrey Semashev 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_DIRECTORY_TREE_HPP
+#define BOOST_FILESYSTEM_DIRECTORY_TREE_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/directory.hpp>
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+#if !defined(BOOST_NO_CXX17_HDR_STRING_VIEW)
+#include <string_view>
+#endif
+
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+//--------------------------------------------------------------------------------------//
+
+namespace boost {
+namespace filesystem {
+
+class directory_tree;
+
+namespace detail {
+
+//! Storage for file names of directory tree entries. Names are allocated in large blocks and are never moved.
+class directory_tree_name_arena
+{
+private:
+    std::vector< path::value_type* > m_blocks;
+    path::value_type* m_pos;
+    std::size_t m_left;
+
+public:
+    directory_tree_name_arena() noexcept :
+        m_pos(nullptr),
+        m_left(0u)
+    {
+    }
+
+    directory_tree_name_arena(directory_tree_name_arena&& that) noexcept :
+        m_blocks(static_cast< std::vector< path::value_type* >&& >(that.m_blocks)),
+        m_pos(that.m_pos),
+        m_left(that.m_left)
+    {
+        that.m_pos = nullptr;
+        that.m_left = 0u;
+    }
+
+    directory_tree_name_arena& operator=(directory_tree_name_arena&& that) noexcept
+    {
+        if (this != &that)
+        {
+            clear();
+            m_blocks.swap(that.m_blocks);
+            m_pos = that.m_pos;
+            m_left = that.m_left;
+            that.m_pos = nullptr;
+            that.m_left = 0u;
+        }
+
+        return *this;
+    }
+
+    directory_tree_name_arena(directory_tree_name_arena const&) = delete;
+    directory_tree_name_arena& operator=(directory_tree_name_arena const&) = delete;
+
+    ~directory_tree_name_arena() { clear(); }
+
+    //! Copies the string into the arena, adds a terminating zero and returns pointer to the stored string
+    BOOST_FILESYSTEM_DECL path::value_type const* store(path::value_type const* str, std::size_t size);
+
+    //! Releases all stored strings
+    BOOST_FILESYSTEM_DECL void clear() noexcept;
+};
+
+} // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                directory_tree_entry                                  //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+//! An entry of a directory tree. Only the file name of the entry is stored, the full path is built on demand.
+class directory_tree_entry
+{
+    friend class directory_tree;
+
+private:
+    directory_tree_entry const* m_parent;
+    path::value_type const* m_name;
+    boost::uint32_t m_name_size;
+    unsigned char m_type;
+    unsigned char m_symlink_type;
+
+public:
+    directory_tree_entry(directory_tree_entry const* parent, path::value_type const* name, std::size_t name_size, file_type type, file_type symlink_type) noexcept :
+        m_parent(parent),
+        m_name(name),
+        m_name_size(static_cast< boost::uint32_t >(name_size)),
+        m_type(static_cast< unsigned char >(type)),
+        m_symlink_type(static_cast< unsigned char >(symlink_type))
+    {
+    }
+
+    //! Returns the entry of the parent directory, or \c nullptr if the entry is in the root directory of the tree
+    directory_tree_entry const* parent() const noexcept { return m_parent; }
+
+    //! Returns the file name of the entry, as a zero-terminated string
+    path::value_type const* name_c_str() const noexcept { return m_name; }
+    //! Returns the length of the file name of the entry
+    std::size_t name_size() const noexcept { return m_name_size; }
+#if !defined(BOOST_NO_CXX17_HDR_STRING_VIEW)
+    //! Returns the file name of the entry
+    std::basic_string_view< path::value_type > name() const noexcept { return std::basic_string_view< path::value_type >(m_name, m_name_size); }
+#endif
+    //! Returns the file name of the entry
+    path filename() const { return path(m_name, m_name + m_name_size); }
+
+    //! Returns the file type, as would be reported by \c status, or \c status_error if it is not known
+    file_type type() const noexcept { return static_cast< file_type >(m_type); }
+    //! Returns the file type, as would be reported by \c symlink_status, or \c status_error if it is not known
+    file_type symlink_type() const noexcept { return static_cast< file_type >(m_symlink_type); }
+
+    //! Returns the depth of the entry in the tree. Entries of the root directory have depth of 0.
+    unsigned int depth() const noexcept
+    {
+        unsigned int n = 0u;
+        for (directory_tree_entry const* p = m_parent; p != nullptr; p = p->m_parent)
+            ++n;
+        return n;
+    }
+};
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                   directory_tree                                     //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+/*!
+ * \brief A listing of a directory tree
+ *
+ * The tree is filled by a recursive walk of a directory. Every entry stores a pointer to its parent directory entry
+ * and its file name, which is allocated in an arena owned by the tree. Full paths of entries are only constructed
+ * on demand. Entries are stored in the walk order, where every directory precedes its contents.
+ */
+class directory_tree
+{
+public:
+    typedef directory_tree_entry value_type;
+    typedef directory_tree_entry const& reference;
+    typedef directory_tree_entry const& const_reference;
+    typedef std::deque< directory_tree_entry >::const_iterator const_iterator;
+    typedef const_iterator iterator;
+    typedef std::size_t size_type;
+
+private:
+    path m_root;
+    std::deque< directory_tree_entry > m_entries;
+    detail::directory_tree_name_arena m_names;
+
+public:
+    directory_tree() noexcept {}
+
+    explicit directory_tree(path const& root, directory_options opts = directory_options::none)
+    {
+        assign_impl(root, opts, nullptr);
+    }
+
+    directory_tree(path const& root, directory_options opts, system::error_code& ec)
+    {
+        assign_impl(root, opts, &ec);
+    }
+
+    directory_tree(directory_tree&&) = default;
+    directory_tree& operator=(directory_tree&&) = default;
+
+    directory_tree(directory_tree const&) = delete;
+    directory_tree& operator=(directory_tree const&) = delete;
+
+    //! Clears the tree and fills it by walking the directory tree rooted at \a root
+    void assign(path const& root, directory_options opts = directory_options::none)
+    {
+        assign_impl(root, opts, nullptr);
+    }
+
+    void assign(path const& root, directory_options opts, system::error_code& ec)
+    {
+        assign_impl(root, opts, &ec);
+    }
+
+    void clear() noexcept
+    {
+        m_entries.clear();
+        m_names.clear();
+        m_root.clear();
+    }
+
+    //! Returns the path of the root directory of the tree
+    path const& root() const noexcept { return m_root; }
+
+    bool empty() const noexcept { return m_entries.empty(); }
+    size_type size() const noexcept { return m_entries.size(); }
+
+    const_iterator begin() const noexcept { return m_entries.begin(); }
+    const_iterator end() const noexcept { return m_entries.end(); }
+    const_iterator cbegin() const noexcept { return m_entries.begin(); }
+    const_iterator cend() const noexcept { return m_entries.end(); }
+
+    //! Returns the path of the entry relative to the root directory
+    path relative_path(directory_tree_entry const& entry) const
+    {
+        return build_path(path(), entry);
+    }
+
+    //! Returns the full path of the entry, which is the root directory path followed by the relative path of the entry
+    path full_path(directory_tree_entry const& entry) const
+    {
+        return build_path(m_root, entry);
+    }
+
+private:
+    BOOST_FILESYSTEM_DECL void assign_impl(path const& root, directory_options opts, system::error_code* ec);
+    BOOST_FILESYSTEM_DECL static path build_path(path const& base, directory_tree_entry const& entry);
+    directory_tree_entry* append_entry(directory_tree_entry const* parent, path const& filename, file_status const& st, file_status const& symlink_st);
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_DIRECTORY_TREE_HPP
@@ -0,0 +1,212 @@
+//  boost/filesystem/directory_watcher.hpp  -------------------------------------------//
+
+//  Copyright Andrey Semashev 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_DIRECTORY_WATCHER_HPP
+#define BOOST_FILESYSTEM_DIRECTORY_WATCHER_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/directory.hpp>
+
+#include <cstddef>
+#include <chrono>
+#include <vector>
+
+#include <boost/detail/bitmask.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+//--------------------------------------------------------------------------------------//
+
+namespace boost {
+namespace filesystem {
+
+//! Kinds of changes reported by directory_watcher
+enum class directory_change : unsigned int
+{
+    none = 0u,
+    added = 1u,             // the file was created or moved into a watched directory
+    removed = 1u << 1u,     // the file was removed or moved out of a watched directory
+    modified = 1u << 2u,    // the file contents were modified
+    attributes = 1u << 3u,  // the file attributes (permissions, timestamps, owner, etc.) were modified
+    overflow = 1u << 4u     // the event queue overflowed and some events were lost, the watcher resynchronized with the directory tree
+};
+
+BOOST_BITMASK(directory_change)
+
+namespace detail {
+
+struct directory_watcher_imp;
+
+} // namespace detail
+
+//! An event reported by directory_watcher
+class directory_watch_event
+{
+    friend struct detail::directory_watcher_imp;
+
+private:
+    boost::filesystem::path m_path;
+    directory_change m_changes;
+    bool m_is_directory;
+
+public:
+    directory_watch_event() noexcept :
+        m_changes(directory_change::none),
+        m_is_directory(false)
+    {
+    }
+
+    directory_watch_event(boost::filesystem::path const& p, directory_change changes, bool is_directory) :
+        m_path(p),
+        m_changes(changes),
+        m_is_directory(is_directory)
+    {
+    }
+
+    //! Returns the path of the changed file
+    boost::filesystem::path const& path() const noexcept { return m_path; }
+    //! Returns the kinds of changes of the file. The changes of the same file within one batch of events are combined.
+    directory_change changes() const noexcept { return m_changes; }
+    //! Returns \c true if the changed file is a directory
+    bool is_directory() const noexcept { return m_is_directory; }
+};
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                  directory_watcher                                   //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+/*!
+ * \brief Watches a directory tree for changes
+ *
+ * The watcher registers watches for the root directory and all its subdirectories, and adds watches for new
+ * subdirectories as they appear. Events are obtained in batches, where all changes of the same file are combined
+ * into one event. If the system event queue overflows, the watcher walks the tree to register watches for
+ * any directories it missed and reports an event with \c directory_change::overflow for the root directory.
+ *
+ * The watcher is currently only supported on Linux, where it is implemented using inotify.
+ */
+class directory_watcher
+{
+private:
+    detail::directory_watcher_imp* m_imp;
+
+public:
+    directory_watcher() noexcept :
+        m_imp(nullptr)
+    {
+    }
+
+    explicit directory_watcher(path const& root, directory_options opts = directory_options::none) :
+        m_imp(nullptr)
+    {
+        open_impl(root, opts, nullptr);
+    }
+
+    directory_watcher(path const& root, directory_options opts, system::error_code& ec) :
+        m_imp(nullptr)
+    {
+        open_impl(root, opts, &ec);
+    }
+
+    directory_watcher(directory_watcher&& that) noexcept :
+        m_imp(that.m_imp)
+    {
+        that.m_imp = nullptr;
+    }
+
+    directory_watcher& operator=(directory_watcher&& that) noexcept
+    {
+        if (this != &that)
+        {
+            close();
+            m_imp = that.m_imp;
+            that.m_imp = nullptr;
+        }
+
+        return *this;
+    }
+
+    directory_watcher(directory_watcher const&) = delete;
+    directory_watcher& operator=(directory_watcher const&) = delete;
+
+    ~directory_watcher() { close(); }
+
+    //! Stops watching the current tree, if any, and starts watching the directory tree rooted at \a root
+    void open(path const& root, directory_options opts = directory_options::none)
+    {
+        open_impl(root, opts, nullptr);
+    }
+
+    void open(path const& root, directory_options opts, system::error_code& ec)
+    {
+        open_impl(root, opts, &ec);
+    }
+
+    //! Stops watching the directory tree
+    BOOST_FILESYSTEM_DECL void close() noexcept;
+
+    bool is_open() const noexcept { return m_imp != nullptr; }
+
+    //! Returns the path of the root directory of the watched tree
+    BOOST_FILESYSTEM_DECL path const& root() const noexcept;
+
+    //! Returns the number of watched directories
+    BOOST_FILESYSTEM_DECL std::size_t watch_count() const noexcept;
+
+    //! Returns a native handle that becomes readable when there are events to process, or -1 if the watcher is not open
+    BOOST_FILESYSTEM_DECL int native_handle() const noexcept;
+
+    //! Waits for changes and replaces the contents of \a events with a batch of events. Returns the number of events.
+    std::size_t wait(std::vector< directory_watch_event >& events)
+    {
+        return wait_impl(events, -1, nullptr);
+    }
+
+    std::size_t wait(std::vector< directory_watch_event >& events, system::error_code& ec)
+    {
+        return wait_impl(events, -1, &ec);
+    }
+
+    //! Waits for changes for at most \a timeout and replaces the contents of \a events with a batch of events. Returns the number of events.
+    template< typename Rep, typename Period >
+    std::size_t wait_for(std::vector< directory_watch_event >& events, std::chrono::duration< Rep, Period > const& timeout)
+    {
+        return wait_impl(events, to_timeout_ms(timeout), nullptr);
+    }
+
+    template< typename Rep, typename Period >
+    std::size_t wait_for(std::vector< directory_watch_event >& events, std::chrono::duration< Rep, Period > const& timeout, system::error_code& ec)
+    {
+        return wait_impl(events, to_timeout_ms(timeout), &ec);
+    }
+
+private:
+    template< typename Rep, typename Period >
+    static long to_timeout_ms(std::chrono::duration< Rep, Period > const& timeout)
+    {
+        const typename std::chrono::milliseconds::rep ms = std::chrono::duration_cast< std::chrono::milliseconds >(timeout).count();
+        return ms < 0 ? 0l : (ms > 0x7fffffff ? 0x7fffffffl : static_cast< long >(ms));
+    }
+
+    BOOST_FILESYSTEM_DECL void open_impl(path const& root, directory_options opts, system::error_code* ec);
+    BOOST_FILESYSTEM_DECL std::size_t wait_impl(std::vector< directory_watch_event >& events, long timeout_ms, system::error_code* ec);
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_DIRECTORY_WATCHER_HPP
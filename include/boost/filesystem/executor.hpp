@@ -0,0 +1,81 @@
+//  boost/filesystem/executor.hpp  ----------------------------------------------------//
+
+//  Copyright Andrey Semashev 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_EXECUTOR_HPP
+#define BOOST_FILESYSTEM_EXECUTOR_HPP
+
+#include <boost/filesystem/config.hpp>
+
+#include <functional>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+//--------------------------------------------------------------------------------------//
+
+namespace boost {
+namespace filesystem {
+
+namespace detail {
+
+struct thread_pool_executor_imp;
+
+} // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                thread_pool_executor                                  //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+/*!
+ * \brief A pool of threads that run blocking filesystem operations on behalf of asynchronous callers
+ *
+ * Tasks are run in the order they were posted, by whichever thread of the pool becomes available first.
+ * The threads are started on construction. When the executor is destroyed, the tasks that are already posted
+ * are run to completion before the threads are joined.
+ *
+ * If the library is built without support for threads, tasks are run in the thread that posts them.
+ */
+class thread_pool_executor
+{
+private:
+    detail::thread_pool_executor_imp* m_imp;
+
+public:
+    //! Starts \a thread_count threads. If \a thread_count is 0, the number of threads is equal to the number of CPUs.
+    explicit thread_pool_executor(unsigned int thread_count = 0u) :
+        m_imp(nullptr)
+    {
+        start(thread_count);
+    }
+
+    thread_pool_executor(thread_pool_executor const&) = delete;
+    thread_pool_executor& operator=(thread_pool_executor const&) = delete;
+
+    ~thread_pool_executor() { stop(); }
+
+    //! Returns the number of threads in the pool
+    BOOST_FILESYSTEM_DECL unsigned int thread_count() const noexcept;
+
+    //! Schedules \a task to be run by one of the threads of the pool. The task must not throw.
+    BOOST_FILESYSTEM_DECL void post(std::function< void() > task);
+
+private:
+    BOOST_FILESYSTEM_DECL void start(unsigned int thread_count);
+    BOOST_FILESYSTEM_DECL void stop() noexcept;
+};
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_EXECUTOR_HPP
@@ -0,0 +1,169 @@
+//  boost/filesystem/glob.hpp  --------------------------------------------------------//
+
+//  Copyright Andrey Semashev 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_GLOB_HPP
+#define BOOST_FILESYSTEM_GLOB_HPP
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/directory.hpp>
+
+#include <vector>
+
+#include <boost/detail/bitmask.hpp>
+#include <boost/smart_ptr/intrusive_ptr.hpp>
+#include <boost/system/error_code.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+//--------------------------------------------------------------------------------------//
+
+namespace boost {
+namespace filesystem {
+
+//! Glob pattern compilation options
+enum class glob_options : unsigned int
+{
+    none = 0u,
+    match_hidden = 1u,      // wildcards match file names starting with a dot, "**" descends into such directories
+    no_escape = 1u << 1u,   // backslash is not an escape character; this is always the case on Windows, where backslash is a directory separator
+    no_braces = 1u << 2u    // braces are not special and do not denote alternatives
+};
+
+BOOST_BITMASK(glob_options)
+
+class glob_pattern;
+
+namespace detail {
+
+struct glob_pattern_imp;
+
+BOOST_FILESYSTEM_DECL void intrusive_ptr_add_ref(glob_pattern_imp const* p) noexcept;
+BOOST_FILESYSTEM_DECL void intrusive_ptr_release(glob_pattern_imp const* p) noexcept;
+
+BOOST_FILESYSTEM_DECL
+void glob(glob_pattern const& pattern, directory_options opts, std::vector< path >& results, system::error_code* ec);
+
+} // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                    glob_pattern                                      //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+/*!
+ * \brief A compiled glob pattern
+ *
+ * The pattern is split into path elements, each of which is compiled into a matcher that operates on file names
+ * directly, without constructing paths. The supported syntax is:
+ *
+ * - \c * matches any number of characters, \c ? matches any single character,
+ * - <tt>[abc]</tt>, <tt>[a-z]</tt>, <tt>[!a-z]</tt> and <tt>[^a-z]</tt> match a single character from (or not from) the set,
+ * - <tt>{a,b,c}</tt> matches any of the comma-separated alternatives, which may themselves contain wildcards,
+ * - \c ** as a whole path element matches any number of nested directories, including none,
+ * - a backslash escapes the following character (on POSIX systems).
+ *
+ * Unless \c glob_options::match_hidden is specified, wildcards do not match a leading dot in file names.
+ * A trailing directory separator restricts matches to directories. The pattern is compiled once and can be
+ * used concurrently by multiple threads.
+ */
+class glob_pattern
+{
+    friend BOOST_FILESYSTEM_DECL void detail::glob(glob_pattern const& pattern, directory_options opts, std::vector< path >& results, system::error_code* ec);
+
+private:
+    boost::intrusive_ptr< const detail::glob_pattern_imp > m_imp;
+
+public:
+    glob_pattern() noexcept {}
+
+    explicit glob_pattern(path const& pattern, glob_options opts = glob_options::none)
+    {
+        compile(pattern, opts, nullptr);
+    }
+
+    glob_pattern(path const& pattern, glob_options opts, system::error_code& ec)
+    {
+        compile(pattern, opts, &ec);
+    }
+
+    //! Compiles a new pattern
+    void assign(path const& pattern, glob_options opts = glob_options::none)
+    {
+        compile(pattern, opts, nullptr);
+    }
+
+    void assign(path const& pattern, glob_options opts, system::error_code& ec)
+    {
+        compile(pattern, opts, &ec);
+    }
+
+    //! Returns \c true if no pattern is compiled
+    bool empty() const noexcept { return !m_imp; }
+
+    //! Returns the pattern string
+    BOOST_FILESYSTEM_DECL path const& pattern() const noexcept;
+    //! Returns the pattern compilation options
+    BOOST_FILESYSTEM_DECL glob_options options() const noexcept;
+
+    /*!
+     * \brief Lexically tests if the path matches the pattern
+     *
+     * The path is matched element by element, without accessing the filesystem. All elements except the last
+     * are assumed to be directories.
+     */
+    BOOST_FILESYSTEM_DECL bool match(path const& p) const;
+
+private:
+    BOOST_FILESYSTEM_DECL void compile(path const& pattern, glob_options opts, system::error_code* ec);
+};
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                        glob                                          //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+//! Returns paths of the files matching the pattern, in the order of directory traversal
+inline std::vector< path > glob(glob_pattern const& pattern, directory_options opts = directory_options::none)
+{
+    std::vector< path > results;
+    detail::glob(pattern, opts, results, nullptr);
+    return results;
+}
+
+inline std::vector< path > glob(glob_pattern const& pattern, directory_options opts, system::error_code& ec)
+{
+    std::vector< path > results;
+    detail::glob(pattern, opts, results, &ec);
+    return results;
+}
+
+inline std::vector< path > glob(path const& pattern, directory_options opts = directory_options::none)
+{
+    return filesystem::glob(glob_pattern(pattern), opts);
+}
+
+inline std::vector< path > glob(path const& pattern, directory_options opts, system::error_code& ec)
+{
+    glob_pattern compiled(pattern, glob_options::none, ec);
+    if (ec)
+        return std::vector< path >();
+    return filesystem::glob(compiled, opts, ec);
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_GLOB_HPP
@@ -24,7 +24,9 @@
 #include <boost/system/error_code.hpp>
 #include <boost/cstdint.hpp>
 #include <ctime>
+#include <chrono>
 #include <string>
+#include <functional>
 
 #include <boost/filesystem/detail/header.hpp> // must be the last #include
 
@@ -52,6 +54,8 @@ enum class copy_options : unsigned int
     synchronize_data = 1u << 3u,        // Flush all buffered data written to the target file to permanent storage
     synchronize = 1u << 4u,             // Flush all buffered data and attributes written to the target file to permanent storage
     ignore_attribute_errors = 1u << 5u, // Ignore errors of copying file attributes
+    reflink = 1u << 6u,                 // Make the target file share the data of the source file (clone), fail if not supported by the filesystem
+    reflink_or_copy = 1u << 7u,         // Clone the file data if supported by the filesystem, otherwise copy it
 
     // copy options:
     recursive = 1u << 8u,               // Recurse into sub-directories
@@ -60,11 +64,74 @@ enum class copy_options : unsigned int
     directories_only = 1u << 11u,       // Only copy directory structure, do not copy non-directory files
     create_symlinks = 1u << 12u,        // Create symlinks instead of copying files
     create_hard_links = 1u << 13u,      // Create hard links instead of copying files
-    _detail_recursing = 1u << 14u       // Internal use only, do not use
+    _detail_recursing = 1u << 14u,      // Internal use only, do not use
+    parallel = 1u << 15u,               // When recursing, create the directories and then copy the files concurrently using multiple threads
+
+    // copy_file options:
+    preserve_sparse = 1u << 16u,        // Copy only the data regions of sparse files, leaving holes in the target file
+    parallel_chunks = 1u << 17u,        // Copy large files in chunks concurrently using multiple threads
+    no_cache = 1u << 18u                // Avoid keeping the copied data in the system file cache
 };
 
 BOOST_BITMASK(copy_options)
 
+//! Method used to copy file data, as reported in copy_progress
+enum class copy_strategy : unsigned int
+{
+    none = 0u,       // No file data is copied, e.g. when a directory or a symlink is created
+    clone,           // The target file shares the data of the source file (reflink)
+    copy_file_range, // Data is copied by copy_file_range system call
+    sendfile,        // Data is copied by sendfile system call
+    read_write,      // Data is read into a buffer and written to the target file
+    system_copy      // Data is copied by the system file copy function, e.g. CopyFileExW on Windows
+};
+
+//! Progress of copy_file and copy operations
+struct copy_progress
+{
+    path const& from;                            // The file being copied
+    path const& to;                              // The target file
+    copy_strategy strategy;                      // Method used to copy the file data
+    boost::uintmax_t file_size;                  // Size of the file being copied, as obtained before copying
+    boost::uintmax_t file_bytes_copied;          // Number of bytes of the file copied so far
+    boost::uintmax_t total_bytes_copied;         // Number of bytes copied so far by the operation, including the previous files
+    boost::uintmax_t files_copied;               // Number of files copied so far by the operation, including directories and symlinks
+    std::chrono::steady_clock::duration elapsed; // Time since the operation started
+};
+
+//! Function that is called to report progress of copy_file and copy. Returning \c false cancels the operation.
+typedef std::function< bool (copy_progress const&) > copy_progress_handler;
+
+enum class sync_options : unsigned int
+{
+    none = 0u,                     // Default. Copy the files that are missing in the target tree or differ in size or last write time.
+    compare_contents = 1u,         // Compare contents of the files of equal size instead of their last write times
+    delete_extraneous = 1u << 1u   // Remove the files in the target tree that do not exist in the source tree
+};
+
+BOOST_BITMASK(sync_options)
+
+//! Changes made by sync_tree
+struct sync_summary
+{
+    boost::uintmax_t files_created;       // Number of files and symlinks copied to the target tree that did not exist there
+    boost::uintmax_t files_updated;       // Number of files and symlinks in the target tree replaced with the changed source files
+    boost::uintmax_t files_unchanged;     // Number of files and symlinks in the target tree that are equal to the source files
+    boost::uintmax_t files_removed;       // Number of files removed from the target tree, including the contents of the removed directories
+    boost::uintmax_t directories_created; // Number of directories created in the target tree
+    boost::uintmax_t bytes_copied;        // Total size of the copied files
+
+    sync_summary() noexcept :
+        files_created(0u),
+        files_updated(0u),
+        files_unchanged(0u),
+        files_removed(0u),
+        directories_created(0u),
+        bytes_copied(0u)
+    {
+    }
+};
+
 //--------------------------------------------------------------------------------------//
 //                             implementation details                                   //
 //--------------------------------------------------------------------------------------//
@@ -90,8 +157,14 @@ path canonical_v4(path const& p, path const& base, system::error_code* ec = null
 BOOST_FILESYSTEM_DECL
 void copy(path const& from, path const& to, copy_options options, system::error_code* ec = nullptr);
 BOOST_FILESYSTEM_DECL
+void copy_parallel(path const& from, path const& to, copy_options options, unsigned int thread_count, system::error_code* ec = nullptr);
+BOOST_FILESYSTEM_DECL
+void copy_with_progress(path const& from, path const& to, copy_options options, copy_progress_handler const& handler, system::error_code* ec = nullptr);
+BOOST_FILESYSTEM_DECL
 bool copy_file(path const& from, path const& to, copy_options options, system::error_code* ec = nullptr);
 BOOST_FILESYSTEM_DECL
+bool copy_file_with_progress(path const& from, path const& to, copy_options options, copy_progress_handler const& handler, system::error_code* ec = nullptr);
+BOOST_FILESYSTEM_DECL
 void copy_symlink(path const& existing_symlink, path const& new_symlink, system::error_code* ec = nullptr);
 BOOST_FILESYSTEM_DECL
 bool create_directories(path const& p, system::error_code* ec = nullptr);
@@ -138,6 +211,8 @@ void resize_file(path const& p, uintmax_t size, system::error_code* ec = nullptr
 BOOST_FILESYSTEM_DECL
 space_info space(path const& p, system::error_code* ec = nullptr);
 BOOST_FILESYSTEM_DECL
+sync_summary sync_tree(path const& from, path const& to, sync_options options, system::error_code* ec = nullptr);
+BOOST_FILESYSTEM_DECL
 path system_complete(path const& p, system::error_code* ec = nullptr);
 BOOST_FILESYSTEM_DECL
 path temp_directory_path(system::error_code* ec = nullptr);
@@ -359,6 +434,26 @@ inline void copy(path const& from, path const& to, copy_options options, system:
     detail::copy(from, to, options, &ec);
 }
 
+inline void copy(path const& from, path const& to, copy_options options, unsigned int thread_count)
+{
+    detail::copy_parallel(from, to, options, thread_count);
+}
+
+inline void copy(path const& from, path const& to, copy_options options, unsigned int thread_count, system::error_code& ec) noexcept
+{
+    detail::copy_parallel(from, to, options, thread_count, &ec);
+}
+
+inline void copy(path const& from, path const& to, copy_options options, copy_progress_handler const& handler)
+{
+    detail::copy_with_progress(from, to, options, handler);
+}
+
+inline void copy(path const& from, path const& to, copy_options options, copy_progress_handler const& handler, system::error_code& ec) noexcept
+{
+    detail::copy_with_progress(from, to, options, handler, &ec);
+}
+
 inline bool copy_file(path const& from, path const& to)
 {
     return detail::copy_file(from, to, copy_options::none);
@@ -379,6 +474,16 @@ inline bool copy_file(path const& from, path const& to, copy_options options, sy
     return detail::copy_file(from, to, options, &ec);
 }
 
+inline bool copy_file(path const& from, path const& to, copy_options options, copy_progress_handler const& handler)
+{
+    return detail::copy_file_with_progress(from, to, options, handler);
+}
+
+inline bool copy_file(path const& from, path const& to, copy_options options, copy_progress_handler const& handler, system::error_code& ec) noexcept
+{
+    return detail::copy_file_with_progress(from, to, options, handler, &ec);
+}
+
 inline void copy_symlink(path const& existing_symlink, path const& new_symlink)
 {
     detail::copy_symlink(existing_symlink, new_symlink);
@@ -588,6 +693,21 @@ inline space_info space(path const& p, system::error_code& ec) noexcept
     return detail::space(p, &ec);
 }
 
+inline sync_summary sync_tree(path const& from, path const& to, sync_options options = sync_options::none)
+{
+    return detail::sync_tree(from, to, options);
+}
+
+inline sync_summary sync_tree(path const& from, path const& to, system::error_code& ec) noexcept
+{
+    return detail::sync_tree(from, to, sync_options::none, &ec);
+}
+
+inline sync_summary sync_tree(path const& from, path const& to, sync_options options, system::error_code& ec) noexcept
+{
+    return detail::sync_tree(from, to, options, &ec);
+}
+
 inline path system_complete(path const& p)
 {
     return detail::system_complete(p);
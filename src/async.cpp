@@ -0,0 +1,845 @@
+//  async.cpp  ------------------------------------------------------------------------//
+
+//  Copyright 2026 Andrey Semashev
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/async.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/file_status.hpp>
+#include <boost/filesystem/executor.hpp>
+
+#include <cstddef>
+#include <new> // std::bad_alloc
+#include <memory> // std::unique_ptr
+#include <functional>
+#include <utility> // std::move
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+#include <mutex>
+#include <condition_variable>
+#endif
+
+#if defined(BOOST_FILESYSTEM_HAS_IO_URING) && !defined(BOOST_FILESYSTEM_DISABLE_IO_URING) && \
+    (defined(BOOST_FILESYSTEM_HAS_STATX) || defined(BOOST_FILESYSTEM_HAS_STATX_SYSCALL)) && !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+#include <cerrno>
+#include <thread>
+#include <system_error>
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#if !defined(BOOST_FILESYSTEM_HAS_STATX)
+#include <linux/stat.h>
+#endif
+#include "io_uring.hpp"
+#include "posix_tools.hpp"
+#define BOOST_FILESYSTEM_ASYNC_USE_IO_URING
+#endif
+
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+namespace detail {
+
+namespace {
+
+//! An operation on one or two paths that may be submitted to io_uring
+struct path_operation
+{
+    enum kind_type : unsigned char
+    {
+        status,
+        symlink_status,
+        create_directory,
+        remove,
+        //! Used when io_uring unlinkat reports that the file to remove is a directory
+        remove_directory,
+        rename
+    };
+
+    kind_type kind;
+    path p1;
+    path p2;
+#if defined(BOOST_FILESYSTEM_ASYNC_USE_IO_URING)
+    //! Next operation in the list of operations taken back from the io_uring submission queue
+    path_operation* next_withdrawn;
+#endif
+    async_context::status_handler on_status;
+    async_context::result_handler on_result;
+    async_context::completion_handler on_completion;
+#if defined(BOOST_FILESYSTEM_ASYNC_USE_IO_URING)
+    struct ::statx stx;
+#endif
+
+    explicit path_operation(kind_type k) noexcept :
+        kind(k)
+#if defined(BOOST_FILESYSTEM_ASYNC_USE_IO_URING)
+        , next_withdrawn(nullptr)
+#endif
+    {
+    }
+
+    //! Performs the operation synchronously and calls the handler
+    void run() noexcept
+    {
+        system::error_code ec;
+        switch (kind)
+        {
+        case status:
+        case symlink_status:
+            {
+                file_status st(status_error);
+                try
+                {
+                    st = kind == status ? filesystem::status(p1, ec) : filesystem::symlink_status(p1, ec);
+                }
+                catch (std::bad_alloc&)
+                {
+                    ec = make_error_code(system::errc::not_enough_memory);
+                }
+                on_status(st, ec);
+            }
+            break;
+
+        case create_directory:
+        case remove:
+        case remove_directory:
+            {
+                bool result = false;
+                try
+                {
+                    result = kind == create_directory ? filesystem::create_directory(p1, ec) : filesystem::remove(p1, ec);
+                }
+                catch (std::bad_alloc&)
+                {
+                    ec = make_error_code(system::errc::not_enough_memory);
+                }
+                on_result(result, ec);
+            }
+            break;
+
+        default: // rename
+            try
+            {
+                filesystem::rename(p1, p2, ec);
+            }
+            catch (std::bad_alloc&)
+            {
+                ec = make_error_code(system::errc::not_enough_memory);
+            }
+            on_completion(ec);
+            break;
+        }
+    }
+};
+
+#if defined(BOOST_FILESYSTEM_ASYNC_USE_IO_URING)
+
+//! Number of the io_uring opcodes that are probed for support
+BOOST_CONSTEXPR_OR_CONST unsigned int probed_opcode_count = io_uring_op_mkdirat + 1u;
+
+//! Returns the io_uring opcode of the operation
+inline unsigned int get_io_uring_opcode(path_operation::kind_type kind) noexcept
+{
+    switch (kind)
+    {
+    case path_operation::status:
+    case path_operation::symlink_status:
+        return IORING_OP_STATX;
+    case path_operation::create_directory:
+        return io_uring_op_mkdirat;
+    case path_operation::remove:
+    case path_operation::remove_directory:
+        return io_uring_op_unlinkat;
+    default: // rename
+        return io_uring_op_renameat;
+    }
+}
+
+//! Tests if the error indicates that the file does not exist
+inline bool not_found_error(int err) noexcept
+{
+    return err == ENOENT || err == ENOTDIR;
+}
+
+#endif // defined(BOOST_FILESYSTEM_ASYNC_USE_IO_URING)
+
+} // namespace
+
+//! Implementation of async_context
+struct async_context_imp
+{
+    thread_pool_executor pool;
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+    std::mutex pending_mutex;
+    std::condition_variable pending_cond;
+#endif
+    //! Number of operations that are started and whose handlers have not returned yet
+    std::size_t pending_count;
+
+#if defined(BOOST_FILESYSTEM_ASYNC_USE_IO_URING)
+    io_uring_instance ring;
+    //! Indicates that the ring is initialized and the completion thread is running
+    bool use_ring;
+    bool supported_opcodes[probed_opcode_count];
+
+    //! Protects the submission queue and the members below
+    std::mutex sq_mutex;
+    //! Notifies the completion thread that entries were submitted or the context is stopping
+    std::condition_variable completion_cond;
+    //! Number of entries that are prepared or submitted and not completed yet
+    unsigned int in_flight;
+    //! Number of entries that are prepared and not submitted yet
+    unsigned int unsubmitted;
+    //! Number of active batches
+    unsigned int batch_depth;
+    //! Operations taken back from the submission queue after io_uring failed to submit them, to be run on the thread pool
+    path_operation* withdrawn;
+    //! Indicates that io_uring failed to submit entries and must not be used for new operations
+    bool ring_failed;
+    bool stopping;
+    std::thread completion_thread;
+#endif
+
+    explicit async_context_imp(unsigned int thread_count) :
+        pool(thread_count),
+        pending_count(0u)
+#if defined(BOOST_FILESYSTEM_ASYNC_USE_IO_URING)
+        , use_ring(false),
+        in_flight(0u),
+        unsubmitted(0u),
+        batch_depth(0u),
+        withdrawn(nullptr),
+        ring_failed(false),
+        stopping(false)
+#endif
+    {
+    }
+
+    void operation_started()
+    {
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+        std::lock_guard< std::mutex > lock(pending_mutex);
+#endif
+        ++pending_count;
+    }
+
+    void operation_completed() noexcept
+    {
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+        std::lock_guard< std::mutex > lock(pending_mutex);
+        if (--pending_count == 0u)
+            pending_cond.notify_all();
+#else
+        --pending_count;
+#endif
+    }
+
+    void wait_for_operations() noexcept
+    {
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+        std::unique_lock< std::mutex > lock(pending_mutex);
+        while (pending_count > 0u)
+            pending_cond.wait(lock);
+#endif
+    }
+
+    //! Starts the operation, either by submitting it to io_uring or by posting it to the thread pool. Takes ownership of the operation on success.
+    void start(std::unique_ptr< path_operation >& op)
+    {
+        operation_started();
+        try
+        {
+#if defined(BOOST_FILESYSTEM_ASYNC_USE_IO_URING)
+            if (submit(op.get()))
+            {
+                op.release();
+                return;
+            }
+#endif
+            post(op.get());
+            op.release();
+        }
+        catch (...)
+        {
+            operation_completed();
+            throw;
+        }
+    }
+
+    //! Posts a task to the thread pool that runs the operation synchronously
+    void post(path_operation* op)
+    {
+        async_context_imp* const imp = this;
+        pool.post([imp, op]()
+        {
+            imp->finish(op);
+        });
+    }
+
+    //! Runs the operation synchronously, calls its handler and destroys the operation
+    void finish(path_operation* op) noexcept
+    {
+        op->run();
+        delete op;
+        operation_completed();
+    }
+
+#if defined(BOOST_FILESYSTEM_ASYNC_USE_IO_URING)
+
+    //! Creates the ring and starts the completion thread. If io_uring is not usable, all operations will run on the thread pool.
+    void init_ring(unsigned int queue_depth) noexcept
+    {
+        if (queue_depth == 0u || ring.init(queue_depth) != 0 || ring.probe(supported_opcodes, probed_opcode_count) != 0)
+            return;
+
+        try
+        {
+            completion_thread = std::thread(&async_context_imp::completion_loop, this);
+        }
+        catch (std::system_error&)
+        {
+            return;
+        }
+
+        use_ring = true;
+    }
+
+    //! Stops the completion thread. Must be called after all operations have completed.
+    void stop_ring() noexcept
+    {
+        {
+            std::lock_guard< std::mutex > lock(sq_mutex);
+            stopping = true;
+        }
+
+        // No entries are in flight, so the completion thread is not waiting on the ring
+        completion_cond.notify_one();
+        completion_thread.join();
+    }
+
+    //! Prepares a submission queue entry for the operation. Returns \c false if the operation cannot be submitted to io_uring.
+    bool submit(path_operation* op) noexcept
+    {
+        if (!use_ring)
+            return false;
+
+        const unsigned int opcode = get_io_uring_opcode(op->kind);
+        if (!supported_opcodes[opcode])
+            return false;
+
+        std::unique_lock< std::mutex > lock(sq_mutex);
+
+        // Limiting the number of entries in flight guarantees that the completion queue, which is twice as large, does not overflow
+        if (ring_failed || in_flight >= ring.sq_entries())
+            return false;
+
+        struct ::io_uring_sqe* sqe = ring.get_sqe();
+        if (BOOST_UNLIKELY(!sqe))
+            return false;
+
+        sqe->opcode = static_cast< boost::uint8_t >(opcode);
+        sqe->fd = AT_FDCWD;
+        sqe->addr = reinterpret_cast< boost::uint64_t >(op->p1.c_str());
+        sqe->user_data = reinterpret_cast< boost::uint64_t >(op);
+        switch (op->kind)
+        {
+        case path_operation::status:
+        case path_operation::symlink_status:
+            sqe->len = STATX_TYPE | STATX_MODE;
+            sqe->off = reinterpret_cast< boost::uint64_t >(&op->stx);
+            sqe->statx_flags = op->kind == path_operation::status ? AT_NO_AUTOMOUNT : (AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT);
+            break;
+
+        case path_operation::create_directory:
+            sqe->len = S_IRWXU | S_IRWXG | S_IRWXO;
+            break;
+
+        case path_operation::remove:
+        case path_operation::remove_directory:
+            // unlink_flags
+            sqe->rw_flags = op->kind == path_operation::remove_directory ? AT_REMOVEDIR : 0;
+            break;
+
+        default: // rename
+            // new directory descriptor and new path
+            sqe->len = static_cast< boost::uint32_t >(AT_FDCWD);
+            sqe->off = reinterpret_cast< boost::uint64_t >(op->p2.c_str());
+            break;
+        }
+
+        ++in_flight;
+        ++unsubmitted;
+        if (batch_depth == 0u && !flush())
+        {
+            lock.unlock();
+            redispatch_withdrawn();
+        }
+
+        return true;
+    }
+
+    /*!
+     * \brief Submits the prepared entries to the kernel. Must be called with \c sq_mutex locked.
+     *
+     * If submission fails permanently, takes the entries back from the submission queue and returns \c false.
+     * In this case, the caller must call \c redispatch_withdrawn after unlocking \c sq_mutex.
+     */
+    bool flush() noexcept
+    {
+        while (unsubmitted > 0u)
+        {
+            const int err = ring.submit_and_wait(0u);
+            if (BOOST_LIKELY(err == 0))
+            {
+                unsubmitted = 0u;
+                completion_cond.notify_one();
+                break;
+            }
+
+            if (err != EINTR && err != EAGAIN && err != EBUSY)
+            {
+                // The kernel will not consume the entries, run the operations on the thread pool instead
+                ring.withdraw_unsubmitted([this](struct ::io_uring_sqe const& sqe)
+                {
+                    path_operation* const op = reinterpret_cast< path_operation* >(sqe.user_data);
+                    op->next_withdrawn = withdrawn;
+                    withdrawn = op;
+                    --in_flight;
+                });
+
+                unsubmitted = 0u;
+                ring_failed = true;
+                return false;
+            }
+
+            if (err != EINTR)
+                std::this_thread::yield();
+        }
+
+        return true;
+    }
+
+    //! Runs the operations taken back from the submission queue on the thread pool. Must be called with \c sq_mutex not locked.
+    void redispatch_withdrawn() noexcept
+    {
+        path_operation* op;
+        {
+            std::lock_guard< std::mutex > lock(sq_mutex);
+            op = withdrawn;
+            withdrawn = nullptr;
+        }
+
+        while (op)
+        {
+            path_operation* const next = op->next_withdrawn;
+            redispatch(op);
+            op = next;
+        }
+    }
+
+    //! Processes completions of the submitted operations
+    void completion_loop() noexcept
+    {
+        while (true)
+        {
+            struct ::io_uring_cqe* cqe = ring.peek_cqe();
+            if (!cqe)
+            {
+                {
+                    // Only wait on the ring while there are submitted entries, since the entries that fail to be submitted are withdrawn
+                    std::unique_lock< std::mutex > lock(sq_mutex);
+                    while (in_flight == unsubmitted)
+                    {
+                        if (stopping)
+                            return;
+
+                        completion_cond.wait(lock);
+                    }
+                }
+
+                ring.wait(1u);
+                continue;
+            }
+
+            const boost::uint64_t user_data = cqe->user_data;
+            const int res = cqe->res;
+            ring.cqe_seen();
+
+            {
+                std::lock_guard< std::mutex > lock(sq_mutex);
+                --in_flight;
+            }
+
+            complete(reinterpret_cast< path_operation* >(user_data), res);
+        }
+    }
+
+    //! Calls the handler of the operation completed by io_uring
+    void complete(path_operation* op, int res) noexcept
+    {
+        system::error_code ec;
+        const int err = -res;
+        switch (op->kind)
+        {
+        case path_operation::status:
+        case path_operation::symlink_status:
+            {
+                file_status st(status_error);
+                if (res == 0)
+                {
+                    if (BOOST_LIKELY((op->stx.stx_mask & (STATX_TYPE | STATX_MODE)) == (STATX_TYPE | STATX_MODE)))
+                        st = status_from_mode(op->stx.stx_mode);
+                    else
+                        ec.assign(BOOST_ERROR_NOT_SUPPORTED, system::system_category());
+                }
+                else
+                {
+                    // Same as status(p, ec), which always reports errno, even though some errno values are not status errors
+                    ec.assign(err, system::system_category());
+                    if (not_found_error(err))
+                        st = file_status(file_not_found, no_perms);
+                }
+
+                op->on_status(st, ec);
+            }
+            break;
+
+        case path_operation::create_directory:
+            if (err == EEXIST)
+            {
+                // The operation succeeds without creating a directory if the existing file is a directory
+                redispatch(op);
+                return;
+            }
+
+            if (res != 0)
+                ec.assign(err, system::system_category());
+            op->on_result(res == 0, ec);
+            break;
+
+        case path_operation::remove:
+        case path_operation::remove_directory:
+            if (err == EISDIR && op->kind == path_operation::remove)
+            {
+                op->kind = path_operation::remove_directory;
+                if (!submit(op))
+                    redispatch(op);
+                return;
+            }
+
+            if (res != 0 && !not_found_error(err))
+                ec.assign(err, system::system_category());
+            op->on_result(res == 0, ec);
+            break;
+
+        default: // rename
+            if (res != 0)
+                ec.assign(err, system::system_category());
+            op->on_completion(ec);
+            break;
+        }
+
+        delete op;
+        operation_completed();
+    }
+
+    //! Completes the operation on the thread pool, or on the calling thread if posting fails
+    void redispatch(path_operation* op) noexcept
+    {
+        try
+        {
+            post(op);
+        }
+        catch (...)
+        {
+            finish(op);
+        }
+    }
+
+#endif // defined(BOOST_FILESYSTEM_ASYNC_USE_IO_URING)
+};
+
+namespace {
+
+//! Base class for the operations that always run on the thread pool
+struct pooled_operation_base
+{
+    async_context_imp* imp;
+
+    explicit pooled_operation_base(async_context_imp* p) noexcept :
+        imp(p)
+    {
+    }
+};
+
+struct create_directories_operation :
+    public pooled_operation_base
+{
+    path p;
+    async_context::result_handler handler;
+
+    create_directories_operation(async_context_imp* imp, path&& pth, async_context::result_handler&& h) :
+        pooled_operation_base(imp),
+        p(std::move(pth)),
+        handler(std::move(h))
+    {
+    }
+
+    void operator()()
+    {
+        system::error_code ec;
+        bool result = false;
+        try
+        {
+            result = filesystem::create_directories(p, ec);
+        }
+        catch (std::bad_alloc&)
+        {
+            ec = make_error_code(system::errc::not_enough_memory);
+        }
+        handler(result, ec);
+        imp->operation_completed();
+    }
+};
+
+struct remove_all_operation :
+    public pooled_operation_base
+{
+    path p;
+    async_context::count_handler handler;
+
+    remove_all_operation(async_context_imp* imp, path&& pth, async_context::count_handler&& h) :
+        pooled_operation_base(imp),
+        p(std::move(pth)),
+        handler(std::move(h))
+    {
+    }
+
+    void operator()()
+    {
+        system::error_code ec;
+        boost::uintmax_t count = 0u;
+        try
+        {
+            count = filesystem::remove_all(p, ec);
+        }
+        catch (std::bad_alloc&)
+        {
+            ec = make_error_code(system::errc::not_enough_memory);
+        }
+        handler(count, ec);
+        imp->operation_completed();
+    }
+};
+
+struct copy_file_operation :
+    public pooled_operation_base
+{
+    path from;
+    path to;
+    copy_options options;
+    async_context::result_handler handler;
+
+    copy_file_operation(async_context_imp* imp, path&& f, path&& t, copy_options opts, async_context::result_handler&& h) :
+        pooled_operation_base(imp),
+        from(std::move(f)),
+        to(std::move(t)),
+        options(opts),
+        handler(std::move(h))
+    {
+    }
+
+    void operator()()
+    {
+        system::error_code ec;
+        bool result = false;
+        try
+        {
+            result = filesystem::copy_file(from, to, options, ec);
+        }
+        catch (std::bad_alloc&)
+        {
+            ec = make_error_code(system::errc::not_enough_memory);
+        }
+        handler(result, ec);
+        imp->operation_completed();
+    }
+};
+
+//! Posts an operation that always runs on the thread pool
+template< typename Operation >
+void post_pooled(async_context_imp* imp, Operation&& op)
+{
+    imp->operation_started();
+    try
+    {
+        imp->pool.post(std::function< void() >(static_cast< Operation&& >(op)));
+    }
+    catch (...)
+    {
+        imp->operation_completed();
+        throw;
+    }
+}
+
+} // namespace
+
+} // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                   async_context                                      //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+BOOST_FILESYSTEM_DECL
+thread_pool_executor& async_context::get_executor() noexcept
+{
+    return m_imp->pool;
+}
+
+BOOST_FILESYSTEM_DECL
+bool async_context::uses_io_uring() const noexcept
+{
+#if defined(BOOST_FILESYSTEM_ASYNC_USE_IO_URING)
+    return m_imp->use_ring;
+#else
+    return false;
+#endif
+}
+
+BOOST_FILESYSTEM_DECL
+void async_context::async_status(path p, status_handler handler)
+{
+    std::unique_ptr< detail::path_operation > op(new detail::path_operation(detail::path_operation::status));
+    op->p1 = std::move(p);
+    op->on_status = std::move(handler);
+    m_imp->start(op);
+}
+
+BOOST_FILESYSTEM_DECL
+void async_context::async_symlink_status(path p, status_handler handler)
+{
+    std::unique_ptr< detail::path_operation > op(new detail::path_operation(detail::path_operation::symlink_status));
+    op->p1 = std::move(p);
+    op->on_status = std::move(handler);
+    m_imp->start(op);
+}
+
+BOOST_FILESYSTEM_DECL
+void async_context::async_create_directory(path p, result_handler handler)
+{
+    std::unique_ptr< detail::path_operation > op(new detail::path_operation(detail::path_operation::create_directory));
+    op->p1 = std::move(p);
+    op->on_result = std::move(handler);
+    m_imp->start(op);
+}
+
+BOOST_FILESYSTEM_DECL
+void async_context::async_create_directories(path p, result_handler handler)
+{
+    detail::post_pooled(m_imp, detail::create_directories_operation(m_imp, std::move(p), std::move(handler)));
+}
+
+BOOST_FILESYSTEM_DECL
+void async_context::async_remove(path p, result_handler handler)
+{
+    std::unique_ptr< detail::path_operation > op(new detail::path_operation(detail::path_operation::remove));
+    op->p1 = std::move(p);
+    op->on_result = std::move(handler);
+    m_imp->start(op);
+}
+
+BOOST_FILESYSTEM_DECL
+void async_context::async_remove_all(path p, count_handler handler)
+{
+    detail::post_pooled(m_imp, detail::remove_all_operation(m_imp, std::move(p), std::move(handler)));
+}
+
+BOOST_FILESYSTEM_DECL
+void async_context::async_rename(path from, path to, completion_handler handler)
+{
+    std::unique_ptr< detail::path_operation > op(new detail::path_operation(detail::path_operation::rename));
+    op->p1 = std::move(from);
+    op->p2 = std::move(to);
+    op->on_completion = std::move(handler);
+    m_imp->start(op);
+}
+
+BOOST_FILESYSTEM_DECL
+void async_context::async_copy_file(path from, path to, copy_options opts, result_handler handler)
+{
+    detail::post_pooled(m_imp, detail::copy_file_operation(m_imp, std::move(from), std::move(to), opts, std::move(handler)));
+}
+
+BOOST_FILESYSTEM_DECL
+void async_context::init(unsigned int thread_count, unsigned int queue_depth)
+{
+    m_imp = new detail::async_context_imp(thread_count);
+#if defined(BOOST_FILESYSTEM_ASYNC_USE_IO_URING)
+    m_imp->init_ring(queue_depth);
+#else
+    (void)queue_depth;
+#endif
+}
+
+BOOST_FILESYSTEM_DECL
+void async_context::destroy() noexcept
+{
+    if (!m_imp)
+        return;
+
+    m_imp->wait_for_operations();
+#if defined(BOOST_FILESYSTEM_ASYNC_USE_IO_URING)
+    if (m_imp->use_ring)
+        m_imp->stop_ring();
+#endif
+
+    delete m_imp;
+    m_imp = nullptr;
+}
+
+BOOST_FILESYSTEM_DECL
+void async_context::begin_batch() noexcept
+{
+#if defined(BOOST_FILESYSTEM_ASYNC_USE_IO_URING)
+    std::lock_guard< std::mutex > lock(m_imp->sq_mutex);
+    ++m_imp->batch_depth;
+#endif
+}
+
+BOOST_FILESYSTEM_DECL
+void async_context::end_batch() noexcept
+{
+#if defined(BOOST_FILESYSTEM_ASYNC_USE_IO_URING)
+    bool flushed = true;
+    {
+        std::lock_guard< std::mutex > lock(m_imp->sq_mutex);
+        if (--m_imp->batch_depth == 0u)
+            flushed = m_imp->flush();
+    }
+
+    if (!flushed)
+        m_imp->redispatch_withdrawn();
+#endif
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
@@ -15,6 +15,8 @@
 
 #include <boost/filesystem/config.hpp>
 #include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/directory_tree.hpp>
+#include <boost/filesystem/glob.hpp>
 #include <boost/filesystem/exception.hpp>
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/file_status.hpp>
@@ -22,15 +24,24 @@
 #include <cstddef>
 #include <cerrno>
 #include <cstring>
-#include <cstdlib> // std::malloc, std::free
 #include <new>     // std::nothrow, std::bad_alloc
 #include <limits>
+#include <memory>    // std::unique_ptr
 #include <string>
-#include <utility> // std::move
+#include <vector>
+#include <deque>
+#include <utility>   // std::move
+#include <algorithm> // std::sort
+#include <exception> // std::exception_ptr
+#include <unordered_set>
 #include <boost/assert.hpp>
 #include <boost/system/error_code.hpp>
 #include <boost/smart_ptr/intrusive_ptr.hpp>
 
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+#include <mutex>
+#endif
+
 #ifdef BOOST_FILESYSTEM_POSIX_API
 
 #include <sys/types.h>
@@ -67,6 +78,15 @@ BOOST_PRAGMA_MESSAGE("Boost.Filesystem: readdir_r is used instead of readdir bec
     "Otherwise, support for this platform is deprecated and will be removed in a future release.")
 #endif // defined(BOOST_FILESYSTEM_USE_READDIR_R)
 
+#if (defined(linux) || defined(__linux) || defined(__linux__)) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && \
+    !defined(BOOST_FILESYSTEM_DISABLE_GETDENTS64)
+#include <sys/syscall.h>
+#if defined(__NR_getdents64)
+#include <boost/cstdint.hpp>
+#define BOOST_FILESYSTEM_USE_GETDENTS64
+#endif
+#endif
+
 // At least Mac OS X 10.6 and older doesn't support O_CLOEXEC
 #ifndef O_CLOEXEC
 #define O_CLOEXEC 0
@@ -88,6 +108,8 @@ BOOST_PRAGMA_MESSAGE("Boost.Filesystem: readdir_r is used instead of readdir bec
 #include "atomic_tools.hpp"
 #include "error_handling.hpp"
 #include "private_config.hpp"
+#include "thread_pool.hpp"
+#include "glob_tools.hpp"
 
 #include <boost/filesystem/detail/header.hpp> // must be the last #include
 
@@ -104,10 +126,38 @@ namespace filesystem {
 //                                                                                      //
 //--------------------------------------------------------------------------------------//
 
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+
+namespace {
+
+//! Stores the obtained attributes in the attribute cache of a directory entry
+void store_entry_attributes(detail::entry_attributes_cache& cache, detail::entry_attributes_cache const& attrs, entry_attributes obtained) noexcept
+{
+    if ((obtained & entry_attributes::file_size) != entry_attributes::none)
+        cache.file_size = attrs.file_size;
+    if ((obtained & entry_attributes::last_write_time) != entry_attributes::none)
+    {
+        cache.last_write_time = attrs.last_write_time;
+        cache.last_write_time_nsec = attrs.last_write_time_nsec;
+    }
+    if ((obtained & entry_attributes::hard_link_count) != entry_attributes::none)
+        cache.hard_link_count = attrs.hard_link_count;
+    if ((obtained & entry_attributes::inode) != entry_attributes::none)
+        cache.inode = attrs.inode;
+    if ((obtained & entry_attributes::allocated_size) != entry_attributes::none)
+        cache.allocated_size = attrs.allocated_size;
+    cache.mask |= obtained;
+}
+
+} // namespace
+
+#endif // defined(BOOST_FILESYSTEM_POSIX_API)
+
 BOOST_FILESYSTEM_DECL void directory_entry::refresh_impl(system::error_code* ec) const
 {
     m_status = filesystem::file_status();
     m_symlink_status = filesystem::file_status();
+    m_attributes.mask = entry_attributes::none;
 
     m_symlink_status = detail::symlink_status(m_path, ec);
 
@@ -122,6 +172,81 @@ BOOST_FILESYSTEM_DECL void directory_entry::refresh_impl(system::error_code* ec)
     }
 }
 
+BOOST_FILESYSTEM_DECL void directory_entry::refresh_attributes_impl(entry_attributes mask, system::error_code* ec) const
+{
+    if (ec)
+        ec->clear();
+
+    // Invalidate the requested attributes and set them to the values returned by the corresponding operations on errors
+    m_attributes.mask &= ~mask;
+    if ((mask & entry_attributes::file_size) != entry_attributes::none)
+        m_attributes.file_size = static_cast< boost::uintmax_t >(-1);
+    if ((mask & entry_attributes::last_write_time) != entry_attributes::none)
+    {
+        m_attributes.last_write_time = (std::numeric_limits< std::time_t >::min)();
+        m_attributes.last_write_time_nsec = 0u;
+    }
+    if ((mask & entry_attributes::hard_link_count) != entry_attributes::none)
+        m_attributes.hard_link_count = static_cast< boost::uintmax_t >(-1);
+    if ((mask & entry_attributes::inode) != entry_attributes::none)
+        m_attributes.inode = static_cast< boost::uintmax_t >(-1);
+    if ((mask & entry_attributes::allocated_size) != entry_attributes::none)
+        m_attributes.allocated_size = static_cast< boost::uintmax_t >(-1);
+
+    if (mask == entry_attributes::none)
+        return;
+
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+
+    detail::entry_attributes_cache attrs;
+    file_status st;
+    const entry_attributes obtained = detail::entry_attributes_impl(m_path, mask, attrs, st, ec);
+    if (ec && *ec)
+        return;
+
+    m_status = st;
+    store_entry_attributes(m_attributes, attrs, obtained);
+
+    // The file size is only defined for regular files
+    if (BOOST_UNLIKELY(obtained != mask))
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, m_path, ec, "boost::filesystem::directory_entry::refresh");
+
+#else // defined(BOOST_FILESYSTEM_POSIX_API)
+
+    // There is no single call that would obtain all attributes on Windows, so use the standalone operations
+    if ((mask & entry_attributes::file_size) != entry_attributes::none)
+    {
+        const boost::uintmax_t size = detail::file_size(m_path, ec);
+        if (ec && *ec)
+            return;
+        m_attributes.file_size = size;
+        m_attributes.mask |= entry_attributes::file_size;
+    }
+
+    if ((mask & entry_attributes::last_write_time) != entry_attributes::none)
+    {
+        const std::time_t t = detail::last_write_time(m_path, ec);
+        if (ec && *ec)
+            return;
+        m_attributes.last_write_time = t;
+        m_attributes.mask |= entry_attributes::last_write_time;
+    }
+
+    if ((mask & entry_attributes::hard_link_count) != entry_attributes::none)
+    {
+        const boost::uintmax_t count = detail::hard_link_count(m_path, ec);
+        if (ec && *ec)
+            return;
+        m_attributes.hard_link_count = count;
+        m_attributes.mask |= entry_attributes::hard_link_count;
+    }
+
+    if ((mask & (entry_attributes::inode | entry_attributes::allocated_size)) != entry_attributes::none)
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, m_path, ec, "boost::filesystem::directory_entry::refresh");
+
+#endif // defined(BOOST_FILESYSTEM_POSIX_API)
+}
+
 //--------------------------------------------------------------------------------------//
 //                                                                                      //
 //                               directory_iterator                                     //
@@ -230,27 +355,129 @@ boost::scope::unique_fd openat_directory(int basedir_fd, path const& p, director
 
 BOOST_CONSTEXPR_OR_CONST std::size_t dir_itr_imp_extra_data_alignment = 16u;
 
+//! Size of the header preceding every directory iterator in its memory block. The header stores the size of the block.
+BOOST_CONSTEXPR_OR_CONST std::size_t dir_itr_imp_block_header_size = dir_itr_imp_extra_data_alignment;
+
+namespace {
+
+#if !defined(BOOST_NO_CXX11_THREAD_LOCAL)
+
+#define BOOST_FILESYSTEM_USE_DIR_ITR_IMP_CACHE
+
+/*!
+ * \brief Per-thread cache of memory blocks of destroyed directory iterators
+ *
+ * A directory iterator is allocated in a single block along with its entries buffer. A recursive walk keeps
+ * only a few directories open at a time, so the blocks of the closed directories are reused for the directories
+ * opened next, instead of being returned to the heap. The cache is trivially destructible, so that it can still
+ * be used when iterators are destroyed during thread termination.
+ */
+struct dir_itr_imp_block_cache
+{
+    static BOOST_CONSTEXPR_OR_CONST unsigned int capacity = 4u;
+
+    void* blocks[capacity];
+    unsigned int count;
+    //! Indicates that dir_itr_imp_block_cache_cleanup was registered to release the blocks on thread termination
+    bool cleanup_registered;
+    //! Indicates that the thread is terminating and no blocks can be cached
+    bool disabled;
+};
+
+thread_local dir_itr_imp_block_cache g_dir_itr_imp_block_cache;
+
+//! Releases the blocks cached by the current thread on thread termination
+struct dir_itr_imp_block_cache_cleanup
+{
+    ~dir_itr_imp_block_cache_cleanup()
+    {
+        dir_itr_imp_block_cache& cache = g_dir_itr_imp_block_cache;
+        cache.disabled = true;
+        while (cache.count > 0u)
+            ::operator delete(cache.blocks[--cache.count]);
+    }
+};
+
+//! Adds the block to the cache of the current thread. Returns \c false if the cache is full.
+inline bool cache_dir_itr_imp_block(void* block) noexcept
+{
+    dir_itr_imp_block_cache& cache = g_dir_itr_imp_block_cache;
+    if (cache.disabled || cache.count >= dir_itr_imp_block_cache::capacity)
+        return false;
+
+    if (BOOST_UNLIKELY(!cache.cleanup_registered))
+    {
+        static thread_local dir_itr_imp_block_cache_cleanup cleanup;
+        (void)cleanup;
+        cache.cleanup_registered = true;
+    }
+
+    cache.blocks[cache.count++] = block;
+    return true;
+}
+
+//! Takes a block of the specified size from the cache of the current thread. Returns \c nullptr if there is no such block.
+inline void* get_cached_dir_itr_imp_block(std::size_t total_size) noexcept
+{
+    dir_itr_imp_block_cache& cache = g_dir_itr_imp_block_cache;
+    for (unsigned int i = cache.count; i > 0u;)
+    {
+        --i;
+        void* block = cache.blocks[i];
+        if (*static_cast< std::size_t* >(block) == total_size)
+        {
+            cache.blocks[i] = cache.blocks[--cache.count];
+            return block;
+        }
+    }
+
+    return nullptr;
+}
+
+#endif // !defined(BOOST_NO_CXX11_THREAD_LOCAL)
+
+} // namespace
+
 BOOST_FILESYSTEM_DECL void* dir_itr_imp::operator new(std::size_t class_size, std::size_t extra_size) noexcept
 {
     if (extra_size > 0)
         class_size = (class_size + dir_itr_imp_extra_data_alignment - 1u) & ~(dir_itr_imp_extra_data_alignment - 1u);
-    std::size_t total_size = class_size + extra_size;
+    const std::size_t total_size = dir_itr_imp_block_header_size + class_size + extra_size;
+
+    void* block = nullptr;
+#if defined(BOOST_FILESYSTEM_USE_DIR_ITR_IMP_CACHE)
+    block = get_cached_dir_itr_imp_block(total_size);
+    if (!block)
+#endif
+    {
+        // Return nullptr on OOM
+        block = ::operator new(total_size, std::nothrow);
+        if (BOOST_UNLIKELY(!block))
+            return nullptr;
 
-    // Return nullptr on OOM
-    void* p = std::malloc(total_size);
-    if (BOOST_LIKELY(p != nullptr))
-        std::memset(p, 0, total_size);
+        *static_cast< std::size_t* >(block) = total_size;
+    }
+
+    // Only the iterator structure is zero-initialized, the extra data is initialized by its users as needed
+    void* p = static_cast< unsigned char* >(block) + dir_itr_imp_block_header_size;
+    std::memset(p, 0, class_size);
     return p;
 }
 
-BOOST_FILESYSTEM_DECL void dir_itr_imp::operator delete(void* p, std::size_t extra_size) noexcept
+BOOST_FILESYSTEM_DECL void dir_itr_imp::operator delete(void* p, std::size_t) noexcept
 {
-    std::free(p);
+    dir_itr_imp::operator delete(p);
 }
 
 BOOST_FILESYSTEM_DECL void dir_itr_imp::operator delete(void* p) noexcept
 {
-    std::free(p);
+    void* block = static_cast< unsigned char* >(p) - dir_itr_imp_block_header_size;
+#if defined(BOOST_FILESYSTEM_USE_DIR_ITR_IMP_CACHE)
+    if (cache_dir_itr_imp_block(block))
+        return;
+#endif
+
+    ::operator delete(block);
 }
 
 namespace {
@@ -261,12 +488,94 @@ inline void* get_dir_itr_imp_extra_data(dir_itr_imp* imp) noexcept
     return reinterpret_cast< unsigned char* >(imp) + extra_data_offset;
 }
 
+//! Tests if the file name is dot or dot-dot
+inline bool is_dot_or_dot_dot(const path::value_type* filename_str) noexcept
+{
+    return filename_str[0] == path::dot &&
+        (filename_str[1] == static_cast< path::value_type >('\0') ||
+            (filename_str[1] == path::dot && filename_str[2] == static_cast< path::value_type >('\0')));
+}
+
+inline bool is_dot_or_dot_dot(path const& filename) noexcept
+{
+    return is_dot_or_dot_dot(filename.c_str());
+}
+
 #ifdef BOOST_FILESYSTEM_POSIX_API
 
+//! Indicates format of the handle and extra data in the directory iterator
+enum extra_data_format
+{
+    //! The handle is a DIR* stream, extra data, if present, is used by readdir_r
+    readdir_format,
+    //! The handle points to getdents64_state, which is placed in the extra data and is followed by the entries buffer
+    getdents64_format
+};
+
+#if defined(BOOST_FILESYSTEM_USE_GETDENTS64)
+
+//! Directory entry structure filled by getdents64. There is no definition of this structure in libc headers.
+struct linux_dirent64
+{
+    boost::uint64_t d_ino;
+    boost::int64_t d_off;
+    unsigned short d_reclen;
+    unsigned char d_type;
+    char d_name[1];
+};
+
+//! State of the getdents64-based directory iterator
+struct getdents64_state
+{
+    //! Directory file descriptor
+    int fd;
+    //! Offset of the next entry in the buffer
+    unsigned int current_offset;
+    //! Size of the data in the buffer
+    unsigned int end_offset;
+    //! Position in the directory of the entry following the last returned entry
+    boost::int64_t next_entry_cookie;
+};
+
+//! Offset of the entries buffer from the start of the extra data
+BOOST_CONSTEXPR_OR_CONST std::size_t getdents64_buffer_offset = (sizeof(getdents64_state) + dir_itr_imp_extra_data_alignment - 1u) & ~(dir_itr_imp_extra_data_alignment - 1u);
+
+/*!
+ * \brief Size of the entries buffer for getdents64.
+ *
+ * This is the same size as glibc allocates for a DIR stream, but the buffer is allocated along with the iterator,
+ * so opening a directory involves only one memory allocation. A single getdents64 call typically fills
+ * hundreds of entries.
+ */
+BOOST_CONSTEXPR_OR_CONST std::size_t getdents64_buffer_size = 32768u;
+
+//! Indicates whether getdents64 should be used for directory iteration. Set to \c false if the syscall is not supported.
+bool g_use_getdents64 = true;
+
+#endif // defined(BOOST_FILESYSTEM_USE_GETDENTS64)
+
 inline system::error_code dir_itr_close(dir_itr_imp& imp) noexcept
 {
     if (imp.handle != nullptr)
     {
+#if defined(BOOST_FILESYSTEM_USE_GETDENTS64)
+        if (imp.extra_data_format == getdents64_format)
+        {
+            const int fd = static_cast< getdents64_state* >(imp.handle)->fd;
+            imp.handle = nullptr;
+            imp.extra_data_format = readdir_format;
+            // Note: Linux always closes the file descriptor, even if close fails with EINTR
+            if (BOOST_UNLIKELY(::close(fd) != 0))
+            {
+                const int err = errno;
+                if (err != EINTR)
+                    return system::error_code(err, system::system_category());
+            }
+
+            return error_code();
+        }
+#endif // defined(BOOST_FILESYSTEM_USE_GETDENTS64)
+
         DIR* h = static_cast< DIR* >(imp.handle);
         imp.handle = nullptr;
         int err = 0;
@@ -285,6 +594,11 @@ inline system::error_code dir_itr_close(dir_itr_imp& imp) noexcept
 // Obtains a file descriptor from the directory iterator
 inline int dir_itr_fd(dir_itr_imp const& imp, system::error_code& ec)
 {
+#if defined(BOOST_FILESYSTEM_USE_GETDENTS64)
+    if (imp.extra_data_format == getdents64_format)
+        return static_cast< const getdents64_state* >(imp.handle)->fd;
+#endif
+
     // Note: dirfd is a macro on FreeBSD 9 and older
     const int fd = dirfd(static_cast< DIR* >(imp.handle));
     if (BOOST_UNLIKELY(fd < 0))
@@ -414,46 +728,29 @@ inline int invoke_readdir(dir_itr_imp& imp, struct dirent** result)
 
 #endif // !defined(BOOST_FILESYSTEM_USE_READDIR_R)
 
-system::error_code dir_itr_increment(dir_itr_imp& imp, fs::path& filename, fs::file_status& sf, fs::file_status& symlink_sf)
-{
-    dirent* result = nullptr;
-    while (true)
-    {
-        int err = invoke_readdir(imp, &result);
-        if (BOOST_UNLIKELY(err != 0))
-        {
-            if (err == EINTR)
-                continue;
-            return system::error_code(err, system::system_category());
-        }
-
-        if (result == nullptr)
-            return dir_itr_close(imp);
-
-        break;
-    }
-
-    filename = result->d_name;
+#if defined(BOOST_FILESYSTEM_HAS_DIRENT_D_TYPE) || defined(BOOST_FILESYSTEM_USE_GETDENTS64)
 
-#if defined(BOOST_FILESYSTEM_HAS_DIRENT_D_TYPE)
-    if (result->d_type == DT_UNKNOWN) // filesystem does not supply d_type value
+//! Sets file statuses from the file type reported in the directory entry
+inline void set_file_statuses(unsigned char d_type, fs::file_status& sf, fs::file_status& symlink_sf)
+{
+    if (d_type == DT_UNKNOWN) // filesystem does not supply d_type value
     {
         sf = symlink_sf = fs::file_status(fs::status_error);
     }
     else // filesystem supplies d_type value
     {
-        if (result->d_type == DT_REG)
+        if (d_type == DT_REG)
             sf = symlink_sf = fs::file_status(fs::regular_file);
-        else if (result->d_type == DT_DIR)
+        else if (d_type == DT_DIR)
             sf = symlink_sf = fs::file_status(fs::directory_file);
-        else if (result->d_type == DT_LNK)
+        else if (d_type == DT_LNK)
         {
             sf = fs::file_status(fs::status_error);
             symlink_sf = fs::file_status(fs::symlink_file);
         }
         else
         {
-            switch (result->d_type)
+            switch (d_type)
             {
             case DT_SOCK:
                 sf = symlink_sf = fs::file_status(fs::socket_file);
@@ -473,12 +770,141 @@ system::error_code dir_itr_increment(dir_itr_imp& imp, fs::path& filename, fs::f
             }
         }
     }
+}
+
+#endif // defined(BOOST_FILESYSTEM_HAS_DIRENT_D_TYPE) || defined(BOOST_FILESYSTEM_USE_GETDENTS64)
+
+#if defined(BOOST_FILESYSTEM_USE_GETDENTS64)
+
+//! Switches the directory iterator from getdents64 to readdir, if getdents64 is not supported
+system::error_code dir_itr_fallback_to_readdir(dir_itr_imp& imp)
+{
+    filesystem::detail::atomic_store_relaxed(g_use_getdents64, false);
+
+    getdents64_state* state = static_cast< getdents64_state* >(imp.handle);
+    while (true)
+    {
+        DIR* h = ::fdopendir(state->fd);
+        if (BOOST_UNLIKELY(!h))
+        {
+            const int err = errno;
+            if (err == EINTR)
+                continue;
+            return system::error_code(err, system::system_category());
+        }
+
+        // The file descriptor is now owned by the DIR stream
+        imp.handle = h;
+        imp.extra_data_format = readdir_format;
+        break;
+    }
+
+    return system::error_code();
+}
+
+//! Produces the next directory entry from the getdents64 buffer, refilling it when exhausted
+system::error_code dir_itr_read_getdents64(dir_itr_imp& imp, const char*& filename, fs::file_status& sf, fs::file_status& symlink_sf, boost::uintmax_t* ino, bool& fallback)
+{
+    getdents64_state* state = static_cast< getdents64_state* >(imp.handle);
+    unsigned char* const buffer = static_cast< unsigned char* >(get_dir_itr_imp_extra_data(&imp)) + getdents64_buffer_offset;
+    if (state->current_offset >= state->end_offset)
+    {
+        while (true)
+        {
+            const long res = ::syscall(__NR_getdents64, state->fd, buffer, getdents64_buffer_size);
+            if (BOOST_UNLIKELY(res < 0))
+            {
+                const int err = errno;
+                if (err == EINTR)
+                    continue;
+                if (err == ENOSYS)
+                {
+                    fallback = true;
+                    return dir_itr_fallback_to_readdir(imp);
+                }
+                return system::error_code(err, system::system_category());
+            }
+
+            if (res == 0)
+                return dir_itr_close(imp);
+
+            state->current_offset = 0u;
+            state->end_offset = static_cast< unsigned int >(res);
+            break;
+        }
+    }
+
+    const linux_dirent64* entry = reinterpret_cast< const linux_dirent64* >(buffer + state->current_offset);
+    state->current_offset += entry->d_reclen;
+    state->next_entry_cookie = entry->d_off;
+
+    filename = entry->d_name;
+    set_file_statuses(entry->d_type, sf, symlink_sf);
+    if (ino)
+        *ino = entry->d_ino;
+
+    return system::error_code();
+}
+
+#endif // defined(BOOST_FILESYSTEM_USE_GETDENTS64)
+
+/*!
+ * \brief Produces the next directory entry without copying its name
+ *
+ * The name points to the buffer of directory entries and remains valid until the next call or until the iterator is closed.
+ * If \a ino is not \c nullptr, it receives the inode number of the entry.
+ */
+system::error_code dir_itr_read(dir_itr_imp& imp, const char*& filename, fs::file_status& sf, fs::file_status& symlink_sf, boost::uintmax_t* ino = nullptr)
+{
+#if defined(BOOST_FILESYSTEM_USE_GETDENTS64)
+    if (BOOST_LIKELY(imp.extra_data_format == getdents64_format))
+    {
+        bool fallback = false;
+        system::error_code ec = dir_itr_read_getdents64(imp, filename, sf, symlink_sf, ino, fallback);
+        if (BOOST_LIKELY(!fallback) || !!ec)
+            return ec;
+    }
+#endif // defined(BOOST_FILESYSTEM_USE_GETDENTS64)
+
+    dirent* result = nullptr;
+    while (true)
+    {
+        int err = invoke_readdir(imp, &result);
+        if (BOOST_UNLIKELY(err != 0))
+        {
+            if (err == EINTR)
+                continue;
+            return system::error_code(err, system::system_category());
+        }
+
+        if (result == nullptr)
+            return dir_itr_close(imp);
+
+        break;
+    }
+
+    filename = result->d_name;
+    if (ino)
+        *ino = result->d_ino;
+
+#if defined(BOOST_FILESYSTEM_HAS_DIRENT_D_TYPE)
+    set_file_statuses(result->d_type, sf, symlink_sf);
 #else
     sf = symlink_sf = fs::file_status(fs::status_error);
 #endif
     return system::error_code();
 }
 
+//! Produces the next directory entry. If \a ino is not \c nullptr, it receives the inode number of the entry.
+inline system::error_code dir_itr_increment(dir_itr_imp& imp, fs::path& filename, fs::file_status& sf, fs::file_status& symlink_sf, boost::uintmax_t* ino = nullptr)
+{
+    const char* name = nullptr;
+    system::error_code ec = dir_itr_read(imp, name, sf, symlink_sf, ino);
+    if (BOOST_LIKELY(!ec && imp.handle != nullptr))
+        filename = name;
+    return ec;
+}
+
 system::error_code dir_itr_create(boost::intrusive_ptr< detail::dir_itr_imp >& imp, fs::path const& dir, directory_options opts, directory_iterator_params* params, fs::path& first_filename, fs::file_status&, fs::file_status&)
 {
     std::size_t extra_size = 0u;
@@ -503,6 +929,12 @@ system::error_code dir_itr_create(boost::intrusive_ptr< detail::dir_itr_imp >& i
     }
 #endif // defined(BOOST_FILESYSTEM_USE_READDIR_R)
 
+#if defined(BOOST_FILESYSTEM_USE_GETDENTS64)
+    const bool use_getdents64 = filesystem::detail::atomic_load_relaxed(g_use_getdents64);
+    if (use_getdents64)
+        extra_size = getdents64_buffer_offset + getdents64_buffer_size;
+#endif // defined(BOOST_FILESYSTEM_USE_GETDENTS64)
+
     boost::intrusive_ptr< detail::dir_itr_imp > pimpl(new (extra_size) detail::dir_itr_imp());
     if (BOOST_UNLIKELY(!pimpl))
         return make_error_code(system::errc::not_enough_memory);
@@ -521,22 +953,39 @@ system::error_code dir_itr_create(boost::intrusive_ptr< detail::dir_itr_imp >& i
             return ec;
     }
 
-    while (true)
+#if defined(BOOST_FILESYSTEM_USE_GETDENTS64)
+    if (use_getdents64)
     {
-        pimpl->handle = ::fdopendir(fd.get());
-        if (BOOST_UNLIKELY(!pimpl->handle))
+        // The entries buffer will be filled on the first increment. If getdents64 turns out to be unsupported,
+        // the iterator will switch to readdir at that point.
+        getdents64_state* state = static_cast< getdents64_state* >(get_dir_itr_imp_extra_data(pimpl.get()));
+        state->fd = fd.release();
+        state->current_offset = 0u;
+        state->end_offset = 0u;
+        state->next_entry_cookie = 0;
+        pimpl->handle = state;
+        pimpl->extra_data_format = getdents64_format;
+    }
+    else
+#endif // defined(BOOST_FILESYSTEM_USE_GETDENTS64)
+    {
+        while (true)
         {
-            const int err = errno;
-            if (err == EINTR)
-                continue;
-            return system::error_code(err, system::system_category());
+            pimpl->handle = ::fdopendir(fd.get());
+            if (BOOST_UNLIKELY(!pimpl->handle))
+            {
+                const int err = errno;
+                if (err == EINTR)
+                    continue;
+                return system::error_code(err, system::system_category());
+            }
+
+            break;
         }
 
-        break;
+        // At this point fd will be closed by closedir
+        fd.release();
     }
-
-    // At this point fd will be closed by closedir
-    fd.release();
 #else // defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW)
     while (true)
     {
@@ -560,6 +1009,27 @@ system::error_code dir_itr_create(boost::intrusive_ptr< detail::dir_itr_imp >& i
     return system::error_code();
 }
 
+//! Obtains and caches attributes of the directory entry the iterator currently points to
+void dir_itr_cache_attributes(dir_itr_imp& imp, fs::path const& filename, fs::file_status& sf, fs::file_status& symlink_sf, detail::entry_attributes_cache& attrs)
+{
+    // Errors are not reported here, the attributes will be obtained when requested by the user
+    system::error_code ec;
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    const int dir_fd = dir_itr_fd(imp, ec);
+    if (BOOST_UNLIKELY(!!ec))
+        return;
+
+    attrs.mask = detail::entry_attributes_impl(filename, entry_attributes::all, attrs, sf, &ec, dir_fd);
+#else
+    attrs.mask = detail::entry_attributes_impl(imp.dir_entry.path(), entry_attributes::all, attrs, sf, &ec);
+#endif
+
+    // If the entry is known not to be a symlink, its full symlink status is the same as the status obtained along with
+    // the attributes. This avoids querying the file again when the symlink status is requested.
+    if (!ec && fs::type_present(symlink_sf) && symlink_sf.type() != fs::symlink_file)
+        symlink_sf = sf;
+}
+
 BOOST_CONSTEXPR_OR_CONST err_t not_found_error_code = ENOENT;
 
 #else // BOOST_FILESYSTEM_WINDOWS_API
@@ -1120,6 +1590,12 @@ done:
     return system::error_code();
 }
 
+//! Obtains and caches attributes of the directory entry the iterator currently points to. Not implemented on Windows,
+//! the attributes are obtained when requested by the user.
+inline void dir_itr_cache_attributes(dir_itr_imp&, fs::path const&, fs::file_status&, fs::file_status&, detail::entry_attributes_cache&) noexcept
+{
+}
+
 BOOST_CONSTEXPR_OR_CONST err_t not_found_error_code = ERROR_PATH_NOT_FOUND;
 
 #endif // BOOST_FILESYSTEM_WINDOWS_API
@@ -1263,6 +1739,9 @@ void directory_iterator_construct(directory_iterator& it, path const& p, directo
         return;
     }
 
+    if ((opts & (directory_options::inode_ordered_attributes | directory_options::prefetch_attributes)) != directory_options::none)
+        opts |= directory_options::cache_entry_attributes;
+
     if (ec)
         ec->clear();
 
@@ -1272,6 +1751,8 @@ void directory_iterator_construct(directory_iterator& it, path const& p, directo
         path filename;
         file_status file_stat, symlink_file_stat;
         system::error_code result = dir_itr_create(imp, p, opts, params, filename, file_stat, symlink_file_stat);
+        if (!result)
+            imp->options = opts;
 
         while (true)
         {
@@ -1305,6 +1786,8 @@ void directory_iterator_construct(directory_iterator& it, path const& p, directo
                     file_stat,
                     symlink_file_stat
                 );
+                if ((opts & directory_options::cache_entry_attributes) != directory_options::none)
+                    dir_itr_cache_attributes(*imp, filename, imp->dir_entry.m_status, imp->dir_entry.m_symlink_status, imp->dir_entry.m_attributes);
                 it.m_imp.swap(imp);
                 return;
             }
@@ -1364,7 +1847,10 @@ void directory_iterator_increment(directory_iterator& it, system::error_code* ec
                   && (filename_str[1] == static_cast< path::string_type::value_type >('\0') ||
                       (filename_str[1] == path::dot && filename_str[2] == static_cast< path::string_type::value_type >('\0')))))
             {
-                it.m_imp->dir_entry.replace_filename_with_status(filename, file_stat, symlink_file_stat);
+                detail::dir_itr_imp& imp = *it.m_imp;
+                imp.dir_entry.replace_filename_with_status(filename, file_stat, symlink_file_stat);
+                if ((imp.options & directory_options::cache_entry_attributes) != directory_options::none)
+                    dir_itr_cache_attributes(imp, filename, imp.dir_entry.m_status, imp.dir_entry.m_symlink_status, imp.dir_entry.m_attributes);
                 return;
             }
         }
@@ -1379,179 +1865,704 @@ void directory_iterator_increment(directory_iterator& it, system::error_code* ec
     }
 }
 
-//--------------------------------------------------------------------------------------//
-//                                                                                      //
-//                           recursive_directory_iterator                               //
-//                                                                                      //
-//--------------------------------------------------------------------------------------//
+#if defined(BOOST_FILESYSTEM_POSIX_API)
 
-BOOST_FILESYSTEM_DECL
-void recursive_directory_iterator_construct(recursive_directory_iterator& it, path const& dir_path, directory_options opts, system::error_code* ec)
+namespace {
+
+//! An element of a directory_iterator::next_batch result, whose attributes are to be obtained in inode order
+struct deferred_attributes_entry
 {
-    // At most one of the two options may be specified
-    BOOST_ASSERT((opts & (directory_options::follow_directory_symlink | directory_options::_detail_no_follow)) != (directory_options::follow_directory_symlink | directory_options::_detail_no_follow));
+    boost::uintmax_t ino;
+    std::size_t index;
+};
+
+//! Orders deferred entries by inode numbers
+struct deferred_attributes_inode_order
+{
+    bool operator()(deferred_attributes_entry const& left, deferred_attributes_entry const& right) const noexcept
+    {
+        return left.ino < right.ino;
+    }
+};
+
+} // namespace
+
+#endif // defined(BOOST_FILESYSTEM_POSIX_API)
 
+BOOST_FILESYSTEM_DECL
+std::size_t directory_iterator_next_batch(directory_iterator& it, directory_entry* entries, std::size_t count, system::error_code* ec)
+{
     if (ec)
         ec->clear();
 
-    directory_iterator dir_it;
-    detail::directory_iterator_construct(dir_it, dir_path, opts, nullptr, ec);
-    if ((ec && *ec) || dir_it == directory_iterator())
-        return;
-
-    boost::intrusive_ptr< detail::recur_dir_itr_imp > imp;
-    if (!ec)
-    {
-        imp = new detail::recur_dir_itr_imp(opts);
-    }
-    else
+    std::size_t filled = 0u;
+    try
     {
-        imp = new (std::nothrow) detail::recur_dir_itr_imp(opts);
-        if (BOOST_UNLIKELY(!imp))
+        path filename;
+        file_status file_stat, symlink_file_stat;
+        system::error_code increment_ec;
+
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+        // On POSIX systems, querying attributes of files in readdir order results in random accesses to the inode table
+        // on cold caches. When requested, collect inode numbers of the entries of the batch first and then query attributes
+        // in the inode order, which is typically the order of inodes on disk. On filesystems with high latency of
+        // the queries, such as network filesystems, the queries for the whole batch can also be issued concurrently.
+        std::vector< deferred_attributes_entry > deferred;
+        const directory_options defer_opts = it.is_end() ? directory_options::none :
+            (it.m_imp->options & (directory_options::inode_ordered_attributes | directory_options::prefetch_attributes));
+        const bool defer_attributes = defer_opts != directory_options::none;
+        boost::uintmax_t ino = 0u;
+#endif
+
+        bool done = false;
+        while (!done && filled < count && !it.is_end())
         {
-            *ec = make_error_code(system::errc::not_enough_memory);
-            return;
+            // Copy assignment reuses the storage already allocated in the target entry path
+            directory_entry const& current = it.m_imp->dir_entry;
+            directory_entry& entry = entries[filled];
+            entry.assign_with_status(current.m_path, current.m_status, current.m_symlink_status);
+            entry.m_attributes = current.m_attributes;
+            ++filled;
+
+            while (true)
+            {
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+                increment_ec = dir_itr_increment(*it.m_imp, filename, file_stat, symlink_file_stat, defer_attributes ? &ino : nullptr);
+#else
+                increment_ec = dir_itr_increment(*it.m_imp, filename, file_stat, symlink_file_stat);
+#endif
+
+                if (BOOST_UNLIKELY(!!increment_ec))
+                {
+                    boost::intrusive_ptr< detail::dir_itr_imp > imp;
+                    imp.swap(it.m_imp);
+                    path error_path(imp->dir_entry.path().parent_path());
+                    if (!ec)
+                        BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::directory_iterator::next_batch", error_path, increment_ec));
+
+                    *ec = increment_ec;
+                    done = true;
+                    break;
+                }
+
+                if (it.m_imp->handle == nullptr) // eof, make end
+                {
+                    it.m_imp.reset();
+                    done = true;
+                    break;
+                }
+
+                const path::string_type::value_type* filename_str = filename.c_str();
+                if (!(filename_str[0] == path::dot // !(dot or dot-dot)
+                      && (filename_str[1] == static_cast< path::string_type::value_type >('\0') ||
+                          (filename_str[1] == path::dot && filename_str[2] == static_cast< path::string_type::value_type >('\0')))))
+                {
+                    detail::dir_itr_imp& imp = *it.m_imp;
+                    imp.dir_entry.replace_filename_with_status(filename, file_stat, symlink_file_stat);
+                    if ((imp.options & directory_options::cache_entry_attributes) != directory_options::none)
+                    {
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+                        // Only the entries that will be added to this batch are deferred
+                        if (defer_attributes && filled < count)
+                        {
+                            deferred_attributes_entry de = { ino, filled };
+                            deferred.push_back(de);
+                        }
+                        else
+#endif
+                        {
+                            dir_itr_cache_attributes(imp, filename, imp.dir_entry.m_status, imp.dir_entry.m_symlink_status, imp.dir_entry.m_attributes);
+                        }
+                    }
+                    break;
+                }
+            }
         }
-    }
 
-    try
-    {
-        imp->m_stack.push_back(std::move(dir_it));
-        it.m_imp.swap(imp);
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+        if (!deferred.empty())
+        {
+            if ((defer_opts & directory_options::inode_ordered_attributes) != directory_options::none)
+                std::sort(deferred.begin(), deferred.end(), deferred_attributes_inode_order());
+
+            // If the directory has been closed upon reaching its end, fall back to using full paths of the entries
+            int dir_fd = -1;
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+            if (!it.is_end())
+            {
+                system::error_code fd_ec;
+                dir_fd = dir_itr_fd(*it.m_imp, fd_ec);
+                if (BOOST_UNLIKELY(!!fd_ec))
+                    dir_fd = -1;
+            }
+#endif
+
+            std::vector< path > filenames;
+            if (dir_fd >= 0)
+            {
+                filenames.reserve(deferred.size());
+                for (std::size_t i = 0u, n = deferred.size(); i < n; ++i)
+                    filenames.push_back(detail::path_algorithms::filename_v4(entries[deferred[i].index].m_path));
+            }
+
+            std::vector< detail::entry_attributes_request > requests;
+            requests.reserve(deferred.size());
+            for (std::size_t i = 0u, n = deferred.size(); i < n; ++i)
+            {
+                directory_entry& entry = entries[deferred[i].index];
+                detail::entry_attributes_request request = { dir_fd >= 0 ? &filenames[i] : &entry.m_path, &entry.m_attributes, &entry.m_status };
+                requests.push_back(request);
+            }
+
+            if ((defer_opts & directory_options::prefetch_attributes) != directory_options::none)
+            {
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                if (dir_fd >= 0)
+                {
+                    detail::entry_attributes_batch_impl(requests.data(), requests.size(), dir_fd);
+                }
+                else
+#endif
+                {
+                    detail::entry_attributes_batch_impl(requests.data(), requests.size());
+                }
+            }
+            else
+            {
+                // Errors are not reported here, the attributes will be obtained when requested by the user
+                system::error_code attr_ec;
+                for (std::size_t i = 0u, n = requests.size(); i < n; ++i)
+                {
+                    detail::entry_attributes_request const& request = requests[i];
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                    if (dir_fd >= 0)
+                    {
+                        request.attrs->mask = detail::entry_attributes_impl(*request.p, entry_attributes::all, *request.attrs, *request.st, &attr_ec, dir_fd);
+                        continue;
+                    }
+#endif
+                    request.attrs->mask = detail::entry_attributes_impl(*request.p, entry_attributes::all, *request.attrs, *request.st, &attr_ec);
+                }
+            }
+        }
+#endif // defined(BOOST_FILESYSTEM_POSIX_API)
     }
     catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        it.m_imp.reset();
+        *ec = make_error_code(system::errc::not_enough_memory);
+    }
+
+    return filled;
+}
+
+BOOST_FILESYSTEM_DECL
+void directory_iterator_refresh_attributes(directory_iterator& it, entry_attributes mask, system::error_code* ec)
+{
+    BOOST_ASSERT_MSG(!it.is_end(), "attempt to refresh attributes of end directory iterator");
+    directory_entry& entry = it.m_imp->dir_entry;
+
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    // Query the attributes relative to the open directory to avoid resolving the full path of the entry
+    system::error_code local_ec;
+    const int dir_fd = dir_itr_fd(*it.m_imp, local_ec);
+    if (BOOST_LIKELY(!local_ec))
     {
         if (ec)
+            ec->clear();
+
+        entry.m_attributes.mask &= ~mask;
+        if (mask == entry_attributes::none)
+            return;
+
+        detail::entry_attributes_cache attrs;
+        file_status st;
+        const entry_attributes obtained = detail::entry_attributes_impl(path_algorithms::filename_v4(entry.m_path), mask, attrs, st, &local_ec, dir_fd);
+        if (BOOST_UNLIKELY(!!local_ec))
         {
-            *ec = make_error_code(system::errc::not_enough_memory);
+            emit_error(local_ec.value(), entry.m_path, ec, "boost::filesystem::directory_entry::refresh");
             return;
         }
 
-        throw;
+        entry.m_status = st;
+        store_entry_attributes(entry.m_attributes, attrs, obtained);
+
+        // The file size is only defined for regular files
+        if (BOOST_UNLIKELY(obtained != mask))
+            emit_error(BOOST_ERROR_NOT_SUPPORTED, entry.m_path, ec, "boost::filesystem::directory_entry::refresh");
+
+        return;
     }
-}
+#endif
 
-namespace {
+    entry.refresh_attributes_impl(mask, ec);
+}
 
-void recursive_directory_iterator_pop_on_error(detail::recur_dir_itr_imp* imp)
+BOOST_FILESYSTEM_DECL
+bool directory_entry_cached_last_write_time(directory_entry const& entry, std::time_t& sec, boost::uint32_t& nsec) noexcept
 {
-    imp->m_stack.pop_back();
-
-    while (!imp->m_stack.empty())
-    {
-        directory_iterator& dir_it = imp->m_stack.back();
-        system::error_code increment_ec;
-        detail::directory_iterator_increment(dir_it, &increment_ec);
-        if (!increment_ec && dir_it != directory_iterator())
-            break;
+    if ((entry.m_attributes.mask & entry_attributes::last_write_time) == entry_attributes::none)
+        return false;
 
-        imp->m_stack.pop_back();
-    }
+    sec = entry.m_attributes.last_write_time;
+    nsec = entry.m_attributes.last_write_time_nsec;
+    return true;
 }
 
-} // namespace
+} // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                directory_reader                                      //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
 
 BOOST_FILESYSTEM_DECL
-void recursive_directory_iterator_pop(recursive_directory_iterator& it, system::error_code* ec)
+void directory_reader::open_impl(path const& p, directory_options opts, system::error_code* ec)
 {
-    BOOST_ASSERT_MSG(!it.is_end(), "pop() on end recursive_directory_iterator");
-    detail::recur_dir_itr_imp* const imp = it.m_imp.get();
+    close();
 
     if (ec)
         ec->clear();
 
-    imp->m_stack.pop_back();
+    if (BOOST_UNLIKELY(p.empty()))
+    {
+        emit_error(detail::not_found_error_code, p, ec, "boost::filesystem::directory_reader::open");
+        return;
+    }
 
-    while (true)
+    try
     {
-        if (imp->m_stack.empty())
-        {
-            it.m_imp.reset(); // done, so make end iterator
-            break;
-        }
+        m_dir = p;
 
-        directory_iterator& dir_it = imp->m_stack.back();
-        system::error_code increment_ec;
-        detail::directory_iterator_increment(dir_it, &increment_ec);
-        if (BOOST_UNLIKELY(!!increment_ec))
+        file_status file_stat, symlink_file_stat;
+        system::error_code err = detail::dir_itr_create(m_imp, p, opts, nullptr, m_filename, file_stat, symlink_file_stat);
+        if (BOOST_UNLIKELY(!!err))
         {
-            if ((imp->m_options & directory_options::pop_on_error) == directory_options::none)
-            {
-                // Make an end iterator on errors
-                it.m_imp.reset();
-            }
-            else
-            {
-                recursive_directory_iterator_pop_on_error(imp);
+            m_imp.reset();
 
-                if (imp->m_stack.empty())
-                    it.m_imp.reset(); // done, so make end iterator
+            if (err == make_error_condition(system::errc::permission_denied) &&
+                (opts & directory_options::skip_permission_denied) != directory_options::none)
+            {
+                return;
             }
 
             if (!ec)
-                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::recursive_directory_iterator::pop", increment_ec));
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::directory_reader::open", p, err));
 
-            *ec = increment_ec;
+            *ec = err;
             return;
         }
 
-        if (dir_it != directory_iterator())
-            break;
+        if (m_imp->handle == nullptr) // eof
+        {
+            m_imp.reset();
+            return;
+        }
 
-        imp->m_stack.pop_back();
+        // dir_itr_create may have produced the first entry of the directory
+        m_pending = !detail::is_dot_or_dot_dot(m_filename);
+        m_type = file_stat.type();
+        m_symlink_type = symlink_file_stat.type();
+    }
+    catch (std::bad_alloc&)
+    {
+        m_imp.reset();
+
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
     }
 }
 
 BOOST_FILESYSTEM_DECL
-void recursive_directory_iterator_increment(recursive_directory_iterator& it, system::error_code* ec)
+bool directory_reader::next_impl(system::error_code* ec)
 {
-    enum push_directory_result : unsigned int
+    if (ec)
+        ec->clear();
+
+    if (BOOST_UNLIKELY(!m_imp))
+        return false;
+
+    if (m_pending)
     {
-        directory_not_pushed = 0u,
-        directory_pushed = 1u,
-        keep_depth = 1u << 1u
-    };
+        m_pending = false;
+        m_name = m_filename.c_str();
+        m_name_size = m_filename.native().size();
+        return true;
+    }
 
-    struct local
+    try
     {
-        //! Attempts to descend into a directory
-        static push_directory_result push_directory(detail::recur_dir_itr_imp* imp, system::error_code& ec)
+        file_status file_stat, symlink_file_stat;
+        while (true)
         {
-            push_directory_result result = directory_not_pushed;
-            try
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+            // Refer to the name in the buffer of directory entries
+            const char* name = nullptr;
+            system::error_code err = detail::dir_itr_read(*m_imp, name, file_stat, symlink_file_stat);
+#else
+            system::error_code err = detail::dir_itr_increment(*m_imp, m_filename, file_stat, symlink_file_stat);
+            const path::value_type* name = m_filename.c_str();
+#endif
+            if (BOOST_UNLIKELY(!!err))
             {
-                //  Discover if the iterator is for a directory that needs to be recursed into,
-                //  taking symlinks and options into account.
+                close();
 
-                if ((imp->m_options & directory_options::_detail_no_push) != directory_options::none)
-                {
-                    imp->m_options &= ~directory_options::_detail_no_push;
-                    return result;
-                }
+                if (!ec)
+                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::directory_reader::next", m_dir, err));
 
-                file_type symlink_ft = status_error;
+                *ec = err;
+                return false;
+            }
 
-#if defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
-                int parentdir_fd = -1;
-                path dir_it_filename;
-#elif defined(BOOST_FILESYSTEM_WINDOWS_API)
-                unique_handle direntry_handle;
-#endif
+            if (m_imp->handle == nullptr) // eof
+            {
+                close();
+                return false;
+            }
 
-                // If we are not recursing into symlinks, we are going to have to know if the
-                // stack top is a symlink, so get symlink_status and verify no error occurred.
-                if ((imp->m_options & directory_options::follow_directory_symlink) == directory_options::none ||
-                    (imp->m_options & directory_options::skip_dangling_symlinks) != directory_options::none)
-                {
-                    directory_iterator const& dir_it = imp->m_stack.back();
-                    if (!filesystem::type_present(dir_it->m_symlink_status))
-                    {
+            if (detail::is_dot_or_dot_dot(name))
+                continue;
+
+            m_name = name;
 #if defined(BOOST_FILESYSTEM_POSIX_API)
+            m_name_size = std::strlen(name);
+#else
+            m_name_size = m_filename.native().size();
+#endif
+            m_type = file_stat.type();
+            m_symlink_type = symlink_file_stat.type();
+            return true;
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        close();
 
-#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
-                        parentdir_fd = dir_itr_fd(*dir_it.m_imp, ec);
-                        if (BOOST_UNLIKELY(!!ec))
-                            return result;
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return false;
+    }
+}
+
+namespace detail {
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                           recursive_directory_iterator                               //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+BOOST_FILESYSTEM_DECL
+void recursive_directory_iterator_construct(recursive_directory_iterator& it, path const& dir_path, directory_options opts, detail::recursion_filter_base* filter, system::error_code* ec)
+{
+    // At most one of the two options may be specified
+    BOOST_ASSERT((opts & (directory_options::follow_directory_symlink | directory_options::_detail_no_follow)) != (directory_options::follow_directory_symlink | directory_options::_detail_no_follow));
+
+    // The iterator takes ownership of the filter
+    std::unique_ptr< detail::recursion_filter_base > filter_ptr(filter);
+
+    if (ec)
+        ec->clear();
+
+    directory_iterator dir_it;
+    detail::directory_iterator_construct(dir_it, dir_path, opts, nullptr, ec);
+    if ((ec && *ec) || dir_it == directory_iterator())
+        return;
+
+    boost::intrusive_ptr< detail::recur_dir_itr_imp > imp;
+    if (!ec)
+    {
+        imp = new detail::recur_dir_itr_imp(opts, filter_ptr.get());
+    }
+    else
+    {
+        imp = new (std::nothrow) detail::recur_dir_itr_imp(opts, filter_ptr.get());
+        if (BOOST_UNLIKELY(!imp))
+        {
+            *ec = make_error_code(system::errc::not_enough_memory);
+            return;
+        }
+    }
+
+    filter_ptr.release();
+
+    try
+    {
+        imp->m_stack.push_back(std::move(dir_it));
+        it.m_imp.swap(imp);
+    }
+    catch (std::bad_alloc&)
+    {
+        if (ec)
+        {
+            *ec = make_error_code(system::errc::not_enough_memory);
+            return;
+        }
+
+        throw;
+    }
+}
+
+namespace {
+
+/*!
+ * \brief Advances the directory iterator at the top of the stack to the next entry
+ *
+ * If the directory was closed to stay within the limit of open directories, reopens it and positions the iterator
+ * after the saved entry. Where supported, the directory is reopened relative to its parent directory, which is in turn
+ * reopened relative to its parent, starting from the root of the iteration, without following symlinks other than
+ * the ones that were followed when descending. On Linux, the position is restored using the directory offset (cookie)
+ * saved when the directory was closed. Otherwise, the directory is read from the beginning until the saved entry is found,
+ * and if it is not found, an error is returned.
+ */
+void recursive_directory_iterator_advance(detail::recur_dir_itr_imp* imp, system::error_code& ec)
+{
+    if (BOOST_LIKELY(imp->m_closed_levels.size() < imp->m_stack.size()))
+    {
+        detail::directory_iterator_increment(imp->m_stack.back(), &ec);
+        return;
+    }
+
+    ec.clear();
+
+    try
+    {
+        std::vector< detail::recur_dir_itr_closed_level >& closed_levels = imp->m_closed_levels;
+        detail::recur_dir_itr_closed_level level(std::move(closed_levels.back()));
+        closed_levels.pop_back();
+
+        path dir_path(level.entry_path);
+        detail::path_algorithms::remove_filename_v4(dir_path);
+        const directory_options opts = imp->m_options & ~directory_options::_detail_no_push;
+
+        directory_iterator next;
+#if defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+        // All levels up to the one being reopened are closed. Open the root of the iteration by path, as it was originally opened,
+        // and the subdirectories relative to their parents.
+        path root_path(closed_levels.empty() ? level.entry_path : closed_levels.front().entry_path);
+        detail::path_algorithms::remove_filename_v4(root_path);
+        detail::directory_iterator_params params{ detail::open_directory(root_path, opts, ec) };
+        if (BOOST_UNLIKELY(!!ec))
+            return;
+
+        for (std::size_t i = 0u, n = closed_levels.size(); i < n; ++i)
+        {
+            detail::recur_dir_itr_closed_level const& parent_level = closed_levels[i];
+            const directory_options subdir_opts = parent_level.follow_entry ? opts : (opts | directory_options::_detail_no_follow);
+            params.dir_fd = detail::openat_directory(params.dir_fd.get(), detail::path_algorithms::filename_v4(parent_level.entry_path), subdir_opts, ec);
+            if (BOOST_UNLIKELY(!!ec))
+                return;
+        }
+
+#if defined(BOOST_FILESYSTEM_USE_GETDENTS64)
+        if (level.has_cookie)
+        {
+            if (BOOST_UNLIKELY(::lseek(params.dir_fd.get(), static_cast< off_t >(level.cookie), SEEK_SET) < 0))
+            {
+                const int err = errno;
+                ec.assign(err, system::system_category());
+                return;
+            }
+
+            detail::directory_iterator_construct(next, dir_path, opts, &params, &ec);
+        }
+        else
+#endif // defined(BOOST_FILESYSTEM_USE_GETDENTS64)
+        {
+            detail::directory_iterator_construct(next, dir_path, opts, &params, &ec);
+#else // defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+        {
+            detail::directory_iterator_construct(next, dir_path, opts, nullptr, &ec);
+#endif // defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+
+            // Note: This makes iterating over a directory that is closed and reopened many times quadratic in the number of its entries
+            path::string_type const& entry_path = level.entry_path.native();
+            const std::size_t filename_size = detail::path_algorithms::find_filename_v4_size(level.entry_path);
+            const path::value_type* const filename = entry_path.c_str() + entry_path.size() - filename_size;
+            bool found = false;
+            while (!ec && next != directory_iterator())
+            {
+                path::string_type const& p = next->path().native();
+                found = detail::path_algorithms::find_filename_v4_size(next->path()) == filename_size &&
+                    path::string_type::traits_type::compare(p.c_str() + p.size() - filename_size, filename, filename_size) == 0;
+
+                detail::directory_iterator_increment(next, &ec);
+                if (found)
+                    break;
+            }
+
+            // If the entry was removed, the position in the directory is lost
+            if (BOOST_UNLIKELY(!ec && !found))
+                ec = make_error_code(system::errc::no_such_file_or_directory);
+        }
+
+        if (BOOST_LIKELY(!ec))
+            imp->m_stack.back() = std::move(next);
+    }
+    catch (std::bad_alloc&)
+    {
+        ec = make_error_code(system::errc::not_enough_memory);
+    }
+}
+
+void recursive_directory_iterator_pop_on_error(detail::recur_dir_itr_imp* imp)
+{
+    imp->m_stack.pop_back();
+
+    while (!imp->m_stack.empty())
+    {
+        system::error_code increment_ec;
+        recursive_directory_iterator_advance(imp, increment_ec);
+        if (!increment_ec && imp->m_stack.back() != directory_iterator())
+            break;
+
+        imp->m_stack.pop_back();
+    }
+}
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+void recursive_directory_iterator_pop(recursive_directory_iterator& it, system::error_code* ec)
+{
+    BOOST_ASSERT_MSG(!it.is_end(), "pop() on end recursive_directory_iterator");
+    detail::recur_dir_itr_imp* const imp = it.m_imp.get();
+
+    if (ec)
+        ec->clear();
+
+    imp->m_stack.pop_back();
+
+    while (true)
+    {
+        if (imp->m_stack.empty())
+        {
+            it.m_imp.reset(); // done, so make end iterator
+            break;
+        }
+
+        system::error_code increment_ec;
+        recursive_directory_iterator_advance(imp, increment_ec);
+        if (BOOST_UNLIKELY(!!increment_ec))
+        {
+            if ((imp->m_options & directory_options::pop_on_error) == directory_options::none)
+            {
+                // Make an end iterator on errors
+                it.m_imp.reset();
+            }
+            else
+            {
+                recursive_directory_iterator_pop_on_error(imp);
+
+                if (imp->m_stack.empty())
+                    it.m_imp.reset(); // done, so make end iterator
+            }
+
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::recursive_directory_iterator::pop", increment_ec));
+
+            *ec = increment_ec;
+            return;
+        }
+
+        if (imp->m_stack.back() != directory_iterator())
+            break;
+
+        imp->m_stack.pop_back();
+    }
+}
+
+BOOST_FILESYSTEM_DECL
+void recursive_directory_iterator_increment(recursive_directory_iterator& it, system::error_code* ec)
+{
+    enum push_directory_result : unsigned int
+    {
+        directory_not_pushed = 0u,
+        directory_pushed = 1u,
+        keep_depth = 1u << 1u
+    };
+
+    struct local
+    {
+        //! Closes the outermost open directories while the number of open directories exceeds the limit. Throws \c std::bad_alloc if the position in a directory cannot be saved.
+        static void close_outer_levels(detail::recur_dir_itr_imp* imp)
+        {
+            const std::size_t max_open_dirs = imp->m_max_open_dirs;
+            if (max_open_dirs == 0u)
+                return;
+
+            std::vector< detail::recur_dir_itr_closed_level >& closed_levels = imp->m_closed_levels;
+            // The directory at the top of the stack is always kept open
+            while ((imp->m_stack.size() - closed_levels.size()) > max_open_dirs && (closed_levels.size() + 1u) < imp->m_stack.size())
+            {
+                directory_iterator& dir_it = imp->m_stack[closed_levels.size()];
+                detail::recur_dir_itr_closed_level level;
+                level.entry_path = dir_it->path();
+                // Unless following symlinks, the entry was verified not to be a symlink before descending into it
+                level.follow_entry = (imp->m_options & directory_options::follow_directory_symlink) != directory_options::none &&
+                    dir_it->m_symlink_status.type() != directory_file;
+#if defined(BOOST_FILESYSTEM_USE_GETDENTS64)
+                if (dir_it.m_imp->extra_data_format == getdents64_format)
+                {
+                    const boost::int64_t cookie = static_cast< const getdents64_state* >(dir_it.m_imp->handle)->next_entry_cookie;
+                    if (static_cast< boost::int64_t >(static_cast< off_t >(cookie)) == cookie)
+                    {
+                        level.cookie = cookie;
+                        level.has_cookie = true;
+                    }
+                }
+#endif // defined(BOOST_FILESYSTEM_USE_GETDENTS64)
+                closed_levels.push_back(std::move(level));
+                dir_it = directory_iterator();
+            }
+        }
+
+        //! Attempts to descend into a directory
+        static push_directory_result push_directory(detail::recur_dir_itr_imp* imp, system::error_code& ec)
+        {
+            push_directory_result result = directory_not_pushed;
+            try
+            {
+                //  Discover if the iterator is for a directory that needs to be recursed into,
+                //  taking symlinks and options into account.
+
+                if ((imp->m_options & directory_options::_detail_no_push) != directory_options::none)
+                {
+                    imp->m_options &= ~directory_options::_detail_no_push;
+                    return result;
+                }
+
+                file_type symlink_ft = status_error;
+
+#if defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                int parentdir_fd = -1;
+                path dir_it_filename;
+#elif defined(BOOST_FILESYSTEM_WINDOWS_API)
+                unique_handle direntry_handle;
+#endif
+
+                // If we are not recursing into symlinks, we are going to have to know if the
+                // stack top is a symlink, so get symlink_status and verify no error occurred.
+                if ((imp->m_options & directory_options::follow_directory_symlink) == directory_options::none ||
+                    (imp->m_options & directory_options::skip_dangling_symlinks) != directory_options::none)
+                {
+                    directory_iterator const& dir_it = imp->m_stack.back();
+                    if (!filesystem::type_present(dir_it->m_symlink_status))
+                    {
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                        parentdir_fd = dir_itr_fd(*dir_it.m_imp, ec);
+                        if (BOOST_UNLIKELY(!!ec))
+                            return result;
 
                         dir_it_filename = detail::path_algorithms::filename_v4(dir_it->path());
 
@@ -1618,6 +2629,10 @@ void recursive_directory_iterator_increment(recursive_directory_iterator& it, sy
                     if (ft != status_error && ft != directory_file)
                         return result;
 
+                    // Let the user's filter prune the subtree before the directory is opened
+                    if (imp->m_filter && !(*imp->m_filter)(*dir_it))
+                        return result;
+
 #if defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
 
                     if (parentdir_fd < 0)
@@ -1755,6 +2770,8 @@ void recursive_directory_iterator_increment(recursive_directory_iterator& it, sy
                         if (!next.is_end())
                         {
                             imp->m_stack.push_back(std::move(next)); // may throw
+                            // If this fails, the error is reported as if the directory was not pushed, which pops it with pop_on_error
+                            close_outer_levels(imp); // may throw
                             return directory_pushed;
                         }
                     }
@@ -1796,9 +2813,8 @@ void recursive_directory_iterator_increment(recursive_directory_iterator& it, sy
             if ((push_result & keep_depth) != 0u)
             {
                 system::error_code increment_ec;
-                directory_iterator& dir_it = imp->m_stack.back();
-                detail::directory_iterator_increment(dir_it, &increment_ec);
-                if (!increment_ec && !dir_it.is_end())
+                recursive_directory_iterator_advance(imp, increment_ec);
+                if (!increment_ec && !imp->m_stack.back().is_end())
                     goto on_error_return;
             }
 
@@ -1827,19 +2843,1512 @@ void recursive_directory_iterator_increment(recursive_directory_iterator& it, sy
             break;
         }
 
-        directory_iterator& dir_it = imp->m_stack.back();
-        detail::directory_iterator_increment(dir_it, &local_ec);
+        recursive_directory_iterator_advance(imp, local_ec);
         if (BOOST_UNLIKELY(!!local_ec))
             goto on_error;
 
-        if (!dir_it.is_end())
+        if (!imp->m_stack.back().is_end())
             break;
 
         imp->m_stack.pop_back();
     }
 }
 
-} // namespace detail
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                   parallel_walk                                      //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+namespace {
+
+#if defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+
+//! Directory that is kept open while its subdirectories are pending to be walked
+struct parallel_walk_dir :
+    public boost::intrusive_ref_counter< parallel_walk_dir >
+{
+    boost::scope::unique_fd fd;
+};
+
+//! Duplicates the file descriptor of the directory being iterated, so that it can be used after the iterator is closed
+boost::scope::unique_fd dup_directory_fd(int fd, system::error_code& ec)
+{
+#if defined(F_DUPFD_CLOEXEC) && !defined(BOOST_FILESYSTEM_NO_O_CLOEXEC)
+    int res = ::fcntl(fd, F_DUPFD_CLOEXEC, 0);
+#else
+    int res = ::dup(fd);
+#endif
+    if (BOOST_UNLIKELY(res < 0))
+    {
+        const int err = errno;
+        ec = system::error_code(err, system::system_category());
+        return boost::scope::unique_fd();
+    }
+
+    boost::scope::unique_fd new_fd(res);
+
+#if (!defined(F_DUPFD_CLOEXEC) || defined(BOOST_FILESYSTEM_NO_O_CLOEXEC)) && defined(FD_CLOEXEC)
+    res = ::fcntl(new_fd.get(), F_SETFD, FD_CLOEXEC);
+    if (BOOST_UNLIKELY(res < 0))
+    {
+        const int err = errno;
+        ec = system::error_code(err, system::system_category());
+        return boost::scope::unique_fd();
+    }
+#endif
+
+    return new_fd;
+}
+
+#endif // defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+
+//! A directory to be walked
+struct parallel_walk_task
+{
+#if defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    //! Parent directory. If not null, the directory is opened relative to the parent.
+    boost::intrusive_ptr< parallel_walk_dir > parent;
+#endif
+    //! Full path of the directory
+    path dir_path;
+    //! Symlink file type of the directory entry, if known
+    file_type symlink_ft;
+    //! Indicates that the directory is the root of the walk
+    bool is_root;
+
+    parallel_walk_task() noexcept :
+        symlink_ft(status_error),
+        is_root(false)
+    {
+    }
+};
+
+//! Error that occurred in a worker thread of parallel_walk
+struct parallel_walk_error
+{
+    system::error_code ec;
+    path error_path;
+    std::exception_ptr exception;
+};
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+void parallel_walk(path const& root, parallel_walk_options const& opts, parallel_walk_visitor_t* visitor, void* context, system::error_code* ec)
+{
+    struct local
+    {
+        struct walker
+        {
+            work_stealing_pool< parallel_walk_task > pool;
+            const directory_options options;
+            parallel_walk_visitor_t* const visitor;
+            void* const context;
+            //! Errors, one per worker
+            std::vector< parallel_walk_error > errors;
+
+            walker(parallel_walk_options const& opts, parallel_walk_visitor_t* vis, void* ctx) :
+                pool(detail::resolve_thread_count(opts.thread_count)),
+                options(opts.options & ~(directory_options::_detail_no_follow | directory_options::_detail_no_push)),
+                visitor(vis),
+                context(ctx),
+                errors(pool.worker_count())
+            {
+            }
+
+            void operator()(unsigned int worker, parallel_walk_task& task) noexcept
+            {
+                try
+                {
+                    walk_directory(worker, task);
+                }
+                catch (...)
+                {
+                    parallel_walk_error& err = errors[worker];
+                    if (!err.exception)
+                        err.exception = std::current_exception();
+                    pool.stop();
+                }
+            }
+
+            //! Records an error. Unless pop_on_error is specified, the walk is stopped.
+            void fail(unsigned int worker, system::error_code const& ec, path const& p)
+            {
+                parallel_walk_error& err = errors[worker];
+                if (!err.ec)
+                {
+                    err.ec = ec;
+                    err.error_path = p;
+                }
+
+                if ((options & directory_options::pop_on_error) == directory_options::none)
+                    pool.stop();
+            }
+
+            //! Tests if a directory opening error should be ignored
+            bool is_ignored_error(system::error_code const& ec, file_type symlink_ft) const
+            {
+                return
+                (
+                    // Skip non-directory files
+                    ec == system::error_code(ENOTDIR, system::system_category()) ||
+                    (
+                        ec == make_error_condition(system::errc::permission_denied) &&
+                        (options & directory_options::skip_permission_denied) != directory_options::none
+                    ) ||
+                    (
+                        // Skip dangling symlink, if requested by options
+                        ec == make_error_condition(system::errc::no_such_file_or_directory) && symlink_ft == symlink_file &&
+                        (options & (directory_options::follow_directory_symlink | directory_options::skip_dangling_symlinks)) == (directory_options::follow_directory_symlink | directory_options::skip_dangling_symlinks)
+                    )
+                );
+            }
+
+            void walk_directory(unsigned int worker, parallel_walk_task& task)
+            {
+                system::error_code ec;
+                directory_iterator it;
+
+#if defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                if (!!task.parent)
+                {
+                    detail::directory_iterator_params params{ detail::openat_directory(task.parent->fd.get(), detail::path_algorithms::filename_v4(task.dir_path), options, ec) };
+                    // Release the parent directory as early as possible to reduce the number of open file descriptors
+                    task.parent.reset();
+                    if (BOOST_UNLIKELY(!!ec))
+                    {
+                        if (!is_ignored_error(ec, task.symlink_ft))
+                            fail(worker, ec, task.dir_path);
+                        return;
+                    }
+
+                    detail::directory_iterator_construct(it, task.dir_path, options, &params, &ec);
+                }
+                else
+#endif
+                {
+                    detail::directory_iterator_construct(it, task.dir_path, options, nullptr, &ec);
+                }
+
+                if (BOOST_UNLIKELY(!!ec))
+                {
+                    if (task.is_root || !is_ignored_error(ec, task.symlink_ft))
+                        fail(worker, ec, task.dir_path);
+                    return;
+                }
+
+#if defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                boost::intrusive_ptr< parallel_walk_dir > dir;
+#endif
+
+                while (!it.is_end())
+                {
+                    if (pool.stopped())
+                        return;
+
+                    directory_entry const& entry = it.m_imp->dir_entry;
+                    visitor(context, entry);
+
+                    // Discover if the entry is a directory that needs to be recursed into, taking symlinks and options into account.
+                    file_type symlink_ft = status_error;
+                    if ((options & directory_options::follow_directory_symlink) == directory_options::none ||
+                        (options & directory_options::skip_dangling_symlinks) != directory_options::none)
+                    {
+                        if (!filesystem::type_present(entry.m_symlink_status))
+                        {
+#if defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                            const int dir_fd = dir_itr_fd(*it.m_imp, ec);
+                            if (!ec)
+                                entry.m_symlink_status = detail::symlink_status_impl(detail::path_algorithms::filename_v4(entry.path()), &ec, dir_fd);
+#else
+                            entry.m_symlink_status = detail::symlink_status_impl(entry.path(), &ec);
+#endif
+                            if (BOOST_UNLIKELY(!!ec))
+                            {
+                                fail(worker, ec, entry.path());
+                                return;
+                            }
+                        }
+
+                        symlink_ft = entry.m_symlink_status.type();
+                    }
+
+                    if ((options & directory_options::follow_directory_symlink) != directory_options::none || symlink_ft != symlink_file)
+                    {
+                        file_type ft = entry.m_status.type();
+
+#if defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                        // If the file type is not known, the child task will test whether the file is a directory by opening it
+                        if (ft == status_error || ft == directory_file)
+                        {
+                            if (!dir)
+                            {
+                                const int dir_fd = dir_itr_fd(*it.m_imp, ec);
+                                boost::intrusive_ptr< parallel_walk_dir > new_dir(new parallel_walk_dir());
+                                if (!ec)
+                                    new_dir->fd = dup_directory_fd(dir_fd, ec);
+                                if (BOOST_UNLIKELY(!!ec))
+                                {
+                                    fail(worker, ec, task.dir_path);
+                                    return;
+                                }
+
+                                dir.swap(new_dir);
+                            }
+
+                            parallel_walk_task child;
+                            child.parent = dir;
+                            child.dir_path = entry.path();
+                            child.symlink_ft = symlink_ft;
+                            pool.push(worker, std::move(child));
+                        }
+#else
+                        if (ft == status_error)
+                        {
+                            entry.m_status = detail::status(entry.path(), &ec);
+                            if (BOOST_UNLIKELY(!!ec))
+                            {
+                                fail(worker, ec, entry.path());
+                                return;
+                            }
+
+                            ft = entry.m_status.type();
+                        }
+
+                        if (ft == directory_file)
+                        {
+                            parallel_walk_task child;
+                            child.dir_path = entry.path();
+                            child.symlink_ft = symlink_ft;
+                            pool.push(worker, std::move(child));
+                        }
+#endif
+                    }
+
+                    detail::directory_iterator_increment(it, &ec);
+                    if (BOOST_UNLIKELY(!!ec))
+                    {
+                        fail(worker, ec, task.dir_path);
+                        return;
+                    }
+                }
+            }
+        };
+    };
+
+    if (ec)
+        ec->clear();
+
+    try
+    {
+        local::walker w(opts, visitor, context);
+
+        parallel_walk_task root_task;
+        root_task.dir_path = root;
+        root_task.is_root = true;
+        w.pool.push(0u, std::move(root_task));
+
+        w.pool.run(w);
+
+        for (std::size_t i = 0u, n = w.errors.size(); i < n; ++i)
+        {
+            if (!!w.errors[i].exception)
+                std::rethrow_exception(w.errors[i].exception);
+        }
+
+        for (std::size_t i = 0u, n = w.errors.size(); i < n; ++i)
+        {
+            parallel_walk_error const& err = w.errors[i];
+            if (!!err.ec)
+            {
+                if (!ec)
+                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::parallel_walk", err.error_path, err.ec));
+
+                *ec = err.ec;
+                return;
+            }
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+    }
+}
+
+} // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                   directory_tree                                     //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+namespace detail {
+
+namespace {
+
+//! Size of a block of the name arena, in characters
+BOOST_CONSTEXPR_OR_CONST std::size_t directory_tree_name_block_size = 65536u / sizeof(path::value_type);
+
+//! A directory that is being iterated by directory_tree
+struct directory_tree_level
+{
+    boost::intrusive_ptr< dir_itr_imp > imp;
+    //! Entry of the directory, or nullptr for the root directory
+    directory_tree_entry const* dir;
+};
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+path::value_type const* directory_tree_name_arena::store(path::value_type const* str, std::size_t size)
+{
+    const std::size_t required_size = size + 1u;
+    if (BOOST_UNLIKELY(m_left < required_size))
+    {
+        if (BOOST_UNLIKELY(required_size > directory_tree_name_block_size / 4u))
+        {
+            // Allocate a dedicated block for a large name, and keep using the current block for subsequent names
+            m_blocks.reserve(m_blocks.size() + 1u);
+            path::value_type* block = new path::value_type[required_size];
+            std::memcpy(block, str, size * sizeof(path::value_type));
+            block[size] = static_cast< path::value_type >('\0');
+            m_blocks.push_back(block);
+            return block;
+        }
+
+        m_blocks.reserve(m_blocks.size() + 1u);
+        m_pos = new path::value_type[directory_tree_name_block_size];
+        m_blocks.push_back(m_pos);
+        m_left = directory_tree_name_block_size;
+    }
+
+    path::value_type* name = m_pos;
+    std::memcpy(name, str, size * sizeof(path::value_type));
+    name[size] = static_cast< path::value_type >('\0');
+    m_pos += required_size;
+    m_left -= required_size;
+    return name;
+}
+
+BOOST_FILESYSTEM_DECL
+void directory_tree_name_arena::clear() noexcept
+{
+    for (std::size_t i = 0u, n = m_blocks.size(); i < n; ++i)
+        delete[] m_blocks[i];
+    m_blocks.clear();
+    m_pos = nullptr;
+    m_left = 0u;
+}
+
+} // namespace detail
+
+inline directory_tree_entry* directory_tree::append_entry(directory_tree_entry const* parent, path const& filename, file_status const& st, file_status const& symlink_st)
+{
+    path::string_type const& name = filename.native();
+    path::value_type const* stored_name = m_names.store(name.c_str(), name.size());
+    m_entries.push_back(directory_tree_entry(parent, stored_name, name.size(), st.type(), symlink_st.type()));
+    return &m_entries.back();
+}
+
+BOOST_FILESYSTEM_DECL
+path directory_tree::build_path(path const& base, directory_tree_entry const& entry)
+{
+    // Collect the chain of parent entries and the total length of the path
+    std::vector< directory_tree_entry const* > chain;
+    std::size_t size = base.native().size();
+    for (directory_tree_entry const* e = &entry; e != nullptr; e = e->m_parent)
+    {
+        chain.push_back(e);
+        size += e->m_name_size + 1u;
+    }
+
+    path::string_type str;
+    str.reserve(size);
+    str.assign(base.native());
+    path p(static_cast< path::string_type&& >(str));
+    for (std::size_t i = chain.size(); i > 0u;)
+    {
+        --i;
+        directory_tree_entry const* e = chain[i];
+        detail::path_algorithms::append_v4(p, e->m_name, e->m_name + e->m_name_size);
+    }
+
+    return p;
+}
+
+BOOST_FILESYSTEM_DECL
+void directory_tree::assign_impl(path const& root, directory_options opts, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    clear();
+
+    if (BOOST_UNLIKELY(root.empty()))
+    {
+        emit_error(detail::not_found_error_code, root, ec, "boost::filesystem::directory_tree");
+        return;
+    }
+
+    opts &= ~(directory_options::_detail_no_follow | directory_options::_detail_no_push | directory_options::cache_entry_attributes);
+
+    try
+    {
+        m_root = root;
+
+        std::vector< detail::directory_tree_level > stack;
+        system::error_code first_error;
+        path error_path;
+
+        path filename;
+        file_status file_stat, symlink_file_stat;
+        system::error_code err;
+
+        {
+            detail::directory_tree_level level;
+            level.dir = nullptr;
+            err = detail::dir_itr_create(level.imp, root, opts, nullptr, filename, file_stat, symlink_file_stat);
+            if (BOOST_UNLIKELY(!!err))
+            {
+                if (err == make_error_condition(system::errc::permission_denied) &&
+                    (opts & directory_options::skip_permission_denied) != directory_options::none)
+                {
+                    return;
+                }
+
+                if (!ec)
+                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::directory_tree", root, err));
+
+                *ec = err;
+                return;
+            }
+
+            stack.push_back(static_cast< detail::directory_tree_level&& >(level));
+        }
+
+        // dir_itr_create may have produced the first entry of the directory
+        bool have_entry = true;
+        while (!stack.empty())
+        {
+            detail::dir_itr_imp& imp = *stack.back().imp;
+            if (!have_entry)
+            {
+                err = detail::dir_itr_increment(imp, filename, file_stat, symlink_file_stat);
+                if (BOOST_UNLIKELY(!!err))
+                {
+                    if (!first_error)
+                    {
+                        first_error = err;
+                        error_path = stack.back().dir ? full_path(*stack.back().dir) : m_root;
+                    }
+
+                    if ((opts & directory_options::pop_on_error) == directory_options::none)
+                        break;
+
+                    stack.pop_back();
+                    continue;
+                }
+            }
+
+            have_entry = false;
+
+            if (imp.handle == nullptr) // eof
+            {
+                stack.pop_back();
+                continue;
+            }
+
+            if (detail::is_dot_or_dot_dot(filename))
+                continue;
+
+            directory_tree_entry* const entry = append_entry(stack.back().dir, filename, file_stat, symlink_file_stat);
+
+            //  Discover if the entry is a directory that needs to be recursed into, taking symlinks and options into account.
+            //  This follows the logic of recursive_directory_iterator.
+            file_type symlink_ft = status_error;
+            if ((opts & directory_options::follow_directory_symlink) == directory_options::none ||
+                (opts & directory_options::skip_dangling_symlinks) != directory_options::none)
+            {
+                symlink_ft = entry->symlink_type();
+                if (symlink_ft == status_error)
+                {
+#if defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                    const int dir_fd = detail::dir_itr_fd(imp, err);
+                    if (!err)
+                        symlink_ft = detail::symlink_status_impl(filename, &err, dir_fd).type();
+#else
+                    symlink_ft = detail::symlink_status(full_path(*entry), &err).type();
+#endif
+                    if (BOOST_UNLIKELY(!!err))
+                    {
+                        if (!first_error)
+                        {
+                            first_error = err;
+                            error_path = full_path(*entry);
+                        }
+
+                        if ((opts & directory_options::pop_on_error) == directory_options::none)
+                            break;
+
+                        continue;
+                    }
+
+                    entry->m_symlink_type = static_cast< unsigned char >(symlink_ft);
+                }
+            }
+
+            if ((opts & directory_options::follow_directory_symlink) == directory_options::none && symlink_ft == symlink_file)
+                continue;
+
+            file_type ft = entry->type();
+            if (ft != status_error && ft != directory_file)
+                continue;
+
+            detail::directory_tree_level level;
+            level.dir = entry;
+
+#if defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+            {
+                const int dir_fd = detail::dir_itr_fd(imp, err);
+                detail::directory_iterator_params params;
+                if (!err)
+                    params.dir_fd = detail::openat_directory(dir_fd, filename, opts, err);
+                if (!err)
+                    err = detail::dir_itr_create(level.imp, filename, opts, &params, filename, file_stat, symlink_file_stat);
+            }
+#else
+            {
+                path dir_path(full_path(*entry));
+                if (ft == status_error)
+                {
+                    ft = detail::status(dir_path, &err).type();
+                    if (!err && ft != directory_file)
+                        continue;
+                }
+
+                if (!err)
+                    err = detail::dir_itr_create(level.imp, dir_path, opts, nullptr, filename, file_stat, symlink_file_stat);
+            }
+#endif
+
+            if (BOOST_UNLIKELY(!!err))
+            {
+                if
+                (
+                    // Skip non-directory files
+                    err == system::error_code(ENOTDIR, system::system_category()) ||
+                    (
+                        err == make_error_condition(system::errc::permission_denied) &&
+                        (opts & directory_options::skip_permission_denied) != directory_options::none
+                    ) ||
+                    (
+                        // Skip dangling symlink, if requested by options
+                        err == make_error_condition(system::errc::no_such_file_or_directory) && symlink_ft == symlink_file &&
+                        (opts & (directory_options::follow_directory_symlink | directory_options::skip_dangling_symlinks)) == (directory_options::follow_directory_symlink | directory_options::skip_dangling_symlinks)
+                    )
+                )
+                {
+                    continue;
+                }
+
+                if (!first_error)
+                {
+                    first_error = err;
+                    error_path = full_path(*entry);
+                }
+
+                if ((opts & directory_options::pop_on_error) == directory_options::none)
+                    break;
+
+                continue;
+            }
+
+            entry->m_type = static_cast< unsigned char >(directory_file);
+            stack.push_back(static_cast< detail::directory_tree_level&& >(level));
+            have_entry = true;
+        }
+
+        if (BOOST_UNLIKELY(!!first_error))
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::directory_tree", error_path, first_error));
+
+            *ec = first_error;
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+    }
+}
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                     disk_usage                                       //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+namespace detail {
+
+namespace {
+
+#if !defined(BOOST_FILESYSTEM_POSIX_API)
+
+//! Attributes of a file used for disk usage accounting
+struct file_usage_stat
+{
+    file_type type;
+    boost::uintmax_t size;
+    boost::uintmax_t allocated_size;
+    boost::uintmax_t hard_link_count;
+    boost::uintmax_t device;
+    boost::uintmax_t inode;
+};
+
+//! Obtains the attributes of the file used for disk usage accounting. There is no single call that would obtain all
+//! attributes on Windows, so the allocated size is approximated by the file size and hard links are not detected.
+system::error_code file_usage_stat_impl(path const& p, bool follow_symlinks, file_usage_stat& st)
+{
+    system::error_code ec;
+    const file_status sf = follow_symlinks ? detail::status(p, &ec) : detail::symlink_status(p, &ec);
+    if (BOOST_UNLIKELY(!!ec))
+        return ec;
+
+    st.type = sf.type();
+    st.size = 0u;
+    st.hard_link_count = 1u;
+    st.device = 0u;
+    st.inode = 0u;
+    if (st.type == regular_file)
+    {
+        st.size = detail::file_size(p, &ec);
+        if (BOOST_UNLIKELY(!!ec))
+            return ec;
+    }
+    st.allocated_size = st.size;
+
+    return ec;
+}
+
+#endif // !defined(BOOST_FILESYSTEM_POSIX_API)
+
+//! A directory in the tree measured by disk_usage
+struct disk_usage_node
+{
+    //! Parent directory, or nullptr for the root directory
+    disk_usage_node* parent;
+    //! Depth of the directory in the tree, the root directory has depth of 0
+    std::size_t depth;
+    path dir_path;
+    //! Disk usage of the directory itself and its direct contents. The usage of subdirectories is added when the walk completes.
+    disk_usage_info usage;
+
+    disk_usage_node() noexcept :
+        parent(nullptr),
+        depth(0u)
+    {
+    }
+};
+
+//! A directory to be measured
+struct disk_usage_task
+{
+#if defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    //! Parent directory. If not null, the directory is opened relative to the parent.
+    boost::intrusive_ptr< parallel_walk_dir > parent;
+#endif
+    disk_usage_node* node;
+
+    disk_usage_task() noexcept :
+        node(nullptr)
+    {
+    }
+};
+
+//! Set of files with multiple hard links that were already accounted by disk_usage
+class disk_usage_inode_set
+{
+private:
+    //! Device and inode numbers of a file
+    typedef std::pair< boost::uintmax_t, boost::uintmax_t > key_type;
+
+    struct key_hash
+    {
+        std::size_t operator()(key_type const& key) const noexcept
+        {
+            return static_cast< std::size_t >((key.second ^ (key.first << 7u)) * static_cast< boost::uintmax_t >(0x9E3779B97F4A7C15ull));
+        }
+    };
+
+    typedef std::unordered_set< key_type, key_hash > set_type;
+
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+    //! A part of the set protected by its own mutex to reduce contention between threads
+    struct shard
+    {
+        std::mutex mutex;
+        set_type keys;
+    };
+
+    static BOOST_CONSTEXPR_OR_CONST std::size_t shard_count = 16u;
+
+    shard m_shards[shard_count];
+#else
+    set_type m_keys;
+#endif
+
+public:
+    //! Adds the file to the set. Returns \c true if the file was not in the set.
+    bool insert(boost::uintmax_t device, boost::uintmax_t inode)
+    {
+        const key_type key(device, inode);
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+        shard& sh = m_shards[static_cast< std::size_t >(inode % shard_count)];
+        std::lock_guard< std::mutex > lock(sh.mutex);
+        return sh.keys.insert(key).second;
+#else
+        return m_keys.insert(key).second;
+#endif
+    }
+};
+
+//! Adds disk usage of a subtree to the total
+inline void add_disk_usage(disk_usage_info& total, disk_usage_info const& usage) noexcept
+{
+    total.apparent_size += usage.apparent_size;
+    total.allocated_size += usage.allocated_size;
+    total.file_count += usage.file_count;
+    total.directory_count += usage.directory_count;
+}
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+void disk_usage(path const& root, parallel_walk_options const& opts, std::vector< directory_usage >& usage, system::error_code* ec)
+{
+    struct local
+    {
+        struct walker
+        {
+            work_stealing_pool< disk_usage_task > pool;
+            const directory_options options;
+            disk_usage_inode_set inodes;
+            //! Directories discovered by each worker
+            std::vector< std::vector< std::unique_ptr< disk_usage_node > > > nodes;
+            //! Errors, one per worker
+            std::vector< parallel_walk_error > errors;
+
+            explicit walker(parallel_walk_options const& opts) :
+                pool(detail::resolve_thread_count(opts.thread_count)),
+                options(opts.options & (directory_options::skip_permission_denied | directory_options::pop_on_error)),
+                nodes(pool.worker_count()),
+                errors(pool.worker_count())
+            {
+            }
+
+            void operator()(unsigned int worker, disk_usage_task& task) noexcept
+            {
+                try
+                {
+                    measure_directory(worker, task);
+                }
+                catch (...)
+                {
+                    parallel_walk_error& err = errors[worker];
+                    if (!err.exception)
+                        err.exception = std::current_exception();
+                    pool.stop();
+                }
+            }
+
+            //! Records an error. Unless pop_on_error is specified, the walk is stopped.
+            void fail(unsigned int worker, system::error_code const& ec, path const& p)
+            {
+                // Which worker encounters an error depends on scheduling, so keep the error on the smallest path to report it deterministically
+                parallel_walk_error& err = errors[worker];
+                if (!err.ec || detail::path_algorithms::compare_v4(p, err.error_path) < 0)
+                {
+                    err.ec = ec;
+                    err.error_path = p;
+                }
+
+                if ((options & directory_options::pop_on_error) == directory_options::none)
+                    pool.stop();
+            }
+
+            //! Returns the path of a directory entry. The paths are only constructed for subdirectories and for error reporting.
+            static path make_entry_path(disk_usage_node const& node, path const& filename)
+            {
+                path::string_type const& name = filename.native();
+                path entry_path(node.dir_path);
+                detail::path_algorithms::append_v4(entry_path, name.data(), name.data() + name.size());
+                return entry_path;
+            }
+
+            void measure_directory(unsigned int worker, disk_usage_task& task)
+            {
+                disk_usage_node* const node = task.node;
+                // Subdirectories are known to be directories and not symlinks, make sure they are not replaced with symlinks
+                const directory_options dir_options = node->parent ? (options | directory_options::_detail_no_follow) : options;
+
+                boost::intrusive_ptr< detail::dir_itr_imp > imp;
+                path filename;
+                file_status file_stat, symlink_file_stat;
+                system::error_code err;
+
+#if defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                if (!!task.parent)
+                {
+                    detail::directory_iterator_params params{ detail::openat_directory(task.parent->fd.get(), detail::path_algorithms::filename_v4(node->dir_path), dir_options, err) };
+                    // Release the parent directory as early as possible to reduce the number of open file descriptors
+                    task.parent.reset();
+                    if (!err)
+                        err = detail::dir_itr_create(imp, node->dir_path, dir_options, &params, filename, file_stat, symlink_file_stat);
+                }
+                else
+#endif
+                {
+                    err = detail::dir_itr_create(imp, node->dir_path, dir_options, nullptr, filename, file_stat, symlink_file_stat);
+                }
+
+                if (BOOST_UNLIKELY(!!err))
+                {
+                    // Subdirectories that were removed after being listed are skipped, like du does
+                    if (!node->parent || (err != make_error_condition(system::errc::no_such_file_or_directory) &&
+                        (err != make_error_condition(system::errc::permission_denied) || (options & directory_options::skip_permission_denied) == directory_options::none)))
+                    {
+                        fail(worker, err, node->dir_path);
+                    }
+
+                    return;
+                }
+
+#if defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                const int dir_fd = detail::dir_itr_fd(*imp, err);
+                if (BOOST_UNLIKELY(!!err))
+                {
+                    fail(worker, err, node->dir_path);
+                    return;
+                }
+
+                boost::intrusive_ptr< parallel_walk_dir > dir;
+#endif
+
+                std::vector< std::unique_ptr< disk_usage_node > >& worker_nodes = nodes[worker];
+                file_usage_stat st;
+                // dir_itr_create may have produced the first entry of the directory
+                bool have_entry = true;
+                while (true)
+                {
+                    if (pool.stopped())
+                        return;
+
+                    if (!have_entry)
+                    {
+                        err = detail::dir_itr_increment(*imp, filename, file_stat, symlink_file_stat);
+                        if (BOOST_UNLIKELY(!!err))
+                        {
+                            fail(worker, err, node->dir_path);
+                            return;
+                        }
+                    }
+
+                    have_entry = false;
+
+                    if (imp->handle == nullptr) // eof
+                        break;
+
+                    if (detail::is_dot_or_dot_dot(filename))
+                        continue;
+
+#if defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                    err = detail::file_usage_stat_impl(filename, false, st, dir_fd);
+#else
+                    err = detail::file_usage_stat_impl(make_entry_path(*node, filename), false, st);
+#endif
+                    if (BOOST_UNLIKELY(!!err))
+                    {
+                        // Entries that were removed after being listed are skipped, like du does
+                        if (err == make_error_condition(system::errc::no_such_file_or_directory))
+                            continue;
+
+                        fail(worker, err, make_entry_path(*node, filename));
+                        if ((options & directory_options::pop_on_error) == directory_options::none)
+                            return;
+                        continue;
+                    }
+
+                    if (st.type != directory_file)
+                    {
+                        // Files with multiple hard links are only accounted once
+                        if (st.hard_link_count > 1u && !inodes.insert(st.device, st.inode))
+                            continue;
+
+                        node->usage.apparent_size += st.size;
+                        node->usage.allocated_size += st.allocated_size;
+                        ++node->usage.file_count;
+                        continue;
+                    }
+
+                    ++node->usage.directory_count;
+
+                    std::unique_ptr< disk_usage_node > child(new disk_usage_node());
+                    child->parent = node;
+                    child->depth = node->depth + 1u;
+                    child->dir_path = make_entry_path(*node, filename);
+                    child->usage.apparent_size = st.size;
+                    child->usage.allocated_size = st.allocated_size;
+                    worker_nodes.push_back(std::move(child));
+
+                    disk_usage_task child_task;
+                    child_task.node = worker_nodes.back().get();
+
+#if defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+                    if (!dir)
+                    {
+                        boost::intrusive_ptr< parallel_walk_dir > new_dir(new parallel_walk_dir());
+                        new_dir->fd = dup_directory_fd(dir_fd, err);
+                        if (BOOST_UNLIKELY(!!err))
+                        {
+                            fail(worker, err, node->dir_path);
+                            return;
+                        }
+
+                        dir.swap(new_dir);
+                    }
+
+                    child_task.parent = dir;
+#endif
+
+                    pool.push(worker, std::move(child_task));
+                }
+            }
+        };
+
+        //! Orders directories by depth, deepest first
+        static bool deeper(disk_usage_node const* left, disk_usage_node const* right) noexcept
+        {
+            return left->depth > right->depth;
+        }
+
+        //! Orders directories by path
+        static bool path_less(directory_usage const& left, directory_usage const& right)
+        {
+            return detail::path_algorithms::compare_v4(left.dir_path, right.dir_path) < 0;
+        }
+    };
+
+    if (ec)
+        ec->clear();
+
+    usage.clear();
+
+    try
+    {
+        local::walker w(opts);
+
+        {
+            file_usage_stat st;
+            system::error_code err = detail::file_usage_stat_impl(root, true, st);
+            if (BOOST_UNLIKELY(!!err))
+            {
+                if (!ec)
+                    BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::disk_usage", root, err));
+
+                *ec = err;
+                return;
+            }
+
+            std::unique_ptr< disk_usage_node > root_node(new disk_usage_node());
+            root_node->dir_path = root;
+            root_node->usage.apparent_size = st.size;
+            root_node->usage.allocated_size = st.allocated_size;
+            w.nodes[0].push_back(std::move(root_node));
+        }
+
+        disk_usage_task root_task;
+        root_task.node = w.nodes[0].back().get();
+        w.pool.push(0u, std::move(root_task));
+
+        w.pool.run(w);
+
+        for (std::size_t i = 0u, n = w.errors.size(); i < n; ++i)
+        {
+            if (!!w.errors[i].exception)
+                std::rethrow_exception(w.errors[i].exception);
+        }
+
+        system::error_code first_error;
+        path error_path;
+        for (std::size_t i = 0u, n = w.errors.size(); i < n; ++i)
+        {
+            parallel_walk_error const& err = w.errors[i];
+            if (!!err.ec && (!first_error || detail::path_algorithms::compare_v4(err.error_path, error_path) < 0))
+            {
+                first_error = err.ec;
+                error_path = err.error_path;
+            }
+        }
+
+        // Unless pop_on_error is specified, the walk was interrupted and the results are incomplete
+        if (!first_error || (w.options & directory_options::pop_on_error) != directory_options::none)
+        {
+            std::size_t node_count = 0u;
+            for (std::size_t i = 0u, n = w.nodes.size(); i < n; ++i)
+                node_count += w.nodes[i].size();
+
+            std::vector< disk_usage_node* > nodes;
+            nodes.reserve(node_count);
+            for (std::size_t i = 0u, n = w.nodes.size(); i < n; ++i)
+            {
+                for (std::size_t j = 0u, m = w.nodes[i].size(); j < m; ++j)
+                    nodes.push_back(w.nodes[i][j].get());
+            }
+
+            // Accumulate the usage of subdirectories in their parents, starting from the deepest directories
+            std::sort(nodes.begin(), nodes.end(), &local::deeper);
+            for (std::size_t i = 0u; i < node_count; ++i)
+            {
+                disk_usage_node* const node = nodes[i];
+                if (node->parent)
+                    add_disk_usage(node->parent->usage, node->usage);
+            }
+
+            usage.resize(node_count);
+            for (std::size_t i = 0u; i < node_count; ++i)
+            {
+                disk_usage_node* const node = nodes[i];
+                directory_usage& u = usage[i];
+                u.dir_path = static_cast< path&& >(node->dir_path);
+                u.usage = node->usage;
+            }
+
+            std::sort(usage.begin(), usage.end(), &local::path_less);
+        }
+
+        if (BOOST_UNLIKELY(!!first_error))
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::disk_usage", error_path, first_error));
+
+            *ec = first_error;
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        usage.clear();
+
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+    }
+}
+
+} // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                        glob                                          //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+namespace detail {
+
+namespace {
+
+#if defined(BOOST_FILESYSTEM_POSIX_API) && defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW) && defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+#define BOOST_FILESYSTEM_GLOB_USE_AT_APIS
+#endif
+
+//! A directory that is being scanned by glob
+struct glob_level
+{
+    boost::intrusive_ptr< dir_itr_imp > imp;
+    //! Path of the directory, as reported in the results
+    path dir_path;
+    //! Sorted indices of the pattern elements that are matched against the directory entries
+    std::vector< boost::uint32_t > states;
+    //! The current directory entry
+    path filename;
+    file_status file_stat, symlink_file_stat;
+    //! Indicates that the current entry was produced by dir_itr_create and has not been processed yet
+    bool have_entry;
+};
+
+/*!
+ * \brief Walks the directories that may contain files matching a glob pattern
+ *
+ * Every directory is associated with the set of pattern elements that its entries are matched against. Entry names
+ * are matched as they are read from the directory, and only the matching entries are turned into paths and queried
+ * for status. Literal pattern elements are looked up with a \c stat call instead of scanning the directory.
+ */
+class glob_walker
+{
+private:
+    glob_pattern_imp const& m_pattern;
+    const directory_options m_options;
+    std::vector< path >& m_results;
+    //! Directories being scanned. A deque is used so that references to the scanned directories remain valid when new directories are added.
+    std::deque< glob_level > m_stack;
+    std::vector< boost::uint32_t > m_next_states;
+    std::vector< boost::uint32_t > m_recursive_states;
+    system::error_code m_first_error;
+    path m_error_path;
+    bool m_stop;
+
+public:
+    glob_walker(glob_pattern_imp const& pattern, directory_options opts, std::vector< path >& results) :
+        m_pattern(pattern),
+        m_options(opts),
+        m_results(results),
+        m_stop(false)
+    {
+    }
+
+    glob_walker(glob_walker const&) = delete;
+    glob_walker& operator=(glob_walker const&) = delete;
+
+    system::error_code const& error() const noexcept { return m_first_error; }
+    path const& error_path() const noexcept { return m_error_path; }
+
+    void run()
+    {
+        glob_pattern_imp const& pattern = m_pattern;
+        if (pattern.first_wildcard >= pattern.components.size())
+        {
+            // The pattern does not contain wildcards, only check if the file exists
+            system::error_code err;
+            const file_status st = get_status(current_dir_fd, pattern.base, pattern.directories_only, err);
+            if (exists(st))
+            {
+                if (!pattern.directories_only || st.type() == directory_file)
+                    m_results.push_back(pattern.base);
+            }
+            else if (st.type() != file_not_found && !!err)
+            {
+                on_error(err, pattern.base);
+            }
+
+            return;
+        }
+
+        m_next_states.clear();
+        m_next_states.push_back(static_cast< boost::uint32_t >(pattern.first_wildcard));
+        pattern.close_states(m_next_states);
+        std::vector< boost::uint32_t > states(m_next_states);
+        add_directory(current_dir_fd, pattern.base.empty() ? path(".") : pattern.base, pattern.base, states);
+
+        while (!m_stack.empty() && !m_stop)
+        {
+            glob_level& level = m_stack.back();
+            if (!level.have_entry)
+            {
+                system::error_code err = detail::dir_itr_increment(*level.imp, level.filename, level.file_stat, level.symlink_file_stat);
+                if (BOOST_UNLIKELY(!!err))
+                {
+                    on_error(err, level.dir_path);
+                    m_stack.pop_back();
+                    continue;
+                }
+            }
+
+            level.have_entry = false;
+
+            if (level.imp->handle == nullptr) // eof
+            {
+                m_stack.pop_back();
+                continue;
+            }
+
+            if (detail::is_dot_or_dot_dot(level.filename))
+                continue;
+
+            process_entry(level);
+        }
+    }
+
+private:
+#if defined(BOOST_FILESYSTEM_GLOB_USE_AT_APIS)
+    static BOOST_CONSTEXPR_OR_CONST int current_dir_fd = AT_FDCWD;
+#else
+    static BOOST_CONSTEXPR_OR_CONST int current_dir_fd = -1;
+#endif
+
+    //! Returns status of the file. \a p is relative to \a basedir_fd, if supported, or the current directory otherwise.
+    static file_status get_status(int basedir_fd, path const& p, bool follow_symlinks, system::error_code& err)
+    {
+#if defined(BOOST_FILESYSTEM_GLOB_USE_AT_APIS)
+        return follow_symlinks ? detail::status_impl(p, &err, basedir_fd) : detail::symlink_status_impl(p, &err, basedir_fd);
+#else
+        (void)basedir_fd;
+        return follow_symlinks ? detail::status(p, &err) : detail::symlink_status(p, &err);
+#endif
+    }
+
+    //! Records the error. Returns \c true if the error is ignored.
+    bool on_error(system::error_code const& err, path const& p)
+    {
+        if
+        (
+            // The file was removed, or it is not a directory
+            err == make_error_condition(system::errc::no_such_file_or_directory) ||
+            err == make_error_condition(system::errc::not_a_directory) ||
+            (
+                err == make_error_condition(system::errc::permission_denied) &&
+                (m_options & directory_options::skip_permission_denied) != directory_options::none
+            )
+        )
+        {
+            return true;
+        }
+
+        if (!m_first_error)
+        {
+            m_first_error = err;
+            m_error_path = p;
+        }
+
+        if ((m_options & directory_options::pop_on_error) == directory_options::none)
+            m_stop = true;
+
+        return false;
+    }
+
+    /*!
+     * Adds a directory whose entries should be matched against the pattern elements in \a states. \a rel is the path
+     * of the directory relative to \a parent_fd, if supported, or the current directory otherwise. \a dir_path is the path
+     * of the directory to report in the results.
+     */
+    void add_directory(int parent_fd, path const& rel, path const& dir_path, std::vector< boost::uint32_t >& states)
+    {
+        glob_pattern_imp const& pattern = m_pattern;
+        const std::size_t component_count = pattern.components.size();
+        while (!states.empty() && states.back() >= component_count)
+            states.pop_back();
+        if (states.empty())
+            return;
+
+        if (states.size() == 1u && pattern.components[states.front()].kind == glob_component::literal)
+        {
+            // Look up the literal names directly instead of scanning the directory
+            const std::size_t index = states.front();
+            glob_component const& component = pattern.components[index];
+            const bool last = (index + 1u) == component_count;
+            for (std::size_t i = 0u, n = component.names.size(); i < n && !m_stop; ++i)
+            {
+                path::string_type const& name = component.names[i];
+                path child_rel(rel);
+                detail::path_algorithms::append_v4(child_rel, name.c_str(), name.c_str() + name.size());
+                path child_path(dir_path);
+                detail::path_algorithms::append_v4(child_path, name.c_str(), name.c_str() + name.size());
+
+                system::error_code err;
+                const file_status st = get_status(parent_fd, child_rel, !last || pattern.directories_only, err);
+                if (!exists(st))
+                {
+                    if (st.type() != file_not_found && !!err)
+                        on_error(err, child_path);
+                    continue;
+                }
+
+                if (last)
+                {
+                    if (!pattern.directories_only || st.type() == directory_file)
+                        m_results.push_back(static_cast< path&& >(child_path));
+                }
+                else if (st.type() == directory_file)
+                {
+                    std::vector< boost::uint32_t > child_states;
+                    child_states.push_back(static_cast< boost::uint32_t >(index + 1u));
+                    pattern.close_states(child_states);
+                    add_directory(parent_fd, child_rel, child_path, child_states);
+                }
+            }
+
+            return;
+        }
+
+        glob_level level;
+        level.have_entry = true;
+        system::error_code err;
+#if defined(BOOST_FILESYSTEM_GLOB_USE_AT_APIS)
+        detail::directory_iterator_params params;
+        params.dir_fd = detail::openat_directory(parent_fd, rel, m_options, err);
+        if (!err)
+            err = detail::dir_itr_create(level.imp, rel, m_options, &params, level.filename, level.file_stat, level.symlink_file_stat);
+#else
+        (void)parent_fd;
+        err = detail::dir_itr_create(level.imp, rel, m_options, nullptr, level.filename, level.file_stat, level.symlink_file_stat);
+#endif
+        if (BOOST_UNLIKELY(!!err))
+        {
+            on_error(err, dir_path);
+            return;
+        }
+
+        level.dir_path = dir_path;
+        level.states.swap(states);
+        m_stack.push_back(static_cast< glob_level&& >(level));
+    }
+
+    //! Matches the current entry of the directory against the pattern
+    void process_entry(glob_level& level)
+    {
+        glob_pattern_imp const& pattern = m_pattern;
+        const std::size_t component_count = pattern.components.size();
+        path::value_type const* const name = level.filename.c_str();
+        const std::size_t name_size = level.filename.native().size();
+
+        bool matched = false;
+        m_next_states.clear();
+        m_recursive_states.clear();
+        for (std::size_t i = 0u, n = level.states.size(); i < n; ++i)
+        {
+            const boost::uint32_t index = level.states[i];
+            if (pattern.components[index].kind == glob_component::recursive)
+            {
+                if (pattern.match_recursive(name))
+                {
+                    m_recursive_states.push_back(index);
+                    // Trailing "**" matches everything in the subtree
+                    matched |= (index + 1u) == component_count;
+                }
+            }
+            else if (pattern.match_component(index, name, name_size))
+            {
+                if ((index + 1u) == component_count)
+                    matched = true;
+                else
+                    m_next_states.push_back(index + 1u);
+            }
+        }
+
+        if (!matched && m_next_states.empty() && m_recursive_states.empty())
+            return;
+
+        // Only now that the name has matched, find out whether the entry is a directory
+        bool is_dir = false;
+        if (!m_next_states.empty() || !m_recursive_states.empty() || pattern.directories_only)
+        {
+            system::error_code err;
+            int dir_fd = current_dir_fd;
+#if defined(BOOST_FILESYSTEM_GLOB_USE_AT_APIS)
+            path const& entry_rel = level.filename;
+            dir_fd = detail::dir_itr_fd(*level.imp, err);
+#else
+            path entry_rel(level.dir_path.empty() ? path(".") : level.dir_path);
+            detail::path_algorithms::append_v4(entry_rel, name, name + name_size);
+#endif
+
+            file_type symlink_ft = level.symlink_file_stat.type();
+            if (symlink_ft == status_error && !err)
+                symlink_ft = get_status(dir_fd, entry_rel, false, err).type();
+
+            file_type ft = symlink_ft;
+            if (symlink_ft == symlink_file)
+            {
+                // "**" only descends into directory symlinks if requested, but other elements, like in the shell, follow symlinks
+                if ((m_options & directory_options::follow_directory_symlink) == directory_options::none)
+                    m_recursive_states.clear();
+
+                if (!m_next_states.empty() || !m_recursive_states.empty() || pattern.directories_only)
+                {
+                    ft = get_status(dir_fd, entry_rel, true, err).type();
+                    if (ft == file_not_found) // dangling symlink
+                        err.clear();
+                }
+            }
+
+            if (BOOST_UNLIKELY(!!err))
+            {
+                path entry_path(level.dir_path);
+                detail::path_algorithms::append_v4(entry_path, name, name + name_size);
+                on_error(err, entry_path);
+                return;
+            }
+
+            is_dir = ft == directory_file;
+        }
+
+        path entry_path(level.dir_path);
+        detail::path_algorithms::append_v4(entry_path, name, name + name_size);
+
+        if (matched && (!pattern.directories_only || is_dir))
+            m_results.push_back(entry_path);
+
+        if (!is_dir || (m_next_states.empty() && m_recursive_states.empty()))
+            return;
+
+        std::vector< boost::uint32_t > states(m_next_states);
+        states.insert(states.end(), m_recursive_states.begin(), m_recursive_states.end());
+        pattern.close_states(states);
+
+#if defined(BOOST_FILESYSTEM_GLOB_USE_AT_APIS)
+        system::error_code err;
+        const int dir_fd = detail::dir_itr_fd(*level.imp, err);
+        if (BOOST_UNLIKELY(!!err))
+        {
+            on_error(err, level.dir_path);
+            return;
+        }
+
+        add_directory(dir_fd, level.filename, entry_path, states);
+#else
+        add_directory(current_dir_fd, entry_path, entry_path, states);
+#endif
+    }
+};
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+void glob(glob_pattern const& pattern, directory_options opts, std::vector< path >& results, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    results.clear();
+
+    if (BOOST_UNLIKELY(pattern.empty()))
+        return;
+
+    opts &= directory_options::follow_directory_symlink | directory_options::skip_permission_denied | directory_options::pop_on_error;
+
+    try
+    {
+        glob_walker walker(*pattern.m_imp, opts, results);
+        walker.run();
+
+        if (BOOST_UNLIKELY(!!walker.error()))
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::glob", walker.error_path(), walker.error()));
+
+            *ec = walker.error();
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        results.clear();
+
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+    }
+}
+
+} // namespace detail
+
 } // namespace filesystem
 } // namespace boost
 
@@ -0,0 +1,1265 @@
+//  directory_snapshot.cpp  -----------------------------------------------------------//
+
+//  Copyright 2026 Andrey Semashev
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/directory_snapshot.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/file_status.hpp>
+
+#include <cstddef>
+#include <cerrno>
+#include <cstring>
+#include <new> // std::bad_alloc
+#include <stdexcept> // std::length_error
+#include <limits>
+#include <vector>
+#include <algorithm> // std::sort, std::lower_bound
+#include <boost/assert.hpp>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#ifdef BOOST_FILESYSTEM_POSIX_API
+
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <boost/scope/unique_fd.hpp>
+#include "posix_tools.hpp"
+
+#else // BOOST_FILESYSTEM_POSIX_API
+
+#include <windows.h>
+#include "windows_tools.hpp"
+
+#endif // BOOST_FILESYSTEM_POSIX_API
+
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+namespace detail {
+
+namespace {
+
+//! Snapshot file signature
+BOOST_CONSTEXPR_OR_CONST char directory_snapshot_magic[8] = { 'B', 'F', 'S', 'S', 'N', 'A', 'P', '\0' };
+//! Current version of the snapshot file format
+BOOST_CONSTEXPR_OR_CONST boost::uint32_t directory_snapshot_version = 1u;
+BOOST_CONSTEXPR_OR_CONST boost::uint32_t directory_snapshot_byte_order = 0x01020304u;
+//! Value of the parent index that indicates no record
+BOOST_CONSTEXPR_OR_CONST boost::uint32_t directory_snapshot_no_record = ~static_cast< boost::uint32_t >(0u);
+
+//! The record is a directory whose contents were completely read
+BOOST_CONSTEXPR_OR_CONST boost::uint8_t directory_snapshot_record_listed = 1u;
+
+static_assert(sizeof(directory_snapshot_header) % 8u == 0u && sizeof(directory_snapshot_record) % 8u == 0u,
+    "Boost.Filesystem: directory snapshot header and record sizes must keep the records and the name table aligned");
+
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+BOOST_CONSTEXPR_OR_CONST err_t invalid_argument_error = EINVAL;
+BOOST_CONSTEXPR_OR_CONST err_t invalid_data_error = EINVAL;
+#else
+BOOST_CONSTEXPR_OR_CONST err_t invalid_argument_error = ERROR_INVALID_PARAMETER;
+BOOST_CONSTEXPR_OR_CONST err_t invalid_data_error = ERROR_INVALID_DATA;
+#endif
+
+//! Identity and modification times of a directory, which are used to detect changes in the directory contents
+struct directory_stamp
+{
+    boost::uint64_t inode;
+    boost::int64_t mtime;
+    boost::int64_t ctime;
+    boost::uint32_t mtime_nsec;
+    boost::uint32_t ctime_nsec;
+};
+
+inline bool stamp_matches(directory_snapshot_record const& rec, directory_stamp const& stamp) noexcept
+{
+    return rec.inode == stamp.inode && rec.mtime == stamp.mtime && rec.mtime_nsec == stamp.mtime_nsec &&
+        rec.ctime == stamp.ctime && rec.ctime_nsec == stamp.ctime_nsec;
+}
+
+//! Tests if the error code indicates that the file does not exist
+inline bool is_not_found_error(system::error_code const& err) noexcept
+{
+    return err == make_error_condition(system::errc::no_such_file_or_directory) ||
+        err == make_error_condition(system::errc::not_a_directory);
+}
+
+//! Attributes of the files that are obtained to refresh the records of the directories that did not change
+BOOST_CONSTEXPR_OR_CONST entry_attributes refreshed_file_attributes = entry_attributes::file_size | entry_attributes::last_write_time | entry_attributes::inode;
+
+//! Sets the attributes of the record to the ones obtained by following symlinks
+inline void set_refreshed_attributes(directory_snapshot_record& rec, file_status st, entry_attributes_cache const& attrs, system::error_code const& err) noexcept
+{
+    rec.file_size = 0u;
+    rec.mtime = 0;
+    rec.inode = 0u;
+    if (BOOST_UNLIKELY(!!err))
+    {
+        rec.type = static_cast< boost::uint8_t >(is_not_found_error(err) ? file_not_found : status_error);
+        return;
+    }
+
+    rec.type = static_cast< boost::uint8_t >(st.type());
+    if (st.type() == regular_file)
+        rec.file_size = attrs.file_size;
+    rec.mtime = static_cast< boost::int64_t >(attrs.last_write_time);
+    rec.inode = attrs.inode;
+}
+
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+
+#if defined(BOOST_FILESYSTEM_HAS_STAT_ST_MTIM)
+#define BOOST_FILESYSTEM_STAT_ST_MTIMENSEC st_mtim.tv_nsec
+#define BOOST_FILESYSTEM_STAT_ST_CTIMENSEC st_ctim.tv_nsec
+#elif defined(BOOST_FILESYSTEM_HAS_STAT_ST_MTIMESPEC)
+#define BOOST_FILESYSTEM_STAT_ST_MTIMENSEC st_mtimespec.tv_nsec
+#define BOOST_FILESYSTEM_STAT_ST_CTIMENSEC st_ctimespec.tv_nsec
+#elif defined(BOOST_FILESYSTEM_HAS_STAT_ST_MTIMENSEC)
+#define BOOST_FILESYSTEM_STAT_ST_MTIMENSEC st_mtimensec
+#define BOOST_FILESYSTEM_STAT_ST_CTIMENSEC st_ctimensec
+#endif
+
+//! Obtains the stamp of the open directory. Returns 0 on success or a system error code.
+err_t get_directory_stamp(int fd, directory_stamp& stamp) noexcept
+{
+    struct ::stat dir_stat;
+    if (BOOST_UNLIKELY(::fstat(fd, &dir_stat) != 0))
+        return errno;
+
+    if (!S_ISDIR(dir_stat.st_mode))
+        return ENOTDIR;
+
+    stamp.inode = static_cast< boost::uint64_t >(dir_stat.st_ino);
+    stamp.mtime = static_cast< boost::int64_t >(dir_stat.st_mtime);
+    stamp.ctime = static_cast< boost::int64_t >(dir_stat.st_ctime);
+#if defined(BOOST_FILESYSTEM_STAT_ST_MTIMENSEC)
+    stamp.mtime_nsec = static_cast< boost::uint32_t >(dir_stat.BOOST_FILESYSTEM_STAT_ST_MTIMENSEC);
+    stamp.ctime_nsec = static_cast< boost::uint32_t >(dir_stat.BOOST_FILESYSTEM_STAT_ST_CTIMENSEC);
+#else
+    stamp.mtime_nsec = 0u;
+    stamp.ctime_nsec = 0u;
+#endif
+
+    return 0;
+}
+
+/*!
+ * \brief A directory that is opened to obtain its stamp and then list its contents
+ *
+ * The stamp is obtained from the open directory before its contents are read, so that it corresponds to the listed directory,
+ * and any changes made to the directory while it is being read result in a different stamp on the next scan.
+ */
+class stamped_directory
+{
+private:
+    boost::scope::unique_fd m_fd;
+
+public:
+    //! Opens the directory and obtains its stamp. Returns 0 on success or a system error code.
+    err_t open(path const& p, directory_stamp& stamp) noexcept
+    {
+        system::error_code ec;
+        m_fd = open_directory(p, directory_options::none, ec);
+        if (BOOST_UNLIKELY(!!ec))
+            return ec.value();
+
+        return get_directory_stamp(m_fd.get(), stamp);
+    }
+
+    //! Constructs the iterator over the contents of the open directory
+    void iterate(directory_iterator& it, path const& p, directory_options opts, system::error_code& ec)
+    {
+#if defined(BOOST_FILESYSTEM_HAS_FDOPENDIR_NOFOLLOW)
+        directory_iterator_params params{ static_cast< boost::scope::unique_fd&& >(m_fd) };
+        directory_iterator_construct(it, p, opts, &params, &ec);
+#else
+        m_fd.reset();
+        directory_iterator_construct(it, p, opts, nullptr, &ec);
+#endif
+    }
+
+    //! Obtains the current attributes of an entry of the open directory, following symlinks, and updates its record. Must be called before \c iterate.
+    void refresh(path const& dir_path, path const& name, directory_snapshot_record& rec) const
+    {
+        entry_attributes_cache attrs;
+        file_status st;
+        system::error_code err;
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+        (void)dir_path;
+        entry_attributes_impl(name, refreshed_file_attributes, attrs, st, &err, m_fd.get());
+#else
+        entry_attributes_impl(dir_path / name, refreshed_file_attributes, attrs, st, &err);
+#endif
+        set_refreshed_attributes(rec, st, attrs, err);
+    }
+};
+
+#else // defined(BOOST_FILESYSTEM_POSIX_API)
+
+//! Converts FILETIME to seconds and nanoseconds since the POSIX epoch
+inline void filetime_to_stamp(FILETIME const& ft, boost::int64_t& sec, boost::uint32_t& nsec) noexcept
+{
+    const boost::int64_t ticks = static_cast< boost::int64_t >((static_cast< boost::uint64_t >(ft.dwHighDateTime) << 32u) | ft.dwLowDateTime) -
+        static_cast< boost::int64_t >(116444736000000000ll);
+    boost::int64_t q = ticks / 10000000, r = ticks % 10000000;
+    if (r < 0)
+    {
+        --q;
+        r += 10000000;
+    }
+
+    sec = q;
+    nsec = static_cast< boost::uint32_t >(r * 100);
+}
+
+//! Obtains the stamp of the open directory. Returns 0 on success or a system error code.
+err_t get_directory_stamp(HANDLE h, directory_stamp& stamp) noexcept
+{
+    BY_HANDLE_FILE_INFORMATION info;
+    if (BOOST_UNLIKELY(!::GetFileInformationByHandle(h, &info)))
+        return ::GetLastError();
+
+    if ((info.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0u)
+        return ERROR_DIRECTORY;
+
+    // The status change time is not provided by GetFileInformationByHandle, only the last write time is used to detect changes
+    stamp.inode = (static_cast< boost::uint64_t >(info.nFileIndexHigh) << 32u) | info.nFileIndexLow;
+    filetime_to_stamp(info.ftLastWriteTime, stamp.mtime, stamp.mtime_nsec);
+    stamp.ctime = 0;
+    stamp.ctime_nsec = 0u;
+
+    return 0;
+}
+
+/*!
+ * \brief A directory that is opened to obtain its stamp and then list its contents
+ *
+ * The stamp is obtained from the open directory before its contents are read, so that it corresponds to the listed directory,
+ * and any changes made to the directory while it is being read result in a different stamp on the next scan.
+ */
+class stamped_directory
+{
+private:
+    unique_handle m_handle;
+
+public:
+    //! Opens the directory and obtains its stamp. Returns 0 on success or a system error code.
+    err_t open(path const& p, directory_stamp& stamp) noexcept
+    {
+        m_handle = create_file_handle(
+            p,
+            FILE_LIST_DIRECTORY | FILE_READ_ATTRIBUTES,
+            FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+            nullptr,
+            OPEN_EXISTING,
+            FILE_FLAG_BACKUP_SEMANTICS);
+        if (BOOST_UNLIKELY(!m_handle))
+            return ::GetLastError();
+
+        return get_directory_stamp(m_handle.get(), stamp);
+    }
+
+    //! Constructs the iterator over the contents of the open directory. The object must outlive the iterator.
+    void iterate(directory_iterator& it, path const& p, directory_options opts, system::error_code& ec)
+    {
+        directory_iterator_params params{ m_handle.get(), false };
+        directory_iterator_construct(it, p, opts, &params, &ec);
+    }
+
+    //! Obtains the current attributes of an entry of the open directory, following symlinks, and updates its record
+    void refresh(path const& dir_path, path const& name, directory_snapshot_record& rec) const
+    {
+        entry_attributes_cache attrs;
+        file_status st;
+        system::error_code err;
+        directory_entry entry(dir_path / name, err);
+        if (BOOST_LIKELY(!err))
+        {
+            entry.refresh(refreshed_file_attributes, err);
+            if (BOOST_LIKELY(!err))
+            {
+                st = entry.status(err);
+                if (st.type() == regular_file)
+                    attrs.file_size = entry.file_size(err);
+                if (BOOST_LIKELY(!err))
+                {
+                    attrs.last_write_time = entry.last_write_time(err);
+                    attrs.inode = entry.inode(err);
+                }
+            }
+        }
+
+        set_refreshed_attributes(rec, st, attrs, err);
+    }
+};
+
+#endif // defined(BOOST_FILESYSTEM_POSIX_API)
+
+//! A directory that is waiting to be listed or copied from the previous snapshot
+struct directory_snapshot_pending
+{
+    boost::uint32_t index;
+    //! Index of the directory record in the previous snapshot, or directory_snapshot_no_record
+    boost::uint32_t previous_index;
+};
+
+//! Snapshot that is being built
+class directory_snapshot_builder
+{
+private:
+    std::vector< directory_snapshot_record > m_records;
+    std::vector< path::value_type > m_names;
+
+public:
+    std::vector< directory_snapshot_record >& records() noexcept { return m_records; }
+
+    //! Appends a record with the given name and returns its index
+    std::size_t append(path::value_type const* name, std::size_t name_size, boost::uint32_t parent)
+    {
+        if (BOOST_UNLIKELY(m_records.size() >= static_cast< std::size_t >(directory_snapshot_no_record) ||
+            name_size > static_cast< std::size_t >((std::numeric_limits< boost::uint32_t >::max)())))
+        {
+            BOOST_FILESYSTEM_THROW(std::length_error("boost::filesystem::directory_snapshot: too many entries or too long file name"));
+        }
+
+        directory_snapshot_record rec;
+        std::memset(&rec, 0, sizeof(rec));
+        rec.name_offset = m_names.size();
+        rec.name_size = static_cast< boost::uint32_t >(name_size);
+        rec.parent = parent;
+        rec.type = static_cast< boost::uint8_t >(status_error);
+        rec.symlink_type = static_cast< boost::uint8_t >(status_error);
+
+        m_names.insert(m_names.end(), name, name + name_size);
+        m_names.push_back(static_cast< path::value_type >('\0'));
+        m_records.push_back(rec);
+
+        return m_records.size() - 1u;
+    }
+
+    //! Returns the path of the directory record
+    path build_path(std::size_t index) const
+    {
+        std::vector< std::size_t > chain;
+        std::size_t size = 0u;
+        while (true)
+        {
+            chain.push_back(index);
+            size += m_records[index].name_size + 1u;
+            if (index == 0u)
+                break;
+            index = m_records[index].parent;
+        }
+
+        path::string_type str;
+        str.reserve(size);
+        path p(static_cast< path::string_type&& >(str));
+        for (std::size_t i = chain.size(); i > 0u;)
+        {
+            --i;
+            directory_snapshot_record const& rec = m_records[chain[i]];
+            path::value_type const* name = m_names.data() + rec.name_offset;
+            path_algorithms::append_v4(p, name, name + rec.name_size);
+        }
+
+        return p;
+    }
+
+    //! Serializes the snapshot to the storage buffer
+    void finish(std::vector< unsigned char >& buffer, directory_options opts) const
+    {
+        directory_snapshot_header header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, directory_snapshot_magic, sizeof(header.magic));
+        header.version = directory_snapshot_version;
+        header.byte_order = directory_snapshot_byte_order;
+        header.char_size = static_cast< boost::uint32_t >(sizeof(path::value_type));
+        header.record_size = static_cast< boost::uint32_t >(sizeof(directory_snapshot_record));
+        header.options = static_cast< boost::uint32_t >(opts);
+        header.record_count = m_records.size();
+        header.name_table_size = m_names.size();
+
+        const std::size_t records_size = m_records.size() * sizeof(directory_snapshot_record);
+        const std::size_t names_size = m_names.size() * sizeof(path::value_type);
+        buffer.resize(sizeof(header) + records_size + names_size);
+        unsigned char* p = buffer.data();
+        std::memcpy(p, &header, sizeof(header));
+        p += sizeof(header);
+        std::memcpy(p, m_records.data(), records_size);
+        p += records_size;
+        std::memcpy(p, m_names.data(), names_size);
+    }
+};
+
+//! Lexicographically compares two file names
+inline int compare_names(path::value_type const* left, std::size_t left_size, path::value_type const* right, std::size_t right_size) noexcept
+{
+    const std::size_t n = left_size < right_size ? left_size : right_size;
+    int res = path::string_type::traits_type::compare(left, right, n);
+    if (res == 0)
+        res = left_size < right_size ? -1 : (left_size > right_size ? 1 : 0);
+    return res;
+}
+
+//! Orders record indices of a snapshot by the file names of the records
+struct directory_snapshot_name_order
+{
+    directory_snapshot_record const* records;
+    path::value_type const* names;
+
+    int compare(boost::uint32_t index, path::value_type const* name, std::size_t name_size) const noexcept
+    {
+        directory_snapshot_record const& rec = records[index];
+        return compare_names(names + rec.name_offset, rec.name_size, name, name_size);
+    }
+
+    bool operator()(boost::uint32_t left, boost::uint32_t right) const noexcept
+    {
+        directory_snapshot_record const& rec = records[right];
+        return compare(left, names + rec.name_offset, rec.name_size) < 0;
+    }
+};
+
+//! Tests if the snapshot entry is a directory that needs to be recursed into
+inline bool is_directory_to_recurse(directory_snapshot_record const& rec, directory_options opts) noexcept
+{
+    if (rec.type != static_cast< boost::uint8_t >(directory_file))
+        return false;
+
+    return rec.symlink_type != static_cast< boost::uint8_t >(symlink_file) ||
+        (opts & directory_options::follow_directory_symlink) != directory_options::none;
+}
+
+//! A pair of matching directories in the compared snapshots
+struct directory_snapshot_diff_level
+{
+    boost::uint32_t old_index;
+    boost::uint32_t new_index;
+};
+
+//! Tests if the entries have the same file type
+inline bool same_file_type(directory_snapshot_record const& left, directory_snapshot_record const& right) noexcept
+{
+    return left.type == right.type && left.symlink_type == right.symlink_type;
+}
+
+//! Tests if the attributes of the entries differ
+inline bool file_attributes_differ(directory_snapshot_record const& left, directory_snapshot_record const& right) noexcept
+{
+    return left.file_size != right.file_size || left.mtime != right.mtime || left.mtime_nsec != right.mtime_nsec || left.inode != right.inode;
+}
+
+//! Reports the error to the caller
+inline void report_error(system::error_code const& err, path const& p, system::error_code* ec, const char* message)
+{
+    if (!ec)
+        BOOST_FILESYSTEM_THROW(filesystem_error(message, p, err));
+
+    *ec = err;
+}
+
+} // namespace
+
+BOOST_FILESYSTEM_DECL
+void diff(directory_snapshot const& from, directory_snapshot const& to, snapshot_diff_visitor_t* visitor, void* context)
+{
+    directory_snapshot_record const* const old_records = from.m_records;
+    directory_snapshot_record const* const new_records = to.m_records;
+    if (!old_records && !new_records)
+        return;
+
+    // Reports the entry and all entries in its subtree as added or removed
+    std::vector< boost::uint32_t > subtree;
+    auto report_subtree = [&subtree, visitor, context](directory_snapshot const& snapshot, boost::uint32_t index, snapshot_change change)
+    {
+        directory_snapshot_record const* const records = snapshot.m_records;
+        subtree.clear();
+        subtree.push_back(index);
+        while (!subtree.empty())
+        {
+            const boost::uint32_t i = subtree.back();
+            subtree.pop_back();
+
+            const directory_snapshot_entry entry(&snapshot, i);
+            if (change == snapshot_change::added)
+                visitor(context, change, nullptr, &entry);
+            else
+                visitor(context, change, &entry, nullptr);
+
+            directory_snapshot_record const& rec = records[i];
+            for (boost::uint32_t j = rec.first_child + rec.child_count; j > rec.first_child;)
+                subtree.push_back(--j);
+        }
+    };
+
+    // Compares the entries that are present in both snapshots
+    std::vector< directory_snapshot_diff_level > stack;
+    auto compare_entries = [&](boost::uint32_t old_index, boost::uint32_t new_index)
+    {
+        directory_snapshot_record const& old_rec = old_records[old_index];
+        directory_snapshot_record const& new_rec = new_records[new_index];
+        if (!same_file_type(old_rec, new_rec))
+        {
+            const directory_snapshot_entry old_entry(&from, old_index), new_entry(&to, new_index);
+            visitor(context, snapshot_change::type_changed, &old_entry, &new_entry);
+            for (boost::uint32_t i = old_rec.first_child, n = i + old_rec.child_count; i < n; ++i)
+                report_subtree(from, i, snapshot_change::removed);
+            for (boost::uint32_t i = new_rec.first_child, n = i + new_rec.child_count; i < n; ++i)
+                report_subtree(to, i, snapshot_change::added);
+            return;
+        }
+
+        if (old_rec.child_count > 0u || new_rec.child_count > 0u)
+        {
+            directory_snapshot_diff_level level = { old_index, new_index };
+            stack.push_back(level);
+        }
+        else if (old_rec.type != static_cast< boost::uint8_t >(directory_file) && file_attributes_differ(old_rec, new_rec))
+        {
+            const directory_snapshot_entry old_entry(&from, old_index), new_entry(&to, new_index);
+            visitor(context, snapshot_change::modified, &old_entry, &new_entry);
+        }
+    };
+
+    if (!old_records)
+    {
+        for (boost::uint32_t i = new_records[0].first_child, n = i + new_records[0].child_count; i < n; ++i)
+            report_subtree(to, i, snapshot_change::added);
+        return;
+    }
+
+    if (!new_records)
+    {
+        for (boost::uint32_t i = old_records[0].first_child, n = i + old_records[0].child_count; i < n; ++i)
+            report_subtree(from, i, snapshot_change::removed);
+        return;
+    }
+
+    const directory_snapshot_name_order old_order = { old_records, from.m_names };
+    const directory_snapshot_name_order new_order = { new_records, to.m_names };
+    std::vector< boost::uint32_t > old_children, new_children;
+
+    directory_snapshot_diff_level root = { 0u, 0u };
+    stack.push_back(root);
+    while (!stack.empty())
+    {
+        const directory_snapshot_diff_level level = stack.back();
+        stack.pop_back();
+
+        directory_snapshot_record const& old_dir = old_records[level.old_index];
+        directory_snapshot_record const& new_dir = new_records[level.new_index];
+
+        // If the directory did not change, its entries are likely stored in the same order in both snapshots,
+        // which allows to match them without sorting
+        if (old_dir.child_count == new_dir.child_count && stamp_matches(old_dir, directory_stamp{ new_dir.inode, new_dir.mtime, new_dir.ctime, new_dir.mtime_nsec, new_dir.ctime_nsec }))
+        {
+            boost::uint32_t i = 0u;
+            for (; i < old_dir.child_count; ++i)
+            {
+                directory_snapshot_record const& old_rec = old_records[old_dir.first_child + i];
+                directory_snapshot_record const& new_rec = new_records[new_dir.first_child + i];
+                if (compare_names(from.m_names + old_rec.name_offset, old_rec.name_size, to.m_names + new_rec.name_offset, new_rec.name_size) != 0)
+                    break;
+            }
+
+            if (i == old_dir.child_count)
+            {
+                for (i = 0u; i < old_dir.child_count; ++i)
+                    compare_entries(old_dir.first_child + i, new_dir.first_child + i);
+                continue;
+            }
+        }
+
+        // Merge the sorted lists of entries of the directory
+        old_children.clear();
+        for (boost::uint32_t i = old_dir.first_child, n = i + old_dir.child_count; i < n; ++i)
+            old_children.push_back(i);
+        std::sort(old_children.begin(), old_children.end(), old_order);
+
+        new_children.clear();
+        for (boost::uint32_t i = new_dir.first_child, n = i + new_dir.child_count; i < n; ++i)
+            new_children.push_back(i);
+        std::sort(new_children.begin(), new_children.end(), new_order);
+
+        std::size_t old_pos = 0u, new_pos = 0u;
+        while (old_pos < old_children.size() || new_pos < new_children.size())
+        {
+            int res;
+            if (old_pos == old_children.size())
+            {
+                res = 1;
+            }
+            else if (new_pos == new_children.size())
+            {
+                res = -1;
+            }
+            else
+            {
+                directory_snapshot_record const& new_rec = new_records[new_children[new_pos]];
+                res = old_order.compare(old_children[old_pos], to.m_names + new_rec.name_offset, new_rec.name_size);
+            }
+
+            if (res < 0)
+                report_subtree(from, old_children[old_pos++], snapshot_change::removed);
+            else if (res > 0)
+                report_subtree(to, new_children[new_pos++], snapshot_change::added);
+            else
+                compare_entries(old_children[old_pos++], new_children[new_pos++]);
+        }
+    }
+}
+
+} // namespace detail
+
+BOOST_FILESYSTEM_DECL
+void directory_snapshot::clear() noexcept
+{
+    if (m_mapping)
+    {
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+        ::munmap(m_mapping, m_mapping_size);
+#else
+        ::UnmapViewOfFile(m_mapping);
+#endif
+        m_mapping = nullptr;
+        m_mapping_size = 0u;
+    }
+
+    m_buffer.clear();
+    m_root.clear();
+    m_header = nullptr;
+    m_records = nullptr;
+    m_names = nullptr;
+    m_listed_directory_count = 0u;
+}
+
+BOOST_FILESYSTEM_DECL
+path directory_snapshot::build_path(path const& base, std::size_t index) const
+{
+    std::vector< std::size_t > chain;
+    std::size_t size = base.native().size();
+    for (; index != 0u; index = m_records[index].parent)
+    {
+        chain.push_back(index);
+        size += m_records[index].name_size + 1u;
+    }
+
+    path::string_type str;
+    str.reserve(size);
+    str.assign(base.native());
+    path p(static_cast< path::string_type&& >(str));
+    for (std::size_t i = chain.size(); i > 0u;)
+    {
+        --i;
+        detail::directory_snapshot_record const& rec = m_records[chain[i]];
+        path::value_type const* name = m_names + rec.name_offset;
+        detail::path_algorithms::append_v4(p, name, name + rec.name_size);
+    }
+
+    return p;
+}
+
+BOOST_FILESYSTEM_DECL
+void directory_snapshot::build_impl(path const& root, directory_options opts, directory_snapshot const* previous, snapshot_rescan_options rescan_opts, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    // Take a copy of the root path as it may refer to the previous snapshot, which may be this object
+    path root_path(root);
+    clear();
+
+    if (BOOST_UNLIKELY(root_path.empty()))
+    {
+        emit_error(BOOST_ERROR_FILE_NOT_FOUND, root_path, ec, "boost::filesystem::directory_snapshot");
+        return;
+    }
+
+    opts &= ~(directory_options::_detail_no_follow | directory_options::_detail_no_push | directory_options::cache_entry_attributes |
+        directory_options::inode_ordered_attributes | directory_options::prefetch_attributes);
+
+    const directory_options iterator_opts = (opts & directory_options::skip_permission_denied) | directory_options::cache_entry_attributes;
+
+    try
+    {
+        detail::directory_snapshot_builder builder;
+        std::vector< detail::directory_snapshot_record >& records = builder.records();
+        std::vector< detail::directory_snapshot_pending > pending;
+        std::vector< boost::uint32_t > previous_children;
+        size_type listed_count = 0u;
+
+        system::error_code first_error;
+        path error_path;
+
+        {
+            path::string_type const& root_str = root_path.native();
+            builder.append(root_str.c_str(), root_str.size(), 0u);
+            records[0].type = static_cast< boost::uint8_t >(directory_file);
+
+            detail::directory_snapshot_pending root_dir = { 0u, previous && previous->m_records ? 0u : detail::directory_snapshot_no_record };
+            pending.push_back(root_dir);
+        }
+
+        for (std::size_t pos = 0u; pos < pending.size(); ++pos)
+        {
+            const detail::directory_snapshot_pending dir = pending[pos];
+            path dir_path(pos == 0u ? root_path : builder.build_path(dir.index));
+
+            detail::directory_stamp stamp = {};
+            detail::stamped_directory stamped_dir;
+            const err_t stamp_err = stamped_dir.open(dir_path, stamp);
+            if (BOOST_UNLIKELY(stamp_err != 0))
+            {
+                system::error_code err(stamp_err, system::system_category());
+                // The directory may have been removed since its parent was read
+                if (pos > 0u && detail::is_not_found_error(err))
+                    continue;
+
+                if (err == make_error_condition(system::errc::permission_denied) &&
+                    (opts & directory_options::skip_permission_denied) != directory_options::none)
+                {
+                    // Record the directory as empty, as directory_iterator would present it
+                    ++listed_count;
+                    detail::directory_snapshot_record& rec = records[dir.index];
+                    rec.first_child = static_cast< boost::uint32_t >(records.size());
+                    rec.flags |= detail::directory_snapshot_record_listed;
+                    continue;
+                }
+
+                if (pos == 0u)
+                {
+                    detail::report_error(err, root_path, ec, "boost::filesystem::directory_snapshot");
+                    return;
+                }
+
+                if (!first_error)
+                {
+                    first_error = err;
+                    error_path = dir_path;
+                }
+
+                if ((opts & directory_options::pop_on_error) == directory_options::none)
+                    break;
+
+                continue;
+            }
+
+            {
+                detail::directory_snapshot_record& rec = records[dir.index];
+                rec.inode = stamp.inode;
+                rec.mtime = stamp.mtime;
+                rec.mtime_nsec = stamp.mtime_nsec;
+                rec.ctime = stamp.ctime;
+                rec.ctime_nsec = stamp.ctime_nsec;
+            }
+
+            const std::size_t first_child = records.size();
+
+            detail::directory_snapshot_record const* previous_rec = nullptr;
+            if (dir.previous_index != detail::directory_snapshot_no_record)
+            {
+                previous_rec = &previous->m_records[dir.previous_index];
+                if ((previous_rec->flags & detail::directory_snapshot_record_listed) == 0u)
+                    previous_rec = nullptr;
+            }
+
+            if (previous_rec && detail::stamp_matches(*previous_rec, stamp))
+            {
+                // The directory contents did not change, copy them from the previous snapshot
+                for (boost::uint32_t i = previous_rec->first_child, n = i + previous_rec->child_count; i < n; ++i)
+                {
+                    detail::directory_snapshot_record const& previous_child = previous->m_records[i];
+                    const std::size_t index = builder.append(previous->m_names + previous_child.name_offset, previous_child.name_size, dir.index);
+                    detail::directory_snapshot_record& child = records[index];
+                    child.file_size = previous_child.file_size;
+                    child.inode = previous_child.inode;
+                    child.mtime = previous_child.mtime;
+                    child.mtime_nsec = previous_child.mtime_nsec;
+                    child.type = previous_child.type;
+                    child.symlink_type = previous_child.symlink_type;
+
+                    // Modifying a file does not change the stamp of its directory, so the attributes of the files may be outdated
+                    if ((rescan_opts & snapshot_rescan_options::refresh_file_attributes) != snapshot_rescan_options::none &&
+                        child.symlink_type != static_cast< boost::uint8_t >(directory_file))
+                    {
+                        stamped_dir.refresh(dir_path, path(previous->m_names + previous_child.name_offset, previous->m_names + previous_child.name_offset + previous_child.name_size), child);
+                    }
+
+                    if (detail::is_directory_to_recurse(child, opts))
+                    {
+                        detail::directory_snapshot_pending subdir = { static_cast< boost::uint32_t >(index), i };
+                        pending.push_back(subdir);
+                    }
+                }
+            }
+            else
+            {
+                ++listed_count;
+
+                system::error_code err;
+                directory_iterator it;
+                stamped_dir.iterate(it, dir_path, iterator_opts, err);
+                if (BOOST_UNLIKELY(!!err))
+                {
+                    if (pos > 0u && detail::is_not_found_error(err))
+                        continue;
+
+                    if (pos == 0u)
+                    {
+                        detail::report_error(err, root_path, ec, "boost::filesystem::directory_snapshot");
+                        return;
+                    }
+
+                    if (!first_error)
+                    {
+                        first_error = err;
+                        error_path = dir_path;
+                    }
+
+                    if ((opts & directory_options::pop_on_error) == directory_options::none)
+                        break;
+
+                    continue;
+                }
+
+                // Sort the entries of the previous version of the directory by name to match subdirectories
+                previous_children.clear();
+                detail::directory_snapshot_name_order name_order = { nullptr, nullptr };
+                if (previous_rec)
+                {
+                    name_order.records = previous->m_records;
+                    name_order.names = previous->m_names;
+                    for (boost::uint32_t i = previous_rec->first_child, n = i + previous_rec->child_count; i < n; ++i)
+                    {
+                        if (detail::is_directory_to_recurse(previous->m_records[i], opts))
+                            previous_children.push_back(i);
+                    }
+                    std::sort(previous_children.begin(), previous_children.end(), name_order);
+                }
+
+                for (directory_iterator end; it != end;)
+                {
+                    directory_entry const& entry = *it;
+                    path::string_type const& entry_path = entry.path().native();
+                    const std::size_t name_size = detail::path_algorithms::find_filename_v4_size(entry.path());
+                    path::value_type const* const name = entry_path.c_str() + entry_path.size() - name_size;
+                    const std::size_t index = builder.append(name, name_size, dir.index);
+
+                    system::error_code attr_ec;
+                    const file_status symlink_st = entry.symlink_status(attr_ec);
+                    const file_status st = entry.status(attr_ec);
+                    detail::directory_snapshot_record& rec = records[index];
+                    rec.type = static_cast< boost::uint8_t >(st.type());
+                    rec.symlink_type = static_cast< boost::uint8_t >(symlink_st.type());
+                    if (st.type() == regular_file)
+                        rec.file_size = entry.file_size(attr_ec);
+                    if (!attr_ec)
+                    {
+                        const std::time_t mtime = entry.last_write_time(attr_ec);
+                        const boost::uintmax_t inode = entry.inode(attr_ec);
+                        if (!attr_ec)
+                        {
+                            rec.mtime = static_cast< boost::int64_t >(mtime);
+                            rec.inode = inode;
+                        }
+                    }
+
+                    if (detail::is_directory_to_recurse(rec, opts))
+                    {
+                        detail::directory_snapshot_pending subdir = { static_cast< boost::uint32_t >(index), detail::directory_snapshot_no_record };
+                        if (!previous_children.empty())
+                        {
+                            std::vector< boost::uint32_t >::const_iterator prev_it = std::lower_bound
+                            (
+                                previous_children.begin(),
+                                previous_children.end(),
+                                static_cast< boost::uint32_t >(index),
+                                [&name_order, name, name_size](boost::uint32_t left, boost::uint32_t) noexcept
+                                {
+                                    return name_order.compare(left, name, name_size) < 0;
+                                }
+                            );
+
+                            if (prev_it != previous_children.end() && name_order.compare(*prev_it, name, name_size) == 0)
+                                subdir.previous_index = *prev_it;
+                        }
+
+                        pending.push_back(subdir);
+                    }
+
+                    it.increment(err);
+                    if (BOOST_UNLIKELY(!!err))
+                        break;
+                }
+
+                if (BOOST_UNLIKELY(!!err))
+                {
+                    if (!first_error)
+                    {
+                        first_error = err;
+                        error_path = dir_path;
+                    }
+
+                    if ((opts & directory_options::pop_on_error) == directory_options::none)
+                        break;
+
+                    // Keep the entries that were read, but don't mark the directory as listed so that it is read again on rescan
+                    detail::directory_snapshot_record& rec = records[dir.index];
+                    rec.first_child = static_cast< boost::uint32_t >(first_child);
+                    rec.child_count = static_cast< boost::uint32_t >(records.size() - first_child);
+                    continue;
+                }
+            }
+
+            detail::directory_snapshot_record& rec = records[dir.index];
+            rec.first_child = static_cast< boost::uint32_t >(first_child);
+            rec.child_count = static_cast< boost::uint32_t >(records.size() - first_child);
+            rec.flags |= detail::directory_snapshot_record_listed;
+        }
+
+        builder.finish(m_buffer, opts);
+        m_root = static_cast< path&& >(root_path);
+        m_header = reinterpret_cast< detail::directory_snapshot_header const* >(m_buffer.data());
+        m_records = reinterpret_cast< detail::directory_snapshot_record const* >(m_buffer.data() + sizeof(detail::directory_snapshot_header));
+        m_names = reinterpret_cast< path::value_type const* >(m_records + m_header->record_count);
+        m_listed_directory_count = listed_count;
+
+        if (BOOST_UNLIKELY(!!first_error))
+            detail::report_error(first_error, error_path, ec, "boost::filesystem::directory_snapshot");
+    }
+    catch (std::bad_alloc&)
+    {
+        clear();
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+    }
+    catch (std::length_error&)
+    {
+        clear();
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::value_too_large);
+    }
+}
+
+BOOST_FILESYSTEM_DECL
+void directory_snapshot::save_impl(path const& file, system::error_code* ec) const
+{
+    if (ec)
+        ec->clear();
+
+    unsigned char const* data = static_cast< unsigned char const* >(m_mapping ? m_mapping : static_cast< void const* >(m_buffer.data()));
+    std::size_t size = m_mapping ? m_mapping_size : m_buffer.size();
+    if (BOOST_UNLIKELY(size == 0u))
+    {
+        emit_error(detail::invalid_argument_error, file, ec, "boost::filesystem::directory_snapshot::save: the snapshot is empty");
+        return;
+    }
+
+    // Write the snapshot to a temporary file and then replace the target file with it, so that the file is never left
+    // partially written and the processes that have the previous version of the file mapped are not affected
+    path temp_file;
+    try
+    {
+        system::error_code err;
+        const path suffix(detail::unique_path(path(".%%%%-%%%%-%%%%-%%%%.tmp"), &err));
+        if (BOOST_UNLIKELY(!!err))
+        {
+            detail::report_error(err, file, ec, "boost::filesystem::directory_snapshot::save");
+            return;
+        }
+
+        temp_file = file;
+        temp_file += suffix.native();
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return;
+    }
+
+    err_t err = 0;
+
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+
+    boost::scope::unique_fd fd;
+    while (true)
+    {
+        fd.reset(::open(temp_file.c_str(), O_WRONLY | O_CREAT | O_EXCL | O_CLOEXEC, S_IRUSR | S_IWUSR | S_IRGRP | S_IWGRP | S_IROTH | S_IWOTH));
+        if (BOOST_LIKELY(fd.get() >= 0))
+            break;
+
+        err = errno;
+        if (err != EINTR)
+        {
+            emit_error(err, temp_file, ec, "boost::filesystem::directory_snapshot::save");
+            return;
+        }
+    }
+
+    // Preserve the permissions of the file being replaced. This is not essential for the snapshot, so errors are ignored.
+    struct ::stat file_stat;
+    if (::stat(file.c_str(), &file_stat) == 0 && S_ISREG(file_stat.st_mode))
+        ::fchmod(fd.get(), file_stat.st_mode & (S_IRWXU | S_IRWXG | S_IRWXO));
+
+    while (size > 0u)
+    {
+        const ssize_t written = ::write(fd.get(), data, size);
+        if (BOOST_UNLIKELY(written < 0))
+        {
+            err = errno;
+            if (err == EINTR)
+                continue;
+
+            goto fail;
+        }
+
+        data += written;
+        size -= static_cast< std::size_t >(written);
+    }
+
+    while (::fsync(fd.get()) != 0)
+    {
+        err = errno;
+        if (err != EINTR)
+            goto fail;
+    }
+
+    if (BOOST_UNLIKELY(::close(fd.release()) != 0))
+    {
+        err = errno;
+        if (err != EINTR)
+            goto fail;
+    }
+
+#else // defined(BOOST_FILESYSTEM_POSIX_API)
+
+    {
+        detail::unique_handle h(detail::create_file_handle(temp_file, GENERIC_WRITE, 0u, nullptr, CREATE_NEW, FILE_ATTRIBUTE_NORMAL));
+        if (BOOST_UNLIKELY(!h))
+        {
+            emit_error(::GetLastError(), temp_file, ec, "boost::filesystem::directory_snapshot::save");
+            return;
+        }
+
+        while (size > 0u)
+        {
+            const DWORD chunk = size > 0x40000000u ? static_cast< DWORD >(0x40000000u) : static_cast< DWORD >(size);
+            DWORD written = 0u;
+            if (BOOST_UNLIKELY(!::WriteFile(h.get(), data, chunk, &written, nullptr)))
+            {
+                err = ::GetLastError();
+                goto fail;
+            }
+
+            data += written;
+            size -= written;
+        }
+
+        if (BOOST_UNLIKELY(!::FlushFileBuffers(h.get())))
+        {
+            err = ::GetLastError();
+            goto fail;
+        }
+    }
+
+#endif // defined(BOOST_FILESYSTEM_POSIX_API)
+
+    {
+        system::error_code rename_err;
+        detail::rename(temp_file, file, &rename_err);
+        if (BOOST_LIKELY(!rename_err))
+            return;
+
+        system::error_code remove_err;
+        detail::remove(temp_file, &remove_err);
+        detail::report_error(rename_err, file, ec, "boost::filesystem::directory_snapshot::save");
+        return;
+    }
+
+fail:
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+    fd.reset();
+#endif
+    {
+        system::error_code remove_err;
+        detail::remove(temp_file, &remove_err);
+    }
+    emit_error(err, file, ec, "boost::filesystem::directory_snapshot::save");
+}
+
+BOOST_FILESYSTEM_DECL
+void directory_snapshot::load_impl(path const& file, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    clear();
+
+    void* mapping = nullptr;
+    std::size_t size = 0u;
+
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+
+    {
+        boost::scope::unique_fd fd;
+        while (true)
+        {
+            fd.reset(::open(file.c_str(), O_RDONLY | O_CLOEXEC));
+            if (BOOST_LIKELY(fd.get() >= 0))
+                break;
+
+            const int err = errno;
+            if (err != EINTR)
+            {
+                emit_error(err, file, ec, "boost::filesystem::directory_snapshot::load");
+                return;
+            }
+        }
+
+        struct ::stat file_stat;
+        if (BOOST_UNLIKELY(::fstat(fd.get(), &file_stat) != 0))
+        {
+            emit_error(errno, file, ec, "boost::filesystem::directory_snapshot::load");
+            return;
+        }
+
+        if (BOOST_UNLIKELY(!S_ISREG(file_stat.st_mode) || file_stat.st_size < static_cast< off_t >(sizeof(detail::directory_snapshot_header)) ||
+            static_cast< boost::uintmax_t >(file_stat.st_size) > static_cast< boost::uintmax_t >((std::numeric_limits< std::size_t >::max)())))
+        {
+            emit_error(detail::invalid_data_error, file, ec, "boost::filesystem::directory_snapshot::load: invalid snapshot file");
+            return;
+        }
+
+        size = static_cast< std::size_t >(file_stat.st_size);
+        mapping = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd.get(), 0);
+        if (BOOST_UNLIKELY(mapping == MAP_FAILED))
+        {
+            emit_error(errno, file, ec, "boost::filesystem::directory_snapshot::load");
+            return;
+        }
+    }
+
+#else // defined(BOOST_FILESYSTEM_POSIX_API)
+
+    {
+        detail::unique_handle h(detail::create_file_handle(file, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL));
+        if (BOOST_UNLIKELY(!h))
+        {
+            emit_error(::GetLastError(), file, ec, "boost::filesystem::directory_snapshot::load");
+            return;
+        }
+
+        LARGE_INTEGER file_size;
+        if (BOOST_UNLIKELY(!::GetFileSizeEx(h.get(), &file_size)))
+        {
+            emit_error(::GetLastError(), file, ec, "boost::filesystem::directory_snapshot::load");
+            return;
+        }
+
+        if (BOOST_UNLIKELY(file_size.QuadPart < static_cast< LONGLONG >(sizeof(detail::directory_snapshot_header)) ||
+            static_cast< boost::uintmax_t >(file_size.QuadPart) > static_cast< boost::uintmax_t >((std::numeric_limits< std::size_t >::max)())))
+        {
+            emit_error(detail::invalid_data_error, file, ec, "boost::filesystem::directory_snapshot::load: invalid snapshot file");
+            return;
+        }
+
+        detail::unique_handle mapping_handle(::CreateFileMappingW(h.get(), nullptr, PAGE_READONLY, 0u, 0u, nullptr));
+        if (BOOST_UNLIKELY(!mapping_handle))
+        {
+            emit_error(::GetLastError(), file, ec, "boost::filesystem::directory_snapshot::load");
+            return;
+        }
+
+        size = static_cast< std::size_t >(file_size.QuadPart);
+        mapping = ::MapViewOfFile(mapping_handle.get(), FILE_MAP_READ, 0u, 0u, 0u);
+        if (BOOST_UNLIKELY(mapping == nullptr))
+        {
+            emit_error(::GetLastError(), file, ec, "boost::filesystem::directory_snapshot::load");
+            return;
+        }
+    }
+
+#endif // defined(BOOST_FILESYSTEM_POSIX_API)
+
+    m_mapping = mapping;
+    m_mapping_size = size;
+
+    // Validate the snapshot so that accessing the entries never reads outside the mapped file
+    unsigned char const* const data = static_cast< unsigned char const* >(mapping);
+    detail::directory_snapshot_header const* header = reinterpret_cast< detail::directory_snapshot_header const* >(data);
+    bool valid = std::memcmp(header->magic, detail::directory_snapshot_magic, sizeof(header->magic)) == 0 &&
+        header->version == detail::directory_snapshot_version &&
+        header->byte_order == detail::directory_snapshot_byte_order &&
+        header->char_size == sizeof(path::value_type) &&
+        header->record_size == sizeof(detail::directory_snapshot_record) &&
+        header->record_count > 0u && header->record_count <= detail::directory_snapshot_no_record;
+
+    if (valid)
+    {
+        const boost::uint64_t records_size = header->record_count * sizeof(detail::directory_snapshot_record);
+        const boost::uint64_t max_names = (std::numeric_limits< boost::uint64_t >::max)() / sizeof(path::value_type);
+        valid = header->name_table_size <= max_names &&
+            (size - sizeof(detail::directory_snapshot_header)) >= records_size &&
+            (size - sizeof(detail::directory_snapshot_header) - records_size) == header->name_table_size * sizeof(path::value_type);
+    }
+
+    if (valid)
+    {
+        detail::directory_snapshot_record const* records = reinterpret_cast< detail::directory_snapshot_record const* >(data + sizeof(detail::directory_snapshot_header));
+        path::value_type const* names = reinterpret_cast< path::value_type const* >(records + header->record_count);
+        const boost::uint64_t record_count = header->record_count;
+        for (boost::uint64_t i = 0u; i < record_count && valid; ++i)
+        {
+            detail::directory_snapshot_record const& rec = records[i];
+            valid = rec.name_offset < header->name_table_size && rec.name_size < header->name_table_size - rec.name_offset &&
+                names[rec.name_offset + rec.name_size] == static_cast< path::value_type >('\0') &&
+                (i == 0u || rec.parent < i) &&
+                rec.type <= static_cast< boost::uint8_t >(type_unknown) &&
+                rec.symlink_type <= static_cast< boost::uint8_t >(type_unknown) &&
+                (rec.child_count == 0u || (rec.first_child > i && rec.first_child <= record_count && rec.child_count <= record_count - rec.first_child));
+        }
+
+        if (valid)
+        {
+            m_header = header;
+            m_records = records;
+            m_names = names;
+            m_root = path(names + records[0].name_offset, names + records[0].name_offset + records[0].name_size);
+            return;
+        }
+    }
+
+    clear();
+    emit_error(detail::invalid_data_error, file, ec, "boost::filesystem::directory_snapshot::load: invalid snapshot file");
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
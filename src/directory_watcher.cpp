@@ -0,0 +1,505 @@
+//  directory_watcher.cpp  ------------------------------------------------------------//
+
+//  Copyright 2026 Andrey Semashev
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/directory_watcher.hpp>
+#include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/exception.hpp>
+#include <boost/filesystem/file_status.hpp>
+
+#include <cstddef>
+#include <cerrno>
+#include <cstring>
+#include <new> // std::bad_alloc
+#include <memory> // std::unique_ptr
+#include <string>
+#include <vector>
+#include <utility> // std::pair
+#include <unordered_map>
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#if defined(linux) || defined(__linux) || defined(__linux__)
+#define BOOST_FILESYSTEM_USE_INOTIFY
+#endif
+
+#if defined(BOOST_FILESYSTEM_USE_INOTIFY)
+#include <poll.h>
+#include <unistd.h>
+#include <sys/inotify.h>
+#include <boost/scope/unique_fd.hpp>
+#endif
+
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+namespace detail {
+
+#if defined(BOOST_FILESYSTEM_USE_INOTIFY)
+
+namespace {
+
+//! Events of the watched directories that are reported by the watcher
+BOOST_CONSTEXPR_OR_CONST boost::uint32_t inotify_watch_mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO |
+    IN_MODIFY | IN_ATTRIB | IN_DELETE_SELF | IN_ONLYDIR | IN_EXCL_UNLINK;
+
+//! Size of the buffer for reading inotify events
+BOOST_CONSTEXPR_OR_CONST std::size_t inotify_buffer_size = 65536u;
+
+//! Maximum number of reads of the inotify queue per batch, which limits the batch size when the tree is changing constantly
+BOOST_CONSTEXPR_OR_CONST unsigned int inotify_max_reads_per_batch = 16u;
+
+//! Tests if the error indicates that the directory was removed or replaced with a different file
+inline bool is_not_found_error(int err) noexcept
+{
+    return err == ENOENT || err == ENOTDIR;
+}
+
+} // namespace
+
+//! Implementation of directory_watcher
+struct directory_watcher_imp
+{
+    path root;
+    directory_options options;
+    boost::scope::unique_fd fd;
+    //! Paths of the watched directories, by watch descriptor
+    std::unordered_map< int, path > watches;
+    //! Watch descriptor of the root directory
+    int root_wd;
+    //! Indices of the events in the current batch, by path
+    std::unordered_map< path::string_type, std::size_t > batch_index;
+    std::vector< directory_watch_event >* batch;
+    std::vector< unsigned char > buffer;
+
+    directory_watcher_imp() :
+        options(directory_options::none),
+        root_wd(-1),
+        batch(nullptr)
+    {
+    }
+
+    //! Adds an event to the current batch, combining it with the previous event for the same file
+    void add_event(path const& p, directory_change changes, bool is_directory)
+    {
+        std::pair< std::unordered_map< path::string_type, std::size_t >::iterator, bool > res =
+            batch_index.insert(std::unordered_map< path::string_type, std::size_t >::value_type(p.native(), batch->size()));
+        if (res.second)
+        {
+            batch->push_back(directory_watch_event(p, changes, is_directory));
+        }
+        else
+        {
+            directory_watch_event& event = (*batch)[res.first->second];
+            event.m_changes |= changes;
+            event.m_is_directory = is_directory;
+        }
+    }
+
+    //! Registers a watch for a directory. Returns 0 on success or a system error code.
+    int add_watch(path const& p, bool follow)
+    {
+        const int wd = ::inotify_add_watch(fd.get(), p.c_str(), inotify_watch_mask | (follow ? 0u : static_cast< boost::uint32_t >(IN_DONT_FOLLOW)));
+        if (BOOST_UNLIKELY(wd < 0))
+            return errno;
+
+        watches[wd] = p;
+        return 0;
+    }
+
+    //! Removes the watches of the directory and its subdirectories
+    void remove_watches(path const& p) noexcept
+    {
+        path::string_type const& str = p.native();
+        for (std::unordered_map< int, path >::iterator it = watches.begin(), end = watches.end(); it != end;)
+        {
+            path::string_type const& watch_str = it->second.native();
+            if (watch_str.size() >= str.size() && watch_str.compare(0u, str.size(), str) == 0 &&
+                (watch_str.size() == str.size() || watch_str[str.size()] == path::preferred_separator))
+            {
+                ::inotify_rm_watch(fd.get(), it->first);
+                it = watches.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    /*!
+     * Registers watches for the directory and its subdirectories. If \a report_added is \c true, reports every found entry
+     * as added, as they may have been created before the watch was registered.
+     */
+    system::error_code add_tree(path const& dir, bool follow, bool report_added)
+    {
+        int err = add_watch(dir, follow);
+        if (BOOST_UNLIKELY(err != 0))
+        {
+            if (is_not_found_error(err) ||
+                (err == EACCES && (options & directory_options::skip_permission_denied) != directory_options::none))
+            {
+                return system::error_code();
+            }
+
+            return system::error_code(err, system::system_category());
+        }
+
+        const bool follow_symlinks = (options & directory_options::follow_directory_symlink) != directory_options::none;
+        system::error_code ec;
+        recursive_directory_iterator it(dir, options & (directory_options::follow_directory_symlink | directory_options::skip_permission_denied), ec);
+        while (!ec && it != recursive_directory_iterator())
+        {
+            directory_entry const& entry = *it;
+            system::error_code status_ec;
+            file_type ft = entry.symlink_status(status_ec).type();
+            if (ft == symlink_file && follow_symlinks)
+                ft = entry.status(status_ec).type();
+
+            const bool is_directory = ft == directory_file;
+            if (report_added)
+                add_event(entry.path(), directory_change::added, is_directory);
+
+            if (is_directory)
+            {
+                err = add_watch(entry.path(), follow_symlinks);
+                if (BOOST_UNLIKELY(err != 0))
+                {
+                    if (is_not_found_error(err) ||
+                        (err == EACCES && (options & directory_options::skip_permission_denied) != directory_options::none))
+                    {
+                        it.disable_recursion_pending();
+                    }
+                    else
+                    {
+                        return system::error_code(err, system::system_category());
+                    }
+                }
+            }
+
+            it.increment(ec);
+        }
+
+        // The directory may have been removed while it was being walked
+        if (BOOST_UNLIKELY(!!ec) && !is_not_found_error(ec.value()))
+            return ec;
+
+        return system::error_code();
+    }
+
+    //! Processes the events in the buffer
+    system::error_code process_events(std::size_t size, bool& overflow)
+    {
+        system::error_code first_error;
+        for (std::size_t pos = 0u; pos < size;)
+        {
+            struct ::inotify_event const* const ev = reinterpret_cast< struct ::inotify_event const* >(buffer.data() + pos);
+            pos += sizeof(struct ::inotify_event) + ev->len;
+
+            if ((ev->mask & IN_Q_OVERFLOW) != 0u)
+            {
+                overflow = true;
+                continue;
+            }
+
+            std::unordered_map< int, path >::iterator it = watches.find(ev->wd);
+            if (it == watches.end())
+                continue;
+
+            if ((ev->mask & IN_IGNORED) != 0u)
+            {
+                watches.erase(it);
+                continue;
+            }
+
+            path p(it->second);
+            bool is_directory = true;
+            if (ev->len > 0u && ev->name[0] != '\0')
+            {
+                path_algorithms::append_v4(p, ev->name, ev->name + std::strlen(ev->name));
+                is_directory = (ev->mask & IN_ISDIR) != 0u;
+            }
+            else if ((ev->mask & IN_DELETE_SELF) != 0u)
+            {
+                // Removal of subdirectories is reported by the parent directory watches
+                if (ev->wd == root_wd)
+                    add_event(p, directory_change::removed, true);
+                continue;
+            }
+
+            if ((ev->mask & (IN_CREATE | IN_MOVED_TO)) != 0u)
+            {
+                add_event(p, directory_change::added, is_directory);
+                if (is_directory)
+                {
+                    system::error_code err = add_tree(p, false, true);
+                    if (BOOST_UNLIKELY(!!err) && !first_error)
+                        first_error = err;
+                }
+            }
+
+            if ((ev->mask & (IN_DELETE | IN_MOVED_FROM)) != 0u)
+            {
+                add_event(p, directory_change::removed, is_directory);
+                if (is_directory && (ev->mask & IN_MOVED_FROM) != 0u)
+                    remove_watches(p);
+            }
+
+            if ((ev->mask & IN_MODIFY) != 0u)
+                add_event(p, directory_change::modified, is_directory);
+
+            if ((ev->mask & IN_ATTRIB) != 0u)
+                add_event(p, directory_change::attributes, is_directory);
+        }
+
+        return first_error;
+    }
+};
+
+#else // defined(BOOST_FILESYSTEM_USE_INOTIFY)
+
+//! Implementation of directory_watcher
+struct directory_watcher_imp
+{
+};
+
+#endif // defined(BOOST_FILESYSTEM_USE_INOTIFY)
+
+} // namespace detail
+
+BOOST_FILESYSTEM_DECL
+void directory_watcher::close() noexcept
+{
+    delete m_imp;
+    m_imp = nullptr;
+}
+
+BOOST_FILESYSTEM_DECL
+path const& directory_watcher::root() const noexcept
+{
+#if defined(BOOST_FILESYSTEM_USE_INOTIFY)
+    if (m_imp)
+        return m_imp->root;
+#endif
+
+    static const path empty_path;
+    return empty_path;
+}
+
+BOOST_FILESYSTEM_DECL
+std::size_t directory_watcher::watch_count() const noexcept
+{
+#if defined(BOOST_FILESYSTEM_USE_INOTIFY)
+    if (m_imp)
+        return m_imp->watches.size();
+#endif
+
+    return 0u;
+}
+
+BOOST_FILESYSTEM_DECL
+int directory_watcher::native_handle() const noexcept
+{
+#if defined(BOOST_FILESYSTEM_USE_INOTIFY)
+    if (m_imp)
+        return m_imp->fd.get();
+#endif
+
+    return -1;
+}
+
+BOOST_FILESYSTEM_DECL
+void directory_watcher::open_impl(path const& root, directory_options opts, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    close();
+
+#if defined(BOOST_FILESYSTEM_USE_INOTIFY)
+
+    if (BOOST_UNLIKELY(root.empty()))
+    {
+        emit_error(ENOENT, root, ec, "boost::filesystem::directory_watcher");
+        return;
+    }
+
+    try
+    {
+        std::unique_ptr< detail::directory_watcher_imp > imp(new detail::directory_watcher_imp());
+        imp->root = root;
+        imp->options = opts & (directory_options::follow_directory_symlink | directory_options::skip_permission_denied);
+
+        imp->fd.reset(::inotify_init1(IN_NONBLOCK | IN_CLOEXEC));
+        if (BOOST_UNLIKELY(imp->fd.get() < 0))
+        {
+            emit_error(errno, root, ec, "boost::filesystem::directory_watcher");
+            return;
+        }
+
+        // Register the root watch separately to report errors if the root directory does not exist
+        const int err = imp->add_watch(root, true);
+        if (BOOST_UNLIKELY(err != 0))
+        {
+            emit_error(err, root, ec, "boost::filesystem::directory_watcher");
+            return;
+        }
+
+        imp->root_wd = imp->watches.begin()->first;
+
+        system::error_code tree_err = imp->add_tree(root, true, false);
+        if (BOOST_UNLIKELY(!!tree_err))
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::directory_watcher", root, tree_err));
+
+            *ec = tree_err;
+            return;
+        }
+
+        m_imp = imp.release();
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+    }
+
+#else // defined(BOOST_FILESYSTEM_USE_INOTIFY)
+
+    (void)opts;
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, root, ec, "boost::filesystem::directory_watcher");
+
+#endif // defined(BOOST_FILESYSTEM_USE_INOTIFY)
+}
+
+BOOST_FILESYSTEM_DECL
+std::size_t directory_watcher::wait_impl(std::vector< directory_watch_event >& events, long timeout_ms, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    events.clear();
+
+#if defined(BOOST_FILESYSTEM_USE_INOTIFY)
+
+    if (BOOST_UNLIKELY(!m_imp))
+    {
+        emit_error(EBADF, ec, "boost::filesystem::directory_watcher::wait");
+        return 0u;
+    }
+
+    detail::directory_watcher_imp& imp = *m_imp;
+
+    while (true)
+    {
+        struct ::pollfd pfd;
+        pfd.fd = imp.fd.get();
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        const int res = ::poll(&pfd, 1, static_cast< int >(timeout_ms));
+        if (res > 0)
+            break;
+
+        if (res == 0)
+            return 0u;
+
+        const int err = errno;
+        if (err != EINTR)
+        {
+            emit_error(err, imp.root, ec, "boost::filesystem::directory_watcher::wait");
+            return 0u;
+        }
+    }
+
+    system::error_code first_error;
+    try
+    {
+        imp.batch = &events;
+        imp.batch_index.clear();
+        if (imp.buffer.empty())
+            imp.buffer.resize(detail::inotify_buffer_size);
+
+        // Read all events that are already queued to combine them into a single batch
+        bool overflow = false;
+        for (unsigned int i = 0u; i < detail::inotify_max_reads_per_batch; ++i)
+        {
+            const ssize_t size = ::read(imp.fd.get(), imp.buffer.data(), imp.buffer.size());
+            if (size < 0)
+            {
+                const int err = errno;
+                if (err == EINTR)
+                    continue;
+                if (err == EAGAIN || err == EWOULDBLOCK)
+                    break;
+
+                first_error.assign(err, system::system_category());
+                break;
+            }
+
+            system::error_code err = imp.process_events(static_cast< std::size_t >(size), overflow);
+            if (BOOST_UNLIKELY(!!err) && !first_error)
+                first_error = err;
+        }
+
+        if (overflow)
+        {
+            // Events were lost, register watches for the directories that may have been created in the meantime
+            system::error_code err = imp.add_tree(imp.root, true, false);
+            if (BOOST_UNLIKELY(!!err) && !first_error)
+                first_error = err;
+
+            imp.add_event(imp.root, directory_change::overflow, true);
+        }
+
+        imp.batch = nullptr;
+    }
+    catch (std::bad_alloc&)
+    {
+        imp.batch = nullptr;
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+        return events.size();
+    }
+
+    if (BOOST_UNLIKELY(!!first_error))
+    {
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::directory_watcher::wait", imp.root, first_error));
+
+        *ec = first_error;
+    }
+
+    return events.size();
+
+#else // defined(BOOST_FILESYSTEM_USE_INOTIFY)
+
+    (void)timeout_ms;
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, ec, "boost::filesystem::directory_watcher::wait");
+    return 0u;
+
+#endif // defined(BOOST_FILESYSTEM_USE_INOTIFY)
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
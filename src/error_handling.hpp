@@ -39,6 +39,7 @@ typedef int err_t;
 #define BOOST_ERROR_FILE_NOT_FOUND ENOENT
 #define BOOST_ERROR_ALREADY_EXISTS EEXIST
 #define BOOST_ERROR_NOT_SUPPORTED ENOSYS
+#define BOOST_ERROR_OPERATION_CANCELED ECANCELED
 
 #else
 
@@ -50,6 +51,7 @@ typedef boost::winapi::DWORD_ err_t;
 #define BOOST_ERROR_FILE_NOT_FOUND boost::winapi::ERROR_FILE_NOT_FOUND_
 #define BOOST_ERROR_ALREADY_EXISTS boost::winapi::ERROR_ALREADY_EXISTS_
 #define BOOST_ERROR_NOT_SUPPORTED boost::winapi::ERROR_NOT_SUPPORTED_
+#define BOOST_ERROR_OPERATION_CANCELED boost::winapi::ERROR_OPERATION_ABORTED_
 
 // STATUS_* constants defined in ntstatus.h in some SDKs are defined as DWORDs, and NTSTATUS is LONG.
 // This results in signed/unsigned mismatch warnings emitted by gcc and clang. Consider that a platform bug.
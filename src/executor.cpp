@@ -0,0 +1,185 @@
+//  executor.cpp  ---------------------------------------------------------------------//
+
+//  Copyright 2026 Andrey Semashev
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/executor.hpp>
+
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include <functional>
+#include <utility> // std::move
+
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#endif
+
+#include "thread_pool.hpp" // resolve_thread_count
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+namespace detail {
+
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+
+//! Implementation of thread_pool_executor
+struct thread_pool_executor_imp
+{
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque< std::function< void() > > tasks;
+    std::vector< std::thread > threads;
+    bool stopping;
+
+    thread_pool_executor_imp() :
+        stopping(false)
+    {
+    }
+
+    void run() noexcept
+    {
+        std::unique_lock< std::mutex > lock(mutex);
+        while (true)
+        {
+            if (!tasks.empty())
+            {
+                std::function< void() > task(std::move(tasks.front()));
+                tasks.pop_front();
+                lock.unlock();
+                task();
+                task = nullptr;
+                lock.lock();
+                continue;
+            }
+
+            if (stopping)
+                break;
+
+            cond.wait(lock);
+        }
+    }
+};
+
+#else // !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+
+struct thread_pool_executor_imp
+{
+};
+
+#endif // !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+
+} // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                thread_pool_executor                                  //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+
+BOOST_FILESYSTEM_DECL
+unsigned int thread_pool_executor::thread_count() const noexcept
+{
+    return static_cast< unsigned int >(m_imp->threads.size());
+}
+
+BOOST_FILESYSTEM_DECL
+void thread_pool_executor::post(std::function< void() > task)
+{
+    {
+        std::lock_guard< std::mutex > lock(m_imp->mutex);
+        m_imp->tasks.push_back(std::move(task));
+    }
+
+    m_imp->cond.notify_one();
+}
+
+BOOST_FILESYSTEM_DECL
+void thread_pool_executor::start(unsigned int thread_count)
+{
+    thread_count = detail::resolve_thread_count(thread_count);
+
+    m_imp = new detail::thread_pool_executor_imp();
+    try
+    {
+        m_imp->threads.reserve(thread_count);
+        for (unsigned int i = 0u; i < thread_count; ++i)
+            m_imp->threads.emplace_back(&detail::thread_pool_executor_imp::run, m_imp);
+    }
+    catch (...)
+    {
+        // Proceed with fewer threads, if any were started
+        if (m_imp->threads.empty())
+        {
+            delete m_imp;
+            m_imp = nullptr;
+            throw;
+        }
+    }
+}
+
+BOOST_FILESYSTEM_DECL
+void thread_pool_executor::stop() noexcept
+{
+    if (!m_imp)
+        return;
+
+    {
+        std::lock_guard< std::mutex > lock(m_imp->mutex);
+        m_imp->stopping = true;
+    }
+    m_imp->cond.notify_all();
+
+    for (std::size_t i = 0u, n = m_imp->threads.size(); i < n; ++i)
+        m_imp->threads[i].join();
+
+    delete m_imp;
+    m_imp = nullptr;
+}
+
+#else // !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+
+BOOST_FILESYSTEM_DECL
+unsigned int thread_pool_executor::thread_count() const noexcept
+{
+    return 0u;
+}
+
+BOOST_FILESYSTEM_DECL
+void thread_pool_executor::post(std::function< void() > task)
+{
+    task();
+}
+
+BOOST_FILESYSTEM_DECL
+void thread_pool_executor::start(unsigned int)
+{
+}
+
+BOOST_FILESYSTEM_DECL
+void thread_pool_executor::stop() noexcept
+{
+}
+
+#endif // !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
@@ -0,0 +1,705 @@
+//  glob.cpp  -------------------------------------------------------------------------//
+
+//  Copyright 2026 Andrey Semashev
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#include "platform_config.hpp"
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/glob.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/exception.hpp>
+
+#include <cstddef>
+#include <cerrno>
+#include <new> // std::bad_alloc
+#include <memory> // std::unique_ptr
+#include <string>
+#include <vector>
+#include <algorithm> // std::sort, std::unique, std::find
+#include <boost/cstdint.hpp>
+#include <boost/system/error_code.hpp>
+
+#if defined(BOOST_FILESYSTEM_WINDOWS_API)
+#include <windows.h>
+#endif
+
+#include "glob_tools.hpp"
+#include "error_handling.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+
+namespace detail {
+
+namespace {
+
+typedef std::char_traits< path::value_type > glob_char_traits;
+
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+BOOST_CONSTEXPR_OR_CONST err_t invalid_argument_error = EINVAL;
+#else
+BOOST_CONSTEXPR_OR_CONST err_t invalid_argument_error = ERROR_INVALID_PARAMETER;
+#endif
+
+//! Maximum number of brace alternatives of a single path element
+BOOST_CONSTEXPR_OR_CONST std::size_t glob_max_alternatives = 1024u;
+
+BOOST_CONSTEXPR_OR_CONST path::value_type glob_asterisk = static_cast< path::value_type >('*');
+BOOST_CONSTEXPR_OR_CONST path::value_type glob_question_mark = static_cast< path::value_type >('?');
+BOOST_CONSTEXPR_OR_CONST path::value_type glob_backslash = static_cast< path::value_type >('\\');
+BOOST_CONSTEXPR_OR_CONST path::value_type glob_open_bracket = static_cast< path::value_type >('[');
+BOOST_CONSTEXPR_OR_CONST path::value_type glob_close_bracket = static_cast< path::value_type >(']');
+BOOST_CONSTEXPR_OR_CONST path::value_type glob_open_brace = static_cast< path::value_type >('{');
+BOOST_CONSTEXPR_OR_CONST path::value_type glob_close_brace = static_cast< path::value_type >('}');
+BOOST_CONSTEXPR_OR_CONST path::value_type glob_comma = static_cast< path::value_type >(',');
+BOOST_CONSTEXPR_OR_CONST path::value_type glob_dash = static_cast< path::value_type >('-');
+BOOST_CONSTEXPR_OR_CONST path::value_type glob_exclamation_mark = static_cast< path::value_type >('!');
+BOOST_CONSTEXPR_OR_CONST path::value_type glob_caret = static_cast< path::value_type >('^');
+
+/*!
+ * Searches for the literal in the string. The first character of the literal is searched with \c char_traits::find,
+ * which is \c memchr or \c wmemchr and is vectorized in most C runtimes, so that most of the string is skipped quickly.
+ */
+inline bool find_literal(path::value_type const* str, std::size_t size, path::string_type const& literal) noexcept
+{
+    const std::size_t literal_size = literal.size();
+    path::value_type const* const literal_str = literal.c_str();
+    while (size >= literal_size)
+    {
+        path::value_type const* p = glob_char_traits::find(str, size - literal_size + 1u, literal_str[0]);
+        if (!p)
+            return false;
+
+        if (glob_char_traits::compare(p + 1, literal_str + 1, literal_size - 1u) == 0)
+            return true;
+
+        const std::size_t skipped = static_cast< std::size_t >(p - str) + 1u;
+        str += skipped;
+        size -= skipped;
+    }
+
+    return false;
+}
+
+//! Returns the position after the closing bracket of a character class that starts at \a pos, or 0 if the class is not terminated
+std::size_t find_char_class_end(path::string_type const& str, std::size_t pos, bool escape) noexcept
+{
+    const std::size_t size = str.size();
+    ++pos;
+    if (pos < size && (str[pos] == glob_exclamation_mark || str[pos] == glob_caret))
+        ++pos;
+    // A closing bracket at the beginning of the class is a literal
+    if (pos < size && str[pos] == glob_close_bracket)
+        ++pos;
+
+    while (pos < size)
+    {
+        const path::value_type c = str[pos];
+        if (c == glob_close_bracket)
+            return pos + 1u;
+        if (c == glob_backslash && escape && (pos + 1u) < size)
+            ++pos;
+        ++pos;
+    }
+
+    return 0u;
+}
+
+//! Expands brace alternatives in the path element. Returns \c false if the number of alternatives is too large.
+bool expand_braces(path::string_type const& element, bool escape, std::vector< path::string_type >& alternatives)
+{
+    const std::size_t size = element.size();
+    for (std::size_t pos = 0u; pos < size; ++pos)
+    {
+        const path::value_type c = element[pos];
+        if (c == glob_backslash && escape)
+        {
+            ++pos;
+            continue;
+        }
+
+        if (c == glob_open_bracket)
+        {
+            const std::size_t class_end = find_char_class_end(element, pos, escape);
+            if (class_end > 0u)
+                pos = class_end - 1u;
+            continue;
+        }
+
+        if (c != glob_open_brace)
+            continue;
+
+        // Find the matching closing brace and the commas that separate the top-level alternatives
+        std::vector< std::size_t > separators;
+        separators.push_back(pos);
+        std::size_t close_pos = 0u;
+        unsigned int depth = 1u;
+        for (std::size_t i = pos + 1u; i < size; ++i)
+        {
+            const path::value_type d = element[i];
+            if (d == glob_backslash && escape)
+            {
+                ++i;
+            }
+            else if (d == glob_open_bracket)
+            {
+                const std::size_t class_end = find_char_class_end(element, i, escape);
+                if (class_end > 0u)
+                    i = class_end - 1u;
+            }
+            else if (d == glob_open_brace)
+            {
+                ++depth;
+            }
+            else if (d == glob_close_brace)
+            {
+                if (--depth == 0u)
+                {
+                    close_pos = i;
+                    break;
+                }
+            }
+            else if (d == glob_comma && depth == 1u)
+            {
+                separators.push_back(i);
+            }
+        }
+
+        // Unterminated braces and braces without commas are literal
+        if (close_pos == 0u || separators.size() < 2u)
+            continue;
+
+        separators.push_back(close_pos);
+        for (std::size_t i = 0u, n = separators.size() - 1u; i < n; ++i)
+        {
+            path::string_type expanded(element, 0u, pos);
+            expanded.append(element, separators[i] + 1u, separators[i + 1u] - separators[i] - 1u);
+            expanded.append(element, close_pos + 1u, path::string_type::npos);
+            // The rest of the element, including the inserted alternative, may contain more braces
+            if (!expand_braces(expanded, escape, alternatives))
+                return false;
+        }
+
+        return true;
+    }
+
+    if (std::find(alternatives.begin(), alternatives.end(), element) == alternatives.end())
+    {
+        if (alternatives.size() >= glob_max_alternatives)
+            return false;
+        alternatives.push_back(element);
+    }
+
+    return true;
+}
+
+//! Appends a literal character to the operations of the alternative
+inline void append_literal(glob_alternative& alt, path::value_type c)
+{
+    if (alt.ops.empty() || alt.ops.back().kind != glob_op::literal)
+    {
+        glob_op op;
+        op.kind = glob_op::literal;
+        op.negated = false;
+        op.offset = static_cast< boost::uint32_t >(alt.chars.size());
+        op.size = 0u;
+        alt.ops.push_back(op);
+    }
+
+    alt.chars.push_back(c);
+    ++alt.ops.back().size;
+}
+
+//! Compiles a brace alternative of a path element
+void compile_alternative(path::string_type const& str, bool escape, glob_alternative& alt)
+{
+    const std::size_t size = str.size();
+    for (std::size_t pos = 0u; pos < size; ++pos)
+    {
+        const path::value_type c = str[pos];
+        if (c == glob_backslash && escape && (pos + 1u) < size)
+        {
+            append_literal(alt, str[++pos]);
+        }
+        else if (c == glob_asterisk)
+        {
+            // Consecutive asterisks are equivalent to one
+            if (alt.ops.empty() || alt.ops.back().kind != glob_op::any_string)
+            {
+                glob_op op = { glob_op::any_string, false, 0u, 0u };
+                alt.ops.push_back(op);
+            }
+        }
+        else if (c == glob_question_mark)
+        {
+            glob_op op = { glob_op::any_char, false, 0u, 0u };
+            alt.ops.push_back(op);
+        }
+        else if (c == glob_open_bracket && find_char_class_end(str, pos, escape) > 0u)
+        {
+            const std::size_t class_end = find_char_class_end(str, pos, escape) - 1u;
+            glob_op op = { glob_op::char_class, false, static_cast< boost::uint32_t >(alt.ranges.size()), 0u };
+            ++pos;
+            if (str[pos] == glob_exclamation_mark || str[pos] == glob_caret)
+            {
+                op.negated = true;
+                ++pos;
+            }
+
+            while (pos < class_end)
+            {
+                glob_char_range range;
+                if (str[pos] == glob_backslash && escape && (pos + 1u) < class_end)
+                    ++pos;
+                range.first = range.last = str[pos++];
+                if ((pos + 1u) < class_end && str[pos] == glob_dash)
+                {
+                    ++pos;
+                    if (str[pos] == glob_backslash && escape && (pos + 1u) < class_end)
+                        ++pos;
+                    range.last = str[pos++];
+                }
+
+                alt.ranges.push_back(range);
+            }
+
+            op.size = static_cast< boost::uint32_t >(alt.ranges.size() - op.offset);
+            alt.ops.push_back(op);
+        }
+        else
+        {
+            append_literal(alt, c);
+        }
+    }
+
+    // Separate the anchored literals at the ends of the alternative
+    if (!alt.ops.empty() && alt.ops.front().kind == glob_op::literal)
+    {
+        alt.prefix.assign(alt.chars, alt.ops.front().offset, alt.ops.front().size);
+        alt.ops.erase(alt.ops.begin());
+    }
+
+    if (!alt.ops.empty() && alt.ops.back().kind == glob_op::literal)
+    {
+        alt.suffix.assign(alt.chars, alt.ops.back().offset, alt.ops.back().size);
+        alt.ops.pop_back();
+    }
+
+    alt.min_size = alt.prefix.size() + alt.suffix.size();
+    for (std::size_t i = 0u, n = alt.ops.size(); i < n; ++i)
+    {
+        glob_op const& op = alt.ops[i];
+        switch (op.kind)
+        {
+        case glob_op::literal:
+            alt.min_size += op.size;
+            if (op.size > 1u && op.size > alt.required.size())
+                alt.required.assign(alt.chars, op.offset, op.size);
+            break;
+
+        case glob_op::any_char:
+        case glob_op::char_class:
+            ++alt.min_size;
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    alt.match_any_middle = alt.ops.size() == 1u && alt.ops.front().kind == glob_op::any_string;
+    alt.matches_leading_dot = !alt.prefix.empty() && alt.prefix[0] == path::dot;
+}
+
+//! Tests if the character matches the character class
+inline bool match_char_class(glob_alternative const& alt, glob_op const& op, path::value_type c) noexcept
+{
+    glob_char_range const* range = alt.ranges.data() + op.offset;
+    for (glob_char_range const* const end = range + op.size; range != end; ++range)
+    {
+        if (c >= range->first && c <= range->last)
+            return !op.negated;
+    }
+
+    return op.negated;
+}
+
+} // namespace
+
+bool glob_alternative::match(path::value_type const* name, std::size_t size, bool match_hidden) const noexcept
+{
+    if (size < min_size)
+        return false;
+
+    if (!match_hidden && name[0] == path::dot && !matches_leading_dot)
+        return false;
+
+    if (!prefix.empty() && glob_char_traits::compare(name, prefix.c_str(), prefix.size()) != 0)
+        return false;
+
+    if (!suffix.empty() && glob_char_traits::compare(name + size - suffix.size(), suffix.c_str(), suffix.size()) != 0)
+        return false;
+
+    if (match_any_middle)
+        return true;
+
+    name += prefix.size();
+    size -= prefix.size() + suffix.size();
+
+    if (!required.empty() && !find_literal(name, size, required))
+        return false;
+
+    // Match the operations against the middle part of the name. When an operation fails to match,
+    // backtrack to the last asterisk and let it consume one more character.
+    std::size_t op_pos = 0u, name_pos = 0u;
+    std::size_t star_op_pos = 0u, star_name_pos = 0u;
+    bool have_star = false;
+    const std::size_t op_count = ops.size();
+    while (name_pos < size)
+    {
+        if (op_pos < op_count)
+        {
+            glob_op const& op = ops[op_pos];
+            switch (op.kind)
+            {
+            case glob_op::literal:
+                if (op.size <= (size - name_pos) && glob_char_traits::compare(name + name_pos, chars.c_str() + op.offset, op.size) == 0)
+                {
+                    name_pos += op.size;
+                    ++op_pos;
+                    continue;
+                }
+                break;
+
+            case glob_op::any_char:
+                ++name_pos;
+                ++op_pos;
+                continue;
+
+            case glob_op::char_class:
+                if (match_char_class(*this, op, name[name_pos]))
+                {
+                    ++name_pos;
+                    ++op_pos;
+                    continue;
+                }
+                break;
+
+            default: // any_string
+                have_star = true;
+                star_op_pos = op_pos;
+                star_name_pos = name_pos;
+                ++op_pos;
+                continue;
+            }
+        }
+
+        if (!have_star)
+            return false;
+
+        op_pos = star_op_pos + 1u;
+        name_pos = ++star_name_pos;
+    }
+
+    while (op_pos < op_count && ops[op_pos].kind == glob_op::any_string)
+        ++op_pos;
+
+    return op_pos == op_count;
+}
+
+bool glob_pattern_imp::match_component(std::size_t index, path::value_type const* name, std::size_t size) const noexcept
+{
+    glob_component const& component = components[index];
+    if (component.kind == glob_component::literal)
+    {
+        for (std::size_t i = 0u, n = component.names.size(); i < n; ++i)
+        {
+            path::string_type const& literal = component.names[i];
+            if (literal.size() == size && glob_char_traits::compare(literal.c_str(), name, size) == 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    const bool match_hidden = (options & glob_options::match_hidden) != glob_options::none;
+    for (std::size_t i = 0u, n = component.alternatives.size(); i < n; ++i)
+    {
+        if (component.alternatives[i].match(name, size, match_hidden))
+            return true;
+    }
+
+    return false;
+}
+
+void glob_pattern_imp::close_states(std::vector< boost::uint32_t >& states) const
+{
+    const std::size_t component_count = components.size();
+    for (std::size_t i = 0u, n = states.size(); i < n; ++i)
+    {
+        boost::uint32_t index = states[i];
+        while (index < component_count && components[index].kind == glob_component::recursive)
+            states.push_back(++index);
+    }
+
+    std::sort(states.begin(), states.end());
+    states.erase(std::unique(states.begin(), states.end()), states.end());
+}
+
+BOOST_FILESYSTEM_DECL void intrusive_ptr_add_ref(glob_pattern_imp const* p) noexcept
+{
+    p->ref_count.fetch_add(1u, std::memory_order_relaxed);
+}
+
+BOOST_FILESYSTEM_DECL void intrusive_ptr_release(glob_pattern_imp const* p) noexcept
+{
+    if (p->ref_count.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+        delete p;
+}
+
+} // namespace detail
+
+//--------------------------------------------------------------------------------------//
+//                                                                                      //
+//                                    glob_pattern                                      //
+//                                                                                      //
+//--------------------------------------------------------------------------------------//
+
+BOOST_FILESYSTEM_DECL
+path const& glob_pattern::pattern() const noexcept
+{
+    if (m_imp)
+        return m_imp->pattern;
+
+    static const path empty_path;
+    return empty_path;
+}
+
+BOOST_FILESYSTEM_DECL
+glob_options glob_pattern::options() const noexcept
+{
+    if (m_imp)
+        return m_imp->options;
+
+    return glob_options::none;
+}
+
+BOOST_FILESYSTEM_DECL
+void glob_pattern::compile(path const& pattern, glob_options opts, system::error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    path::string_type const& str = pattern.native();
+    if (BOOST_UNLIKELY(str.empty()))
+    {
+        emit_error(detail::invalid_argument_error, pattern, ec, "boost::filesystem::glob_pattern: the pattern is empty");
+        return;
+    }
+
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+    const bool escape = (opts & glob_options::no_escape) == glob_options::none;
+#else
+    // Backslash is a directory separator
+    const bool escape = false;
+#endif
+
+    try
+    {
+        std::unique_ptr< detail::glob_pattern_imp > imp(new detail::glob_pattern_imp());
+        imp->pattern = pattern;
+        imp->options = opts;
+
+        const std::size_t root_size = detail::path_algorithms::find_root_path_size(pattern);
+        imp->base.assign(str.c_str(), str.c_str() + root_size);
+
+        std::vector< path::string_type > alternatives;
+        const std::size_t size = str.size();
+        std::size_t pos = root_size;
+        while (pos < size)
+        {
+            if (detail::is_directory_separator(str[pos]))
+            {
+                ++pos;
+                continue;
+            }
+
+            std::size_t end = pos + 1u;
+            while (end < size && !detail::is_directory_separator(str[end]))
+                ++end;
+
+            path::string_type element(str, pos, end - pos);
+            pos = end;
+
+            detail::glob_component component;
+            if (element.size() == 2u && element[0] == detail::glob_asterisk && element[1] == detail::glob_asterisk)
+            {
+                // Consecutive "**" elements are equivalent to one
+                if (!imp->components.empty() && imp->components.back().kind == detail::glob_component::recursive)
+                    continue;
+
+                component.kind = detail::glob_component::recursive;
+                imp->components.push_back(static_cast< detail::glob_component&& >(component));
+                continue;
+            }
+
+            alternatives.clear();
+            if ((opts & glob_options::no_braces) == glob_options::none)
+            {
+                if (!detail::expand_braces(element, escape, alternatives))
+                {
+                    emit_error(detail::invalid_argument_error, pattern, ec, "boost::filesystem::glob_pattern: too many brace alternatives");
+                    return;
+                }
+            }
+            else
+            {
+                alternatives.push_back(element);
+            }
+
+            bool literal = true;
+            for (std::size_t i = 0u, n = alternatives.size(); i < n; ++i)
+            {
+                detail::glob_alternative alt;
+                detail::compile_alternative(alternatives[i], escape, alt);
+                // Empty alternatives never match a file name
+                if (alt.min_size == 0u && alt.ops.empty())
+                    continue;
+
+                literal &= alt.ops.empty();
+                component.alternatives.push_back(static_cast< detail::glob_alternative&& >(alt));
+            }
+
+            if (literal)
+            {
+                component.kind = detail::glob_component::literal;
+                for (std::size_t i = 0u, n = component.alternatives.size(); i < n; ++i)
+                    component.names.push_back(static_cast< path::string_type&& >(component.alternatives[i].prefix));
+                component.alternatives.clear();
+            }
+            else
+            {
+                component.kind = detail::glob_component::wildcard;
+            }
+
+            imp->components.push_back(static_cast< detail::glob_component&& >(component));
+        }
+
+        imp->directories_only = size > root_size && detail::is_directory_separator(str[size - 1u]);
+
+        // Leading literal elements with a single name are added to the base directory, which is opened directly
+        std::size_t first_wildcard = 0u;
+        for (std::size_t n = imp->components.size(); first_wildcard < n; ++first_wildcard)
+        {
+            detail::glob_component const& component = imp->components[first_wildcard];
+            if (component.kind != detail::glob_component::literal || component.names.size() != 1u)
+                break;
+
+            path::string_type const& name = component.names.front();
+            detail::path_algorithms::append_v4(imp->base, name.c_str(), name.c_str() + name.size());
+        }
+
+        imp->first_wildcard = first_wildcard;
+        m_imp = imp.release();
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+    }
+}
+
+BOOST_FILESYSTEM_DECL
+bool glob_pattern::match(path const& p) const
+{
+    if (!m_imp)
+        return false;
+
+    detail::glob_pattern_imp const& imp = *m_imp;
+    path::string_type const& pattern_str = imp.pattern.native();
+    path::string_type const& str = p.native();
+
+    const std::size_t pattern_root_size = detail::path_algorithms::find_root_path_size(imp.pattern);
+    const std::size_t root_size = detail::path_algorithms::find_root_path_size(p);
+    if (root_size != pattern_root_size || pattern_str.compare(0u, root_size, str, 0u, root_size) != 0)
+        return false;
+
+    const std::size_t component_count = imp.components.size();
+    std::vector< boost::uint32_t > states, next_states;
+    states.push_back(0u);
+    imp.close_states(states);
+
+    const std::size_t size = str.size();
+    std::size_t pos = root_size;
+    while (true)
+    {
+        while (pos < size && detail::is_directory_separator(str[pos]))
+            ++pos;
+
+        if (pos >= size)
+            return component_count == 0u;
+
+        std::size_t end = pos + 1u;
+        while (end < size && !detail::is_directory_separator(str[end]))
+            ++end;
+
+        path::value_type const* const name = str.c_str() + pos;
+        const std::size_t name_size = end - pos;
+        pos = end;
+        while (pos < size && detail::is_directory_separator(str[pos]))
+            ++pos;
+        const bool last = pos >= size;
+
+        bool matched = false;
+        next_states.clear();
+        for (std::size_t i = 0u, n = states.size(); i < n; ++i)
+        {
+            const boost::uint32_t index = states[i];
+            if (index >= component_count)
+                continue;
+
+            if (imp.components[index].kind == detail::glob_component::recursive)
+            {
+                if (imp.match_recursive(name))
+                {
+                    if (!last)
+                        next_states.push_back(index);
+                    else if (index + 1u == component_count)
+                        matched = true;
+                }
+            }
+            else if (imp.match_component(index, name, name_size))
+            {
+                if (index + 1u == component_count)
+                    matched = true;
+                else if (!last)
+                    next_states.push_back(index + 1u);
+            }
+        }
+
+        if (last)
+            return matched;
+
+        if (next_states.empty())
+            return false;
+
+        imp.close_states(next_states);
+        states.swap(next_states);
+    }
+}
+
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
@@ -0,0 +1,151 @@
+//  glob_tools.hpp  -------------------------------------------------------------------//
+
+//  Copyright 2026 Andrey Semashev
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_SRC_GLOB_TOOLS_HPP_
+#define BOOST_FILESYSTEM_SRC_GLOB_TOOLS_HPP_
+
+#include <boost/filesystem/config.hpp>
+#include <boost/filesystem/path.hpp>
+#include <boost/filesystem/glob.hpp>
+
+#include <cstddef>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <boost/cstdint.hpp>
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+//! Operation of a compiled glob path element matcher
+struct glob_op
+{
+    enum kind_type : unsigned char
+    {
+        //! Matches a literal string, stored in glob_alternative::chars
+        literal,
+        //! Matches any single character
+        any_char,
+        //! Matches any string, including an empty one
+        any_string,
+        //! Matches a single character from a set of ranges, stored in glob_alternative::ranges
+        char_class
+    };
+
+    kind_type kind;
+    //! For char_class, indicates that the set is negated
+    bool negated;
+    //! Offset of the literal or the first range
+    boost::uint32_t offset;
+    //! Length of the literal or the number of ranges
+    boost::uint32_t size;
+};
+
+//! Inclusive range of characters of a glob character class
+struct glob_char_range
+{
+    path::value_type first;
+    path::value_type last;
+};
+
+/*!
+ * \brief One of the brace alternatives of a glob path element
+ *
+ * The leading and trailing literals of the alternative are separated into \c prefix and \c suffix, which are
+ * compared against the ends of the file name before the rest of the operations are run on the middle part of the name.
+ */
+struct glob_alternative
+{
+    //! Storage for literal operations
+    path::string_type chars;
+    std::vector< glob_char_range > ranges;
+    //! Operations matching the middle part of the name, between the prefix and the suffix
+    std::vector< glob_op > ops;
+    path::string_type prefix;
+    path::string_type suffix;
+    //! The longest literal in the middle part of the name, which must be present in the name for it to match
+    path::string_type required;
+    //! Minimum length of a matching name
+    std::size_t min_size;
+    //! Indicates that the middle part matches any string
+    bool match_any_middle;
+    //! Indicates that the alternative can match names starting with a dot, when hidden files are not matched
+    bool matches_leading_dot;
+
+    //! Tests if the name matches the alternative
+    bool match(path::value_type const* name, std::size_t size, bool match_hidden) const noexcept;
+};
+
+//! A compiled glob path element
+struct glob_component
+{
+    enum kind_type : unsigned char
+    {
+        //! The element is one or more literal names, which can be looked up directly
+        literal,
+        //! The element contains wildcards
+        wildcard,
+        //! The element is "**", which matches any number of nested directories
+        recursive
+    };
+
+    kind_type kind;
+    //! Literal names, for literal elements
+    std::vector< path::string_type > names;
+    //! Brace alternatives, for wildcard elements
+    std::vector< glob_alternative > alternatives;
+};
+
+//! Compiled glob pattern
+struct glob_pattern_imp
+{
+    mutable std::atomic< unsigned int > ref_count;
+    path pattern;
+    glob_options options;
+    //! Root name and root directory of the pattern, followed by the leading literal elements
+    path base;
+    //! Index of the first element that is not included in \c base
+    std::size_t first_wildcard;
+    std::vector< glob_component > components;
+    //! Indicates that the pattern ends with a directory separator and only matches directories
+    bool directories_only;
+
+    glob_pattern_imp() noexcept :
+        ref_count(0u),
+        options(glob_options::none),
+        first_wildcard(0u),
+        directories_only(false)
+    {
+    }
+
+    //! Tests if the name matches the specified pattern element. Must not be called for recursive elements.
+    bool match_component(std::size_t index, path::value_type const* name, std::size_t size) const noexcept;
+
+    //! Tests if the name can be matched by a "**" element
+    bool match_recursive(path::value_type const* name) const noexcept
+    {
+        return (options & glob_options::match_hidden) != glob_options::none || name[0] != path::dot;
+    }
+
+    //! Adds the indices of the elements that follow "**" elements to the sorted set of element indices
+    void close_states(std::vector< boost::uint32_t >& states) const;
+};
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_SRC_GLOB_TOOLS_HPP_
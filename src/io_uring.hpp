@@ -0,0 +1,283 @@
+//  io_uring.hpp  ----------------------------------------------------------------------//
+
+//  Copyright 2026 Andrey Semashev
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_SRC_IO_URING_HPP_
+#define BOOST_FILESYSTEM_SRC_IO_URING_HPP_
+
+#include "platform_config.hpp"
+
+#include <cstddef>
+#include <cerrno>
+#include <cstring>
+#include <sys/types.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/io_uring.h>
+
+#include <boost/filesystem/config.hpp>
+#include "atomic_ref.hpp"
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+//! Opcodes of the io_uring operations on paths, which may not be defined in older kernel headers
+enum io_uring_path_opcode : unsigned char
+{
+    io_uring_op_renameat = 35u,
+    io_uring_op_unlinkat = 36u,
+    io_uring_op_mkdirat = 37u
+};
+
+/*!
+ * \brief A minimal io_uring instance
+ *
+ * The instance supports preparing a number of submission queue entries, submitting them and waiting for completions.
+ * It is intended to be used by a single thread. The library does not depend on liburing, so the rings are set up
+ * using the raw system calls.
+ */
+class io_uring_instance
+{
+private:
+    int m_fd;
+    unsigned int m_sq_entries;
+
+    void* m_sq_ring;
+    std::size_t m_sq_ring_size;
+    void* m_cq_ring;
+    std::size_t m_cq_ring_size;
+    struct ::io_uring_sqe* m_sqes;
+    std::size_t m_sqes_size;
+
+    unsigned int* m_sq_head;
+    unsigned int* m_sq_tail;
+    unsigned int* m_sq_array;
+    unsigned int m_sq_mask;
+    //! Tail of the submission queue, including the entries that are prepared but not yet published to the kernel
+    unsigned int m_sqe_tail;
+
+    unsigned int* m_cq_head;
+    unsigned int* m_cq_tail;
+    struct ::io_uring_cqe* m_cqes;
+    unsigned int m_cq_mask;
+
+public:
+    io_uring_instance() noexcept :
+        m_fd(-1),
+        m_sq_entries(0u),
+        m_sq_ring(MAP_FAILED),
+        m_sq_ring_size(0u),
+        m_cq_ring(MAP_FAILED),
+        m_cq_ring_size(0u),
+        m_sqes(static_cast< struct ::io_uring_sqe* >(MAP_FAILED)),
+        m_sqes_size(0u),
+        m_sq_head(nullptr),
+        m_sq_tail(nullptr),
+        m_sq_array(nullptr),
+        m_sq_mask(0u),
+        m_sqe_tail(0u),
+        m_cq_head(nullptr),
+        m_cq_tail(nullptr),
+        m_cqes(nullptr),
+        m_cq_mask(0u)
+    {
+    }
+
+    io_uring_instance(io_uring_instance const&) = delete;
+    io_uring_instance& operator=(io_uring_instance const&) = delete;
+
+    ~io_uring_instance()
+    {
+        if (m_sqes != MAP_FAILED)
+            ::munmap(m_sqes, m_sqes_size);
+        if (m_cq_ring != MAP_FAILED && m_cq_ring != m_sq_ring)
+            ::munmap(m_cq_ring, m_cq_ring_size);
+        if (m_sq_ring != MAP_FAILED)
+            ::munmap(m_sq_ring, m_sq_ring_size);
+        if (m_fd >= 0)
+            ::close(m_fd);
+    }
+
+    //! Creates the rings with at least \a entries submission queue entries. Returns 0 on success or a system error code.
+    int init(unsigned int entries) noexcept
+    {
+        struct ::io_uring_params params;
+        std::memset(&params, 0, sizeof(params));
+        const long fd = ::syscall(__NR_io_uring_setup, entries, &params);
+        if (fd < 0)
+            return errno;
+
+        m_fd = static_cast< int >(fd);
+        m_sq_entries = params.sq_entries;
+
+        m_sq_ring_size = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+        m_cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof(struct ::io_uring_cqe);
+        if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0u)
+        {
+            if (m_cq_ring_size > m_sq_ring_size)
+                m_sq_ring_size = m_cq_ring_size;
+            m_cq_ring_size = m_sq_ring_size;
+        }
+
+        m_sq_ring = ::mmap(nullptr, m_sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+        if (m_sq_ring == MAP_FAILED)
+            return errno;
+
+        if ((params.features & IORING_FEAT_SINGLE_MMAP) != 0u)
+        {
+            m_cq_ring = m_sq_ring;
+        }
+        else
+        {
+            m_cq_ring = ::mmap(nullptr, m_cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+            if (m_cq_ring == MAP_FAILED)
+                return errno;
+        }
+
+        m_sqes_size = params.sq_entries * sizeof(struct ::io_uring_sqe);
+        m_sqes = static_cast< struct ::io_uring_sqe* >(::mmap(nullptr, m_sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES));
+        if (m_sqes == MAP_FAILED)
+            return errno;
+
+        unsigned char* const sq_ring = static_cast< unsigned char* >(m_sq_ring);
+        m_sq_head = reinterpret_cast< unsigned int* >(sq_ring + params.sq_off.head);
+        m_sq_tail = reinterpret_cast< unsigned int* >(sq_ring + params.sq_off.tail);
+        m_sq_array = reinterpret_cast< unsigned int* >(sq_ring + params.sq_off.array);
+        m_sq_mask = *reinterpret_cast< unsigned int* >(sq_ring + params.sq_off.ring_mask);
+        m_sqe_tail = *m_sq_tail;
+
+        unsigned char* const cq_ring = static_cast< unsigned char* >(m_cq_ring);
+        m_cq_head = reinterpret_cast< unsigned int* >(cq_ring + params.cq_off.head);
+        m_cq_tail = reinterpret_cast< unsigned int* >(cq_ring + params.cq_off.tail);
+        m_cqes = reinterpret_cast< struct ::io_uring_cqe* >(cq_ring + params.cq_off.cqes);
+        m_cq_mask = *reinterpret_cast< unsigned int* >(cq_ring + params.cq_off.ring_mask);
+
+        return 0;
+    }
+
+    //! Returns the number of submission queue entries
+    unsigned int sq_entries() const noexcept { return m_sq_entries; }
+
+    //! Returns a zero-initialized submission queue entry to fill, or \c nullptr if the submission queue is full
+    struct ::io_uring_sqe* get_sqe() noexcept
+    {
+        const unsigned int head = atomic_ns::atomic_ref< unsigned int >(*m_sq_head).load(atomic_ns::memory_order_acquire);
+        if ((m_sqe_tail - head) >= m_sq_entries)
+            return nullptr;
+
+        struct ::io_uring_sqe* sqe = m_sqes + (m_sqe_tail & m_sq_mask);
+        std::memset(sqe, 0, sizeof(*sqe));
+        ++m_sqe_tail;
+        return sqe;
+    }
+
+    //! Submits the prepared entries and waits for at least \a wait_nr completions. Returns 0 on success or a system error code.
+    int submit_and_wait(unsigned int wait_nr) noexcept
+    {
+        unsigned int tail = *m_sq_tail;
+        for (; tail != m_sqe_tail; ++tail)
+            m_sq_array[tail & m_sq_mask] = tail & m_sq_mask;
+        atomic_ns::atomic_ref< unsigned int >(*m_sq_tail).store(tail, atomic_ns::memory_order_release);
+
+        // Also submit the entries that were published but not consumed by the kernel on previous calls
+        const unsigned int to_submit = tail - atomic_ns::atomic_ref< unsigned int >(*m_sq_head).load(atomic_ns::memory_order_acquire);
+
+        const long res = ::syscall(__NR_io_uring_enter, m_fd, to_submit, wait_nr, wait_nr > 0u ? IORING_ENTER_GETEVENTS : 0u, nullptr, 0u);
+        if (res < 0)
+            return errno;
+
+        return 0;
+    }
+
+    /*!
+     * \brief Takes back the entries that were prepared but not consumed by the kernel
+     *
+     * The \a fun function object is called with every entry taken back, in the order of submission. Returns the number
+     * of entries taken back. Must not be called concurrently with preparing and submitting entries.
+     */
+    template< typename Function >
+    unsigned int withdraw_unsubmitted(Function fun)
+    {
+        const unsigned int head = atomic_ns::atomic_ref< unsigned int >(*m_sq_head).load(atomic_ns::memory_order_acquire);
+        for (unsigned int pos = head; pos != m_sqe_tail; ++pos)
+            fun(m_sqes[pos & m_sq_mask]);
+
+        const unsigned int count = m_sqe_tail - head;
+        m_sqe_tail = head;
+        atomic_ns::atomic_ref< unsigned int >(*m_sq_tail).store(head, atomic_ns::memory_order_release);
+        return count;
+    }
+
+    /*!
+     * \brief Waits for at least \a wait_nr completions without submitting entries. Returns 0 on success or a system error code.
+     *
+     * Unlike other members, can be called concurrently with preparing and submitting entries in another thread.
+     */
+    int wait(unsigned int wait_nr) noexcept
+    {
+        const long res = ::syscall(__NR_io_uring_enter, m_fd, 0u, wait_nr, IORING_ENTER_GETEVENTS, nullptr, 0u);
+        if (res < 0)
+            return errno;
+
+        return 0;
+    }
+
+    //! Fills \a supported with flags indicating whether the corresponding opcodes are supported by the kernel. Returns 0 on success or a system error code.
+    int probe(bool* supported, unsigned int count) noexcept
+    {
+#if defined(__NR_io_uring_register)
+        const unsigned int max_ops = 256u;
+        alignas(struct ::io_uring_probe) unsigned char buf[sizeof(struct ::io_uring_probe) + max_ops * sizeof(struct ::io_uring_probe_op)];
+        std::memset(buf, 0, sizeof(buf));
+        struct ::io_uring_probe* const probe = reinterpret_cast< struct ::io_uring_probe* >(buf);
+        const long res = ::syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_PROBE, probe, max_ops);
+        if (res < 0)
+            return errno;
+
+        for (unsigned int i = 0u; i < count; ++i)
+            supported[i] = i <= probe->last_op && i < probe->ops_len && (probe->ops[i].flags & IO_URING_OP_SUPPORTED) != 0u;
+
+        return 0;
+#else
+        (void)supported;
+        (void)count;
+        return ENOSYS;
+#endif
+    }
+
+    //! Returns the next completion queue entry, or \c nullptr if there are no completions
+    struct ::io_uring_cqe* peek_cqe() noexcept
+    {
+        const unsigned int head = *m_cq_head;
+        const unsigned int tail = atomic_ns::atomic_ref< unsigned int >(*m_cq_tail).load(atomic_ns::memory_order_acquire);
+        if (head == tail)
+            return nullptr;
+
+        return m_cqes + (head & m_cq_mask);
+    }
+
+    //! Marks the completion queue entry returned by \c peek_cqe as consumed
+    void cqe_seen() noexcept
+    {
+        atomic_ns::atomic_ref< unsigned int >(*m_cq_head).store(*m_cq_head + 1u, atomic_ns::memory_order_release);
+    }
+};
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_SRC_IO_URING_HPP_
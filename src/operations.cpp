@@ -26,6 +26,8 @@
 #include <boost/assert.hpp>
 #include <new> // std::bad_alloc, std::nothrow
 #include <limits>
+#include <algorithm>
+#include <exception>
 #include <memory>
 #include <string>
 #include <utility>
@@ -34,6 +36,15 @@
 #include <cstring>
 #include <cerrno>
 #include <stdio.h> // for rename
+#include <chrono>
+#include <vector>
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <system_error>
+#endif
 
 // Default to POSIX under Emscripten
 // If BOOST_FILESYSTEM_EMSCRIPTEN_USE_WASI is set, use WASI instead
@@ -88,12 +99,23 @@
 #if !defined(BOOST_FILESYSTEM_DISABLE_COPY_FILE_RANGE) && defined(__NR_copy_file_range)
 #define BOOST_FILESYSTEM_USE_COPY_FILE_RANGE
 #endif // !defined(BOOST_FILESYSTEM_DISABLE_COPY_FILE_RANGE) && defined(__NR_copy_file_range)
+#include <sys/ioctl.h>
+#if !defined(FICLONE)
+// Defined in linux/fs.h since Linux 4.5. Use our definition to avoid including linux/fs.h, which conflicts with sys/mount.h.
+#define FICLONE _IOW(0x94, 9, int)
+#endif
+#define BOOST_FILESYSTEM_USE_FICLONE
 #if !defined(BOOST_FILESYSTEM_DISABLE_STATX) && (defined(BOOST_FILESYSTEM_HAS_STATX) || defined(BOOST_FILESYSTEM_HAS_STATX_SYSCALL))
 #if !defined(BOOST_FILESYSTEM_HAS_STATX) && defined(BOOST_FILESYSTEM_HAS_STATX_SYSCALL)
 #include <linux/stat.h>
 #endif
 #define BOOST_FILESYSTEM_USE_STATX
 #endif // !defined(BOOST_FILESYSTEM_DISABLE_STATX) && (defined(BOOST_FILESYSTEM_HAS_STATX) || defined(BOOST_FILESYSTEM_HAS_STATX_SYSCALL))
+#if defined(BOOST_FILESYSTEM_USE_STATX) && defined(BOOST_FILESYSTEM_HAS_IO_URING) && !defined(BOOST_FILESYSTEM_DISABLE_IO_URING)
+#include <sched.h>
+#include "io_uring.hpp"
+#define BOOST_FILESYSTEM_USE_IO_URING
+#endif
 
 #if defined(__has_include)
 #if __has_include(<linux/magic.h>)
@@ -166,6 +188,7 @@ using std::time_t;
 #endif // BOOST_FILESYSTEM_WINDOWS_API
 
 #include "atomic_tools.hpp"
+#include "thread_pool.hpp"
 #include "error_handling.hpp"
 #include "private_config.hpp"
 
@@ -218,6 +241,10 @@ using boost::system::system_category;
 #define SYMBOLIC_LINK_FLAG_ALLOW_UNPRIVILEGED_CREATE 0x2
 #endif
 
+#ifndef COPY_FILE_NO_BUFFERING
+#define COPY_FILE_NO_BUFFERING 0x00001000
+#endif
+
 #endif // defined(BOOST_FILESYSTEM_POSIX_API)
 
 //  POSIX/Windows macros  ----------------------------------------------------//
@@ -271,6 +298,115 @@ BOOST_CONSTEXPR_OR_CONST unsigned int remove_all_directory_replaced_retry_count
 // Size of a small buffer for a path that can be placed on stack, in character code units
 BOOST_CONSTEXPR_OR_CONST std::size_t small_path_size = 1024u;
 
+struct file_copy_progress;
+
+//! Progress reporting state of a copy_file or copy operation
+struct copy_progress_state
+{
+    copy_progress_handler const& handler;
+    const std::chrono::steady_clock::time_point start_time;
+    uintmax_t total_bytes_copied;
+    uintmax_t files_copied;
+    //! Indicates that the handler requested to cancel the operation. Can be tested without locking the mutex.
+    bool canceled;
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+    //! Serializes updates of the state and calls to the handler from threads of a parallel copy
+    std::mutex mutex;
+#endif
+
+    explicit copy_progress_state(copy_progress_handler const& h) :
+        handler(h),
+        start_time(std::chrono::steady_clock::now()),
+        total_bytes_copied(0u),
+        files_copied(0u),
+        canceled(false)
+    {
+    }
+
+    copy_progress_state(copy_progress_state const&) = delete;
+    copy_progress_state& operator=(copy_progress_state const&) = delete;
+
+    bool is_canceled() const noexcept
+    {
+        return filesystem::detail::atomic_load_relaxed(canceled);
+    }
+
+    /*!
+     * \brief Adds \a size bytes copied using \a strategy and, if \a file_complete is \c true, the file to the progress and calls the handler
+     *
+     * The progress of the file is also updated under the lock, since data of a file can be copied by multiple threads.
+     * Returns \c false if the operation is canceled.
+     */
+    bool report(file_copy_progress& file_progress, copy_strategy strategy, uintmax_t size, bool file_complete);
+};
+
+//! Progress of copying a single file
+struct file_copy_progress
+{
+    copy_progress_state* const state;
+    path const& from;
+    path const& to;
+    copy_strategy strategy;
+    uintmax_t file_size;
+    uintmax_t bytes_copied;
+
+    file_copy_progress(copy_progress_state* st, path const& f, path const& t) noexcept :
+        state(st),
+        from(f),
+        to(t),
+        strategy(copy_strategy::none),
+        file_size(0u),
+        bytes_copied(0u)
+    {
+    }
+
+    //! Reports that \a size bytes of the file were copied using \a strat. Returns \c false if the operation is canceled.
+    bool advance(copy_strategy strat, uintmax_t size)
+    {
+        return state->report(*this, strat, size, false);
+    }
+
+    //! Reports that the file has been copied. Returns \c false if the operation is canceled.
+    bool complete()
+    {
+        return state->report(*this, strategy, 0u, true);
+    }
+};
+
+bool copy_progress_state::report(file_copy_progress& file_progress, copy_strategy strategy, uintmax_t size, bool file_complete)
+{
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+    std::lock_guard< std::mutex > lock(mutex);
+#endif
+    if (canceled)
+        return false;
+
+    file_progress.strategy = strategy;
+    file_progress.bytes_copied += size;
+    total_bytes_copied += size;
+    files_copied += static_cast< uintmax_t >(file_complete);
+
+    const copy_progress progress =
+    {
+        file_progress.from,
+        file_progress.to,
+        file_progress.strategy,
+        file_progress.file_size,
+        file_progress.bytes_copied,
+        total_bytes_copied,
+        files_copied,
+        std::chrono::steady_clock::now() - start_time
+    };
+
+    if (!handler(progress))
+    {
+        filesystem::detail::atomic_store_relaxed(canceled, true);
+        return false;
+    }
+
+    return true;
+}
+
 #if defined(BOOST_FILESYSTEM_POSIX_API)
 
 //--------------------------------------------------------------------------------------//
@@ -455,6 +591,12 @@ inline std::size_t get_blksize(struct ::statx const& st) noexcept
     return st.stx_blksize;
 }
 
+//! Returns the device id from \c statx structure
+inline uintmax_t get_device(struct ::statx const& st) noexcept
+{
+    return (static_cast< uintmax_t >(st.stx_dev_major) << 32u) | st.stx_dev_minor;
+}
+
 #else // defined(BOOST_FILESYSTEM_USE_STATX)
 
 //! Returns \c true if the two \c stat structures refer to the same file
@@ -487,6 +629,12 @@ inline std::size_t get_blksize(struct ::stat const& st) noexcept
 #endif
 }
 
+//! Returns the device id from \c stat structure
+inline uintmax_t get_device(struct ::stat const& st) noexcept
+{
+    return st.st_dev;
+}
+
 #endif // defined(BOOST_FILESYSTEM_USE_STATX)
 
 } // namespace
@@ -535,21 +683,7 @@ file_status status_impl
     }
 #endif
 
-    const mode_t mode = get_mode(path_stat);
-    if (S_ISDIR(mode))
-        return fs::file_status(fs::directory_file, static_cast< perms >(mode) & fs::perms_mask);
-    if (S_ISREG(mode))
-        return fs::file_status(fs::regular_file, static_cast< perms >(mode) & fs::perms_mask);
-    if (S_ISBLK(mode))
-        return fs::file_status(fs::block_file, static_cast< perms >(mode) & fs::perms_mask);
-    if (S_ISCHR(mode))
-        return fs::file_status(fs::character_file, static_cast< perms >(mode) & fs::perms_mask);
-    if (S_ISFIFO(mode))
-        return fs::file_status(fs::fifo_file, static_cast< perms >(mode) & fs::perms_mask);
-    if (S_ISSOCK(mode))
-        return fs::file_status(fs::socket_file, static_cast< perms >(mode) & fs::perms_mask);
-
-    return fs::file_status(fs::type_unknown);
+    return status_from_mode(get_mode(path_stat));
 }
 
 //! symlink_status() implementation
@@ -617,426 +751,2040 @@ file_status symlink_status_impl
 
 namespace {
 
-//! Flushes buffered data and attributes written to the file to permanent storage
-inline int full_sync(int fd)
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+
+//! Returns the statx mask that is needed to obtain the specified attributes
+inline unsigned int entry_attributes_statx_mask(entry_attributes mask) noexcept
 {
-    while (true)
-    {
-#if defined(__APPLE__) && defined(__MACH__) && defined(F_FULLFSYNC)
-        // Mac OS does not flush data to physical storage with fsync()
-        int err = ::fcntl(fd, F_FULLFSYNC);
-#else
-        int err = ::fsync(fd);
-#endif
-        if (BOOST_UNLIKELY(err < 0))
-        {
-            err = errno;
-            // POSIX says fsync can return EINTR (https://pubs.opengroup.org/onlinepubs/9699919799/functions/fsync.html).
-            // fcntl(F_FULLFSYNC) isn't documented to return EINTR, but it doesn't hurt to check.
-            if (err == EINTR)
-                continue;
+    unsigned int stx_mask = STATX_TYPE | STATX_MODE;
+    if ((mask & entry_attributes::file_size) != entry_attributes::none)
+        stx_mask |= STATX_SIZE;
+    if ((mask & entry_attributes::last_write_time) != entry_attributes::none)
+        stx_mask |= STATX_MTIME;
+    if ((mask & entry_attributes::hard_link_count) != entry_attributes::none)
+        stx_mask |= STATX_NLINK;
+    if ((mask & entry_attributes::inode) != entry_attributes::none)
+        stx_mask |= STATX_INO;
+    if ((mask & entry_attributes::allocated_size) != entry_attributes::none)
+        stx_mask |= STATX_BLOCKS;
+
+    return stx_mask;
+}
 
-            return err;
-        }
+//! Fills the attributes and the file status from statx results. Returns the mask of attributes that were obtained.
+inline entry_attributes entry_attributes_from_statx(struct ::statx const& path_stat, entry_attributes mask, entry_attributes_cache& attrs, file_status& st) noexcept
+{
+    const mode_t mode = path_stat.stx_mode;
+    attrs.file_size = path_stat.stx_size;
+    attrs.last_write_time = path_stat.stx_mtime.tv_sec;
+    attrs.last_write_time_nsec = path_stat.stx_mtime.tv_nsec;
+    attrs.hard_link_count = path_stat.stx_nlink;
+    attrs.inode = path_stat.stx_ino;
+    attrs.allocated_size = static_cast< uintmax_t >(path_stat.stx_blocks) * 512u;
 
-        break;
+    st = status_from_mode(mode);
+
+    // Consistent with file_size(), the size is only defined for regular files
+    if (!S_ISREG(mode))
+    {
+        attrs.file_size = static_cast< uintmax_t >(-1);
+        mask &= ~entry_attributes::file_size;
     }
 
-    return 0;
+    return mask;
 }
 
-//! Flushes buffered data written to the file to permanent storage
-inline int data_sync(int fd)
+#endif // defined(BOOST_FILESYSTEM_USE_STATX)
+
+} // namespace
+
+//! Obtains the specified attributes of the file and its status (following symlinks)
+entry_attributes entry_attributes_impl
+(
+    path const& p,
+    entry_attributes mask,
+    entry_attributes_cache& attrs,
+    file_status& st,
+    system::error_code* ec
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) || defined(BOOST_FILESYSTEM_USE_STATX)
+    , int basedir_fd
+#endif
+)
 {
-#if defined(BOOST_FILESYSTEM_HAS_FDATASYNC) && !(defined(__APPLE__) && defined(__MACH__) && defined(F_FULLFSYNC))
-    while (true)
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    const unsigned int stx_mask = entry_attributes_statx_mask(mask);
+
+    struct ::statx path_stat;
+    if (BOOST_UNLIKELY(invoke_statx(basedir_fd, p.c_str(), AT_NO_AUTOMOUNT, stx_mask, &path_stat) < 0))
     {
-        int err = ::fdatasync(fd);
-        if (BOOST_UNLIKELY(err != 0))
-        {
-            err = errno;
-            // POSIX says fsync can return EINTR (https://pubs.opengroup.org/onlinepubs/9699919799/functions/fsync.html).
-            // It doesn't say so for fdatasync, but it is reasonable to expect it as well.
-            if (err == EINTR)
-                continue;
+        emit_error(errno, p, ec, "boost::filesystem::directory_entry::refresh");
+        return entry_attributes::none;
+    }
 
-            return err;
-        }
+    if (BOOST_UNLIKELY((path_stat.stx_mask & stx_mask) != stx_mask))
+    {
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::directory_entry::refresh");
+        return entry_attributes::none;
+    }
 
-        break;
+    return entry_attributes_from_statx(path_stat, mask, attrs, st);
+#else // defined(BOOST_FILESYSTEM_USE_STATX)
+    struct ::stat path_stat;
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    const int res = ::fstatat(basedir_fd, p.c_str(), &path_stat, AT_NO_AUTOMOUNT);
+#else
+    const int res = ::stat(p.c_str(), &path_stat);
+#endif
+    if (BOOST_UNLIKELY(res < 0))
+    {
+        emit_error(errno, p, ec, "boost::filesystem::directory_entry::refresh");
+        return entry_attributes::none;
     }
 
-    return 0;
+    const mode_t mode = path_stat.st_mode;
+    attrs.file_size = path_stat.st_size;
+    attrs.last_write_time = path_stat.st_mtime;
+#if defined(BOOST_FILESYSTEM_STAT_ST_MTIMENSEC)
+    attrs.last_write_time_nsec = static_cast< boost::uint32_t >(path_stat.BOOST_FILESYSTEM_STAT_ST_MTIMENSEC);
 #else
-    return full_sync(fd);
+    attrs.last_write_time_nsec = 0u;
 #endif
+    attrs.hard_link_count = path_stat.st_nlink;
+    attrs.inode = path_stat.st_ino;
+    // Note: POSIX does not specify the unit of st_blocks, but all known systems use 512-byte units
+    attrs.allocated_size = static_cast< uintmax_t >(path_stat.st_blocks) * 512u;
+
+    st = status_from_mode(mode);
+
+    // Consistent with file_size(), the size is only defined for regular files
+    if (!S_ISREG(mode))
+    {
+        attrs.file_size = static_cast< uintmax_t >(-1);
+        mask &= ~entry_attributes::file_size;
+    }
+
+    return mask;
+#endif // defined(BOOST_FILESYSTEM_USE_STATX)
 }
 
-//! Hints the filesystem to opportunistically preallocate storage for a file
-inline int preallocate_storage(int file, uintmax_t size)
+//! Obtains the attributes of the file used for disk usage accounting
+system::error_code file_usage_stat_impl
+(
+    path const& p,
+    bool follow_symlinks,
+    file_usage_stat& st
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) || defined(BOOST_FILESYSTEM_USE_STATX)
+    , int basedir_fd
+#endif
+)
 {
-#if defined(BOOST_FILESYSTEM_HAS_FALLOCATE)
-    if (BOOST_LIKELY(size > 0 && size <= static_cast< uintmax_t >((std::numeric_limits< off_t >::max)())))
+#if defined(BOOST_FILESYSTEM_USE_STATX)
+    const unsigned int stx_mask = STATX_TYPE | STATX_MODE | STATX_NLINK | STATX_INO | STATX_SIZE | STATX_BLOCKS;
+    struct ::statx path_stat;
+    if (BOOST_UNLIKELY(invoke_statx(basedir_fd, p.c_str(), (follow_symlinks ? 0 : AT_SYMLINK_NOFOLLOW) | AT_NO_AUTOMOUNT, stx_mask, &path_stat) < 0))
     {
-        while (true)
-        {
-            // Note: We intentionally use fallocate rather than posix_fallocate to avoid
-            //       invoking glibc emulation that writes zeros to the end of the file.
-            //       We want this call to act like a hint to the filesystem and an early
-            //       check for the free storage space. We don't want to write zeros only
-            //       to later overwrite them with the actual data.
-            int err = fallocate(file, FALLOC_FL_KEEP_SIZE, 0, static_cast< off_t >(size));
-            if (BOOST_UNLIKELY(err != 0))
-            {
-                err = errno;
+        const int err = errno;
+        return system::error_code(err, system::system_category());
+    }
 
-                // Ignore the error if the operation is not supported by the kernel or filesystem
-                if (err == EOPNOTSUPP || err == ENOSYS)
-                    break;
+    if (BOOST_UNLIKELY((path_stat.stx_mask & stx_mask) != stx_mask))
+        return system::error_code(BOOST_ERROR_NOT_SUPPORTED, system::system_category());
 
-                if (err == EINTR)
-                    continue;
+    st.type = status_from_mode(path_stat.stx_mode).type();
+    st.size = path_stat.stx_size;
+    st.allocated_size = static_cast< uintmax_t >(path_stat.stx_blocks) * 512u;
+    st.hard_link_count = path_stat.stx_nlink;
+    st.device = (static_cast< uintmax_t >(path_stat.stx_dev_major) << 32u) | path_stat.stx_dev_minor;
+    st.inode = path_stat.stx_ino;
+#else // defined(BOOST_FILESYSTEM_USE_STATX)
+    struct ::stat path_stat;
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    const int res = ::fstatat(basedir_fd, p.c_str(), &path_stat, (follow_symlinks ? 0 : AT_SYMLINK_NOFOLLOW) | AT_NO_AUTOMOUNT);
+#else
+    const int res = follow_symlinks ? ::stat(p.c_str(), &path_stat) : ::lstat(p.c_str(), &path_stat);
+#endif
+    if (BOOST_UNLIKELY(res < 0))
+    {
+        const int err = errno;
+        return system::error_code(err, system::system_category());
+    }
 
-                return err;
-            }
+    st.type = status_from_mode(path_stat.st_mode).type();
+    st.size = path_stat.st_size;
+    // Note: POSIX does not specify the unit of st_blocks, but all known systems use 512-byte units
+    st.allocated_size = static_cast< uintmax_t >(path_stat.st_blocks) * 512u;
+    st.hard_link_count = path_stat.st_nlink;
+    st.device = path_stat.st_dev;
+    st.inode = path_stat.st_ino;
+#endif // defined(BOOST_FILESYSTEM_USE_STATX)
 
-            break;
-        }
-    }
-#endif
+    return system::error_code();
+}
 
-    return 0;
+namespace {
+
+//! Obtains all attributes and file status of the file specified in the request. Errors are not reported.
+inline void process_entry_attributes_request(entry_attributes_request& request, int basedir_fd)
+{
+    // Errors are not reported, the attributes will be obtained when requested by the user
+    system::error_code ec;
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) || defined(BOOST_FILESYSTEM_USE_STATX)
+    request.attrs->mask = entry_attributes_impl(*request.p, entry_attributes::all, *request.attrs, *request.st, &ec, basedir_fd);
+#else
+    (void)basedir_fd;
+    request.attrs->mask = entry_attributes_impl(*request.p, entry_attributes::all, *request.attrs, *request.st, &ec);
+#endif
 }
 
-//! copy_file implementation wrapper that preallocates storage for the target file
-template< typename CopyFileData >
-struct copy_file_data_preallocate
+#if defined(BOOST_FILESYSTEM_USE_IO_URING)
+
+//! Indicates whether io_uring should be used to obtain attributes of multiple files. Set to \c false if io_uring is not supported.
+bool g_use_io_uring = false;
+
+//! Maximum number of statx requests in flight in io_uring
+BOOST_CONSTEXPR_OR_CONST unsigned int entry_attributes_io_uring_max_entries = 64u;
+
+//! io_uring instance and the buffers for the results of statx requests
+struct entry_attributes_io_uring
 {
-    //! copy_file implementation wrapper that preallocates storage for the target file before invoking the underlying copy implementation
-    static int impl(int infile, int outfile, uintmax_t size, std::size_t blksize)
+    struct statx_slot
     {
-        int err = preallocate_storage(outfile, size);
-        if (BOOST_UNLIKELY(err != 0))
-            return err;
+        struct ::statx buf;
+        std::size_t index;
+    };
+
+    io_uring_instance ring;
+    unsigned int slot_count;
+    statx_slot slots[entry_attributes_io_uring_max_entries];
+    unsigned int free_slots[entry_attributes_io_uring_max_entries];
 
-        return CopyFileData::impl(infile, outfile, size, blksize);
+    entry_attributes_io_uring() noexcept :
+        slot_count(0u)
+    {
     }
-};
 
-// Min and max buffer sizes are selected to minimize the overhead from system calls.
-// The values are picked based on coreutils cp(1) benchmarking data described here:
-// https://github.com/coreutils/coreutils/blob/d1b0257077c0b0f0ee25087efd46270345d1dd1f/src/ioblksize.h#L23-L72
-BOOST_CONSTEXPR_OR_CONST uint_least32_t min_read_write_buf_size = 8u * 1024u;
-BOOST_CONSTEXPR_OR_CONST uint_least32_t max_read_write_buf_size = 256u * 1024u;
+    //! Creates the ring. Returns 0 on success or a system error code.
+    int init() noexcept
+    {
+        const int err = ring.init(entry_attributes_io_uring_max_entries);
+        if (BOOST_LIKELY(err == 0))
+        {
+            const unsigned int sq_entries = ring.sq_entries();
+            slot_count = sq_entries < entry_attributes_io_uring_max_entries ? sq_entries : entry_attributes_io_uring_max_entries;
+        }
 
-//! copy_file read/write loop implementation
-int copy_file_data_read_write_impl(int infile, int outfile, char* buf, std::size_t buf_size)
+        return err;
+    }
+};
+
+/*!
+ * \brief Obtains attributes of the files by submitting statx requests to io_uring
+ *
+ * Returns \c false if io_uring failed, in which case the attributes of all files must be obtained by other means.
+ * The function does not return until the kernel has completed all submitted requests, so that the buffers can be reused.
+ */
+bool entry_attributes_batch_io_uring(entry_attributes_io_uring& uring, entry_attributes_request* requests, std::size_t count, int basedir_fd)
 {
-#if defined(BOOST_FILESYSTEM_HAS_POSIX_FADVISE)
-    ::posix_fadvise(infile, 0, 0, POSIX_FADV_SEQUENTIAL);
-#endif
+    io_uring_instance& ring = uring.ring;
+    unsigned int free_slot_count = uring.slot_count;
+    for (unsigned int i = 0u; i < free_slot_count; ++i)
+        uring.free_slots[i] = i;
 
-    // Don't use file size to limit the amount of data to copy since some filesystems, like procfs or sysfs,
-    // provide files with generated content and indicate that their size is zero or 4096. Just copy as much data
-    // as we can read from the input file.
-    while (true)
+    // Releases the slots of the entries that were not consumed by the kernel, as they will not complete
+    auto withdraw_unsubmitted = [&uring, &free_slot_count](struct ::io_uring_sqe const& sqe)
     {
-        ssize_t sz_read = ::read(infile, buf, buf_size);
-        if (sz_read == 0)
-            break;
-        if (BOOST_UNLIKELY(sz_read < 0))
+        uring.free_slots[free_slot_count++] = static_cast< unsigned int >(sqe.user_data);
+    };
+
+    const unsigned int stx_mask = entry_attributes_statx_mask(entry_attributes::all);
+    std::size_t next = 0u;
+    unsigned int in_flight = 0u;
+    bool failed = false;
+    while (in_flight > 0u || (!failed && next < count))
+    {
+        while (!failed && next < count && free_slot_count > 0u)
         {
-            int err = errno;
-            if (err == EINTR)
-                continue;
-            return err;
+            struct ::io_uring_sqe* sqe = ring.get_sqe();
+            if (!sqe)
+                break;
+
+            const unsigned int slot = uring.free_slots[--free_slot_count];
+            uring.slots[slot].index = next;
+            sqe->opcode = IORING_OP_STATX;
+            sqe->fd = basedir_fd;
+            sqe->addr = reinterpret_cast< boost::uint64_t >(requests[next].p->c_str());
+            sqe->len = stx_mask;
+            sqe->off = reinterpret_cast< boost::uint64_t >(&uring.slots[slot].buf);
+            sqe->statx_flags = AT_NO_AUTOMOUNT;
+            sqe->user_data = slot;
+            ++next;
+            ++in_flight;
         }
 
-        // Allow for partial writes - see Advanced Unix Programming (2nd Ed.),
-        // Marc Rochkind, Addison-Wesley, 2004, page 94
-        for (ssize_t sz_wrote = 0; sz_wrote < sz_read;)
+        const int enter_err = failed ? ring.wait(1u) : ring.submit_and_wait(1u);
+        if (BOOST_UNLIKELY(enter_err != 0 && enter_err != EINTR && enter_err != EAGAIN && enter_err != EBUSY))
         {
-            ssize_t sz = ::write(outfile, buf + sz_wrote, static_cast< std::size_t >(sz_read - sz_wrote));
-            if (BOOST_UNLIKELY(sz < 0))
+            if (!failed)
             {
-                int err = errno;
-                if (err == EINTR)
-                    continue;
-                return err;
+                failed = true;
+                in_flight -= ring.withdraw_unsubmitted(withdraw_unsubmitted);
+            }
+            else
+            {
+                // The kernel may still write to the buffers of the requests in flight, so wait for them to complete
+                // by polling the completion queue
+                ::sched_yield();
             }
-
-            sz_wrote += sz;
         }
-    }
 
-    return 0;
-}
-
-//! copy_file implementation that uses read/write loop (fallback using a stack buffer)
-int copy_file_data_read_write_stack_buf(int infile, int outfile)
-{
-    char stack_buf[min_read_write_buf_size];
-    return copy_file_data_read_write_impl(infile, outfile, stack_buf, sizeof(stack_buf));
-}
+        for (struct ::io_uring_cqe* cqe = ring.peek_cqe(); cqe != nullptr; cqe = ring.peek_cqe())
+        {
+            const unsigned int slot = static_cast< unsigned int >(cqe->user_data);
+            entry_attributes_request& request = requests[uring.slots[slot].index];
+            if (cqe->res == 0 && (uring.slots[slot].buf.stx_mask & stx_mask) == stx_mask)
+            {
+                request.attrs->mask = entry_attributes_from_statx(uring.slots[slot].buf, entry_attributes::all, *request.attrs, *request.st);
+            }
+            else
+            {
+                request.attrs->mask = entry_attributes::none;
+                if (BOOST_UNLIKELY(cqe->res == -EINVAL))
+                {
+                    // The kernel does not support IORING_OP_STATX
+                    filesystem::detail::atomic_store_relaxed(g_use_io_uring, false);
+                    if (!failed)
+                    {
+                        failed = true;
+                        in_flight -= ring.withdraw_unsubmitted(withdraw_unsubmitted);
+                    }
+                }
+            }
 
-//! copy_file implementation that uses read/write loop
-int copy_file_data_read_write(int infile, int outfile, uintmax_t size, std::size_t blksize)
-{
-    {
-        uintmax_t buf_sz = size;
-        // Prefer the buffer to be larger than the file size so that we don't have
-        // to perform an extra read if the file fits in the buffer exactly.
-        buf_sz += (buf_sz < ~static_cast< uintmax_t >(0u));
-        if (buf_sz < blksize)
-            buf_sz = blksize;
-        if (buf_sz < min_read_write_buf_size)
-            buf_sz = min_read_write_buf_size;
-        if (buf_sz > max_read_write_buf_size)
-            buf_sz = max_read_write_buf_size;
-        const std::size_t buf_size = static_cast< std::size_t >(boost::core::bit_ceil(static_cast< uint_least32_t >(buf_sz)));
-        std::unique_ptr< char[] > buf(new (std::nothrow) char[buf_size]);
-        if (BOOST_LIKELY(!!buf.get()))
-            return copy_file_data_read_write_impl(infile, outfile, buf.get(), buf_size);
+            ring.cqe_seen();
+            uring.free_slots[free_slot_count++] = slot;
+            --in_flight;
+        }
     }
 
-    return copy_file_data_read_write_stack_buf(infile, outfile);
+    return !failed;
 }
 
-typedef int copy_file_data_t(int infile, int outfile, uintmax_t size, std::size_t blksize);
+#endif // defined(BOOST_FILESYSTEM_USE_IO_URING)
 
-//! Pointer to the actual implementation of copy_file_data
-copy_file_data_t* copy_file_data = &copy_file_data_read_write;
-
-#if defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
 
-//! copy_file_data wrapper that tests if a read/write loop must be used for a given filesystem
-template< typename CopyFileData >
-int check_fs_type(int infile, int outfile, uintmax_t size, std::size_t blksize);
+//! Maximum number of threads used to obtain attributes of multiple files when io_uring is not available
+BOOST_CONSTEXPR_OR_CONST unsigned int entry_attributes_batch_max_threads = 8u;
 
-#endif // defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+/*!
+ * \brief Threads that help the owning thread to obtain attributes of multiple files
+ *
+ * The threads are started when first needed and wait for the next batch of requests between batches,
+ * until the object is destroyed. Batches are only submitted by the owning thread, which also processes requests.
+ */
+class entry_attributes_batch_workers
+{
+private:
+    std::mutex m_mutex;
+    //! Signalled when a new batch is submitted or the threads need to terminate
+    std::condition_variable m_start_cond;
+    //! Signalled when the worker threads finish processing a batch
+    std::condition_variable m_done_cond;
+    std::vector< std::thread > m_threads;
+
+    entry_attributes_request* m_requests;
+    std::size_t m_count;
+    int m_basedir_fd;
+    std::atomic< std::size_t > m_next_index;
+    //! Incremented for every batch that is processed by worker threads
+    unsigned int m_generation;
+    //! Number of worker threads that take part in processing the current batch
+    unsigned int m_helper_count;
+    //! Number of worker threads that have not finished processing the current batch
+    unsigned int m_active_count;
+    bool m_stopping;
+
+public:
+    entry_attributes_batch_workers() :
+        m_requests(nullptr),
+        m_count(0u),
+        m_basedir_fd(-1),
+        m_next_index(0u),
+        m_generation(0u),
+        m_helper_count(0u),
+        m_active_count(0u),
+        m_stopping(false)
+    {
+    }
+
+    entry_attributes_batch_workers(entry_attributes_batch_workers const&) = delete;
+    entry_attributes_batch_workers& operator=(entry_attributes_batch_workers const&) = delete;
+
+    ~entry_attributes_batch_workers()
+    {
+        {
+            std::lock_guard< std::mutex > lock(m_mutex);
+            m_stopping = true;
+        }
+        m_start_cond.notify_all();
 
-#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
+        for (std::size_t i = 0u, n = m_threads.size(); i < n; ++i)
+            m_threads[i].join();
+    }
 
-struct copy_file_data_sendfile
-{
-    //! copy_file implementation that uses sendfile loop. Requires sendfile to support file descriptors.
-    static int impl(int infile, int outfile, uintmax_t size, std::size_t blksize)
+    //! Obtains attributes of the files in the calling thread and worker threads
+    void run(entry_attributes_request* requests, std::size_t count, int basedir_fd)
     {
-        // sendfile will not send more than this amount of data in one call
-        BOOST_CONSTEXPR_OR_CONST std::size_t max_batch_size = 0x7ffff000u;
-        uintmax_t offset = 0u;
-        while (offset < size)
+        std::size_t helper_count = (count < entry_attributes_batch_max_threads ? count : entry_attributes_batch_max_threads) - 1u;
+        if (m_threads.size() < helper_count)
         {
-            uintmax_t size_left = size - offset;
-            std::size_t size_to_copy = max_batch_size;
-            if (size_left < static_cast< uintmax_t >(max_batch_size))
-                size_to_copy = static_cast< std::size_t >(size_left);
-            ssize_t sz = ::sendfile(outfile, infile, nullptr, size_to_copy);
-            if (BOOST_LIKELY(sz > 0))
+            // If some threads could not be started, the requests are processed by the remaining threads
+            try
             {
-                offset += sz;
+                m_threads.reserve(entry_attributes_batch_max_threads - 1u);
+                while (m_threads.size() < helper_count)
+                    m_threads.emplace_back(&entry_attributes_batch_workers::worker_loop, this, static_cast< unsigned int >(m_threads.size()), m_generation);
             }
-            else if (sz < 0)
+            catch (std::bad_alloc&)
             {
-                int err = errno;
-                if (err == EINTR)
-                    continue;
-
-                if (offset == 0u)
-                {
-                    // sendfile may fail with EINVAL if the underlying filesystem does not support it
-                    if (err == EINVAL)
-                    {
-                    fallback_to_read_write:
-                        return copy_file_data_read_write(infile, outfile, size, blksize);
-                    }
+            }
+            catch (std::system_error&)
+            {
+            }
 
-                    if (err == ENOSYS)
-                    {
-                        filesystem::detail::atomic_store_relaxed(copy_file_data, &copy_file_data_read_write);
-                        goto fallback_to_read_write;
-                    }
-                }
+            if (m_threads.size() < helper_count)
+                helper_count = m_threads.size();
+        }
 
-                return err;
-            }
-            else
+        {
+            std::lock_guard< std::mutex > lock(m_mutex);
+            m_requests = requests;
+            m_count = count;
+            m_basedir_fd = basedir_fd;
+            m_next_index.store(0u, std::memory_order_relaxed);
+            if (helper_count > 0u)
             {
-                // EOF: the input file was truncated while copying was in progress
-                break;
+                m_helper_count = static_cast< unsigned int >(helper_count);
+                m_active_count = m_helper_count;
+                ++m_generation;
             }
         }
 
-        return 0;
-    }
-};
+        if (helper_count > 0u)
+            m_start_cond.notify_all();
 
-#endif // defined(BOOST_FILESYSTEM_USE_SENDFILE)
+        process_requests();
 
-#if defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+        if (helper_count > 0u)
+        {
+            std::unique_lock< std::mutex > lock(m_mutex);
+            while (m_active_count > 0u)
+                m_done_cond.wait(lock);
+        }
+    }
 
-struct copy_file_data_copy_file_range
-{
-    //! copy_file implementation that uses copy_file_range loop. Requires copy_file_range to support cross-filesystem copying.
-    static int impl(int infile, int outfile, uintmax_t size, std::size_t blksize)
+private:
+    void worker_loop(unsigned int index, unsigned int generation) noexcept
     {
-        // Although copy_file_range does not document any particular upper limit of one transfer, still use some upper bound to guarantee
-        // that size_t is not overflown in case if off_t is larger and the file size does not fit in size_t.
-        BOOST_CONSTEXPR_OR_CONST std::size_t max_batch_size = 0x7ffff000u;
-        uintmax_t offset = 0u;
-        while (offset < size)
+        std::unique_lock< std::mutex > lock(m_mutex);
+        while (true)
         {
-            uintmax_t size_left = size - offset;
-            std::size_t size_to_copy = max_batch_size;
-            if (size_left < static_cast< uintmax_t >(max_batch_size))
-                size_to_copy = static_cast< std::size_t >(size_left);
-            // Note: Use syscall directly to avoid depending on libc version. copy_file_range is added in glibc 2.27.
-            // uClibc-ng does not have copy_file_range as of the time of this writing (the latest uClibc-ng release is 1.0.33).
-            loff_t sz = ::syscall(__NR_copy_file_range, infile, (loff_t*)nullptr, outfile, (loff_t*)nullptr, size_to_copy, (unsigned int)0u);
-            if (BOOST_LIKELY(sz > 0))
-            {
-                offset += sz;
-            }
-            else if (sz < 0)
-            {
-                int err = errno;
-                if (err == EINTR)
-                    continue;
-
-                if (offset == 0u)
-                {
-                    // copy_file_range may fail with EINVAL if the underlying filesystem does not support it.
-                    // In some RHEL/CentOS 7.7-7.8 kernel versions, copy_file_range on NFSv4 is also known to return EOPNOTSUPP
-                    // if the remote server does not support COPY, despite that it is not a documented error code.
-                    // See https://patchwork.kernel.org/project/linux-nfs/patch/20190411183418.4510-1-olga.kornievskaia@gmail.com/
-                    // and https://bugzilla.redhat.com/show_bug.cgi?id=1783554.
-                    if (err == EINVAL || err == EOPNOTSUPP)
-                    {
-#if !defined(BOOST_FILESYSTEM_USE_SENDFILE)
-                    fallback_to_read_write:
-#endif
-                        return copy_file_data_read_write(infile, outfile, size, blksize);
-                    }
-
-                    if (err == EXDEV)
-                    {
-#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
-                    fallback_to_sendfile:
-                        return copy_file_data_sendfile::impl(infile, outfile, size, blksize);
-#else
-                        goto fallback_to_read_write;
-#endif
-                    }
+            while (m_generation == generation && !m_stopping)
+                m_start_cond.wait(lock);
 
-                    if (err == ENOSYS)
-                    {
-#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
-                        filesystem::detail::atomic_store_relaxed(copy_file_data, &check_fs_type< copy_file_data_preallocate< copy_file_data_sendfile > >);
-                        goto fallback_to_sendfile;
-#else
-                        filesystem::detail::atomic_store_relaxed(copy_file_data, &copy_file_data_read_write);
-                        goto fallback_to_read_write;
-#endif
-                    }
-                }
+            if (m_stopping)
+                break;
 
-                return err;
-            }
-            else
+            // The thread may have missed the batches it did not take part in, but not the ones it did,
+            // because the owning thread waits for the participating threads before submitting the next batch
+            generation = m_generation;
+            if (index < m_helper_count)
             {
-                // EOF: the input file was truncated while copying was in progress
-                break;
+                lock.unlock();
+                process_requests();
+                lock.lock();
+
+                if (--m_active_count == 0u)
+                    m_done_cond.notify_one();
             }
         }
+    }
 
-        return 0;
+    void process_requests() noexcept
+    {
+        // Requests are taken in order, so that if they are sorted by the caller, they are also issued in that order
+        for (std::size_t i = m_next_index.fetch_add(1u, std::memory_order_relaxed); i < m_count; i = m_next_index.fetch_add(1u, std::memory_order_relaxed))
+            process_entry_attributes_request(m_requests[i], m_basedir_fd);
     }
 };
 
-#endif // defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+#endif // !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
 
-#if defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+/*!
+ * \brief Resources used to obtain attributes of multiple files
+ *
+ * Setting up an io_uring instance or starting threads is expensive compared to a batch of requests for a small
+ * directory, so the resources are created when first needed and are reused for subsequent batches.
+ */
+struct entry_attributes_batch_context
+{
+#if defined(BOOST_FILESYSTEM_USE_IO_URING)
+    std::unique_ptr< entry_attributes_io_uring > uring;
+#endif
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+    entry_attributes_batch_workers workers;
+#endif
+};
 
-//! copy_file_data wrapper that tests if a read/write loop must be used for a given filesystem
-template< typename CopyFileData >
-int check_fs_type(int infile, int outfile, uintmax_t size, std::size_t blksize)
+//! Creates a new context. Returns \c nullptr in case of failure.
+inline entry_attributes_batch_context* create_entry_attributes_batch_context() noexcept
 {
+    try
     {
-        // Some filesystems have regular files with generated content. Such files have arbitrary size, including zero,
-        // but have actual content. Linux system calls sendfile or copy_file_range will not copy contents of such files,
-        // so we must use a read/write loop to handle them.
-        // https://lore.kernel.org/linux-fsdevel/20210212044405.4120619-1-drinkcat@chromium.org/T/
-        struct statfs sfs;
-        while (true)
-        {
-            int err = ::fstatfs(infile, &sfs);
-            if (BOOST_UNLIKELY(err < 0))
-            {
-                err = errno;
-                if (err == EINTR)
-                    continue;
+        return new entry_attributes_batch_context();
+    }
+    catch (...)
+    {
+        return nullptr;
+    }
+}
 
-                goto fallback_to_read_write;
-            }
+#if !defined(BOOST_NO_CXX11_THREAD_LOCAL)
 
-            break;
-        }
+#define BOOST_FILESYSTEM_USE_ENTRY_ATTRIBUTES_BATCH_CONTEXT_CACHE
 
-        if (BOOST_UNLIKELY(sfs.f_type == PROC_SUPER_MAGIC ||
-            sfs.f_type == SYSFS_MAGIC ||
-            sfs.f_type == 0x63677270 || // CGROUP2_SUPER_MAGIC
-            sfs.f_type == 0x0027e0eb || // CGROUP_SUPER_MAGIC
-            sfs.f_type == 0x73636673 || // SECURITYFS_MAGIC
-            sfs.f_type == 0x62656570 || // CONFIGFS_MAGIC
-            sfs.f_type == TRACEFS_MAGIC ||
-            sfs.f_type == DEBUGFS_MAGIC))
+//! Per-thread context used to obtain attributes of multiple files. Trivially destructible, so that it can still be used during thread termination.
+struct entry_attributes_batch_context_cache
+{
+    entry_attributes_batch_context* context;
+    //! Indicates that entry_attributes_batch_context_cleanup was registered to destroy the context on thread termination
+    bool cleanup_registered;
+    //! Indicates that the thread is terminating and no context can be cached
+    bool disabled;
+};
+
+thread_local entry_attributes_batch_context_cache g_entry_attributes_batch_context_cache;
+
+//! Destroys the context cached by the current thread on thread termination
+struct entry_attributes_batch_context_cleanup
+{
+    ~entry_attributes_batch_context_cleanup()
+    {
+        entry_attributes_batch_context_cache& cache = g_entry_attributes_batch_context_cache;
+        cache.disabled = true;
+        delete cache.context;
+        cache.context = nullptr;
+    }
+};
+
+//! Returns the context of the current thread, creating it if needed. Returns \c nullptr if the context cannot be created.
+inline entry_attributes_batch_context* get_entry_attributes_batch_context() noexcept
+{
+    entry_attributes_batch_context_cache& cache = g_entry_attributes_batch_context_cache;
+    if (BOOST_UNLIKELY(!cache.context))
+    {
+        if (cache.disabled)
+            return nullptr;
+
+        if (!cache.cleanup_registered)
         {
-        fallback_to_read_write:
-            return copy_file_data_read_write(infile, outfile, size, blksize);
+            static thread_local entry_attributes_batch_context_cleanup cleanup;
+            (void)cleanup;
+            cache.cleanup_registered = true;
         }
+
+        cache.context = create_entry_attributes_batch_context();
     }
 
-    return CopyFileData::impl(infile, outfile, size, blksize);
+    return cache.context;
 }
 
-#endif // defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
-
-#if defined(linux) || defined(__linux) || defined(__linux__)
+#endif // !defined(BOOST_NO_CXX11_THREAD_LOCAL)
 
-//! Initializes copy_file_data implementation pointer
-inline void init_copy_file_data_impl(unsigned int major_ver, unsigned int minor_ver, unsigned int patch_ver)
-{
-#if defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
-    copy_file_data_t* cfd = &copy_file_data_read_write;
+} // namespace
 
-#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
-    // sendfile started accepting file descriptors as the target in Linux 2.6.33
-    if (major_ver > 2u || (major_ver == 2u && (minor_ver > 6u || (minor_ver == 6u && patch_ver >= 33u))))
-        cfd = &check_fs_type< copy_file_data_preallocate< copy_file_data_sendfile > >;
+//! Obtains all attributes and file statuses of multiple files concurrently
+void entry_attributes_batch_impl
+(
+    entry_attributes_request* requests,
+    std::size_t count
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) || defined(BOOST_FILESYSTEM_USE_STATX)
+    , int basedir_fd
 #endif
-
-#if defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
-    // Although copy_file_range appeared in Linux 4.5, it did not support cross-filesystem copying until 5.3.
-    // copy_file_data_copy_file_range will fallback to copy_file_data_sendfile if copy_file_range returns EXDEV.
-    if (major_ver > 4u || (major_ver == 4u && minor_ver >= 5u))
-        cfd = &check_fs_type< copy_file_data_preallocate< copy_file_data_copy_file_range > >;
+)
+{
+#if !(defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) || defined(BOOST_FILESYSTEM_USE_STATX))
+    const int basedir_fd = -1;
 #endif
 
-    filesystem::detail::atomic_store_relaxed(copy_file_data, cfd);
-#endif // defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
-}
-
-#endif // defined(linux) || defined(__linux) || defined(__linux__)
+    if (count == 0u)
+        return;
 
-#if defined(linux) || defined(__linux) || defined(__linux__)
+    entry_attributes_batch_context* context = nullptr;
+#if defined(BOOST_FILESYSTEM_USE_ENTRY_ATTRIBUTES_BATCH_CONTEXT_CACHE)
+    context = get_entry_attributes_batch_context();
+#endif
 
-struct syscall_initializer
-{
-    syscall_initializer()
+    std::unique_ptr< entry_attributes_batch_context > local_context;
+    if (BOOST_UNLIKELY(!context && count > 1u))
     {
-        struct ::utsname system_info;
-        if (BOOST_UNLIKELY(::uname(&system_info) < 0))
-            return;
+        // The context cannot be cached by the current thread, use one for this batch only
+        local_context.reset(create_entry_attributes_batch_context());
+        context = local_context.get();
+    }
+
+    if (context)
+    {
+#if defined(BOOST_FILESYSTEM_USE_IO_URING)
+        if (filesystem::detail::atomic_load_relaxed(g_use_io_uring))
+        {
+            if (!context->uring)
+            {
+                context->uring.reset(new (std::nothrow) entry_attributes_io_uring());
+                if (BOOST_LIKELY(!!context->uring))
+                {
+                    const int err = context->uring->init();
+                    if (BOOST_UNLIKELY(err != 0))
+                    {
+                        // io_uring may be blocked by seccomp filters or disabled by kernel.io_uring_disabled sysctl
+                        if (err == ENOSYS || err == EPERM || err == EACCES)
+                            filesystem::detail::atomic_store_relaxed(g_use_io_uring, false);
+                        context->uring.reset();
+                    }
+                }
+            }
+
+            if (context->uring)
+            {
+                if (BOOST_LIKELY(entry_attributes_batch_io_uring(*context->uring, requests, count, basedir_fd)))
+                    return;
+
+                // The ring may be unusable after a failure, a new one will be created for the next batch
+                context->uring.reset();
+            }
+        }
+#endif // defined(BOOST_FILESYSTEM_USE_IO_URING)
+
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+        context->workers.run(requests, count, basedir_fd);
+        return;
+#endif
+    }
+
+    for (std::size_t i = 0u; i < count; ++i)
+        process_entry_attributes_request(requests[i], basedir_fd);
+}
+
+namespace {
+
+//! Flushes buffered data and attributes written to the file to permanent storage
+inline int full_sync(int fd)
+{
+    while (true)
+    {
+#if defined(__APPLE__) && defined(__MACH__) && defined(F_FULLFSYNC)
+        // Mac OS does not flush data to physical storage with fsync()
+        int err = ::fcntl(fd, F_FULLFSYNC);
+#else
+        int err = ::fsync(fd);
+#endif
+        if (BOOST_UNLIKELY(err < 0))
+        {
+            err = errno;
+            // POSIX says fsync can return EINTR (https://pubs.opengroup.org/onlinepubs/9699919799/functions/fsync.html).
+            // fcntl(F_FULLFSYNC) isn't documented to return EINTR, but it doesn't hurt to check.
+            if (err == EINTR)
+                continue;
+
+            return err;
+        }
+
+        break;
+    }
+
+    return 0;
+}
+
+//! Flushes buffered data written to the file to permanent storage
+inline int data_sync(int fd)
+{
+#if defined(BOOST_FILESYSTEM_HAS_FDATASYNC) && !(defined(__APPLE__) && defined(__MACH__) && defined(F_FULLFSYNC))
+    while (true)
+    {
+        int err = ::fdatasync(fd);
+        if (BOOST_UNLIKELY(err != 0))
+        {
+            err = errno;
+            // POSIX says fsync can return EINTR (https://pubs.opengroup.org/onlinepubs/9699919799/functions/fsync.html).
+            // It doesn't say so for fdatasync, but it is reasonable to expect it as well.
+            if (err == EINTR)
+                continue;
+
+            return err;
+        }
+
+        break;
+    }
+
+    return 0;
+#else
+    return full_sync(fd);
+#endif
+}
+
+//! Hints the filesystem to opportunistically preallocate storage for a file
+inline int preallocate_storage(int file, uintmax_t size)
+{
+#if defined(BOOST_FILESYSTEM_HAS_FALLOCATE)
+    if (BOOST_LIKELY(size > 0 && size <= static_cast< uintmax_t >((std::numeric_limits< off_t >::max)())))
+    {
+        while (true)
+        {
+            // Note: We intentionally use fallocate rather than posix_fallocate to avoid
+            //       invoking glibc emulation that writes zeros to the end of the file.
+            //       We want this call to act like a hint to the filesystem and an early
+            //       check for the free storage space. We don't want to write zeros only
+            //       to later overwrite them with the actual data.
+            int err = fallocate(file, FALLOC_FL_KEEP_SIZE, 0, static_cast< off_t >(size));
+            if (BOOST_UNLIKELY(err != 0))
+            {
+                err = errno;
+
+                // Ignore the error if the operation is not supported by the kernel or filesystem
+                if (err == EOPNOTSUPP || err == ENOSYS)
+                    break;
+
+                if (err == EINTR)
+                    continue;
+
+                return err;
+            }
+
+            break;
+        }
+    }
+#endif
+
+    return 0;
+}
+
+//! copy_file implementation wrapper that preallocates storage for the target file
+template< typename CopyFileData >
+struct copy_file_data_preallocate
+{
+    //! copy_file implementation wrapper that preallocates storage for the target file before invoking the underlying copy implementation
+    static int impl(int infile, int outfile, uintmax_t size, std::size_t blksize, file_copy_progress* progress)
+    {
+        int err = preallocate_storage(outfile, size);
+        if (BOOST_UNLIKELY(err != 0))
+            return err;
+
+        return CopyFileData::impl(infile, outfile, size, blksize, progress);
+    }
+};
+
+// Min and max buffer sizes are selected to minimize the overhead from system calls.
+// The values are picked based on coreutils cp(1) benchmarking data described here:
+// https://github.com/coreutils/coreutils/blob/d1b0257077c0b0f0ee25087efd46270345d1dd1f/src/ioblksize.h#L23-L72
+BOOST_CONSTEXPR_OR_CONST uint_least32_t min_read_write_buf_size = 8u * 1024u;
+BOOST_CONSTEXPR_OR_CONST uint_least32_t max_read_write_buf_size = 256u * 1024u;
+
+//! Max amount of data copied by one call to sendfile or copy_file_range when progress is reported
+BOOST_CONSTEXPR_OR_CONST std::size_t progress_batch_size = 16u * 1024u * 1024u;
+
+//! copy_file read/write loop implementation
+int copy_file_data_read_write_impl(int infile, int outfile, char* buf, std::size_t buf_size, file_copy_progress* progress)
+{
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_FADVISE)
+    ::posix_fadvise(infile, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+
+    // Don't use file size to limit the amount of data to copy since some filesystems, like procfs or sysfs,
+    // provide files with generated content and indicate that their size is zero or 4096. Just copy as much data
+    // as we can read from the input file.
+    while (true)
+    {
+        ssize_t sz_read = ::read(infile, buf, buf_size);
+        if (sz_read == 0)
+            break;
+        if (BOOST_UNLIKELY(sz_read < 0))
+        {
+            int err = errno;
+            if (err == EINTR)
+                continue;
+            return err;
+        }
+
+        // Allow for partial writes - see Advanced Unix Programming (2nd Ed.),
+        // Marc Rochkind, Addison-Wesley, 2004, page 94
+        for (ssize_t sz_wrote = 0; sz_wrote < sz_read;)
+        {
+            ssize_t sz = ::write(outfile, buf + sz_wrote, static_cast< std::size_t >(sz_read - sz_wrote));
+            if (BOOST_UNLIKELY(sz < 0))
+            {
+                int err = errno;
+                if (err == EINTR)
+                    continue;
+                return err;
+            }
+
+            sz_wrote += sz;
+        }
+
+        if (progress && !progress->advance(copy_strategy::read_write, static_cast< uintmax_t >(sz_read)))
+            return ECANCELED;
+    }
+
+    return 0;
+}
+
+//! copy_file implementation that uses read/write loop (fallback using a stack buffer)
+int copy_file_data_read_write_stack_buf(int infile, int outfile, file_copy_progress* progress)
+{
+    char stack_buf[min_read_write_buf_size];
+    return copy_file_data_read_write_impl(infile, outfile, stack_buf, sizeof(stack_buf), progress);
+}
+
+//! copy_file implementation that uses read/write loop
+int copy_file_data_read_write(int infile, int outfile, uintmax_t size, std::size_t blksize, file_copy_progress* progress)
+{
+    {
+        uintmax_t buf_sz = size;
+        // Prefer the buffer to be larger than the file size so that we don't have
+        // to perform an extra read if the file fits in the buffer exactly.
+        buf_sz += (buf_sz < ~static_cast< uintmax_t >(0u));
+        if (buf_sz < blksize)
+            buf_sz = blksize;
+        if (buf_sz < min_read_write_buf_size)
+            buf_sz = min_read_write_buf_size;
+        if (buf_sz > max_read_write_buf_size)
+            buf_sz = max_read_write_buf_size;
+        const std::size_t buf_size = static_cast< std::size_t >(boost::core::bit_ceil(static_cast< uint_least32_t >(buf_sz)));
+        std::unique_ptr< char[] > buf(new (std::nothrow) char[buf_size]);
+        if (BOOST_LIKELY(!!buf.get()))
+            return copy_file_data_read_write_impl(infile, outfile, buf.get(), buf_size, progress);
+    }
+
+    return copy_file_data_read_write_stack_buf(infile, outfile, progress);
+}
+
+typedef int copy_file_data_t(int infile, int outfile, uintmax_t size, std::size_t blksize, file_copy_progress* progress);
+
+//! Pointer to the actual implementation of copy_file_data
+copy_file_data_t* copy_file_data = &copy_file_data_read_write;
+
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+
+//! copy_file_data wrapper that tests if a read/write loop must be used for a given filesystem
+template< typename CopyFileData >
+int check_fs_type(int infile, int outfile, uintmax_t size, std::size_t blksize, file_copy_progress* progress);
+
+#endif // defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
+
+struct copy_file_data_sendfile
+{
+    //! copy_file implementation that uses sendfile loop. Requires sendfile to support file descriptors.
+    static int impl(int infile, int outfile, uintmax_t size, std::size_t blksize, file_copy_progress* progress)
+    {
+        // sendfile will not send more than this amount of data in one call
+        BOOST_CONSTEXPR_OR_CONST std::size_t max_batch_size = 0x7ffff000u;
+        const std::size_t batch_size = progress ? progress_batch_size : max_batch_size;
+        uintmax_t offset = 0u;
+        while (offset < size)
+        {
+            uintmax_t size_left = size - offset;
+            std::size_t size_to_copy = batch_size;
+            if (size_left < static_cast< uintmax_t >(batch_size))
+                size_to_copy = static_cast< std::size_t >(size_left);
+            ssize_t sz = ::sendfile(outfile, infile, nullptr, size_to_copy);
+            if (BOOST_LIKELY(sz > 0))
+            {
+                offset += sz;
+                if (progress && !progress->advance(copy_strategy::sendfile, static_cast< uintmax_t >(sz)))
+                    return ECANCELED;
+            }
+            else if (sz < 0)
+            {
+                int err = errno;
+                if (err == EINTR)
+                    continue;
+
+                if (offset == 0u)
+                {
+                    // sendfile may fail with EINVAL if the underlying filesystem does not support it
+                    if (err == EINVAL)
+                    {
+                    fallback_to_read_write:
+                        return copy_file_data_read_write(infile, outfile, size, blksize, progress);
+                    }
+
+                    if (err == ENOSYS)
+                    {
+                        filesystem::detail::atomic_store_relaxed(copy_file_data, &copy_file_data_read_write);
+                        goto fallback_to_read_write;
+                    }
+                }
+
+                return err;
+            }
+            else
+            {
+                // EOF: the input file was truncated while copying was in progress
+                break;
+            }
+        }
+
+        return 0;
+    }
+};
+
+#endif // defined(BOOST_FILESYSTEM_USE_SENDFILE)
+
+#if defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+
+struct copy_file_data_copy_file_range
+{
+    //! copy_file implementation that uses copy_file_range loop. Requires copy_file_range to support cross-filesystem copying.
+    static int impl(int infile, int outfile, uintmax_t size, std::size_t blksize, file_copy_progress* progress)
+    {
+        // Although copy_file_range does not document any particular upper limit of one transfer, still use some upper bound to guarantee
+        // that size_t is not overflown in case if off_t is larger and the file size does not fit in size_t.
+        BOOST_CONSTEXPR_OR_CONST std::size_t max_batch_size = 0x7ffff000u;
+        const std::size_t batch_size = progress ? progress_batch_size : max_batch_size;
+        uintmax_t offset = 0u;
+        while (offset < size)
+        {
+            uintmax_t size_left = size - offset;
+            std::size_t size_to_copy = batch_size;
+            if (size_left < static_cast< uintmax_t >(batch_size))
+                size_to_copy = static_cast< std::size_t >(size_left);
+            // Note: Use syscall directly to avoid depending on libc version. copy_file_range is added in glibc 2.27.
+            // uClibc-ng does not have copy_file_range as of the time of this writing (the latest uClibc-ng release is 1.0.33).
+            loff_t sz = ::syscall(__NR_copy_file_range, infile, (loff_t*)nullptr, outfile, (loff_t*)nullptr, size_to_copy, (unsigned int)0u);
+            if (BOOST_LIKELY(sz > 0))
+            {
+                offset += sz;
+                if (progress && !progress->advance(copy_strategy::copy_file_range, static_cast< uintmax_t >(sz)))
+                    return ECANCELED;
+            }
+            else if (sz < 0)
+            {
+                int err = errno;
+                if (err == EINTR)
+                    continue;
+
+                if (offset == 0u)
+                {
+                    // copy_file_range may fail with EINVAL if the underlying filesystem does not support it.
+                    // In some RHEL/CentOS 7.7-7.8 kernel versions, copy_file_range on NFSv4 is also known to return EOPNOTSUPP
+                    // if the remote server does not support COPY, despite that it is not a documented error code.
+                    // See https://patchwork.kernel.org/project/linux-nfs/patch/20190411183418.4510-1-olga.kornievskaia@gmail.com/
+                    // and https://bugzilla.redhat.com/show_bug.cgi?id=1783554.
+                    if (err == EINVAL || err == EOPNOTSUPP)
+                    {
+#if !defined(BOOST_FILESYSTEM_USE_SENDFILE)
+                    fallback_to_read_write:
+#endif
+                        return copy_file_data_read_write(infile, outfile, size, blksize, progress);
+                    }
+
+                    if (err == EXDEV)
+                    {
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
+                    fallback_to_sendfile:
+                        return copy_file_data_sendfile::impl(infile, outfile, size, blksize, progress);
+#else
+                        goto fallback_to_read_write;
+#endif
+                    }
+
+                    if (err == ENOSYS)
+                    {
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
+                        filesystem::detail::atomic_store_relaxed(copy_file_data, &check_fs_type< copy_file_data_preallocate< copy_file_data_sendfile > >);
+                        goto fallback_to_sendfile;
+#else
+                        filesystem::detail::atomic_store_relaxed(copy_file_data, &copy_file_data_read_write);
+                        goto fallback_to_read_write;
+#endif
+                    }
+                }
+
+                return err;
+            }
+            else
+            {
+                // EOF: the input file was truncated while copying was in progress
+                break;
+            }
+        }
+
+        return 0;
+    }
+};
+
+#endif // defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+
+//! copy_file_data wrapper that tests if a read/write loop must be used for a given filesystem
+template< typename CopyFileData >
+int check_fs_type(int infile, int outfile, uintmax_t size, std::size_t blksize, file_copy_progress* progress)
+{
+    {
+        // Some filesystems have regular files with generated content. Such files have arbitrary size, including zero,
+        // but have actual content. Linux system calls sendfile or copy_file_range will not copy contents of such files,
+        // so we must use a read/write loop to handle them.
+        // https://lore.kernel.org/linux-fsdevel/20210212044405.4120619-1-drinkcat@chromium.org/T/
+        struct statfs sfs;
+        while (true)
+        {
+            int err = ::fstatfs(infile, &sfs);
+            if (BOOST_UNLIKELY(err < 0))
+            {
+                err = errno;
+                if (err == EINTR)
+                    continue;
+
+                goto fallback_to_read_write;
+            }
+
+            break;
+        }
+
+        if (BOOST_UNLIKELY(sfs.f_type == PROC_SUPER_MAGIC ||
+            sfs.f_type == SYSFS_MAGIC ||
+            sfs.f_type == 0x63677270 || // CGROUP2_SUPER_MAGIC
+            sfs.f_type == 0x0027e0eb || // CGROUP_SUPER_MAGIC
+            sfs.f_type == 0x73636673 || // SECURITYFS_MAGIC
+            sfs.f_type == 0x62656570 || // CONFIGFS_MAGIC
+            sfs.f_type == TRACEFS_MAGIC ||
+            sfs.f_type == DEBUGFS_MAGIC))
+        {
+        fallback_to_read_write:
+            return copy_file_data_read_write(infile, outfile, size, blksize, progress);
+        }
+    }
+
+    return CopyFileData::impl(infile, outfile, size, blksize, progress);
+}
+
+#endif // defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+
+#if defined(BOOST_FILESYSTEM_USE_FICLONE)
+
+//! Number of filesystems for which lack of support for cloning is remembered
+BOOST_CONSTEXPR_OR_CONST unsigned int clone_unsupported_cache_size = 8u;
+
+//! Device ids of the filesystems that do not support cloning, plus one. Zero indicates an unused slot.
+uintmax_t clone_unsupported_devices[clone_unsupported_cache_size] = {};
+//! Index of the slot to use for the next filesystem that does not support cloning
+unsigned int clone_unsupported_next = 0u;
+
+//! Tests if the filesystem with the given device id is known to not support cloning
+inline bool is_clone_unsupported(uintmax_t device) noexcept
+{
+    for (unsigned int i = 0u; i < clone_unsupported_cache_size; ++i)
+    {
+        if (filesystem::detail::atomic_load_relaxed(clone_unsupported_devices[i]) == device + 1u)
+            return true;
+    }
+
+    return false;
+}
+
+//! Remembers that the filesystem with the given device id does not support cloning
+inline void set_clone_unsupported(uintmax_t device) noexcept
+{
+    // Concurrent updates may overwrite each other or the same slot, which only results in redundant clone attempts later
+    const unsigned int index = filesystem::detail::atomic_load_relaxed(clone_unsupported_next);
+    filesystem::detail::atomic_store_relaxed(clone_unsupported_next, (index + 1u) % clone_unsupported_cache_size);
+    filesystem::detail::atomic_store_relaxed(clone_unsupported_devices[index], device + 1u);
+}
+
+/*!
+ * \brief Makes the target file share the data of the source file on filesystems that support reflinks, such as Btrfs and XFS
+ *
+ * \param device Device id of the target file
+ * \returns 0 on success, \c EOPNOTSUPP if cloning is not supported for the files, or another system error code
+ */
+int clone_file_data(int infile, int outfile, uintmax_t device)
+{
+    if (is_clone_unsupported(device))
+        return EOPNOTSUPP;
+
+    while (true)
+    {
+        if (BOOST_LIKELY(::ioctl(outfile, FICLONE, infile) == 0))
+            return 0;
+
+        const int err = errno;
+        switch (err)
+        {
+        case EINTR:
+            continue;
+
+        // The filesystem does not support cloning. Older kernels may return EINVAL or ENOTTY instead of EOPNOTSUPP.
+        case EOPNOTSUPP:
+#if defined(ENOTSUP) && ENOTSUP != EOPNOTSUPP
+        case ENOTSUP:
+#endif
+        case ENOTTY:
+        case ENOSYS:
+            set_clone_unsupported(device);
+            return EOPNOTSUPP;
+
+        // The files are on different filesystems, or the clone is not supported for these particular files
+        // (e.g. on XFS when one of the files uses DAX). Other files on the same filesystem may still be cloned.
+        case EXDEV:
+        case EINVAL:
+            return EOPNOTSUPP;
+
+        default:
+            return err;
+        }
+    }
+}
+
+#endif // defined(BOOST_FILESYSTEM_USE_FICLONE)
+
+#if !defined(BOOST_FILESYSTEM_USE_WASI)
+
+//! Copies a range of data at the given offset of the input file to the same offset of the output file using pread/pwrite loop
+int copy_file_range_read_write(int infile, int outfile, uintmax_t offset, uintmax_t size, char* buf, std::size_t buf_size, file_copy_progress* progress)
+{
+    while (size > 0u)
+    {
+        std::size_t size_to_read = buf_size;
+        if (size < static_cast< uintmax_t >(buf_size))
+            size_to_read = static_cast< std::size_t >(size);
+        ssize_t sz_read = ::pread(infile, buf, size_to_read, static_cast< off_t >(offset));
+        if (sz_read == 0)
+            break; // EOF: the input file was truncated while copying was in progress
+        if (BOOST_UNLIKELY(sz_read < 0))
+        {
+            int err = errno;
+            if (err == EINTR)
+                continue;
+            return err;
+        }
+
+        for (ssize_t sz_wrote = 0; sz_wrote < sz_read;)
+        {
+            ssize_t sz = ::pwrite(outfile, buf + sz_wrote, static_cast< std::size_t >(sz_read - sz_wrote), static_cast< off_t >(offset + sz_wrote));
+            if (BOOST_UNLIKELY(sz < 0))
+            {
+                int err = errno;
+                if (err == EINTR)
+                    continue;
+                return err;
+            }
+
+            sz_wrote += sz;
+        }
+
+        offset += sz_read;
+        size -= sz_read;
+
+        if (progress && !progress->advance(copy_strategy::read_write, static_cast< uintmax_t >(sz_read)))
+            return ECANCELED;
+    }
+
+    return 0;
+}
+
+//! State of copying ranges of file data at explicit offsets, used by copy_file_data_sparse and copy_file_data_parallel
+struct range_copy_state
+{
+    std::size_t blksize;
+    //! Buffer for pread/pwrite loop, allocated on first use
+    std::unique_ptr< char[] > buf;
+    std::size_t buf_size;
+#if defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+    bool use_copy_file_range;
+#endif
+
+    explicit range_copy_state(std::size_t bs) noexcept :
+        blksize(bs),
+        buf_size(0u)
+#if defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+        , use_copy_file_range(true)
+#endif
+    {
+    }
+
+    //! Copies a range of data at the given offset of the input file to the same offset of the output file
+    int copy_range(int infile, int outfile, uintmax_t offset, uintmax_t size, file_copy_progress* progress)
+    {
+#if defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+        if (use_copy_file_range)
+        {
+            BOOST_CONSTEXPR_OR_CONST std::size_t max_batch_size = 0x7ffff000u;
+            const std::size_t batch_size = progress ? progress_batch_size : max_batch_size;
+            loff_t in_offset = static_cast< loff_t >(offset), out_offset = static_cast< loff_t >(offset);
+            while (size > 0u)
+            {
+                std::size_t size_to_copy = batch_size;
+                if (size < static_cast< uintmax_t >(batch_size))
+                    size_to_copy = static_cast< std::size_t >(size);
+                loff_t sz = ::syscall(__NR_copy_file_range, infile, &in_offset, outfile, &out_offset, size_to_copy, (unsigned int)0u);
+                if (BOOST_LIKELY(sz > 0))
+                {
+                    size -= sz;
+                    if (progress && !progress->advance(copy_strategy::copy_file_range, static_cast< uintmax_t >(sz)))
+                        return ECANCELED;
+                }
+                else if (sz < 0)
+                {
+                    int err = errno;
+                    if (err == EINTR)
+                        continue;
+
+                    // See copy_file_data_copy_file_range for the errors that indicate that copy_file_range cannot be used for these files.
+                    // Since the offsets are explicit, the rest of the file can be copied with pread/pwrite.
+                    if (err == EINVAL || err == EOPNOTSUPP || err == EXDEV || err == ENOSYS)
+                    {
+                        use_copy_file_range = false;
+                        offset = static_cast< uintmax_t >(in_offset);
+                        goto fallback_to_read_write;
+                    }
+
+                    return err;
+                }
+                else
+                {
+                    // EOF: the input file was truncated while copying was in progress
+                    break;
+                }
+            }
+
+            return 0;
+        }
+
+    fallback_to_read_write:
+#endif // defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+        if (!buf)
+        {
+            uintmax_t buf_sz = blksize;
+            if (buf_sz < min_read_write_buf_size)
+                buf_sz = min_read_write_buf_size;
+            if (buf_sz > max_read_write_buf_size)
+                buf_sz = max_read_write_buf_size;
+            buf_size = static_cast< std::size_t >(boost::core::bit_ceil(static_cast< uint_least32_t >(buf_sz)));
+            buf.reset(new (std::nothrow) char[buf_size]);
+            if (BOOST_UNLIKELY(!buf))
+                return ENOMEM;
+        }
+
+        return copy_file_range_read_write(infile, outfile, offset, size, buf.get(), buf_size, progress);
+    }
+};
+
+#endif // !defined(BOOST_FILESYSTEM_USE_WASI)
+
+#if !defined(BOOST_FILESYSTEM_USE_WASI)
+
+//! Size of a chunk of file data copied by one thread in copy_file_data_parallel
+BOOST_CONSTEXPR_OR_CONST uintmax_t parallel_copy_chunk_size = 16u * 1024u * 1024u;
+//! Minimum size of a file to be copied by copy_file_data_parallel
+BOOST_CONSTEXPR_OR_CONST uintmax_t parallel_copy_min_file_size = 2u * parallel_copy_chunk_size;
+//! Maximum number of threads used by copy_file_data_parallel
+BOOST_CONSTEXPR_OR_CONST unsigned int parallel_copy_max_thread_count = 8u;
+
+//! Returns the number of threads to copy a file of the given size with copy_file_data_parallel, or 1 if the file should be copied by one thread
+inline unsigned int get_parallel_copy_thread_count(uintmax_t size) noexcept
+{
+    if (size < parallel_copy_min_file_size || size > static_cast< uintmax_t >((std::numeric_limits< off_t >::max)()))
+        return 1u;
+
+    unsigned int thread_count = resolve_thread_count(0u);
+    if (thread_count > parallel_copy_max_thread_count)
+        thread_count = parallel_copy_max_thread_count;
+
+    const uintmax_t chunk_count = (size + parallel_copy_chunk_size - 1u) / parallel_copy_chunk_size;
+    if (static_cast< uintmax_t >(thread_count) > chunk_count)
+        thread_count = static_cast< unsigned int >(chunk_count);
+
+    return thread_count;
+}
+
+//! A range of file data to copy
+struct file_data_range
+{
+    uintmax_t offset;
+    uintmax_t size;
+};
+
+/*!
+ * \brief Copies the ranges of file data to the same offsets of the target file concurrently, using \a thread_count threads
+ *
+ * The ranges are split into chunks of at most \c parallel_copy_chunk_size bytes. If \a thread_count is 1, the ranges are copied
+ * in the current thread.
+ */
+int copy_file_ranges_parallel(int infile, int outfile, std::vector< file_data_range > const& ranges, unsigned int thread_count, std::size_t blksize, file_copy_progress* progress)
+{
+    if (thread_count <= 1u)
+    {
+        range_copy_state state(blksize);
+        for (std::size_t i = 0u, n = ranges.size(); i < n; ++i)
+        {
+            const int err = state.copy_range(infile, outfile, ranges[i].offset, ranges[i].size, progress);
+            if (BOOST_UNLIKELY(err != 0))
+                return err;
+        }
+
+        return 0;
+    }
+
+    //! Per-thread state of the copy
+    struct worker_state
+    {
+        range_copy_state state;
+        int err;
+        uintmax_t err_offset;
+
+        explicit worker_state(std::size_t bs) noexcept :
+            state(bs),
+            err(0),
+            err_offset(0u)
+        {
+        }
+    };
+
+    struct copier
+    {
+        work_stealing_pool< file_data_range > pool;
+        std::vector< worker_state > workers;
+        const int infile;
+        const int outfile;
+        file_copy_progress* const progress;
+
+        copier(unsigned int thread_count, int in, int out, std::size_t blksize, file_copy_progress* prog) :
+            pool(thread_count),
+            infile(in),
+            outfile(out),
+            progress(prog)
+        {
+            workers.reserve(pool.worker_count());
+            for (unsigned int i = 0u, n = pool.worker_count(); i < n; ++i)
+                workers.emplace_back(blksize);
+        }
+
+        void operator()(unsigned int worker, file_data_range& task) noexcept
+        {
+            worker_state& w = workers[worker];
+            const int err = w.state.copy_range(infile, outfile, task.offset, task.size, progress);
+            if (BOOST_UNLIKELY(err != 0))
+            {
+                // Report the error at the lowest offset, as a sequential copy would
+                if (w.err == 0 || task.offset < w.err_offset)
+                {
+                    w.err = err;
+                    w.err_offset = task.offset;
+                }
+
+                pool.stop();
+            }
+        }
+    };
+
+    int err = 0;
+    try
+    {
+        copier c(thread_count, infile, outfile, blksize, progress);
+
+        // Distribute the chunks in the order of offsets, so that the threads initially copy adjacent ranges of the file
+        const unsigned int worker_count = c.pool.worker_count();
+        unsigned int worker = 0u;
+        for (std::size_t i = 0u, n = ranges.size(); i < n; ++i)
+        {
+            const uintmax_t end = ranges[i].offset + ranges[i].size;
+            for (uintmax_t offset = ranges[i].offset; offset < end; offset += parallel_copy_chunk_size)
+            {
+                file_data_range task = { offset, parallel_copy_chunk_size };
+                if (end - offset < parallel_copy_chunk_size)
+                    task.size = end - offset;
+                c.pool.push(worker, std::move(task));
+                worker = (worker + 1u) % worker_count;
+            }
+        }
+
+        c.pool.run(c);
+
+        uintmax_t err_offset = 0u;
+        for (std::size_t i = 0u, n = c.workers.size(); i < n; ++i)
+        {
+            worker_state const& w = c.workers[i];
+            if (w.err != 0 && (err == 0 || w.err_offset < err_offset))
+            {
+                err = w.err;
+                err_offset = w.err_offset;
+            }
+        }
+    }
+    catch (std::bad_alloc&)
+    {
+        err = ENOMEM;
+    }
+
+    return err;
+}
+
+/*!
+ * \brief copy_file implementation that splits the file into chunks and copies them concurrently using multiple threads
+ *
+ * Every chunk is copied with \c copy_file_range with explicit offsets, where supported, or a \c pread/pwrite loop.
+ * Issuing multiple copy requests at a time allows to utilize the queue depth of NVMe devices, RAID arrays and network
+ * filesystems. The storage for the target file is preallocated before copying. The target file is expected to be empty.
+ * Files that are too small to benefit from concurrent copying are copied with \c copy_file_data.
+ */
+int copy_file_data_parallel(int infile, int outfile, uintmax_t size, std::size_t blksize, file_copy_progress* progress)
+{
+    const unsigned int thread_count = get_parallel_copy_thread_count(size);
+    if (thread_count <= 1u)
+        return filesystem::detail::atomic_load_relaxed(filesystem::detail::copy_file_data)(infile, outfile, size, blksize, progress);
+
+    int err = preallocate_storage(outfile, size);
+    if (BOOST_UNLIKELY(err != 0))
+        return err;
+
+    try
+    {
+        std::vector< file_data_range > ranges;
+        const file_data_range range = { 0u, size };
+        ranges.push_back(range);
+        err = copy_file_ranges_parallel(infile, outfile, ranges, thread_count, blksize, progress);
+    }
+    catch (std::bad_alloc&)
+    {
+        err = ENOMEM;
+    }
+
+    return err;
+}
+
+#if defined(SEEK_DATA) && defined(SEEK_HOLE)
+
+/*!
+ * \brief copy_file implementation that only copies the data regions of a sparse file, leaving holes in the target file
+ *
+ * The data regions are found with \c lseek using \c SEEK_DATA and \c SEEK_HOLE. If \a parallel is \c true, the data regions
+ * are copied concurrently, as in \c copy_file_data_parallel, if their total size is large enough. Files without holes and
+ * files on filesystems that do not report holes are copied with \c copy_file_data_parallel, if \a parallel is \c true, or
+ * \c copy_file_data otherwise, which also handles files with generated contents. The target file is expected to be empty.
+ */
+int copy_file_data_sparse(int infile, int outfile, uintmax_t size, std::size_t blksize, bool parallel, file_copy_progress* progress)
+{
+    if (size > 0u && size <= static_cast< uintmax_t >((std::numeric_limits< off_t >::max)()))
+    {
+        const off_t first_hole = ::lseek(infile, 0, SEEK_HOLE);
+        if (first_hole >= 0 && static_cast< uintmax_t >(first_hole) < size)
+        {
+            int err = 0;
+            try
+            {
+                std::vector< file_data_range > ranges;
+                uintmax_t data_size = 0u, offset = 0u;
+                while (offset < size)
+                {
+                    const off_t data_pos = ::lseek(infile, static_cast< off_t >(offset), SEEK_DATA);
+                    if (data_pos < 0)
+                    {
+                        err = errno;
+                        // ENXIO indicates there is no more data after the offset
+                        if (err == ENXIO)
+                            err = 0;
+                        break;
+                    }
+
+                    if (static_cast< uintmax_t >(data_pos) >= size)
+                        break;
+
+                    const off_t hole_pos = ::lseek(infile, data_pos, SEEK_HOLE);
+                    if (BOOST_UNLIKELY(hole_pos < 0))
+                    {
+                        err = errno;
+                        break;
+                    }
+
+                    uintmax_t data_end = static_cast< uintmax_t >(hole_pos);
+                    if (data_end > size)
+                        data_end = size;
+
+                    const file_data_range range = { static_cast< uintmax_t >(data_pos), data_end - static_cast< uintmax_t >(data_pos) };
+                    ranges.push_back(range);
+                    data_size += range.size;
+                    offset = data_end;
+                }
+
+                if (err == 0)
+                    err = copy_file_ranges_parallel(infile, outfile, ranges, parallel ? get_parallel_copy_thread_count(data_size) : 1u, blksize, progress);
+            }
+            catch (std::bad_alloc&)
+            {
+                err = ENOMEM;
+            }
+
+            if (BOOST_UNLIKELY(err != 0))
+                return err;
+
+            // Set the target file size, which also creates the trailing hole, if any
+            while (true)
+            {
+                if (BOOST_LIKELY(::ftruncate(outfile, static_cast< off_t >(size)) == 0))
+                    break;
+
+                err = errno;
+                if (err != EINTR)
+                    return err;
+            }
+
+            return 0;
+        }
+
+        // lseek may have moved the file position, and the dense copy relies on it
+        if (BOOST_UNLIKELY(::lseek(infile, 0, SEEK_SET) < 0))
+            return errno;
+    }
+
+    if (parallel)
+        return copy_file_data_parallel(infile, outfile, size, blksize, progress);
+
+    return filesystem::detail::atomic_load_relaxed(filesystem::detail::copy_file_data)(infile, outfile, size, blksize, progress);
+}
+
+#endif // defined(SEEK_DATA) && defined(SEEK_HOLE)
+
+//! Size of the ranges of file data after copying which the cached pages are dropped by copy_file_data_drop_cache
+BOOST_CONSTEXPR_OR_CONST uintmax_t drop_cache_range_size = 8u * 1024u * 1024u;
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_FADVISE)
+
+//! Waits for the range of the target file to be written to the storage and drops the cached pages of the range of both files. Zero \a size indicates the range till the end of the files.
+inline void drop_cached_range(int infile, int outfile, uintmax_t offset, uintmax_t size) noexcept
+{
+#if defined(SYNC_FILE_RANGE_WRITE)
+    // Dirty pages cannot be dropped, so wait until the range is written first
+    ::sync_file_range(outfile, static_cast< off_t >(offset), static_cast< off_t >(size), SYNC_FILE_RANGE_WAIT_BEFORE | SYNC_FILE_RANGE_WRITE | SYNC_FILE_RANGE_WAIT_AFTER);
+#endif
+    ::posix_fadvise(infile, static_cast< off_t >(offset), static_cast< off_t >(size), POSIX_FADV_DONTNEED);
+    ::posix_fadvise(outfile, static_cast< off_t >(offset), static_cast< off_t >(size), POSIX_FADV_DONTNEED);
+}
+
+#endif // defined(BOOST_FILESYSTEM_HAS_POSIX_FADVISE)
+
+/*!
+ * \brief copy_file implementation that drops the pages of the copied data from the page cache
+ *
+ * The file is copied in ranges. After a range is copied, writeback of the range of the target file is started, and the previous
+ * range, which has likely been written by that time, is dropped from the page cache in both files. This limits the amount of
+ * cached data of the files to a few ranges. Files that fit in one range, including files with generated contents, are copied
+ * with \c copy_file_data and dropped from the cache afterwards.
+ */
+int copy_file_data_drop_cache(int infile, int outfile, uintmax_t size, std::size_t blksize, file_copy_progress* progress)
+{
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_FADVISE)
+    if (size <= drop_cache_range_size || size > static_cast< uintmax_t >((std::numeric_limits< off_t >::max)()))
+    {
+        const int err = filesystem::detail::atomic_load_relaxed(filesystem::detail::copy_file_data)(infile, outfile, size, blksize, progress);
+        if (BOOST_LIKELY(err == 0))
+            drop_cached_range(infile, outfile, 0u, 0u);
+        return err;
+    }
+
+    range_copy_state state(blksize);
+    uintmax_t offset = 0u, prev_offset = 0u, prev_size = 0u;
+    while (offset < size)
+    {
+        uintmax_t range_size = size - offset;
+        if (range_size > drop_cache_range_size)
+            range_size = drop_cache_range_size;
+
+        const int err = state.copy_range(infile, outfile, offset, range_size, progress);
+        if (BOOST_UNLIKELY(err != 0))
+            return err;
+
+#if defined(SYNC_FILE_RANGE_WRITE)
+        // Start writing the range to the storage while the next range is being copied
+        ::sync_file_range(outfile, static_cast< off_t >(offset), static_cast< off_t >(range_size), SYNC_FILE_RANGE_WRITE);
+#endif
+
+        if (prev_size > 0u)
+            drop_cached_range(infile, outfile, prev_offset, prev_size);
+
+        prev_offset = offset;
+        prev_size = range_size;
+        offset += range_size;
+    }
+
+    if (prev_size > 0u)
+        drop_cached_range(infile, outfile, prev_offset, prev_size);
+
+    return 0;
+#else // defined(BOOST_FILESYSTEM_HAS_POSIX_FADVISE)
+    return filesystem::detail::atomic_load_relaxed(filesystem::detail::copy_file_data)(infile, outfile, size, blksize, progress);
+#endif // defined(BOOST_FILESYSTEM_HAS_POSIX_FADVISE)
+}
+
+#if defined(O_DIRECT)
+
+//! Alignment of buffers, file offsets and sizes for direct I/O, which is used if the system does not report the alignment requirements
+BOOST_CONSTEXPR_OR_CONST std::size_t default_direct_io_alignment = 4096u;
+//! Size of each of the two buffers used by copy_file_data_direct
+BOOST_CONSTEXPR_OR_CONST std::size_t direct_io_buf_size = 1024u * 1024u;
+
+/*!
+ * \brief Updates \a mem_align and \a offset_align to satisfy the direct I/O alignment requirements of the file
+ *
+ * \returns \c false if the file is known to not support direct I/O
+ */
+bool get_direct_io_alignment(int fd, std::size_t& mem_align, std::size_t& offset_align)
+{
+    std::size_t file_mem_align = default_direct_io_alignment, file_offset_align = default_direct_io_alignment;
+#if defined(BOOST_FILESYSTEM_USE_STATX) && defined(STATX_DIOALIGN)
+    // STATX_DIOALIGN is supported since Linux 6.1. On older kernels the mask bit is not set in the result.
+    struct ::statx stx;
+    if (invoke_statx(fd, "", AT_EMPTY_PATH | AT_NO_AUTOMOUNT, STATX_DIOALIGN, &stx) == 0 && (stx.stx_mask & STATX_DIOALIGN) != 0u)
+    {
+        // Zero alignment indicates that direct I/O is not supported for the file
+        if (stx.stx_dio_mem_align == 0u || stx.stx_dio_offset_align == 0u)
+            return false;
+
+        file_mem_align = stx.stx_dio_mem_align;
+        file_offset_align = stx.stx_dio_offset_align;
+    }
+#endif
+
+    if (mem_align < file_mem_align)
+        mem_align = file_mem_align;
+    if (offset_align < file_offset_align)
+        offset_align = file_offset_align;
+
+    return true;
+}
+
+//! Enables or disables direct I/O on the file descriptor
+int set_direct_io(int fd, bool enable) noexcept
+{
+    const int flags = ::fcntl(fd, F_GETFL);
+    if (BOOST_UNLIKELY(flags < 0))
+        return errno;
+
+    const int new_flags = enable ? (flags | O_DIRECT) : (flags & ~O_DIRECT);
+    if (new_flags != flags && BOOST_UNLIKELY(::fcntl(fd, F_SETFL, new_flags) < 0))
+        return errno;
+
+    return 0;
+}
+
+/*!
+ * \brief Reads at least \a min_size bytes at \a offset into \a buf, reading up to \a size bytes
+ *
+ * \a size and \a offset must be aligned for direct I/O. Short reads are continued for as long as the file offset remains aligned.
+ * Less than \a min_size bytes are read if the end of the file is reached or a short read leaves the file offset unaligned.
+ */
+int read_direct(int fd, char* buf, std::size_t size, std::size_t min_size, uintmax_t offset, std::size_t offset_align, std::size_t& sz_read) noexcept
+{
+    sz_read = 0u;
+    while (sz_read < min_size)
+    {
+        ssize_t sz = ::pread(fd, buf + sz_read, size - sz_read, static_cast< off_t >(offset + sz_read));
+        if (BOOST_UNLIKELY(sz < 0))
+        {
+            int err = errno;
+            if (err == EINTR)
+                continue;
+            return err;
+        }
+
+        if (sz == 0)
+            break;
+
+        sz_read += static_cast< std::size_t >(sz);
+
+        // Direct I/O requires aligned file offsets, so the rest of the data cannot be read here
+        if ((sz_read & (offset_align - 1u)) != 0u)
+            break;
+    }
+
+    return 0;
+}
+
+//! Writes \a size bytes from \a buf at \a offset
+int write_direct(int fd, const char* buf, std::size_t size, uintmax_t offset) noexcept
+{
+    for (std::size_t sz_wrote = 0u; sz_wrote < size;)
+    {
+        ssize_t sz = ::pwrite(fd, buf + sz_wrote, size - sz_wrote, static_cast< off_t >(offset + sz_wrote));
+        if (BOOST_UNLIKELY(sz < 0))
+        {
+            int err = errno;
+            if (err == EINTR)
+                continue;
+            return err;
+        }
+
+        sz_wrote += static_cast< std::size_t >(sz);
+    }
+
+    return 0;
+}
+
+//! Double buffer of copy_file_data_direct. If supported, the buffers are filled by a separate thread, ahead of writing.
+struct direct_copy_buffers
+{
+    const int infile;
+    //! Size of the file to copy
+    const uintmax_t file_size;
+    const std::size_t buf_size;
+    const std::size_t offset_align;
+    char* bufs[2];
+    //! Number of bytes read into each of the buffers
+    std::size_t sizes[2];
+    //! Error codes of reading into each of the buffers
+    int errs[2];
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+    //! Indicates that the buffer is filled by the reader thread and can be written
+    bool filled[2];
+    bool stopping;
+    std::mutex mutex;
+    std::condition_variable cond;
+#endif
+
+    direct_copy_buffers(int in, uintmax_t size, char* buf, std::size_t bs, std::size_t align) noexcept :
+        infile(in),
+        file_size(size),
+        buf_size(bs),
+        offset_align(align)
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+        , stopping(false)
+#endif
+    {
+        bufs[0] = buf;
+        bufs[1] = buf + bs;
+        sizes[0] = sizes[1] = 0u;
+        errs[0] = errs[1] = 0;
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+        filled[0] = filled[1] = false;
+#endif
+    }
+
+    direct_copy_buffers(direct_copy_buffers const&) = delete;
+    direct_copy_buffers& operator=(direct_copy_buffers const&) = delete;
+
+    //! Returns the number of bytes of the file that are expected to be read into a buffer at \a offset
+    std::size_t expected_size(uintmax_t offset) const noexcept
+    {
+        const uintmax_t left = file_size - offset;
+        return left < static_cast< uintmax_t >(buf_size) ? static_cast< std::size_t >(left) : buf_size;
+    }
+
+    //! Reads the data at \a offset into the buffer
+    void fill(unsigned int index, uintmax_t offset) noexcept
+    {
+        const std::size_t expected = expected_size(offset);
+        const std::size_t read_size = (expected + offset_align - 1u) & ~(offset_align - 1u);
+        errs[index] = read_direct(infile, bufs[index], read_size, expected, offset, offset_align, sizes[index]);
+
+        // Ignore the data appended to the file after its size was obtained
+        if (sizes[index] > expected)
+            sizes[index] = expected;
+    }
+
+    //! Returns \c true if the buffer contains the last data of the file that can be read with direct I/O, or reading failed
+    bool is_last(unsigned int index, uintmax_t offset) const noexcept
+    {
+        return errs[index] != 0 || sizes[index] < expected_size(offset) || offset + sizes[index] >= file_size;
+    }
+
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+    //! Reader thread function. Fills the buffers alternately as they are released by the writer.
+    void run_reader() noexcept
+    {
+        uintmax_t offset = 0u;
+        for (unsigned int index = 0u; true; index ^= 1u)
+        {
+            {
+                std::unique_lock< std::mutex > lock(mutex);
+                while (filled[index] && !stopping)
+                    cond.wait(lock);
+                if (stopping)
+                    return;
+            }
+
+            fill(index, offset);
+            const bool last = is_last(index, offset);
+
+            {
+                std::lock_guard< std::mutex > lock(mutex);
+                filled[index] = true;
+            }
+            cond.notify_all();
+
+            if (last)
+                return;
+
+            offset += buf_size;
+        }
+    }
+
+    //! Waits until the buffer is filled by the reader thread
+    void wait_filled(unsigned int index)
+    {
+        std::unique_lock< std::mutex > lock(mutex);
+        while (!filled[index])
+            cond.wait(lock);
+    }
+
+    //! Releases the buffer to the reader thread
+    void release(unsigned int index)
+    {
+        {
+            std::lock_guard< std::mutex > lock(mutex);
+            filled[index] = false;
+        }
+        cond.notify_all();
+    }
+
+    //! Requests the reader thread to stop
+    void stop()
+    {
+        {
+            std::lock_guard< std::mutex > lock(mutex);
+            stopping = true;
+        }
+        cond.notify_all();
+    }
+#endif // !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+};
+
+/*!
+ * \brief Copies file data using direct I/O, bypassing the page cache. Both files must have direct I/O enabled.
+ *
+ * Data is read into one buffer while the other one is written, using a separate thread, if possible. The last block of data
+ * is written in full, with padding up to the alignment, and then the target file is truncated to \a size. If the source file
+ * returns less data than expected at a position where direct I/O cannot continue, the rest of the file is copied without
+ * direct I/O, so that the copy is never shorter than the data that was read from the source file.
+ *
+ * \param unsupported Set to \c true if direct I/O failed before any data was written, which indicates that it is not supported by the files
+ */
+int copy_file_data_direct(int infile, int outfile, uintmax_t size, std::size_t blksize, std::size_t mem_align, std::size_t offset_align, file_copy_progress* progress, bool& unsupported)
+{
+    unsupported = false;
+
+    std::size_t buf_size = direct_io_buf_size;
+    if (buf_size < offset_align)
+        buf_size = offset_align;
+
+    void* mem = nullptr;
+    if (BOOST_UNLIKELY(::posix_memalign(&mem, mem_align, 2u * buf_size) != 0))
+        return ENOMEM;
+
+    struct free_deleter
+    {
+        void operator()(void* p) const noexcept { std::free(p); }
+    };
+    std::unique_ptr< char, free_deleter > buf(static_cast< char* >(mem));
+
+    direct_copy_buffers buffers(infile, size, buf.get(), buf_size, offset_align);
+
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+    // If the reader thread cannot be started, read and write in the current thread
+    std::thread reader;
+    try
+    {
+        reader = std::thread(&direct_copy_buffers::run_reader, &buffers);
+    }
+    catch (std::bad_alloc&)
+    {
+    }
+    catch (std::system_error&)
+    {
+    }
+#endif
+
+    int err = 0;
+    uintmax_t offset = 0u;
+    bool padded = false;
+    for (unsigned int index = 0u; true; index ^= 1u)
+    {
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+        if (reader.joinable())
+            buffers.wait_filled(index);
+        else
+#endif
+            buffers.fill(index, offset);
+
+        err = buffers.errs[index];
+        if (BOOST_UNLIKELY(err != 0))
+        {
+            unsupported = err == EINVAL && offset == 0u;
+            break;
+        }
+
+        const bool last = buffers.is_last(index, offset);
+        std::size_t data_size = buffers.sizes[index];
+        std::size_t write_size;
+        if (data_size == buffers.expected_size(offset))
+        {
+            write_size = (data_size + offset_align - 1u) & ~(offset_align - 1u);
+            padded = write_size != data_size;
+        }
+        else
+        {
+            // Only write the aligned part of the data, the rest of the file is copied without direct I/O
+            write_size = data_size & ~(offset_align - 1u);
+            data_size = write_size;
+        }
+
+        if (write_size > 0u)
+        {
+            err = write_direct(outfile, buffers.bufs[index], write_size, offset);
+            if (BOOST_UNLIKELY(err != 0))
+            {
+                unsupported = err == EINVAL && offset == 0u;
+                break;
+            }
+
+            offset += data_size;
+
+            if (progress && !progress->advance(copy_strategy::read_write, static_cast< uintmax_t >(data_size)))
+            {
+                err = ECANCELED;
+                break;
+            }
+        }
+
+        if (last)
+            break;
+
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+        if (reader.joinable())
+            buffers.release(index);
+#endif
+    }
+
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+    if (reader.joinable())
+    {
+        buffers.stop();
+        reader.join();
+    }
+#endif
+
+    if (err != 0)
+        return err;
+
+    if (offset < size)
+    {
+        // The source file returned less data than expected, e.g. because the filesystem completed a read partially
+        // or the file was truncated. Copy the rest of the file without direct I/O.
+        err = set_direct_io(infile, false);
+        if (err == 0)
+            err = set_direct_io(outfile, false);
+        if (err == 0)
+        {
+            range_copy_state state(blksize);
+            err = state.copy_range(infile, outfile, offset, size - offset, progress);
+        }
+    }
+    else if (padded)
+    {
+        // Remove the padding written after the end of the data
+        while (BOOST_UNLIKELY(::ftruncate(outfile, static_cast< off_t >(size)) != 0))
+        {
+            err = errno;
+            if (err != EINTR)
+                break;
+
+            err = 0;
+        }
+    }
+
+    return err;
+}
+
+#endif // defined(O_DIRECT)
+
+/*!
+ * \brief copy_file implementation that avoids keeping the copied data in the page cache
+ *
+ * Uses direct I/O with the alignment reported by \c statx with \c STATX_DIOALIGN, where supported. If direct I/O is not supported
+ * by the files, falls back to \c copy_file_data_drop_cache.
+ */
+int copy_file_data_no_cache(int infile, int outfile, uintmax_t size, std::size_t blksize, file_copy_progress* progress)
+{
+    int err = preallocate_storage(outfile, size);
+    if (BOOST_UNLIKELY(err != 0))
+        return err;
+
+#if defined(O_DIRECT)
+    // Files with generated contents are reported as empty, and copying small files does not benefit from direct I/O
+    std::size_t mem_align = sizeof(void*), offset_align = 1u;
+    if (size > drop_cache_range_size && size <= static_cast< uintmax_t >((std::numeric_limits< off_t >::max)()) &&
+        get_direct_io_alignment(infile, mem_align, offset_align) && get_direct_io_alignment(outfile, mem_align, offset_align))
+    {
+        err = set_direct_io(infile, true);
+        if (err == 0)
+            err = set_direct_io(outfile, true);
+
+        if (err == 0)
+        {
+            bool unsupported = false;
+            err = copy_file_data_direct(infile, outfile, size, blksize, mem_align, offset_align, progress, unsupported);
+            if (!unsupported)
+                return err;
+        }
+
+        // Direct I/O is not supported by the filesystem
+        set_direct_io(infile, false);
+        set_direct_io(outfile, false);
+    }
+#endif // defined(O_DIRECT)
+
+    return copy_file_data_drop_cache(infile, outfile, size, blksize, progress);
+}
+
+#endif // !defined(BOOST_FILESYSTEM_USE_WASI)
+
+#if defined(linux) || defined(__linux) || defined(__linux__)
+
+//! Initializes copy_file_data implementation pointer
+inline void init_copy_file_data_impl(unsigned int major_ver, unsigned int minor_ver, unsigned int patch_ver)
+{
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+    copy_file_data_t* cfd = &copy_file_data_read_write;
+
+#if defined(BOOST_FILESYSTEM_USE_SENDFILE)
+    // sendfile started accepting file descriptors as the target in Linux 2.6.33
+    if (major_ver > 2u || (major_ver == 2u && (minor_ver > 6u || (minor_ver == 6u && patch_ver >= 33u))))
+        cfd = &check_fs_type< copy_file_data_preallocate< copy_file_data_sendfile > >;
+#endif
+
+#if defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+    // Although copy_file_range appeared in Linux 4.5, it did not support cross-filesystem copying until 5.3.
+    // copy_file_data_copy_file_range will fallback to copy_file_data_sendfile if copy_file_range returns EXDEV.
+    if (major_ver > 4u || (major_ver == 4u && minor_ver >= 5u))
+        cfd = &check_fs_type< copy_file_data_preallocate< copy_file_data_copy_file_range > >;
+#endif
+
+    filesystem::detail::atomic_store_relaxed(copy_file_data, cfd);
+#endif // defined(BOOST_FILESYSTEM_USE_SENDFILE) || defined(BOOST_FILESYSTEM_USE_COPY_FILE_RANGE)
+}
+
+#endif // defined(linux) || defined(__linux) || defined(__linux__)
+
+#if defined(linux) || defined(__linux) || defined(__linux__)
+
+struct syscall_initializer
+{
+    syscall_initializer()
+    {
+        struct ::utsname system_info;
+        if (BOOST_UNLIKELY(::uname(&system_info) < 0))
+            return;
 
         unsigned int major_ver = 0u, minor_ver = 0u, patch_ver = 0u;
         int count = std::sscanf(system_info.release, "%u.%u.%u", &major_ver, &minor_ver, &patch_ver);
@@ -1044,6 +2792,11 @@ struct syscall_initializer
             return;
 
         init_statx_impl(major_ver, minor_ver, patch_ver);
+#if defined(BOOST_FILESYSTEM_USE_IO_URING)
+        // IORING_OP_STATX was introduced in Linux 5.6
+        if (major_ver > 5u || (major_ver == 5u && minor_ver >= 6u))
+            filesystem::detail::atomic_store_relaxed(g_use_io_uring, true);
+#endif
         init_copy_file_data_impl(major_ver, minor_ver, patch_ver);
         init_fill_random_impl(major_ver, minor_ver, patch_ver);
     }
@@ -2813,8 +4566,222 @@ path canonical_v4(path const& p, path const& base, system::error_code* ec)
     return detail::canonical_common(source, ec);
 }
 
-BOOST_FILESYSTEM_DECL
-void copy(path const& from, path const& to, copy_options options, system::error_code* ec)
+namespace {
+
+bool copy_file_impl(path const& from, path const& to, copy_options options, copy_progress_state* progress, error_code* ec);
+void copy_impl(path const& from, path const& to, copy_options options, unsigned int thread_count, copy_progress_state* progress, system::error_code* ec);
+
+//! Reports that a file was copied without copying data, e.g. a directory or a symlink was created
+inline void report_copied_entry(copy_progress_state* progress, path const& from, path const& to)
+{
+    if (progress)
+    {
+        file_copy_progress file_progress(progress, from, to);
+        file_progress.complete();
+    }
+}
+
+//! Reports that the copy operation was canceled by the progress handler
+inline void report_copy_canceled(path const& from, path const& to, system::error_code* ec)
+{
+    emit_error(BOOST_ERROR_OPERATION_CANCELED, from, to, ec, "boost::filesystem::copy");
+}
+
+//! A file or directory to be copied by copy_directory_parallel
+struct parallel_copy_task
+{
+    path from;
+    path to;
+};
+
+//! State of a worker thread of copy_directory_parallel
+struct parallel_copy_worker
+{
+    //! Non-directory files found by the worker, to be copied after all directories are created
+    std::vector< parallel_copy_task > files;
+    //! The error with the least source path among the errors that occurred in the worker
+    system::error_code ec;
+    path error_from;
+    path error_to;
+    std::exception_ptr exception;
+};
+
+/*!
+ * \brief Copies the contents of the directory \a from to the existing directory \a to using multiple threads
+ *
+ * First, the directory tree is walked and the target directories are created, distributing the directories
+ * between threads. Then the files found during the walk are copied concurrently. Errors do not stop copying
+ * of the other files, and the error with the least source path is reported, so that the reported error
+ * does not depend on the order in which the threads complete.
+ */
+void copy_directory_parallel(path const& from, path const& to, copy_options options, unsigned int thread_count, copy_progress_state* progress, system::error_code* ec)
+{
+    struct copier
+    {
+        work_stealing_pool< parallel_copy_task > pool;
+        //! Options for copying the entries of the tree
+        copy_options options;
+        copy_progress_state* const progress;
+        std::vector< parallel_copy_worker > workers;
+        bool copying_files;
+
+        copier(copy_options opts, unsigned int thread_count, copy_progress_state* prog) :
+            pool(thread_count),
+            options((opts & ~copy_options::parallel) | copy_options::_detail_recursing),
+            progress(prog),
+            workers(pool.worker_count()),
+            copying_files(false)
+        {
+            // Files are already copied concurrently, copying chunks of every file with its own threads would multiply the number of threads
+            if (pool.worker_count() > 1u)
+                options &= ~copy_options::parallel_chunks;
+        }
+
+        void operator()(unsigned int worker, parallel_copy_task& task) noexcept
+        {
+            try
+            {
+                if (copying_files)
+                {
+                    system::error_code ec;
+                    detail::copy_impl(task.from, task.to, options, 0u, progress, &ec);
+                    if (BOOST_UNLIKELY(!!ec))
+                        fail(worker, ec, task.from, task.to);
+                }
+                else
+                {
+                    copy_directory(worker, task);
+                }
+
+                if (progress && progress->is_canceled())
+                    pool.stop();
+            }
+            catch (...)
+            {
+                parallel_copy_worker& w = workers[worker];
+                if (!w.exception)
+                    w.exception = std::current_exception();
+                pool.stop();
+            }
+        }
+
+        void fail(unsigned int worker, system::error_code const& ec, path const& from, path const& to)
+        {
+            parallel_copy_worker& w = workers[worker];
+            if (!w.ec || path_algorithms::compare_v4(from, w.error_from) < 0)
+            {
+                w.ec = ec;
+                w.error_from = from;
+                w.error_to = to;
+            }
+        }
+
+        //! Creates the subdirectories of the directory and schedules them to be copied. Other files are saved to be copied later.
+        void copy_directory(unsigned int worker, parallel_copy_task& task)
+        {
+            system::error_code ec;
+            fs::directory_iterator it;
+            detail::directory_iterator_construct(it, task.from, directory_options::none, nullptr, &ec);
+            if (BOOST_UNLIKELY(!!ec))
+            {
+                fail(worker, ec, task.from, task.to);
+                return;
+            }
+
+            // Subdirectories are created as if by a non-recursive copy, which creates the target directory and copies its attributes
+            const copy_options dir_options = options & ~copy_options::recursive;
+            const bool follow_symlinks = (options & (copy_options::copy_symlinks | copy_options::skip_symlinks | copy_options::create_symlinks)) == copy_options::none;
+            const fs::directory_iterator end_dit;
+            while (it != end_dit)
+            {
+                directory_entry const& entry = *it;
+                parallel_copy_task child;
+                child.from = entry.path();
+                child.to = task.to;
+                path_algorithms::append_v4(child.to, path_algorithms::filename_v4(child.from));
+
+                // Status errors are reported when the entry is copied along with the files
+                const file_status st = follow_symlinks ? entry.status(ec) : entry.symlink_status(ec);
+                if (!ec && st.type() == fs::directory_file && (options & copy_options::create_symlinks) == copy_options::none)
+                {
+                    detail::copy_impl(child.from, child.to, dir_options, 0u, progress, &ec);
+                    if (BOOST_UNLIKELY(!!ec))
+                        fail(worker, ec, child.from, child.to);
+                    else
+                        pool.push(worker, std::move(child));
+                }
+                else
+                {
+                    workers[worker].files.push_back(std::move(child));
+                }
+
+                detail::directory_iterator_increment(it, &ec);
+                if (BOOST_UNLIKELY(!!ec))
+                {
+                    fail(worker, ec, task.from, task.to);
+                    return;
+                }
+            }
+        }
+    };
+
+    copier c(options, detail::resolve_thread_count(thread_count), progress);
+
+    parallel_copy_task root_task;
+    root_task.from = from;
+    root_task.to = to;
+    c.pool.push(0u, std::move(root_task));
+    c.pool.run(c);
+
+    if (!c.pool.stopped())
+    {
+        c.copying_files = true;
+        const unsigned int worker_count = c.pool.worker_count();
+        unsigned int next_worker = 0u;
+        for (unsigned int i = 0u; i < worker_count; ++i)
+        {
+            std::vector< parallel_copy_task >& files = c.workers[i].files;
+            for (std::size_t j = 0u, n = files.size(); j < n; ++j)
+            {
+                c.pool.push(next_worker, std::move(files[j]));
+                next_worker = (next_worker + 1u) % worker_count;
+            }
+
+            std::vector< parallel_copy_task >().swap(files);
+        }
+
+        c.pool.run(c);
+    }
+
+    parallel_copy_worker const* error_worker = nullptr;
+    for (std::size_t i = 0u, n = c.workers.size(); i < n; ++i)
+    {
+        parallel_copy_worker const& w = c.workers[i];
+        if (!!w.exception)
+            std::rethrow_exception(w.exception);
+
+        if (!!w.ec && (!error_worker || path_algorithms::compare_v4(w.error_from, error_worker->error_from) < 0))
+            error_worker = &w;
+    }
+
+    // Other errors may be the result of cancellation, and which files were copied before the cancellation is not deterministic anyway
+    if (progress && progress->is_canceled())
+    {
+        report_copy_canceled(from, to, ec);
+        return;
+    }
+
+    if (error_worker)
+    {
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::copy", error_worker->error_from, error_worker->error_to, error_worker->ec));
+
+        *ec = error_worker->ec;
+    }
+}
+
+//! Implementation of \c copy. \a thread_count is only used with \c copy_options::parallel. If \a progress is not \c nullptr, reports progress of copying.
+void copy_impl(path const& from, path const& to, copy_options options, unsigned int thread_count, copy_progress_state* progress, system::error_code* ec)
 {
     BOOST_ASSERT((((options & copy_options::overwrite_existing) != copy_options::none) +
         ((options & copy_options::skip_existing) != copy_options::none) +
@@ -2858,6 +4825,8 @@ void copy(path const& from, path const& to, copy_options options, system::error_
             goto fail;
 
         detail::copy_symlink(from, to, ec);
+        if (!ec || !*ec)
+            report_copied_entry(progress, from, to);
     }
     else if (is_regular_file(from_stat))
     {
@@ -2894,12 +4863,16 @@ void copy(path const& from, path const& to, copy_options options, system::error_
                 pfrom = &relative_from;
             }
             detail::create_symlink(*pfrom, to, ec);
+            if (!ec || !*ec)
+                report_copied_entry(progress, from, to);
             return;
         }
 
         if ((options & copy_options::create_hard_links) != copy_options::none)
         {
             detail::create_hard_link(from, to, ec);
+            if (!ec || !*ec)
+                report_copied_entry(progress, from, to);
             return;
         }
 
@@ -2928,10 +4901,10 @@ void copy(path const& from, path const& to, copy_options options, system::error_
         {
             path target(to);
             path_algorithms::append_v4(target, path_algorithms::filename_v4(from));
-            detail::copy_file(from, target, options, ec);
+            detail::copy_file_impl(from, target, options, progress, ec);
         }
         else
-            detail::copy_file(from, to, options, ec);
+            detail::copy_file_impl(from, to, options, progress, ec);
     }
     else if (is_directory(from_stat))
     {
@@ -2970,9 +4943,25 @@ void copy(path const& from, path const& to, copy_options options, system::error_
             detail::create_directory(to, &from, ec);
             if (ec && *ec)
                 return;
+
+            report_copied_entry(progress, from, to);
         }
 
-        if ((options & copy_options::recursive) != copy_options::none || options == copy_options::none)
+        if ((options & (copy_options::recursive | copy_options::parallel)) == (copy_options::recursive | copy_options::parallel))
+        {
+            try
+            {
+                copy_directory_parallel(from, to, options, thread_count, progress, ec);
+            }
+            catch (std::bad_alloc&)
+            {
+                if (!ec)
+                    throw;
+
+                *ec = make_error_code(system::errc::not_enough_memory);
+            }
+        }
+        else if ((options & copy_options::recursive) != copy_options::none || (options & ~copy_options::parallel) == copy_options::none)
         {
             fs::directory_iterator itr;
             detail::directory_iterator_construct(itr, from, directory_options::none, nullptr, ec);
@@ -2982,12 +4971,18 @@ void copy(path const& from, path const& to, copy_options options, system::error_
             const fs::directory_iterator end_dit;
             while (itr != end_dit)
             {
+                if (progress && progress->is_canceled())
+                {
+                    report_copy_canceled(from, to, ec);
+                    return;
+                }
+
                 path const& p = itr->path();
                 {
                     path target(to);
                     path_algorithms::append_v4(target, path_algorithms::filename_v4(p));
                     // Set _detail_recursing flag so that we don't recurse more than for one level deeper into the directory if options are copy_options::none
-                    detail::copy(p, target, options | copy_options::_detail_recursing, ec);
+                    detail::copy_impl(p, target, options | copy_options::_detail_recursing, thread_count, progress, ec);
                 }
                 if (ec && *ec)
                     return;
@@ -3005,16 +5000,45 @@ void copy(path const& from, path const& to, copy_options options, system::error_
     }
 }
 
+} // unnamed namespace
+
 BOOST_FILESYSTEM_DECL
-bool copy_file(path const& from, path const& to, copy_options options, error_code* ec)
+void copy(path const& from, path const& to, copy_options options, system::error_code* ec)
+{
+    detail::copy_impl(from, to, options, 0u, nullptr, ec);
+}
+
+BOOST_FILESYSTEM_DECL
+void copy_parallel(path const& from, path const& to, copy_options options, unsigned int thread_count, system::error_code* ec)
+{
+    detail::copy_impl(from, to, options | copy_options::parallel, thread_count, nullptr, ec);
+}
+
+BOOST_FILESYSTEM_DECL
+void copy_with_progress(path const& from, path const& to, copy_options options, copy_progress_handler const& handler, system::error_code* ec)
+{
+    copy_progress_state progress(handler);
+    detail::copy_impl(from, to, options, 0u, &progress, ec);
+}
+
+namespace {
+
+//! Implementation of \c copy_file. If \a progress is not \c nullptr, reports progress of copying.
+bool copy_file_impl(path const& from, path const& to, copy_options options, copy_progress_state* progress, error_code* ec)
 {
     BOOST_ASSERT((((options & copy_options::overwrite_existing) != copy_options::none) +
         ((options & copy_options::skip_existing) != copy_options::none) +
         ((options & copy_options::update_existing) != copy_options::none)) <= 1);
 
+    BOOST_ASSERT((((options & copy_options::reflink) != copy_options::none) +
+        ((options & copy_options::reflink_or_copy) != copy_options::none)) <= 1);
+
     if (ec)
         ec->clear();
 
+    file_copy_progress file_progress(progress, from, to);
+    file_copy_progress* const fprogress = progress ? &file_progress : nullptr;
+
 #if defined(BOOST_FILESYSTEM_POSIX_API)
 
     int err = 0;
@@ -3189,11 +5213,49 @@ bool copy_file(path const& from, path const& to, copy_options options, error_cod
             goto fail_errno;
     }
 
+    file_progress.file_size = get_size(from_stat);
+
+    if ((options & (copy_options::reflink | copy_options::reflink_or_copy)) != copy_options::none)
+    {
+#if defined(BOOST_FILESYSTEM_USE_FICLONE)
+        err = clone_file_data(infile.get(), outfile.get(), get_device(to_stat));
+#else
+        err = EOPNOTSUPP;
+#endif
+        if (err == 0)
+        {
+            // The file is already cloned, so cancellation will take effect on the next file
+            if (fprogress)
+                fprogress->advance(copy_strategy::clone, file_progress.file_size);
+            goto copied;
+        }
+
+        if (err != EOPNOTSUPP || (options & copy_options::reflink) != copy_options::none)
+            goto fail;
+    }
+
     // Note: Use block size of the target file since it is most important for writing performance.
-    err = filesystem::detail::atomic_load_relaxed(filesystem::detail::copy_file_data)(infile.get(), outfile.get(), get_size(from_stat), get_blksize(to_stat));
+#if !defined(BOOST_FILESYSTEM_USE_WASI)
+    if ((options & copy_options::no_cache) != copy_options::none)
+        err = copy_file_data_no_cache(infile.get(), outfile.get(), get_size(from_stat), get_blksize(to_stat), fprogress);
+    else
+#endif
+#if defined(SEEK_DATA) && defined(SEEK_HOLE) && !defined(BOOST_FILESYSTEM_USE_WASI)
+    if ((options & copy_options::preserve_sparse) != copy_options::none)
+        err = copy_file_data_sparse(infile.get(), outfile.get(), get_size(from_stat), get_blksize(to_stat), (options & copy_options::parallel_chunks) != copy_options::none, fprogress);
+    else
+#endif
+#if !defined(BOOST_FILESYSTEM_USE_WASI)
+    if ((options & copy_options::parallel_chunks) != copy_options::none)
+        err = copy_file_data_parallel(infile.get(), outfile.get(), get_size(from_stat), get_blksize(to_stat), fprogress);
+    else
+#endif
+        err = filesystem::detail::atomic_load_relaxed(filesystem::detail::copy_file_data)(infile.get(), outfile.get(), get_size(from_stat), get_blksize(to_stat), fprogress);
     if (BOOST_UNLIKELY(err != 0))
         goto fail; // err already contains the error code
 
+copied:
+
 #if !defined(BOOST_FILESYSTEM_USE_WASI)
     // If we created a new file with an explicitly added S_IWUSR permission,
     // we may need to update its mode bits to match the source file.
@@ -3230,10 +5292,20 @@ bool copy_file(path const& from, path const& to, copy_options options, error_cod
             goto fail;
     }
 
+    if (fprogress)
+        fprogress->complete();
+
     return true;
 
 #else // defined(BOOST_FILESYSTEM_POSIX_API)
 
+    if ((options & copy_options::reflink) != copy_options::none)
+    {
+        // Cloning is not implemented on Windows. CopyFileW may still use block cloning on ReFS.
+        emit_error(BOOST_ERROR_NOT_SUPPORTED, from, to, ec, "boost::filesystem::copy_file");
+        return false;
+    }
+
     DWORD copy_flags = 0u;
     if ((options & copy_options::overwrite_existing) == copy_options::none ||
         (options & copy_options::skip_existing) != copy_options::none)
@@ -3241,6 +5313,9 @@ bool copy_file(path const& from, path const& to, copy_options options, error_cod
         copy_flags |= COPY_FILE_FAIL_IF_EXISTS;
     }
 
+    if ((options & copy_options::no_cache) != copy_options::none)
+        copy_flags |= COPY_FILE_NO_BUFFERING;
+
     if ((options & copy_options::update_existing) != copy_options::none)
     {
         // Create unique_handle wrappers here so that CloseHandle calls don't clobber error code returned by GetLastError
@@ -3293,6 +5368,8 @@ bool copy_file(path const& from, path const& to, copy_options options, error_cod
     struct callback_context
     {
         DWORD flush_error;
+        bool synchronize;
+        file_copy_progress* progress;
     };
 
     struct local
@@ -3309,18 +5386,28 @@ bool copy_file(path const& from, path const& to, copy_options options, error_cod
             HANDLE to_handle,
             LPVOID ctx)
         {
+            callback_context* context = static_cast< callback_context* >(ctx);
+
             // For each stream, CopyFileExW will open a separate pair of file handles, so we need to flush each stream separately.
-            if (stream_bytes_transferred.QuadPart == stream_size.QuadPart)
+            if (context->synchronize && stream_bytes_transferred.QuadPart == stream_size.QuadPart)
             {
                 BOOL res = ::FlushFileBuffers(to_handle);
                 if (BOOST_UNLIKELY(!res))
                 {
-                    callback_context* context = static_cast< callback_context* >(ctx);
                     if (BOOST_LIKELY(context->flush_error == 0u))
                         context->flush_error = ::GetLastError();
                 }
             }
 
+            file_copy_progress* progress = context->progress;
+            if (progress)
+            {
+                progress->file_size = static_cast< uintmax_t >(total_file_size.QuadPart);
+                const uintmax_t bytes_copied = static_cast< uintmax_t >(total_bytes_transferred.QuadPart);
+                if (bytes_copied > progress->bytes_copied && !progress->advance(copy_strategy::system_copy, bytes_copied - progress->bytes_copied))
+                    return PROGRESS_CANCEL;
+            }
+
             return PROGRESS_CONTINUE;
         }
     };
@@ -3329,7 +5416,9 @@ bool copy_file(path const& from, path const& to, copy_options options, error_cod
     LPPROGRESS_ROUTINE cb = nullptr;
     LPVOID cb_ctx = nullptr;
 
-    if ((options & (copy_options::synchronize_data | copy_options::synchronize)) != copy_options::none)
+    cb_context.synchronize = (options & (copy_options::synchronize_data | copy_options::synchronize)) != copy_options::none;
+    cb_context.progress = fprogress;
+    if (cb_context.synchronize || fprogress)
     {
         cb = &local::on_copy_file_progress;
         cb_ctx = &cb_context;
@@ -3344,6 +5433,9 @@ bool copy_file(path const& from, path const& to, copy_options options, error_cod
         if ((err == ERROR_FILE_EXISTS || err == ERROR_ALREADY_EXISTS) && (options & copy_options::skip_existing) != copy_options::none)
             return false;
 
+        if (err == ERROR_REQUEST_ABORTED && fprogress && progress->is_canceled())
+            err = BOOST_ERROR_OPERATION_CANCELED;
+
     copy_failed:
         emit_error(err, from, to, ec, "boost::filesystem::copy_file");
         return false;
@@ -3355,11 +5447,29 @@ bool copy_file(path const& from, path const& to, copy_options options, error_cod
         goto copy_failed;
     }
 
+    if (fprogress)
+        fprogress->complete();
+
     return true;
 
 #endif // defined(BOOST_FILESYSTEM_POSIX_API)
 }
 
+} // unnamed namespace
+
+BOOST_FILESYSTEM_DECL
+bool copy_file(path const& from, path const& to, copy_options options, error_code* ec)
+{
+    return detail::copy_file_impl(from, to, options, nullptr, ec);
+}
+
+BOOST_FILESYSTEM_DECL
+bool copy_file_with_progress(path const& from, path const& to, copy_options options, copy_progress_handler const& handler, error_code* ec)
+{
+    copy_progress_state progress(handler);
+    return detail::copy_file_impl(from, to, options, &progress, ec);
+}
+
 BOOST_FILESYSTEM_DECL
 void copy_symlink(path const& existing_symlink, path const& new_symlink, system::error_code* ec)
 {
@@ -4603,144 +6713,783 @@ path relative(path const& p, path const& base, error_code* ec)
     return wc_p.lexically_relative(wc_base);
 }
 
-BOOST_FILESYSTEM_DECL
-bool remove(path const& p, error_code* ec)
+BOOST_FILESYSTEM_DECL
+bool remove(path const& p, error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    return detail::remove_impl(p, ec);
+}
+
+BOOST_FILESYSTEM_DECL
+uintmax_t remove_all(path const& p, error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    return detail::remove_all_impl(p, ec);
+}
+
+BOOST_FILESYSTEM_DECL
+void rename(path const& old_p, path const& new_p, error_code* ec)
+{
+    error(!BOOST_MOVE_FILE(old_p.c_str(), new_p.c_str()) ? BOOST_ERRNO : 0, old_p, new_p, ec, "boost::filesystem::rename");
+}
+
+BOOST_FILESYSTEM_DECL
+void resize_file(path const& p, uintmax_t size, system::error_code* ec)
+{
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+    if (BOOST_UNLIKELY(size > static_cast< uintmax_t >((std::numeric_limits< off_t >::max)())))
+    {
+        emit_error(system::errc::file_too_large, p, ec, "boost::filesystem::resize_file");
+        return;
+    }
+#endif
+    error(!BOOST_RESIZE_FILE(p.c_str(), size) ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::resize_file");
+}
+
+BOOST_FILESYSTEM_DECL
+space_info space(path const& p, error_code* ec)
+{
+    space_info info;
+    // Initialize members to -1, as required by C++20 [fs.op.space]/1 in case of error
+    info.capacity = static_cast< uintmax_t >(-1);
+    info.free = static_cast< uintmax_t >(-1);
+    info.available = static_cast< uintmax_t >(-1);
+
+    if (ec)
+        ec->clear();
+
+#if defined(BOOST_FILESYSTEM_USE_WASI)
+
+    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::space");
+
+#elif defined(BOOST_FILESYSTEM_POSIX_API)
+
+    struct BOOST_STATVFS vfs;
+    if (!error(::BOOST_STATVFS(p.c_str(), &vfs) ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::space"))
+    {
+        info.capacity = static_cast< uintmax_t >(vfs.f_blocks) * BOOST_STATVFS_F_FRSIZE;
+        info.free = static_cast< uintmax_t >(vfs.f_bfree) * BOOST_STATVFS_F_FRSIZE;
+        info.available = static_cast< uintmax_t >(vfs.f_bavail) * BOOST_STATVFS_F_FRSIZE;
+    }
+
+#else
+
+    // GetDiskFreeSpaceExW requires a directory path, which is unlike statvfs, which accepts any file.
+    // To work around this, test if the path refers to a directory and use the parent directory if not.
+    error_code local_ec;
+    file_status status = detail::status_impl(p, &local_ec);
+    if (status.type() == fs::status_error || status.type() == fs::file_not_found)
+    {
+    fail_local_ec:
+        if (!ec)
+            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::space", p, local_ec));
+        *ec = local_ec;
+        return info;
+    }
+
+    path dir_path = p;
+    if (!is_directory(status))
+    {
+        path cur_path = detail::current_path(ec);
+        if (ec && *ec)
+            return info;
+
+        status = detail::symlink_status_impl(p, &local_ec);
+        if (status.type() == fs::status_error)
+            goto fail_local_ec;
+        if (is_symlink(status))
+        {
+            // We need to resolve the symlink so that we report the space for the symlink target
+            dir_path = detail::canonical_v4(p, cur_path, ec);
+            if (ec && *ec)
+                return info;
+        }
+
+        dir_path = dir_path.parent_path();
+        if (dir_path.empty())
+        {
+            // The original path was just a filename, which is a relative path wrt. current directory
+            dir_path = cur_path;
+        }
+    }
+
+    // For UNC names, the path must also include a trailing slash.
+    path::string_type str = dir_path.native();
+    if (str.size() >= 2u && detail::is_directory_separator(str[0]) && detail::is_directory_separator(str[1]) && !detail::is_directory_separator(*(str.end() - 1)))
+        str.push_back(path::preferred_separator);
+
+    ULARGE_INTEGER avail, total, free;
+    if (!error(::GetDiskFreeSpaceExW(str.c_str(), &avail, &total, &free) == 0 ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::space"))
+    {
+        info.capacity = static_cast< uintmax_t >(total.QuadPart);
+        info.free = static_cast< uintmax_t >(free.QuadPart);
+        info.available = static_cast< uintmax_t >(avail.QuadPart);
+    }
+
+#endif
+
+    return info;
+}
+
+BOOST_FILESYSTEM_DECL
+file_status status(path const& p, error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    return detail::status_impl(p, ec);
+}
+
+BOOST_FILESYSTEM_DECL
+file_status symlink_status(path const& p, error_code* ec)
+{
+    if (ec)
+        ec->clear();
+
+    return detail::symlink_status_impl(p, ec);
+}
+
+namespace {
+
+//! Size of the buffers used to compare contents of files in sync_tree
+BOOST_CONSTEXPR_OR_CONST std::size_t compare_contents_buf_size = 64u * 1024u;
+
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+
+//! Opens the file for reading. Returns 0 on success or a system error code.
+int open_for_reading(path const& p, boost::scope::unique_fd& fd) noexcept
+{
+    while (true)
+    {
+        fd.reset(::open(p.c_str(), O_RDONLY | O_CLOEXEC));
+        if (BOOST_LIKELY(!!fd))
+            return 0;
+
+        const int err = errno;
+        if (err != EINTR)
+            return err;
+    }
+}
+
+//! Reads up to \a size bytes from the file. Less than \a size bytes are read only at the end of the file. Returns 0 on success or a system error code.
+int read_full(int fd, char* buf, std::size_t size, std::size_t& sz_read) noexcept
+{
+    sz_read = 0u;
+    while (sz_read < size)
+    {
+        ssize_t sz = ::read(fd, buf + sz_read, size - sz_read);
+        if (sz == 0)
+            break;
+        if (BOOST_UNLIKELY(sz < 0))
+        {
+            const int err = errno;
+            if (err == EINTR)
+                continue;
+            return err;
+        }
+
+        sz_read += static_cast< std::size_t >(sz);
+    }
+
+    return 0;
+}
+
+//! Last write time of a file, with the precision supported by the filesystem
+struct precise_file_time
+{
+    boost::int64_t sec;
+    boost::uint32_t nsec;
+};
+
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+//! Resolution of the last write times set by set_precise_last_write_time, in nanoseconds
+BOOST_CONSTEXPR_OR_CONST boost::uint32_t set_last_write_time_resolution = 1u;
+#else
+// utime only supports whole seconds
+BOOST_CONSTEXPR_OR_CONST boost::uint32_t set_last_write_time_resolution = 1000000000u;
+#endif
+
+//! Obtains the last write time of the directory entry from its cached attributes. Returns 0 on success or a system error code.
+int get_entry_last_write_time(directory_entry const& entry, precise_file_time& t) noexcept
+{
+    std::time_t sec = 0;
+    if (BOOST_UNLIKELY(!detail::directory_entry_cached_last_write_time(entry, sec, t.nsec)))
+        return BOOST_ERROR_NOT_SUPPORTED;
+
+    t.sec = sec;
+    return 0;
+}
+
+//! Sets the last write time of the file. Returns 0 on success or a system error code.
+int set_precise_last_write_time(path const& p, precise_file_time const& t) noexcept
+{
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS)
+    struct timespec times[2] = {};
+
+    // Keep the last access time unchanged
+    times[0].tv_nsec = UTIME_OMIT;
+
+    times[1].tv_sec = static_cast< std::time_t >(t.sec);
+    times[1].tv_nsec = static_cast< long >(t.nsec);
+
+    if (BOOST_UNLIKELY(::utimensat(AT_FDCWD, p.c_str(), times, 0) != 0))
+        return errno;
+#else
+    struct ::stat st;
+    if (BOOST_UNLIKELY(::stat(p.c_str(), &st) < 0))
+        return errno;
+
+    ::utimbuf buf;
+    buf.actime = st.st_atime;
+    buf.modtime = static_cast< std::time_t >(t.sec);
+    if (BOOST_UNLIKELY(::utime(p.c_str(), &buf) < 0))
+        return errno;
+#endif
+
+    return 0;
+}
+
+#else // defined(BOOST_FILESYSTEM_POSIX_API)
+
+//! Opens the file for reading. Returns 0 on success or a system error code.
+DWORD open_for_reading(path const& p, unique_handle& h) noexcept
+{
+    h = create_file_handle(
+        p.c_str(),
+        GENERIC_READ,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE,
+        nullptr, // lpSecurityAttributes
+        OPEN_EXISTING,
+        FILE_FLAG_SEQUENTIAL_SCAN);
+
+    if (BOOST_UNLIKELY(!h))
+        return ::GetLastError();
+
+    return 0u;
+}
+
+//! Reads up to \a size bytes from the file. Less than \a size bytes are read only at the end of the file. Returns 0 on success or a system error code.
+DWORD read_full(HANDLE h, char* buf, std::size_t size, std::size_t& sz_read) noexcept
+{
+    sz_read = 0u;
+    while (sz_read < size)
+    {
+        DWORD sz = 0u;
+        if (BOOST_UNLIKELY(!::ReadFile(h, buf + sz_read, static_cast< DWORD >(size - sz_read), &sz, nullptr)))
+            return ::GetLastError();
+        if (sz == 0u)
+            break;
+
+        sz_read += sz;
+    }
+
+    return 0u;
+}
+
+//! Last write time of a file, in the units of \c FILETIME
+struct precise_file_time
+{
+    boost::uint64_t ticks;
+};
+
+//! Obtains the last write time of the file. Returns 0 on success or a system error code.
+DWORD get_precise_last_write_time(path const& p, precise_file_time& t) noexcept
+{
+    unique_handle h(create_file_handle(
+        p.c_str(),
+        FILE_READ_ATTRIBUTES | FILE_READ_EA,
+        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS));
+    if (BOOST_UNLIKELY(!h))
+        return ::GetLastError();
+
+    FILETIME lwt;
+    if (BOOST_UNLIKELY(!::GetFileTime(h.get(), nullptr, nullptr, &lwt)))
+        return ::GetLastError();
+
+    t.ticks = (static_cast< boost::uint64_t >(lwt.dwHighDateTime) << 32u) | lwt.dwLowDateTime;
+    return 0u;
+}
+
+//! Obtains the last write time of the directory entry. Returns 0 on success or a system error code.
+inline DWORD get_entry_last_write_time(directory_entry const& entry, precise_file_time& t) noexcept
 {
-    if (ec)
-        ec->clear();
-
-    return detail::remove_impl(p, ec);
+    // Directory iteration does not obtain last write times on Windows
+    return get_precise_last_write_time(entry.path(), t);
 }
 
-BOOST_FILESYSTEM_DECL
-uintmax_t remove_all(path const& p, error_code* ec)
+//! Sets the last write time of the file. Returns 0 on success or a system error code.
+DWORD set_precise_last_write_time(path const& p, precise_file_time const& t) noexcept
 {
-    if (ec)
-        ec->clear();
+    unique_handle h(create_file_handle(
+        p.c_str(),
+        FILE_WRITE_ATTRIBUTES,
+        FILE_SHARE_DELETE | FILE_SHARE_READ | FILE_SHARE_WRITE,
+        nullptr,
+        OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS));
+    if (BOOST_UNLIKELY(!h))
+        return ::GetLastError();
 
-    return detail::remove_all_impl(p, ec);
+    FILETIME lwt;
+    lwt.dwLowDateTime = static_cast< DWORD >(t.ticks);
+    lwt.dwHighDateTime = static_cast< DWORD >(t.ticks >> 32u);
+    if (BOOST_UNLIKELY(!::SetFileTime(h.get(), nullptr, nullptr, &lwt)))
+        return ::GetLastError();
+
+    return 0u;
 }
 
-BOOST_FILESYSTEM_DECL
-void rename(path const& old_p, path const& new_p, error_code* ec)
+#endif // defined(BOOST_FILESYSTEM_POSIX_API)
+
+//! Tests if the two last write times are equal, with the precision of the times set by set_precise_last_write_time
+inline bool equal_last_write_times(precise_file_time const& left, precise_file_time const& right) noexcept
 {
-    error(!BOOST_MOVE_FILE(old_p.c_str(), new_p.c_str()) ? BOOST_ERRNO : 0, old_p, new_p, ec, "boost::filesystem::rename");
+#if defined(BOOST_FILESYSTEM_POSIX_API)
+    return left.sec == right.sec && left.nsec / set_last_write_time_resolution == right.nsec / set_last_write_time_resolution;
+#else
+    return left.ticks == right.ticks;
+#endif
 }
 
-BOOST_FILESYSTEM_DECL
-void resize_file(path const& p, uintmax_t size, system::error_code* ec)
+//! Tests if the two files have equal contents
+bool equal_file_contents(path const& p1, path const& p2, system::error_code& ec)
 {
+    std::unique_ptr< char[] > buf(new char[2u * compare_contents_buf_size]);
+    char* const buf1 = buf.get();
+    char* const buf2 = buf1 + compare_contents_buf_size;
+
 #if defined(BOOST_FILESYSTEM_POSIX_API)
-    if (BOOST_UNLIKELY(size > static_cast< uintmax_t >((std::numeric_limits< off_t >::max)())))
+    boost::scope::unique_fd file1, file2;
+#else
+    unique_handle file1, file2;
+#endif
+    err_t err = open_for_reading(p1, file1);
+    if (err == 0)
+        err = open_for_reading(p2, file2);
+
+    while (err == 0)
     {
-        emit_error(system::errc::file_too_large, p, ec, "boost::filesystem::resize_file");
-        return;
+        std::size_t size1 = 0u, size2 = 0u;
+        err = read_full(file1.get(), buf1, compare_contents_buf_size, size1);
+        if (err == 0)
+            err = read_full(file2.get(), buf2, compare_contents_buf_size, size2);
+        if (err != 0)
+            break;
+
+        if (size1 != size2 || std::memcmp(buf1, buf2, size1) != 0)
+            return false;
+
+        if (size1 < compare_contents_buf_size)
+            return true;
     }
-#endif
-    error(!BOOST_RESIZE_FILE(p.c_str(), size) ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::resize_file");
+
+    ec.assign(err, system::system_category());
+    return false;
 }
 
-BOOST_FILESYSTEM_DECL
-space_info space(path const& p, error_code* ec)
+//! An entry of a target directory of sync_tree
+struct sync_target_entry
 {
-    space_info info;
-    // Initialize members to -1, as required by C++20 [fs.op.space]/1 in case of error
-    info.capacity = static_cast< uintmax_t >(-1);
-    info.free = static_cast< uintmax_t >(-1);
-    info.available = static_cast< uintmax_t >(-1);
+    path filename;
+    directory_entry entry;
+    //! Indicates that the source directory has an entry with the same name
+    bool seen;
+};
 
-    if (ec)
-        ec->clear();
+//! Implementation of sync_tree
+struct sync_tree_state
+{
+    const sync_options options;
+    sync_summary summary;
+    //! The first error and the paths of the files that caused it
+    system::error_code ec;
+    path error_path1;
+    path error_path2;
 
-#if defined(BOOST_FILESYSTEM_USE_WASI)
+    explicit sync_tree_state(sync_options opts) :
+        options(opts)
+    {
+    }
 
-    emit_error(BOOST_ERROR_NOT_SUPPORTED, p, ec, "boost::filesystem::space");
+    sync_tree_state(sync_tree_state const&) = delete;
+    sync_tree_state& operator=(sync_tree_state const&) = delete;
 
-#elif defined(BOOST_FILESYSTEM_POSIX_API)
+    //! Saves the error and returns \c false
+    bool fail(system::error_code const& err, path const& p1, path const& p2 = path())
+    {
+        ec = err;
+        error_path1 = p1;
+        error_path2 = p2;
+        return false;
+    }
 
-    struct BOOST_STATVFS vfs;
-    if (!error(::BOOST_STATVFS(p.c_str(), &vfs) ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::space"))
+    /*!
+     * \brief Obtains the type of the target entry, without following symlinks
+     *
+     * If the target entry no longer exists, \a target is set to \c nullptr. If the type cannot be obtained, saves the error
+     * and returns \c false, so that the entry is not removed or overwritten based on an unknown type.
+     */
+    bool get_target_type(sync_target_entry*& target, file_type& type)
     {
-        info.capacity = static_cast< uintmax_t >(vfs.f_blocks) * BOOST_STATVFS_F_FRSIZE;
-        info.free = static_cast< uintmax_t >(vfs.f_bfree) * BOOST_STATVFS_F_FRSIZE;
-        info.available = static_cast< uintmax_t >(vfs.f_bavail) * BOOST_STATVFS_F_FRSIZE;
+        type = fs::file_not_found;
+        if (!target)
+            return true;
+
+        system::error_code err;
+        type = target->entry.symlink_status(err).type();
+        if (type == fs::file_not_found)
+        {
+            target = nullptr;
+            return true;
+        }
+
+        if (BOOST_UNLIKELY(!!err))
+            return fail(err, target->entry.path());
+
+        return true;
     }
 
-#else
+    /*!
+     * \brief Makes the contents of the target directory equal to the contents of the source directory
+     *
+     * Every directory is read once, with the attributes of the entries obtained during iteration. The entries of the target
+     * directory are looked up by names of the source entries. If \a to_empty is \c true, the target directory has just been
+     * created and is not read.
+     */
+    bool sync_directory(path const& from, path const& to, bool to_empty)
+    {
+        system::error_code err;
+        std::vector< sync_target_entry > targets;
+        const fs::directory_iterator end_dit;
+        if (!to_empty)
+        {
+            fs::directory_iterator it;
+            detail::directory_iterator_construct(it, to, directory_options::cache_entry_attributes, nullptr, &err);
+            if (BOOST_UNLIKELY(!!err))
+                return fail(err, to);
 
-    // GetDiskFreeSpaceExW requires a directory path, which is unlike statvfs, which accepts any file.
-    // To work around this, test if the path refers to a directory and use the parent directory if not.
-    error_code local_ec;
-    file_status status = detail::status_impl(p, &local_ec);
-    if (status.type() == fs::status_error || status.type() == fs::file_not_found)
+            while (it != end_dit)
+            {
+                sync_target_entry target;
+                target.entry = *it;
+                target.filename = path_algorithms::filename_v4(target.entry.path());
+                target.seen = false;
+                targets.push_back(std::move(target));
+
+                detail::directory_iterator_increment(it, &err);
+                if (BOOST_UNLIKELY(!!err))
+                    return fail(err, to);
+            }
+
+            std::sort(targets.begin(), targets.end(), [](sync_target_entry const& left, sync_target_entry const& right)
+            {
+                return path_algorithms::compare_v4(left.filename, right.filename) < 0;
+            });
+        }
+
+        fs::directory_iterator it;
+        detail::directory_iterator_construct(it, from, directory_options::cache_entry_attributes, nullptr, &err);
+        if (BOOST_UNLIKELY(!!err))
+            return fail(err, from);
+
+        while (it != end_dit)
+        {
+            directory_entry const& entry = *it;
+            const path filename = path_algorithms::filename_v4(entry.path());
+            path target_path = to;
+            path_algorithms::append_v4(target_path, filename);
+
+            sync_target_entry* target = nullptr;
+            std::vector< sync_target_entry >::iterator target_it = std::lower_bound(targets.begin(), targets.end(), filename, [](sync_target_entry const& left, path const& right)
+            {
+                return path_algorithms::compare_v4(left.filename, right) < 0;
+            });
+            if (target_it != targets.end() && path_algorithms::compare_v4(target_it->filename, filename) == 0)
+            {
+                target = &*target_it;
+                target->seen = true;
+            }
+
+            const file_status st = entry.symlink_status(err);
+            if (BOOST_UNLIKELY(!!err))
+                return fail(err, entry.path());
+
+            switch (st.type())
+            {
+            case fs::directory_file:
+                if (!sync_subdirectory(entry.path(), target_path, target))
+                    return false;
+                break;
+
+            case fs::regular_file:
+                if (!sync_file(it, target_path, target))
+                    return false;
+                break;
+
+            case fs::symlink_file:
+                if (!sync_symlink(entry.path(), target_path, target))
+                    return false;
+                break;
+
+            default:
+                // Other types of files, such as FIFOs and sockets, are not synchronized
+                break;
+            }
+
+            detail::directory_iterator_increment(it, &err);
+            if (BOOST_UNLIKELY(!!err))
+                return fail(err, from);
+        }
+
+        if ((options & sync_options::delete_extraneous) != sync_options::none)
+        {
+            for (std::size_t i = 0u, n = targets.size(); i < n; ++i)
+            {
+                if (!targets[i].seen && !remove_target(targets[i]))
+                    return false;
+            }
+        }
+
+        return true;
+    }
+
+    //! Creates the target directory, if needed, and synchronizes its contents
+    bool sync_subdirectory(path const& from, path const& to, sync_target_entry* target)
     {
-    fail_local_ec:
-        if (!ec)
-            BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::space", p, local_ec));
-        *ec = local_ec;
-        return info;
+        file_type target_type;
+        if (!get_target_type(target, target_type))
+            return false;
+
+        if (target_type == fs::directory_file)
+            return sync_directory(from, to, false);
+
+        system::error_code err;
+        if (target && !remove_target(*target))
+            return false;
+
+        detail::create_directory(to, &from, &err);
+        if (BOOST_UNLIKELY(!!err))
+            return fail(err, from, to);
+
+        ++summary.directories_created;
+        return sync_directory(from, to, true);
     }
 
-    path dir_path = p;
-    if (!is_directory(status))
+    //! Copies the regular file, unless the target file is equal to it
+    bool sync_file(fs::directory_iterator& from_it, path const& to, sync_target_entry* target)
     {
-        path cur_path = detail::current_path(ec);
-        if (ec && *ec)
-            return info;
+        directory_entry const& from = *from_it;
+        system::error_code err;
 
-        status = detail::symlink_status_impl(p, &local_ec);
-        if (status.type() == fs::status_error)
-            goto fail_local_ec;
-        if (is_symlink(status))
+        // The attributes are normally cached during iteration, otherwise obtain them relative to the open directory
+        BOOST_CONSTEXPR_OR_CONST entry_attributes compared_attributes = entry_attributes::file_size | entry_attributes::last_write_time;
+        if ((from.cached_attributes() & compared_attributes) != compared_attributes)
         {
-            // We need to resolve the symlink so that we report the space for the symlink target
-            dir_path = detail::canonical_v4(p, cur_path, ec);
-            if (ec && *ec)
-                return info;
+            detail::directory_iterator_refresh_attributes(from_it, compared_attributes, &err);
+            if (BOOST_UNLIKELY(!!err))
+                return fail(err, from.path());
         }
 
-        dir_path = dir_path.parent_path();
-        if (dir_path.empty())
+        const uintmax_t size = from.file_size(err);
+        if (BOOST_UNLIKELY(!!err))
+            return fail(err, from.path());
+
+        // Compare and set the last write times with the full precision, as files may be modified multiple times within a second
+        precise_file_time mtime;
+        err_t time_err = get_entry_last_write_time(from, mtime);
+        if (BOOST_UNLIKELY(time_err != 0))
+            return fail(system::error_code(time_err, system::system_category()), from.path());
+
+        file_type target_type;
+        if (!get_target_type(target, target_type))
+            return false;
+
+        if (target)
         {
-            // The original path was just a filename, which is a relative path wrt. current directory
-            dir_path = cur_path;
+            if (target_type == fs::regular_file)
+            {
+                // Target files whose attributes cannot be obtained are considered changed
+                system::error_code target_err;
+                bool equal = target->entry.file_size(target_err) == size && !target_err;
+                if (equal)
+                {
+                    if ((options & sync_options::compare_contents) != sync_options::none)
+                    {
+                        equal = equal_file_contents(from.path(), to, err);
+                        if (BOOST_UNLIKELY(!!err))
+                            return fail(err, from.path(), to);
+                    }
+                    else
+                    {
+                        precise_file_time target_mtime;
+                        equal = get_entry_last_write_time(target->entry, target_mtime) == 0 && equal_last_write_times(target_mtime, mtime);
+                    }
+                }
+
+                if (equal)
+                {
+                    ++summary.files_unchanged;
+                    return true;
+                }
+            }
+            else if (!remove_target(*target))
+            {
+                return false;
+            }
         }
-    }
 
-    // For UNC names, the path must also include a trailing slash.
-    path::string_type str = dir_path.native();
-    if (str.size() >= 2u && detail::is_directory_separator(str[0]) && detail::is_directory_separator(str[1]) && !detail::is_directory_separator(*(str.end() - 1)))
-        str.push_back(path::preferred_separator);
+        detail::copy_file(from.path(), to, target ? copy_options::overwrite_existing : copy_options::none, &err);
+        if (BOOST_UNLIKELY(!!err))
+            return fail(err, from.path(), to);
 
-    ULARGE_INTEGER avail, total, free;
-    if (!error(::GetDiskFreeSpaceExW(str.c_str(), &avail, &total, &free) == 0 ? BOOST_ERRNO : 0, p, ec, "boost::filesystem::space"))
+        // Make the last write time of the copy equal to the source file, so that the file is not copied again next time
+        time_err = set_precise_last_write_time(to, mtime);
+        if (BOOST_UNLIKELY(time_err != 0))
+            return fail(system::error_code(time_err, system::system_category()), to);
+
+        if (target)
+            ++summary.files_updated;
+        else
+            ++summary.files_created;
+        summary.bytes_copied += size;
+
+        return true;
+    }
+
+    //! Copies the symlink, unless the target symlink has the same value
+    bool sync_symlink(path const& from, path const& to, sync_target_entry* target)
     {
-        info.capacity = static_cast< uintmax_t >(total.QuadPart);
-        info.free = static_cast< uintmax_t >(free.QuadPart);
-        info.available = static_cast< uintmax_t >(avail.QuadPart);
+        file_type target_type;
+        if (!get_target_type(target, target_type))
+            return false;
+
+        system::error_code err;
+        if (target)
+        {
+            if (target_type == fs::symlink_file)
+            {
+                const path value = detail::read_symlink(from, &err);
+                if (BOOST_UNLIKELY(!!err))
+                    return fail(err, from);
+
+                // Target symlinks that cannot be read are considered changed
+                system::error_code target_err;
+                const path target_value = detail::read_symlink(to, &target_err);
+                if (!target_err && path_algorithms::compare_v4(value, target_value) == 0)
+                {
+                    ++summary.files_unchanged;
+                    return true;
+                }
+            }
+
+            if (!remove_target(*target))
+                return false;
+        }
+
+        detail::copy_symlink(from, to, &err);
+        if (BOOST_UNLIKELY(!!err))
+            return fail(err, from, to);
+
+        if (target)
+            ++summary.files_updated;
+        else
+            ++summary.files_created;
+
+        return true;
     }
 
-#endif
+    //! Removes the target entry with all its contents
+    bool remove_target(sync_target_entry const& target)
+    {
+        system::error_code err;
+        const uintmax_t count = detail::remove_all(target.entry.path(), &err);
+        if (BOOST_UNLIKELY(!!err))
+            return fail(err, target.entry.path());
 
-    return info;
-}
+        summary.files_removed += count;
+        return true;
+    }
+};
+
+} // unnamed namespace
 
 BOOST_FILESYSTEM_DECL
-file_status status(path const& p, error_code* ec)
+sync_summary sync_tree(path const& from, path const& to, sync_options options, system::error_code* ec)
 {
     if (ec)
         ec->clear();
 
-    return detail::status_impl(p, ec);
-}
+    try
+    {
+        sync_tree_state state(options);
 
-BOOST_FILESYSTEM_DECL
-file_status symlink_status(path const& p, error_code* ec)
-{
-    if (ec)
-        ec->clear();
+        system::error_code err;
+        file_status st = detail::status(from, &err);
+        if (BOOST_UNLIKELY(!!err))
+        {
+            state.fail(err, from, to);
+        }
+        else if (BOOST_UNLIKELY(st.type() != fs::directory_file))
+        {
+            state.fail(make_error_code(system::errc::not_a_directory), from, to);
+        }
+        else
+        {
+            st = detail::status(to, &err);
+            if (st.type() == fs::file_not_found)
+            {
+                err.clear();
+                detail::create_directory(to, &from, &err);
+                if (BOOST_UNLIKELY(!!err))
+                {
+                    state.fail(err, from, to);
+                }
+                else
+                {
+                    ++state.summary.directories_created;
+                    state.sync_directory(from, to, true);
+                }
+            }
+            else if (BOOST_UNLIKELY(!!err))
+            {
+                state.fail(err, from, to);
+            }
+            else if (BOOST_UNLIKELY(st.type() != fs::directory_file))
+            {
+                state.fail(make_error_code(system::errc::not_a_directory), from, to);
+            }
+            else
+            {
+                state.sync_directory(from, to, false);
+            }
+        }
 
-    return detail::symlink_status_impl(p, ec);
+        if (BOOST_UNLIKELY(!!state.ec))
+        {
+            if (!ec)
+                BOOST_FILESYSTEM_THROW(filesystem_error("boost::filesystem::sync_tree", state.error_path1, state.error_path2, state.ec));
+
+            *ec = state.ec;
+        }
+
+        return state.summary;
+    }
+    catch (std::bad_alloc&)
+    {
+        if (!ec)
+            throw;
+
+        *ec = make_error_code(system::errc::not_enough_memory);
+    }
+
+    return sync_summary();
 }
 
 // contributed by Jeff Flinn
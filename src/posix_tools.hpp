@@ -14,6 +14,8 @@
 
 #include "platform_config.hpp"
 #include <boost/filesystem/config.hpp>
+#include <sys/types.h>
+#include <sys/stat.h>
 #include <unistd.h>
 #include <fcntl.h>
 
@@ -57,8 +59,83 @@ file_status symlink_status_impl
 #endif
 );
 
+//! Obtains the specified attributes of the file and its status (following symlinks). Returns the mask of attributes that were obtained.
+entry_attributes entry_attributes_impl
+(
+    path const& p,
+    entry_attributes mask,
+    entry_attributes_cache& attrs,
+    file_status& st,
+    system::error_code* ec
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) || defined(BOOST_FILESYSTEM_USE_STATX)
+    , int basedir_fd = AT_FDCWD
+#endif
+);
+
+//! Attributes of a file used for disk usage accounting
+struct file_usage_stat
+{
+    file_type type;
+    boost::uintmax_t size;
+    boost::uintmax_t allocated_size;
+    boost::uintmax_t hard_link_count;
+    boost::uintmax_t device;
+    boost::uintmax_t inode;
+};
+
+//! Obtains the attributes of the file used for disk usage accounting. Symlinks are only followed if \a follow_symlinks is \c true.
+system::error_code file_usage_stat_impl
+(
+    path const& p,
+    bool follow_symlinks,
+    file_usage_stat& st
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) || defined(BOOST_FILESYSTEM_USE_STATX)
+    , int basedir_fd = AT_FDCWD
+#endif
+);
+
+//! A request to obtain attributes of a file, used with entry_attributes_batch_impl
+struct entry_attributes_request
+{
+    path const* p;
+    entry_attributes_cache* attrs;
+    file_status* st;
+};
+
+//! Obtains all attributes and file statuses (following symlinks) of multiple files concurrently. Errors are not reported,
+//! the attributes of the files that could not be queried are not cached.
+void entry_attributes_batch_impl
+(
+    entry_attributes_request* requests,
+    std::size_t count
+#if defined(BOOST_FILESYSTEM_HAS_POSIX_AT_APIS) || defined(BOOST_FILESYSTEM_USE_STATX)
+    , int basedir_fd = AT_FDCWD
+#endif
+);
+
 #if defined(BOOST_FILESYSTEM_POSIX_API)
 
+//! Returns file status from file type/access mode, as obtained with or without following symlinks
+inline file_status status_from_mode(mode_t mode) noexcept
+{
+    if (S_ISDIR(mode))
+        return file_status(directory_file, static_cast< perms >(mode) & perms_mask);
+    if (S_ISREG(mode))
+        return file_status(regular_file, static_cast< perms >(mode) & perms_mask);
+    if (S_ISLNK(mode))
+        return file_status(symlink_file, static_cast< perms >(mode) & perms_mask);
+    if (S_ISBLK(mode))
+        return file_status(block_file, static_cast< perms >(mode) & perms_mask);
+    if (S_ISCHR(mode))
+        return file_status(character_file, static_cast< perms >(mode) & perms_mask);
+    if (S_ISFIFO(mode))
+        return file_status(fifo_file, static_cast< perms >(mode) & perms_mask);
+    if (S_ISSOCK(mode))
+        return file_status(socket_file, static_cast< perms >(mode) & perms_mask);
+
+    return file_status(type_unknown);
+}
+
 //! Opens a directory file and returns a file descriptor. Returns a negative value in case of error.
 boost::scope::unique_fd open_directory(path const& p, directory_options opts, system::error_code& ec);
 
@@ -0,0 +1,293 @@
+//  thread_pool.hpp  -------------------------------------------------------------------//
+
+//  Copyright 2026 Andrey Semashev
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  See library home page at http://www.boost.org/libs/filesystem
+
+//--------------------------------------------------------------------------------------//
+
+#ifndef BOOST_FILESYSTEM_SRC_THREAD_POOL_HPP_
+#define BOOST_FILESYSTEM_SRC_THREAD_POOL_HPP_
+
+#include <boost/filesystem/config.hpp>
+#include <cstddef>
+#include <deque>
+#include <vector>
+#include <utility> // std::move
+
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+#include <new> // std::bad_alloc
+#include <atomic>
+#include <functional> // std::ref
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <system_error>
+#endif
+
+#include <boost/filesystem/detail/header.hpp> // must be the last #include
+
+namespace boost {
+namespace filesystem {
+namespace detail {
+
+//! Returns the number of worker threads to use for a parallel operation, given the number requested by user
+inline unsigned int resolve_thread_count(unsigned int requested) noexcept
+{
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+    if (requested == 0u)
+    {
+        requested = std::thread::hardware_concurrency();
+        if (requested == 0u)
+            requested = 1u;
+    }
+
+    return requested;
+#else
+    (void)requested;
+    return 1u;
+#endif
+}
+
+#if !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+
+/*!
+ * \brief A pool of threads processing tasks of type \c Task
+ *
+ * Every worker has its own task queue. Workers push new tasks to and take tasks from the back of their queues,
+ * which makes processing of recursively spawned tasks depth-first and cache-friendly. Idle workers steal tasks
+ * from the front of the queues of other workers. The pool completes when all tasks have been processed.
+ *
+ * The thread that calls \c run participates in the processing as the worker with index 0.
+ */
+template< typename Task >
+class work_stealing_pool
+{
+private:
+    struct worker_queue
+    {
+        std::mutex mutex;
+        std::deque< Task > tasks;
+    };
+
+private:
+    std::vector< worker_queue > m_queues;
+    //! Number of tasks queued or being processed
+    std::atomic< std::size_t > m_pending;
+    //! Number of tasks queued
+    std::atomic< std::size_t > m_queued;
+    std::atomic< bool > m_stopped;
+    std::mutex m_idle_mutex;
+    std::condition_variable m_idle_cond;
+
+public:
+    explicit work_stealing_pool(unsigned int thread_count) :
+        m_queues(thread_count > 0u ? thread_count : 1u),
+        m_pending(0u),
+        m_queued(0u),
+        m_stopped(false)
+    {
+    }
+
+    work_stealing_pool(work_stealing_pool const&) = delete;
+    work_stealing_pool& operator=(work_stealing_pool const&) = delete;
+
+    //! Returns the number of workers
+    unsigned int worker_count() const noexcept { return static_cast< unsigned int >(m_queues.size()); }
+
+    //! Adds a task to the queue of the specified worker. Can be called from task handlers.
+    void push(unsigned int worker, Task&& task)
+    {
+        m_pending.fetch_add(1u, std::memory_order_relaxed);
+        {
+            worker_queue& q = m_queues[worker];
+            std::lock_guard< std::mutex > lock(q.mutex);
+            try
+            {
+                q.tasks.push_back(std::move(task));
+            }
+            catch (...)
+            {
+                m_pending.fetch_sub(1u, std::memory_order_relaxed);
+                throw;
+            }
+            m_queued.fetch_add(1u, std::memory_order_release);
+        }
+
+        std::lock_guard< std::mutex > lock(m_idle_mutex);
+        m_idle_cond.notify_one();
+    }
+
+    //! Requests the pool to stop. The tasks that are still queued are discarded without processing.
+    void stop() noexcept
+    {
+        m_stopped.store(true, std::memory_order_relaxed);
+    }
+
+    //! Returns \c true if the pool was requested to stop
+    bool stopped() const noexcept
+    {
+        return m_stopped.load(std::memory_order_relaxed);
+    }
+
+    /*!
+     * \brief Processes the queued tasks and any tasks pushed by the handler until there are no tasks left
+     *
+     * The \a handler is called as <tt>handler(worker, task)</tt> concurrently from multiple threads and must not throw.
+     * If some of the worker threads cannot be started, the tasks are processed by the remaining threads.
+     */
+    template< typename Handler >
+    void run(Handler& handler)
+    {
+        std::vector< std::thread > threads;
+        const unsigned int thread_count = worker_count();
+        if (thread_count > 1u && m_pending.load(std::memory_order_relaxed) > 0u)
+        {
+            try
+            {
+                threads.reserve(thread_count - 1u);
+                for (unsigned int i = 1u; i < thread_count; ++i)
+                    threads.emplace_back(&work_stealing_pool::template worker_loop< Handler >, this, i, std::ref(handler));
+            }
+            catch (std::bad_alloc&)
+            {
+            }
+            catch (std::system_error&)
+            {
+            }
+        }
+
+        worker_loop(0u, handler);
+
+        for (std::size_t i = 0u, n = threads.size(); i < n; ++i)
+            threads[i].join();
+    }
+
+private:
+    template< typename Handler >
+    void worker_loop(unsigned int worker, Handler& handler)
+    {
+        Task task;
+        while (true)
+        {
+            if (pop(worker, task))
+            {
+                if (!stopped())
+                    handler(worker, task);
+                task = Task();
+
+                if (m_pending.fetch_sub(1u, std::memory_order_acq_rel) == 1u)
+                {
+                    std::lock_guard< std::mutex > lock(m_idle_mutex);
+                    m_idle_cond.notify_all();
+                }
+
+                continue;
+            }
+
+            std::unique_lock< std::mutex > lock(m_idle_mutex);
+            while (true)
+            {
+                if (m_pending.load(std::memory_order_acquire) == 0u)
+                    return;
+                if (m_queued.load(std::memory_order_acquire) > 0u)
+                    break;
+                m_idle_cond.wait(lock);
+            }
+        }
+    }
+
+    //! Takes a task from the back of the worker's own queue or, if it is empty, steals one from the front of other queues
+    bool pop(unsigned int worker, Task& task)
+    {
+        {
+            worker_queue& q = m_queues[worker];
+            std::lock_guard< std::mutex > lock(q.mutex);
+            if (!q.tasks.empty())
+            {
+                task = std::move(q.tasks.back());
+                q.tasks.pop_back();
+                m_queued.fetch_sub(1u, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        const unsigned int thread_count = worker_count();
+        for (unsigned int i = 1u; i < thread_count; ++i)
+        {
+            worker_queue& q = m_queues[(worker + i) % thread_count];
+            std::lock_guard< std::mutex > lock(q.mutex);
+            if (!q.tasks.empty())
+            {
+                task = std::move(q.tasks.front());
+                q.tasks.pop_front();
+                m_queued.fetch_sub(1u, std::memory_order_relaxed);
+                return true;
+            }
+        }
+
+        return false;
+    }
+};
+
+#else // !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+
+//! Single-threaded implementation of the pool, which processes all tasks in the calling thread
+template< typename Task >
+class work_stealing_pool
+{
+private:
+    std::deque< Task > m_tasks;
+    bool m_stopped;
+
+public:
+    explicit work_stealing_pool(unsigned int) :
+        m_stopped(false)
+    {
+    }
+
+    work_stealing_pool(work_stealing_pool const&) = delete;
+    work_stealing_pool& operator=(work_stealing_pool const&) = delete;
+
+    unsigned int worker_count() const noexcept { return 1u; }
+
+    void push(unsigned int, Task&& task)
+    {
+        m_tasks.push_back(std::move(task));
+    }
+
+    void stop() noexcept
+    {
+        m_stopped = true;
+    }
+
+    bool stopped() const noexcept
+    {
+        return m_stopped;
+    }
+
+    template< typename Handler >
+    void run(Handler& handler)
+    {
+        while (!m_tasks.empty())
+        {
+            Task task(std::move(m_tasks.back()));
+            m_tasks.pop_back();
+            if (!m_stopped)
+                handler(0u, task);
+        }
+    }
+};
+
+#endif // !defined(BOOST_FILESYSTEM_SINGLE_THREADED)
+
+} // namespace detail
+} // namespace filesystem
+} // namespace boost
+
+#include <boost/filesystem/detail/footer.hpp>
+
+#endif // BOOST_FILESYSTEM_SRC_THREAD_POOL_HPP_
@@ -24,6 +24,11 @@
 #include <boost/exception/diagnostic_information.hpp>
 #include <boost/core/lightweight_test.hpp>
 
+#if defined(__linux__) || defined(__linux) || defined(linux)
+#include <fcntl.h>
+#include <sys/stat.h>
+#endif
+
 namespace fs = boost::filesystem;
 
 namespace {
@@ -224,6 +229,258 @@ void test_copy_dir_recursive_tree(fs::path const& root_dir)
     fs::remove_all(target_dir);
 }
 
+void test_copy_dir_parallel(fs::path const& root_dir)
+{
+    std::cout << "test_copy_dir_parallel" << std::endl;
+
+    fs::path target_dir = fs::unique_path();
+
+    fs::copy(root_dir, target_dir, fs::copy_options::recursive | fs::copy_options::parallel);
+
+    directory_tree tree = collect_directory_tree(target_dir);
+
+    BOOST_TEST_EQ(tree.size(), 9u);
+    BOOST_TEST(tree.find(fs::path("d1") / "d1" / "f1") != tree.end());
+    BOOST_TEST(tree.find(fs::path("d1") / "d2") != tree.end());
+
+    verify_file(target_dir / "f1", "f1");
+    verify_file(target_dir / "f2", "f2");
+    verify_file(target_dir / "d1/f1", "d1f1");
+    verify_file(target_dir / "d1/d1/f1", "d1d1f1");
+    verify_file(target_dir / "d2/f1", "d2f1");
+
+    fs::remove_all(target_dir);
+
+    boost::system::error_code ec;
+    fs::copy(root_dir, target_dir, fs::copy_options::recursive | fs::copy_options::directories_only, 3u, ec);
+    BOOST_TEST(!ec);
+
+    tree = collect_directory_tree(target_dir);
+
+    BOOST_TEST_EQ(tree.size(), 4u);
+    BOOST_TEST(tree.find(fs::path("d1") / "d1") != tree.end());
+    BOOST_TEST(tree.find(fs::path("d1") / "d2") != tree.end());
+
+    // Copy to a tree where some of the files already exist. The other files must be copied,
+    // and the error must be reported for the least source path.
+    create_file(target_dir / "f2", "target-f2");
+    create_file(target_dir / "d2/f1", "target-d2f1");
+
+    try
+    {
+        fs::copy(root_dir, target_dir, fs::copy_options::recursive, 4u);
+        BOOST_ERROR("Parallel copy to existing files did not throw");
+    }
+    catch (fs::filesystem_error& e)
+    {
+        BOOST_TEST_EQ(e.path1(), root_dir / "d2" / "f1");
+        BOOST_TEST_EQ(e.path2(), target_dir / "d2" / "f1");
+    }
+
+    verify_file(target_dir / "f1", "f1");
+    verify_file(target_dir / "f2", "target-f2");
+    verify_file(target_dir / "d1/d1/f1", "d1d1f1");
+    verify_file(target_dir / "d2/f1", "target-d2f1");
+
+    fs::remove_all(target_dir);
+}
+
+void test_copy_dir_progress(fs::path const& root_dir)
+{
+    std::cout << "test_copy_dir_progress" << std::endl;
+
+    fs::path target_dir = fs::unique_path();
+
+    // The tree contains 9 entries, and the target directory is also created
+    boost::uintmax_t files_copied = 0u, bytes_copied = 0u, call_count = 0u;
+    fs::copy(root_dir, target_dir, fs::copy_options::recursive, [&](fs::copy_progress const& progress) -> bool
+    {
+        BOOST_TEST(progress.files_copied >= files_copied);
+        BOOST_TEST(progress.total_bytes_copied >= bytes_copied);
+        BOOST_TEST(progress.file_bytes_copied <= progress.total_bytes_copied);
+        files_copied = progress.files_copied;
+        bytes_copied = progress.total_bytes_copied;
+        ++call_count;
+        return true;
+    });
+
+    BOOST_TEST_EQ(files_copied, 10u);
+    BOOST_TEST_EQ(bytes_copied, 18u);
+    BOOST_TEST_GE(call_count, 10u);
+    verify_file(target_dir / "d1/d1/f1", "d1d1f1");
+
+    fs::remove_all(target_dir);
+
+    files_copied = 0u;
+    bytes_copied = 0u;
+    fs::copy(root_dir, target_dir, fs::copy_options::recursive | fs::copy_options::parallel, [&](fs::copy_progress const& progress) -> bool
+    {
+        // Calls are serialized, so the totals don't decrease
+        BOOST_TEST(progress.files_copied >= files_copied);
+        BOOST_TEST(progress.total_bytes_copied >= bytes_copied);
+        files_copied = progress.files_copied;
+        bytes_copied = progress.total_bytes_copied;
+        return true;
+    });
+
+    BOOST_TEST_EQ(files_copied, 10u);
+    BOOST_TEST_EQ(bytes_copied, 18u);
+    verify_file(target_dir / "d2/f1", "d2f1");
+
+    fs::remove_all(target_dir);
+
+    // Cancel after the target directory is created
+    call_count = 0u;
+    boost::system::error_code ec;
+    fs::copy(root_dir, target_dir, fs::copy_options::recursive, [&](fs::copy_progress const&) -> bool
+    {
+        ++call_count;
+        return false;
+    }, ec);
+
+    BOOST_TEST(ec == boost::system::errc::operation_canceled);
+    BOOST_TEST_EQ(call_count, 1u);
+    BOOST_TEST(fs::is_directory(target_dir));
+    BOOST_TEST(fs::is_empty(target_dir));
+
+    fs::remove_all(target_dir);
+
+    BOOST_TEST_THROWS(fs::copy(root_dir, target_dir, fs::copy_options::recursive | fs::copy_options::parallel, [](fs::copy_progress const&) { return false; }), fs::filesystem_error);
+
+    fs::remove_all(target_dir);
+}
+
+void test_sync_tree(fs::path const& root_dir, bool symlinks_supported)
+{
+    std::cout << "test_sync_tree" << std::endl;
+
+    fs::path target_dir = fs::unique_path();
+    const boost::uintmax_t file_count = symlinks_supported ? 6u : 5u;
+
+    // Initial sync creates the target directory and 4 subdirectories
+    fs::sync_summary summary = fs::sync_tree(root_dir, target_dir);
+    BOOST_TEST_EQ(summary.directories_created, 5u);
+    BOOST_TEST_EQ(summary.files_created, file_count);
+    BOOST_TEST_EQ(summary.files_updated, 0u);
+    BOOST_TEST_EQ(summary.files_unchanged, 0u);
+    BOOST_TEST_EQ(summary.files_removed, 0u);
+    BOOST_TEST_EQ(summary.bytes_copied, 18u);
+    BOOST_TEST(collect_directory_tree(root_dir) == collect_directory_tree(target_dir));
+    verify_file(target_dir / "d1/d1/f1", "d1d1f1");
+    if (symlinks_supported)
+        BOOST_TEST(fs::is_symlink(target_dir / "s1"));
+
+    summary = fs::sync_tree(root_dir, target_dir);
+    BOOST_TEST_EQ(summary.directories_created, 0u);
+    BOOST_TEST_EQ(summary.files_created, 0u);
+    BOOST_TEST_EQ(summary.files_updated, 0u);
+    BOOST_TEST_EQ(summary.files_unchanged, file_count);
+    BOOST_TEST_EQ(summary.bytes_copied, 0u);
+
+    // A file of a different size is updated
+    create_file(root_dir / "d1/f1", "d1f1-changed");
+    summary = fs::sync_tree(root_dir, target_dir);
+    BOOST_TEST_EQ(summary.files_updated, 1u);
+    BOOST_TEST_EQ(summary.files_unchanged, file_count - 1u);
+    BOOST_TEST_EQ(summary.bytes_copied, 12u);
+    verify_file(target_dir / "d1/f1", "d1f1-changed");
+    create_file(root_dir / "d1/f1", "d1f1");
+
+    // A file with the same size and last write time is only updated when contents are compared
+    create_file(target_dir / "d2/f1", "d2f2");
+    const std::time_t d2f1_time = fs::last_write_time(root_dir / "d2/f1");
+    fs::last_write_time(root_dir / "d2/f1", d2f1_time);
+    fs::last_write_time(target_dir / "d2/f1", d2f1_time);
+    summary = fs::sync_tree(root_dir, target_dir);
+    BOOST_TEST_EQ(summary.files_updated, 1u); // d1/f1
+    verify_file(target_dir / "d2/f1", "d2f2");
+    summary = fs::sync_tree(root_dir, target_dir, fs::sync_options::compare_contents);
+    BOOST_TEST_EQ(summary.files_updated, 1u);
+    BOOST_TEST_EQ(summary.files_unchanged, file_count - 1u);
+    verify_file(target_dir / "d2/f1", "d2f1");
+
+#if defined(__linux__) || defined(__linux) || defined(linux)
+    // Last write times are compared with the full precision, so a file whose last write time differs by a fraction of a second is updated
+    {
+        create_file(target_dir / "d2/f1", "d2f2");
+        struct timespec times[2] = {};
+        times[0].tv_nsec = UTIME_OMIT;
+        times[1].tv_sec = d2f1_time;
+        times[1].tv_nsec = 500000000;
+        BOOST_TEST_EQ(::utimensat(AT_FDCWD, (root_dir / "d2/f1").c_str(), times, 0), 0);
+        struct ::stat st = {};
+        if (::stat((root_dir / "d2/f1").c_str(), &st) == 0 && st.st_mtim.tv_nsec != 0)
+        {
+            summary = fs::sync_tree(root_dir, target_dir);
+            BOOST_TEST_EQ(summary.files_updated, 1u);
+            verify_file(target_dir / "d2/f1", "d2f1");
+
+            // The last write time of the copy is set with the full precision
+            summary = fs::sync_tree(root_dir, target_dir);
+            BOOST_TEST_EQ(summary.files_updated, 0u);
+            BOOST_TEST_EQ(summary.files_unchanged, file_count);
+        }
+    }
+#endif
+
+    // Files with fractional last write times are not copied again by a subsequent sync
+    {
+        const fs::path from_dir = fs::unique_path();
+        const fs::path to_dir = fs::unique_path();
+        fs::create_directory(from_dir);
+        create_file(from_dir / "f1", "f1");
+        create_file(from_dir / "f2", "f2");
+#if defined(__linux__) || defined(__linux) || defined(linux)
+        struct timespec times[2] = {};
+        times[0].tv_nsec = UTIME_OMIT;
+        times[1].tv_sec = d2f1_time;
+        times[1].tv_nsec = 123456789;
+        BOOST_TEST_EQ(::utimensat(AT_FDCWD, (from_dir / "f1").c_str(), times, 0), 0);
+#endif
+
+        summary = fs::sync_tree(from_dir, to_dir);
+        BOOST_TEST_EQ(summary.files_created, 2u);
+        summary = fs::sync_tree(from_dir, to_dir);
+        BOOST_TEST_EQ(summary.files_created, 0u);
+        BOOST_TEST_EQ(summary.files_updated, 0u);
+        BOOST_TEST_EQ(summary.files_unchanged, 2u);
+        BOOST_TEST_EQ(summary.bytes_copied, 0u);
+
+        fs::remove_all(from_dir);
+        fs::remove_all(to_dir);
+    }
+
+    // Extraneous files are only removed on request
+    create_file(target_dir / "extra", "extra");
+    fs::create_directory(target_dir / "d3");
+    create_file(target_dir / "d3/f1", "d3f1");
+    summary = fs::sync_tree(root_dir, target_dir);
+    BOOST_TEST_EQ(summary.files_removed, 0u);
+    BOOST_TEST(fs::exists(target_dir / "extra"));
+    summary = fs::sync_tree(root_dir, target_dir, fs::sync_options::delete_extraneous);
+    BOOST_TEST_EQ(summary.files_removed, 3u);
+    BOOST_TEST_EQ(summary.files_unchanged, file_count);
+    BOOST_TEST(!fs::exists(target_dir / "extra"));
+    BOOST_TEST(!fs::exists(target_dir / "d3"));
+    BOOST_TEST(collect_directory_tree(root_dir) == collect_directory_tree(target_dir));
+
+    // A target file of a different type is replaced
+    fs::remove(target_dir / "f2");
+    fs::create_directory(target_dir / "f2");
+    summary = fs::sync_tree(root_dir, target_dir);
+    BOOST_TEST_EQ(summary.files_updated, 1u);
+    BOOST_TEST_EQ(summary.files_removed, 1u);
+    verify_file(target_dir / "f2", "f2");
+
+    fs::remove_all(target_dir);
+
+    boost::system::error_code ec;
+    fs::sync_tree(root_dir / "f1", target_dir, ec);
+    BOOST_TEST(ec == boost::system::errc::not_a_directory);
+    BOOST_TEST(!fs::exists(target_dir));
+    BOOST_TEST_THROWS(fs::sync_tree(root_dir / "nonexistent", target_dir), fs::filesystem_error);
+}
+
 void test_copy_file_symlinks(fs::path const& root_dir)
 {
     std::cout << "test_copy_file_symlinks" << std::endl;
@@ -300,6 +557,8 @@ int main()
         test_copy_dir_default_ec(root_dir, false);
         test_copy_dir_recursive(root_dir);
         test_copy_dir_recursive_tree(root_dir);
+        test_copy_dir_parallel(root_dir);
+        test_copy_dir_progress(root_dir);
 
         bool symlinks_supported = false;
         try
@@ -326,6 +585,7 @@ int main()
             test_copy_file_symlinks(root_dir);
         }
 
+        test_sync_tree(root_dir, symlinks_supported);
         test_copy_errors(root_dir, symlinks_supported);
 
         fs::remove_all(root_dir);
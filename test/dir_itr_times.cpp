@@ -0,0 +1,229 @@
+//  Boost Filesystem dir_itr_times.cpp  ------------------------------------------------//
+
+//  Copyright Andrey Semashev 2026
+
+//  Distributed under the Boost Software License, Version 1.0.
+//  See http://www.boost.org/LICENSE_1_0.txt
+
+//  Library home page: http://www.boost.org/libs/filesystem
+
+//  Measures the time and the number of memory allocations of recursive directory iteration
+//  and of listing a single directory.
+//
+//  Usage: dir_itr_times [directory count [repeat count]]
+
+#include <boost/config/warning_disable.hpp>
+
+#ifndef BOOST_FILESYSTEM_NO_DEPRECATED
+#define BOOST_FILESYSTEM_NO_DEPRECATED
+#endif
+#ifndef BOOST_SYSTEM_NO_DEPRECATED
+#define BOOST_SYSTEM_NO_DEPRECATED
+#endif
+
+#include <boost/filesystem/operations.hpp>
+#include <boost/filesystem/directory.hpp>
+
+#include <boost/detail/lightweight_main.hpp>
+
+#include <new>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+
+namespace fs = boost::filesystem;
+
+using std::cout;
+using std::endl;
+
+namespace {
+
+//! Allocations of at least this size are counted separately, these are typically the buffers for directory entries
+const std::size_t large_allocation_size = 4096u;
+
+std::size_t allocation_count = 0u;
+std::size_t large_allocation_count = 0u;
+
+void* allocate(std::size_t size) noexcept
+{
+    ++allocation_count;
+    if (size >= large_allocation_size)
+        ++large_allocation_count;
+    return std::malloc(size > 0u ? size : 1u);
+}
+
+} // namespace
+
+void* operator new(std::size_t size)
+{
+    void* p = allocate(size);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, std::nothrow_t const&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, std::nothrow_t const&) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::nothrow_t const&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, std::nothrow_t const&) noexcept
+{
+    std::free(p);
+}
+
+namespace {
+
+//! Creates a tree of \a dir_count directories with \a fanout subdirectories in each and a file in every directory
+void create_tree(fs::path const& root, unsigned int dir_count, unsigned int fanout)
+{
+    std::size_t created = 0u;
+    for (unsigned int i = 0u; i < dir_count; ++i)
+    {
+        // Build a balanced tree by encoding the directory index in base fanout
+        fs::path dir = root;
+        unsigned int n = i;
+        do
+        {
+            dir /= std::to_string(n % fanout);
+            n /= fanout;
+        }
+        while (n > 0u);
+
+        fs::create_directories(dir);
+        std::ofstream((dir / "file").string().c_str()) << "x";
+        ++created;
+    }
+
+    cout << "Created " << created << " directories in " << root << endl;
+}
+
+void time_iteration(fs::path const& root, unsigned int repeat_count)
+{
+    std::size_t dir_count = 0u, entry_count = 0u;
+    const std::size_t allocations_before = allocation_count, large_allocations_before = large_allocation_count;
+    const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+    for (unsigned int i = 0u; i < repeat_count; ++i)
+    {
+        for (fs::recursive_directory_iterator it(root), end; it != end; ++it)
+        {
+            ++entry_count;
+            if (it->is_directory())
+                ++dir_count;
+        }
+    }
+
+    const std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+    const std::size_t allocations = allocation_count - allocations_before, large_allocations = large_allocation_count - large_allocations_before;
+
+    cout << "Iterated over " << entry_count << " entries in " << dir_count << " directories, " << repeat_count << " times" << endl;
+    cout << "  time: " << std::chrono::duration_cast< std::chrono::microseconds >(elapsed).count() << " us" << endl;
+    cout << "  allocations: " << allocations << " (" << static_cast< double >(allocations) / dir_count << " per directory)" << endl;
+    cout << "  allocations of at least " << large_allocation_size << " bytes: " << large_allocations
+         << " (" << static_cast< double >(large_allocations) / dir_count << " per directory)" << endl;
+}
+
+//! Creates a directory with \a file_count files with long names
+void create_flat_directory(fs::path const& dir, unsigned int file_count)
+{
+    fs::create_directories(dir);
+    for (unsigned int i = 0u; i < file_count; ++i)
+        std::ofstream((dir / ("a_file_name_long_enough_to_not_fit_in_small_string_buffers_" + std::to_string(i))).string().c_str());
+}
+
+void time_listing(fs::path const& dir, unsigned int repeat_count)
+{
+    std::size_t entry_count = 0u;
+    std::size_t allocations_before = allocation_count;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0u; i < repeat_count; ++i)
+    {
+        for (fs::directory_iterator it(dir), end; it != end; ++it)
+            ++entry_count;
+    }
+    std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now() - start;
+    std::size_t allocations = allocation_count - allocations_before;
+
+    cout << "directory_iterator listed " << entry_count << " entries, " << repeat_count << " times" << endl;
+    cout << "  time: " << std::chrono::duration_cast< std::chrono::microseconds >(elapsed).count() << " us" << endl;
+    cout << "  allocations: " << allocations << " (" << static_cast< double >(allocations) / entry_count << " per entry)" << endl;
+
+    entry_count = 0u;
+    allocations_before = allocation_count;
+    start = std::chrono::steady_clock::now();
+    for (unsigned int i = 0u; i < repeat_count; ++i)
+    {
+        for (fs::directory_reader reader(dir); reader.next();)
+            ++entry_count;
+    }
+    elapsed = std::chrono::steady_clock::now() - start;
+    allocations = allocation_count - allocations_before;
+
+    cout << "directory_reader listed " << entry_count << " entries, " << repeat_count << " times" << endl;
+    cout << "  time: " << std::chrono::duration_cast< std::chrono::microseconds >(elapsed).count() << " us" << endl;
+    cout << "  allocations: " << allocations << " (" << static_cast< double >(allocations) / entry_count << " per entry)" << endl;
+}
+
+} // namespace
+
+//--------------------------------------------------------------------------------------//
+
+int cpp_main(int argc, char* argv[])
+{
+    unsigned int dir_count = 2000u, repeat_count = 10u;
+    if (argc > 1)
+        dir_count = static_cast< unsigned int >(std::atoi(argv[1]));
+    if (argc > 2)
+        repeat_count = static_cast< unsigned int >(std::atoi(argv[2]));
+
+    const fs::path root = fs::unique_path(fs::temp_directory_path() / "dir_itr_times-%%%%-%%%%");
+    create_tree(root, dir_count, 8u);
+
+    time_iteration(root, repeat_count);
+
+    const fs::path flat_dir = root / "flat";
+    create_flat_directory(flat_dir, dir_count);
+    time_listing(flat_dir, repeat_count);
+
+    fs::remove_all(root);
+    return 0;
+}
@@ -21,6 +21,13 @@
 
 #include <boost/filesystem/operations.hpp>
 #include <boost/filesystem/directory.hpp>
+#include <boost/filesystem/directory_tree.hpp>
+#include <boost/filesystem/directory_snapshot.hpp>
+#include <boost/filesystem/directory_watcher.hpp>
+#include <boost/filesystem/glob.hpp>
+#include <boost/filesystem/executor.hpp>
+#include <boost/filesystem/async.hpp>
+#include <boost/filesystem/coroutine.hpp>
 #include <boost/filesystem/exception.hpp>
 #include <boost/filesystem/file_status.hpp>
 #include <boost/filesystem/fstream.hpp> // for BOOST_FILESYSTEM_C_STR
@@ -47,6 +54,13 @@ using std::endl;
 #include <string>
 #include <vector>
 #include <algorithm>
+#include <iterator>
+#include <chrono>
+#include <mutex>
+#include <future>
+#include <functional>
+#include <utility>
+#include <stdexcept>
 #include <cstring> // for strncmp, etc.
 #include <ctime>
 #include <cstdlib> // for system(), getenv(), etc.
@@ -683,6 +697,70 @@ void directory_iterator_tests()
         BOOST_TEST(found);
     }
 
+    // test a directory with more entries than the iterator can read with a single system call
+    {
+        const fs::path many_dir = dir / "many_entries";
+        fs::create_directory(many_dir);
+        const unsigned int file_count = 2000u;
+        for (unsigned int i = 0u; i < file_count; ++i)
+        {
+            std::string name = "a_reasonably_long_file_name_to_fill_the_buffer_" + std::to_string(i);
+            create_file(many_dir / name);
+        }
+
+        std::vector< bool > found(file_count, false);
+        unsigned int count = 0u;
+        for (fs::directory_iterator itx(many_dir); itx != fs::directory_iterator(); ++itx)
+        {
+            BOOST_TEST(fs::is_regular_file(itx->symlink_status()));
+            const std::string name = itx->path().filename().string();
+            const unsigned int index = static_cast< unsigned int >(std::atoi(name.c_str() + name.rfind('_') + 1u));
+            BOOST_TEST(index < file_count);
+            if (index < file_count)
+            {
+                BOOST_TEST(!found[index]);
+                found[index] = true;
+            }
+            ++count;
+        }
+        BOOST_TEST_EQ(count, file_count);
+
+        // the same directory, iterated in batches
+        std::fill(found.begin(), found.end(), false);
+        count = 0u;
+        fs::directory_entry batch[64];
+        fs::directory_iterator itx(many_dir);
+        while (true)
+        {
+            ec.clear();
+            const std::size_t n = itx.next_batch(batch, sizeof(batch) / sizeof(*batch), ec);
+            BOOST_TEST(!ec);
+            if (n == 0u)
+                break;
+
+            BOOST_TEST(n == sizeof(batch) / sizeof(*batch) || itx == fs::directory_iterator());
+            for (std::size_t i = 0u; i < n; ++i)
+            {
+                BOOST_TEST(batch[i].path().parent_path() == many_dir);
+                BOOST_TEST(fs::is_regular_file(batch[i].symlink_status()));
+                const std::string name = batch[i].path().filename().string();
+                const unsigned int index = static_cast< unsigned int >(std::atoi(name.c_str() + name.rfind('_') + 1u));
+                BOOST_TEST(index < file_count);
+                if (index < file_count)
+                {
+                    BOOST_TEST(!found[index]);
+                    found[index] = true;
+                }
+                ++count;
+            }
+        }
+        BOOST_TEST_EQ(count, file_count);
+        BOOST_TEST(itx == fs::directory_iterator());
+        BOOST_TEST_EQ(itx.next_batch(batch, sizeof(batch) / sizeof(*batch)), 0u);
+
+        fs::remove_all(many_dir);
+    }
+
     // there was an inital bug in directory_iterator that caused premature
     // close of an OS handle. This block will detect regression.
     {
@@ -743,9 +821,937 @@ void recursive_directory_iterator_tests()
     BOOST_TEST_EQ(d1f1_count, 1);
     BOOST_TEST(it == it2); // verify single pass shallow copy semantics
 
+    //  test recursion filter
+    cout << "  with recursion filter" << endl;
+    int d1_count = 0, filter_calls = 0;
+    d1f1_count = 0;
+    for (fs::recursive_directory_iterator it3(dir, fs::directory_options::none,
+             [&filter_calls](fs::directory_entry const& e)
+             {
+                 ++filter_calls;
+                 BOOST_TEST(!fs::is_regular_file(e.symlink_status()));
+                 return e.path().filename() != "d1";
+             });
+         it3 != fs::recursive_directory_iterator();
+         ++it3)
+    {
+        if (it3->path().filename() == "d1")
+            ++d1_count;
+        else if (it3->path().filename() == "d1f1")
+            ++d1f1_count;
+    }
+    BOOST_TEST_EQ(d1_count, 1);
+    BOOST_TEST_EQ(d1f1_count, 0); // d1 was not recursed into
+    BOOST_TEST(filter_calls > 0);
+
+    //  test limiting the number of open directories
+    cout << "  with limited number of open directories" << endl;
+    {
+        const fs::path deep = dir / "deep";
+        fs::path p = deep;
+        for (unsigned int i = 0u; i < 8u; ++i)
+        {
+            fs::create_directories(p / "sibling");
+            create_file(p / "file1");
+            create_file(p / "file2");
+            p /= "child";
+        }
+        fs::create_directories(p);
+
+        std::vector< fs::path > expected;
+        for (fs::recursive_directory_iterator it4(deep), end; it4 != end; ++it4)
+            expected.push_back(it4->path());
+
+        std::vector< fs::path > paths;
+        fs::recursive_directory_iterator it4(deep);
+        it4.max_open_directories(2u);
+        BOOST_TEST_EQ(it4.max_open_directories(), 2u);
+        for (fs::recursive_directory_iterator end; it4 != end; ++it4)
+            paths.push_back(it4->path());
+        BOOST_TEST(paths == expected);
+
+#if defined(BOOST_POSIX_API)
+        // a closed directory that is replaced with a symlink is not followed when reopened
+        if (create_symlink_ok)
+        {
+            fs::recursive_directory_iterator it5(deep), end;
+            it5.max_open_directories(1u);
+            while (it5 != end && it5.depth() < 2)
+                ++it5;
+            BOOST_TEST(it5 != end);
+
+            fs::rename(deep / "child", deep / "moved_child");
+            fs::create_directory_symlink("moved_child", deep / "child");
+            error_code ec;
+            while (it5 != end && !ec)
+                it5.increment(ec);
+            BOOST_TEST(!!ec);
+            fs::remove(deep / "child");
+            fs::rename(deep / "moved_child", deep / "child");
+        }
+#endif
+
+        fs::remove_all(deep);
+    }
+
     cout << "  recursive_directory_iterator_tests complete" << endl;
 }
 
+//  parallel_walk_tests  -------------------------------------------------------------//
+
+struct parallel_walk_collector
+{
+    std::mutex mutex;
+    std::vector< fs::path > paths;
+
+    void operator()(fs::directory_entry const& entry)
+    {
+        std::lock_guard< std::mutex > lock(mutex);
+        paths.push_back(entry.path());
+    }
+};
+
+void parallel_walk_tests()
+{
+    cout << "parallel_walk_tests..." << endl;
+
+    std::vector< fs::path > expected;
+    for (fs::recursive_directory_iterator it(dir), end; it != end; ++it)
+        expected.push_back(it->path());
+    std::sort(expected.begin(), expected.end());
+    BOOST_TEST(!expected.empty());
+
+    for (unsigned int thread_count = 1u; thread_count <= 4u; thread_count += 3u)
+    {
+        parallel_walk_collector collector;
+        fs::parallel_walk(dir, fs::parallel_walk_options(fs::directory_options::none, thread_count), collector);
+        std::sort(collector.paths.begin(), collector.paths.end());
+        BOOST_TEST(collector.paths == expected);
+    }
+
+    if (create_symlink_ok)
+    {
+        std::vector< fs::path > expected_follow;
+        const fs::directory_options follow_opts = fs::directory_options::follow_directory_symlink | fs::directory_options::skip_dangling_symlinks;
+        for (fs::recursive_directory_iterator it(dir, follow_opts), end; it != end; ++it)
+            expected_follow.push_back(it->path());
+        std::sort(expected_follow.begin(), expected_follow.end());
+
+        parallel_walk_collector collector;
+        fs::parallel_walk(dir, follow_opts, collector);
+        std::sort(collector.paths.begin(), collector.paths.end());
+        BOOST_TEST(collector.paths == expected_follow);
+    }
+
+    // error reporting
+    parallel_walk_collector collector;
+    error_code ec;
+    fs::parallel_walk(dir / "no-such-dir", fs::directory_options::none, collector, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(collector.paths.empty());
+    BOOST_TEST(CHECK_EXCEPTION(
+        [&collector]() { fs::parallel_walk(dir / "no-such-dir", fs::directory_options::none, collector); },
+        ENOENT));
+
+    // exceptions thrown by the visitor are propagated to the caller
+    bool exception_thrown = false;
+    try
+    {
+        fs::parallel_walk(dir, fs::parallel_walk_options(fs::directory_options::none, 4u), [](fs::directory_entry const&) { throw std::runtime_error("visitor error"); });
+    }
+    catch (std::runtime_error&)
+    {
+        exception_thrown = true;
+    }
+    BOOST_TEST(exception_thrown);
+
+    cout << "  parallel_walk_tests complete" << endl;
+}
+
+//  disk_usage_tests  ----------------------------------------------------------------//
+
+void disk_usage_tests()
+{
+    cout << "disk_usage_tests..." << endl;
+
+    boost::uintmax_t expected_files = 0u, expected_dirs = 0u;
+    std::vector< fs::path > hard_links;
+    for (fs::recursive_directory_iterator it(dir), end; it != end; ++it)
+    {
+        const fs::file_type type = it->symlink_status().type();
+        if (type == fs::directory_file)
+        {
+            ++expected_dirs;
+            continue;
+        }
+
+        if (type == fs::regular_file && fs::hard_link_count(it->path()) > 1u)
+        {
+            bool found = false;
+            for (std::size_t i = 0u; i < hard_links.size() && !found; ++i)
+                found = fs::equivalent(hard_links[i], it->path());
+            if (found)
+                continue;
+            hard_links.push_back(it->path());
+        }
+
+        ++expected_files;
+    }
+
+    for (unsigned int thread_count = 1u; thread_count <= 4u; thread_count += 3u)
+    {
+        std::vector< fs::directory_usage > usage = fs::disk_usage(dir, fs::parallel_walk_options(fs::directory_options::none, thread_count));
+        BOOST_TEST_EQ(usage.size(), expected_dirs + 1u);
+        if (!usage.empty())
+        {
+            BOOST_TEST_EQ(usage[0].dir_path, dir);
+            BOOST_TEST_EQ(usage[0].usage.file_count, expected_files);
+            BOOST_TEST_EQ(usage[0].usage.directory_count, expected_dirs);
+            for (std::size_t i = 1u; i < usage.size(); ++i)
+                BOOST_TEST(usage[i].usage.apparent_size <= usage[0].usage.apparent_size);
+        }
+    }
+
+    // hard links are accounted once
+    const fs::path root = dir / "disk_usage";
+    fs::create_directories(root / "sub");
+    create_file(root / "f1", "abc");
+    create_file(root / "sub" / "f2", "abcde");
+    error_code ec;
+    fs::create_hard_link(root / "f1", root / "sub" / "f1_link", ec);
+    const bool hard_link_ok = !ec;
+
+    std::vector< fs::directory_usage > usage = fs::disk_usage(root, fs::parallel_walk_options(fs::directory_options::none, 1u));
+    BOOST_TEST_EQ(usage.size(), 2u);
+    if (usage.size() == 2u)
+    {
+        BOOST_TEST_EQ(usage[0].dir_path, root);
+        BOOST_TEST_EQ(usage[0].usage.file_count, 2u);
+        BOOST_TEST_EQ(usage[0].usage.directory_count, 1u);
+        BOOST_TEST_EQ(usage[1].dir_path, root / "sub");
+        BOOST_TEST_EQ(usage[1].usage.file_count, 1u);
+        BOOST_TEST_EQ(usage[1].usage.directory_count, 0u);
+        BOOST_TEST(usage[1].usage.apparent_size >= 5u);
+        BOOST_TEST(usage[0].usage.apparent_size >= usage[1].usage.apparent_size + 3u);
+        BOOST_TEST(usage[0].usage.allocated_size >= usage[1].usage.allocated_size);
+    }
+
+    if (hard_link_ok)
+        fs::remove(root / "sub" / "f1_link");
+
+#if defined(BOOST_POSIX_API)
+    // with multiple errors, the error on the smallest path is reported, regardless of the number of threads
+    fs::create_directory(root / "denied1");
+    fs::create_directory(root / "denied2");
+    fs::permissions(root / "denied1", fs::no_perms);
+    fs::permissions(root / "denied2", fs::no_perms);
+    {
+        // permissions are not checked for privileged users
+        fs::directory_iterator denied_it(root / "denied1", ec);
+    }
+    if (!!ec)
+    {
+        for (unsigned int thread_count = 1u; thread_count <= 4u; thread_count += 3u)
+        {
+            fs::path error_path;
+            try
+            {
+                fs::disk_usage(root, fs::parallel_walk_options(fs::directory_options::pop_on_error, thread_count));
+            }
+            catch (fs::filesystem_error& e)
+            {
+                error_path = e.path1();
+            }
+            BOOST_TEST_EQ(error_path, root / "denied1");
+        }
+    }
+    fs::permissions(root / "denied1", fs::owner_all);
+    fs::permissions(root / "denied2", fs::owner_all);
+#endif
+
+    fs::remove_all(root);
+
+    // error reporting
+    usage = fs::disk_usage(dir / "no-such-dir", fs::parallel_walk_options(), ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(usage.empty());
+    BOOST_TEST(CHECK_EXCEPTION(
+        []() { fs::disk_usage(dir / "no-such-dir"); },
+        ENOENT));
+
+    cout << "  disk_usage_tests complete" << endl;
+}
+
+//  directory_reader_tests  ---------------------------------------------------------//
+
+void directory_reader_tests()
+{
+    cout << "directory_reader_tests..." << endl;
+
+    std::vector< fs::path > expected;
+    for (fs::directory_iterator it(dir), end; it != end; ++it)
+        expected.push_back(it->path());
+    std::sort(expected.begin(), expected.end());
+
+    fs::directory_reader reader(dir);
+    BOOST_TEST(reader.is_open());
+    BOOST_TEST_EQ(reader.directory_path(), dir);
+
+    std::vector< fs::path > paths;
+    while (reader.next())
+    {
+        fs::path p = reader.full_path();
+        BOOST_TEST_EQ(p.filename(), reader.filename());
+        BOOST_TEST_EQ(reader.name_size(), reader.filename().native().size());
+        BOOST_TEST_EQ(reader.name_c_str()[reader.name_size()], static_cast< fs::path::value_type >('\0'));
+        if (reader.symlink_type() != fs::status_error)
+            BOOST_TEST(reader.symlink_type() == fs::symlink_status(p).type());
+        if (reader.type() != fs::status_error)
+            BOOST_TEST(reader.type() == fs::status(p).type());
+        paths.push_back(p);
+    }
+    std::sort(paths.begin(), paths.end());
+    BOOST_TEST(paths == expected);
+    BOOST_TEST(!reader.is_open());
+    BOOST_TEST(!reader.next());
+
+    // moving the reader preserves the name of the current entry
+    {
+        fs::directory_reader moved_from(dir);
+        BOOST_TEST(moved_from.next());
+        const fs::path::string_type first_name(moved_from.name_c_str(), moved_from.name_c_str() + moved_from.name_size());
+        fs::directory_reader moved_to(std::move(moved_from));
+        BOOST_TEST(!moved_from.is_open());
+        BOOST_TEST(moved_to.is_open());
+        BOOST_TEST(fs::path::string_type(moved_to.name_c_str(), moved_to.name_c_str() + moved_to.name_size()) == first_name);
+        BOOST_TEST(std::binary_search(expected.begin(), expected.end(), moved_to.full_path()));
+
+        BOOST_TEST(moved_to.next());
+        const fs::path::string_type second_name(moved_to.name_c_str(), moved_to.name_c_str() + moved_to.name_size());
+        moved_from = std::move(moved_to);
+        BOOST_TEST(!moved_to.is_open());
+        BOOST_TEST(fs::path::string_type(moved_from.name_c_str(), moved_from.name_c_str() + moved_from.name_size()) == second_name);
+        BOOST_TEST(std::binary_search(expected.begin(), expected.end(), moved_from.full_path()));
+    }
+
+    // empty directory
+    fs::path empty_dir = dir / "empty-reader-dir";
+    fs::create_directory(empty_dir);
+    reader.open(empty_dir);
+    BOOST_TEST(!reader.next());
+    fs::remove(empty_dir);
+
+    // error reporting
+    error_code ec;
+    reader.open(dir / "no-such-dir", fs::directory_options::none, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(!reader.is_open());
+    BOOST_TEST(CHECK_EXCEPTION(
+        [&reader]() { reader.open(dir / "no-such-dir"); },
+        ENOENT));
+
+    cout << "  directory_reader_tests complete" << endl;
+}
+
+//  coroutine_tests  ----------------------------------------------------------------//
+
+#if defined(BOOST_FILESYSTEM_DETAIL_HAS_COROUTINES)
+
+//! Coroutine that starts immediately and is not awaited by anyone
+struct detached_task
+{
+    struct promise_type
+    {
+        detached_task get_return_object() const noexcept { return detached_task(); }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_void() const noexcept {}
+        void unhandled_exception() const noexcept { std::terminate(); }
+    };
+};
+
+detached_task async_scan(fs::thread_pool_executor& ex, fs::path root, std::vector< fs::path >& paths, error_code& ec, std::promise< void >& done)
+{
+    fs::async_directory_scanner<> scanner(ex, root, fs::directory_options::none, 3u);
+    while (fs::directory_entry const* entry = co_await scanner.next(ec))
+        paths.push_back(entry->path());
+    done.set_value();
+}
+
+detached_task async_scan_throw(fs::thread_pool_executor& ex, fs::path root, int& error_value, std::promise< void >& done)
+{
+    fs::async_directory_scanner<> scanner(ex, root);
+    try
+    {
+        while (co_await scanner.next())
+        {
+        }
+    }
+    catch (fs::filesystem_error& e)
+    {
+        error_value = e.code().value();
+    }
+    done.set_value();
+}
+
+void coroutine_tests()
+{
+    cout << "coroutine_tests..." << endl;
+
+    std::vector< fs::path > expected;
+    for (fs::directory_iterator it(dir), end; it != end; ++it)
+        expected.push_back(it->path());
+    std::sort(expected.begin(), expected.end());
+
+    std::vector< fs::path > paths;
+    for (fs::directory_entry const& entry : fs::directory_entries(dir))
+        paths.push_back(entry.path());
+    std::sort(paths.begin(), paths.end());
+    BOOST_TEST(paths == expected);
+
+    expected.clear();
+    for (fs::recursive_directory_iterator it(dir), end; it != end; ++it)
+        expected.push_back(it->path());
+    std::sort(expected.begin(), expected.end());
+
+    paths.clear();
+    for (fs::directory_entry const& entry : fs::recursive_directory_entries(dir))
+        paths.push_back(entry.path());
+    std::sort(paths.begin(), paths.end());
+    BOOST_TEST(paths == expected);
+
+    // error reporting
+    error_code ec;
+    paths.clear();
+    for (fs::directory_entry const& entry : fs::recursive_directory_entries(dir / "no-such-dir", fs::directory_options::none, ec))
+        paths.push_back(entry.path());
+    BOOST_TEST(!!ec);
+    BOOST_TEST(paths.empty());
+    BOOST_TEST(CHECK_EXCEPTION(
+        []() { fs::directory_entry_generator gen = fs::directory_entries(dir / "no-such-dir"); gen.begin(); },
+        ENOENT));
+
+    // asynchronous traversal
+    {
+        fs::thread_pool_executor ex(2u);
+        BOOST_TEST_EQ(ex.thread_count(), 2u);
+
+        paths.clear();
+        std::promise< void > done;
+        async_scan(ex, dir, paths, ec, done);
+        done.get_future().wait();
+        BOOST_TEST(!ec);
+        std::sort(paths.begin(), paths.end());
+        BOOST_TEST(paths == expected);
+
+        paths.clear();
+        std::promise< void > done_error;
+        async_scan(ex, dir / "no-such-dir", paths, ec, done_error);
+        done_error.get_future().wait();
+        BOOST_TEST(!!ec);
+        BOOST_TEST(paths.empty());
+
+        int error_value = 0;
+        std::promise< void > done_throw;
+        async_scan_throw(ex, dir / "no-such-dir", error_value, done_throw);
+        done_throw.get_future().wait();
+        BOOST_TEST_NE(error_value, 0);
+    }
+
+    cout << "  coroutine_tests complete" << endl;
+}
+
+#endif // defined(BOOST_FILESYSTEM_DETAIL_HAS_COROUTINES)
+
+//  async_tests  --------------------------------------------------------------------//
+
+//! Receives the result of an asynchronous operation
+template< typename T >
+class async_result
+{
+private:
+    std::promise< std::pair< T, error_code > > m_promise;
+    std::future< std::pair< T, error_code > > m_future;
+
+public:
+    async_result() :
+        m_future(m_promise.get_future())
+    {
+    }
+
+    std::function< void (T, error_code const&) > handler()
+    {
+        return [this](T value, error_code const& ec) { m_promise.set_value(std::make_pair(value, ec)); };
+    }
+
+    std::pair< T, error_code > get() { return m_future.get(); }
+};
+
+void async_tests()
+{
+    cout << "async_tests..." << endl;
+
+    const fs::path root = dir / "async-dir";
+    fs::async_context ctx(2u);
+    cout << "  uses io_uring: " << ctx.uses_io_uring() << endl;
+
+    {
+        async_result< bool > created, existing;
+        ctx.async_create_directory(root, created.handler());
+        std::pair< bool, error_code > res = created.get();
+        BOOST_TEST(res.first);
+        BOOST_TEST(!res.second);
+        BOOST_TEST(fs::is_directory(root));
+
+        ctx.async_create_directory(root, existing.handler());
+        res = existing.get();
+        BOOST_TEST(!res.first);
+        BOOST_TEST(!res.second);
+    }
+
+    {
+        async_result< fs::file_status > st, missing;
+        ctx.async_status(root, st.handler());
+        std::pair< fs::file_status, error_code > res = st.get();
+        BOOST_TEST_EQ(res.first.type(), fs::directory_file);
+        BOOST_TEST(!res.second);
+
+        ctx.async_status(root / "missing", missing.handler());
+        res = missing.get();
+        BOOST_TEST_EQ(res.first.type(), fs::file_not_found);
+        BOOST_TEST(!!res.second);
+    }
+
+    create_file(root / "f", "contents");
+    {
+        async_result< fs::file_status > st;
+        ctx.async_symlink_status(root / "f", st.handler());
+        BOOST_TEST_EQ(st.get().first.type(), fs::regular_file);
+
+        std::promise< error_code > renamed;
+        ctx.async_rename(root / "f", root / "g", [&renamed](error_code const& ec) { renamed.set_value(ec); });
+        BOOST_TEST(!renamed.get_future().get());
+        BOOST_TEST(!fs::exists(root / "f"));
+        BOOST_TEST(fs::exists(root / "g"));
+
+        std::promise< error_code > rename_missing;
+        ctx.async_rename(root / "f", root / "h", [&rename_missing](error_code const& ec) { rename_missing.set_value(ec); });
+        BOOST_TEST(!!rename_missing.get_future().get());
+    }
+
+    {
+        async_result< bool > copied, removed, removed_again, created, removed_dir;
+        ctx.async_copy_file(root / "g", root / "h", fs::copy_options::none, copied.handler());
+        BOOST_TEST(copied.get().first);
+        BOOST_TEST_EQ(fs::file_size(root / "h"), 8u);
+
+        ctx.async_remove(root / "h", removed.handler());
+        BOOST_TEST(removed.get().first);
+        BOOST_TEST(!fs::exists(root / "h"));
+
+        ctx.async_remove(root / "h", removed_again.handler());
+        std::pair< bool, error_code > res = removed_again.get();
+        BOOST_TEST(!res.first);
+        BOOST_TEST(!res.second);
+
+        ctx.async_create_directories(root / "a" / "b" / "c", created.handler());
+        BOOST_TEST(created.get().first);
+        BOOST_TEST(fs::is_directory(root / "a" / "b" / "c"));
+
+        ctx.async_remove(root / "a" / "b" / "c", removed_dir.handler());
+        res = removed_dir.get();
+        BOOST_TEST(res.first);
+        BOOST_TEST(!res.second);
+        BOOST_TEST(!fs::exists(root / "a" / "b" / "c"));
+    }
+
+    {
+        const unsigned int count = 32u;
+        std::vector< async_result< fs::file_status > > results(count);
+        {
+            fs::async_context::batch batch(ctx);
+            for (unsigned int i = 0u; i < count; ++i)
+                ctx.async_status((i & 1u) != 0u ? root / "g" : root / "a", results[i].handler());
+        }
+
+        for (unsigned int i = 0u; i < count; ++i)
+            BOOST_TEST_EQ(results[i].get().first.type(), (i & 1u) != 0u ? fs::regular_file : fs::directory_file);
+    }
+
+    {
+        async_result< boost::uintmax_t > removed;
+        ctx.async_remove_all(root, removed.handler());
+        std::pair< boost::uintmax_t, error_code > res = removed.get();
+        BOOST_TEST_EQ(res.first, 4u);
+        BOOST_TEST(!res.second);
+        BOOST_TEST(!fs::exists(root));
+    }
+
+    cout << "  async_tests complete" << endl;
+}
+
+//  directory_tree_tests  -----------------------------------------------------------//
+
+void directory_tree_tests()
+{
+    cout << "directory_tree_tests..." << endl;
+
+    std::vector< fs::path > expected;
+    for (fs::recursive_directory_iterator it(dir), end; it != end; ++it)
+        expected.push_back(it->path());
+    std::sort(expected.begin(), expected.end());
+
+    fs::directory_tree tree(dir);
+    BOOST_TEST_EQ(tree.root(), dir);
+    BOOST_TEST_EQ(tree.size(), expected.size());
+
+    std::vector< fs::path > paths;
+    for (fs::directory_tree::const_iterator it = tree.begin(), end = tree.end(); it != end; ++it)
+    {
+        fs::path p = tree.full_path(*it);
+        fs::path rel = tree.relative_path(*it);
+        BOOST_TEST_EQ(p.filename(), it->filename());
+        BOOST_TEST_EQ(dir / rel, p);
+        BOOST_TEST_EQ(it->depth(), static_cast< unsigned int >(std::distance(rel.begin(), rel.end()) - 1));
+        if (it->type() != fs::status_error)
+            BOOST_TEST(it->type() == fs::status(p).type());
+        if (it->parent())
+            BOOST_TEST(it->parent()->type() == fs::directory_file);
+        paths.push_back(p);
+    }
+    std::sort(paths.begin(), paths.end());
+    BOOST_TEST(paths == expected);
+
+    // error reporting
+    error_code ec;
+    tree.assign(dir / "no-such-dir", fs::directory_options::none, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(tree.empty());
+    BOOST_TEST(CHECK_EXCEPTION(
+        [&tree]() { tree.assign(dir / "no-such-dir"); },
+        ENOENT));
+
+    cout << "  directory_tree_tests complete" << endl;
+}
+
+//  glob_tests  ---------------------------------------------------------------------//
+
+void glob_tests()
+{
+    cout << "glob_tests..." << endl;
+
+    // lexical matching
+    BOOST_TEST(fs::glob_pattern("*.cpp").match("a.cpp"));
+    BOOST_TEST(!fs::glob_pattern("*.cpp").match("a.hpp"));
+    BOOST_TEST(!fs::glob_pattern("*.cpp").match(".a.cpp"));
+    BOOST_TEST(fs::glob_pattern("*.cpp", fs::glob_options::match_hidden).match(".a.cpp"));
+    BOOST_TEST(fs::glob_pattern(".*").match(".a"));
+    BOOST_TEST(fs::glob_pattern("a?c").match("abc"));
+    BOOST_TEST(!fs::glob_pattern("a?c").match("ac"));
+    BOOST_TEST(fs::glob_pattern("[a-c]x[!0-9]").match("bxy"));
+    BOOST_TEST(!fs::glob_pattern("[a-c]x[!0-9]").match("bx1"));
+    BOOST_TEST(fs::glob_pattern("*ab*ab*c").match("xabyabababzc"));
+    BOOST_TEST(!fs::glob_pattern("*ab*ab*c").match("xabzc"));
+    BOOST_TEST(fs::glob_pattern("{a,b{c,d}}e").match("bde"));
+    BOOST_TEST(!fs::glob_pattern("{a,b{c,d}}e", fs::glob_options::no_braces).match("bde"));
+    BOOST_TEST(fs::glob_pattern("src/**/*.{cpp,hpp}").match("src/a.hpp"));
+    BOOST_TEST(fs::glob_pattern("src/**/*.{cpp,hpp}").match("src/a/b/c.cpp"));
+    BOOST_TEST(!fs::glob_pattern("src/**/*.{cpp,hpp}").match("src/a/.b/c.cpp"));
+    BOOST_TEST(!fs::glob_pattern("src/**/*.{cpp,hpp}").match("include/a.cpp"));
+    BOOST_TEST(fs::glob_pattern("a/**").match("a/b/c"));
+    BOOST_TEST(!fs::glob_pattern("a/**").match("a"));
+#if defined(BOOST_POSIX_API)
+    BOOST_TEST(fs::glob_pattern("a\\*").match("a*"));
+    BOOST_TEST(!fs::glob_pattern("a\\*").match("ab"));
+#endif
+
+    // matching files in the directory tree
+    std::vector< fs::path > expected;
+    for (fs::recursive_directory_iterator it(dir), end; it != end; ++it)
+    {
+        const std::string name = it->path().filename().string();
+        if (name.size() >= 2u && name.compare(name.size() - 2u, 2u, "f1") == 0)
+            expected.push_back(it->path());
+    }
+    std::sort(expected.begin(), expected.end());
+    BOOST_TEST(!expected.empty());
+
+    std::vector< fs::path > paths = fs::glob(dir / "**" / "*f1");
+    std::sort(paths.begin(), paths.end());
+    BOOST_TEST(paths == expected);
+
+    paths = fs::glob(dir / "d1" / "d1f1");
+    BOOST_TEST_EQ(paths.size(), 1u);
+    BOOST_TEST(!paths.empty() && paths.front() == d1f1);
+
+    paths = fs::glob(dir / "{d1,f0,no-such-file}");
+    std::sort(paths.begin(), paths.end());
+    BOOST_TEST_EQ(paths.size(), 2u);
+    BOOST_TEST(paths.size() == 2u && paths[0] == d1 && paths[1] == f0);
+
+    expected.clear();
+    for (fs::directory_iterator it(dir), end; it != end; ++it)
+    {
+        if (fs::is_directory(it->path()))
+            expected.push_back(it->path());
+    }
+    std::sort(expected.begin(), expected.end());
+    paths = fs::glob(dir / "*/");
+    std::sort(paths.begin(), paths.end());
+    BOOST_TEST(paths == expected);
+
+    // no matches is not an error
+    error_code ec;
+    paths = fs::glob(dir / "no-such-dir" / "*", fs::directory_options::none, ec);
+    BOOST_TEST(!ec);
+    BOOST_TEST(paths.empty());
+
+    // error reporting
+    paths = fs::glob(fs::path(), fs::directory_options::none, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(paths.empty());
+
+    cout << "  glob_tests complete" << endl;
+}
+
+//  directory_snapshot_tests  -------------------------------------------------------//
+
+void directory_snapshot_tests()
+{
+    cout << "directory_snapshot_tests..." << endl;
+
+    std::vector< fs::path > expected;
+    for (fs::recursive_directory_iterator it(dir), end; it != end; ++it)
+        expected.push_back(it->path());
+    std::sort(expected.begin(), expected.end());
+
+    fs::directory_snapshot snapshot(dir);
+    BOOST_TEST_EQ(snapshot.root(), dir);
+    BOOST_TEST_EQ(snapshot.size(), expected.size());
+    BOOST_TEST(!snapshot.is_mapped());
+    BOOST_TEST(snapshot.listed_directory_count() > 0u);
+
+    std::vector< fs::path > paths;
+    for (fs::directory_snapshot::const_iterator it = snapshot.begin(), end = snapshot.end(); it != end; ++it)
+    {
+        fs::directory_snapshot_entry entry = *it;
+        fs::path p = snapshot.full_path(entry);
+        BOOST_TEST_EQ(p.filename(), entry.filename());
+        BOOST_TEST_EQ(dir / snapshot.relative_path(entry), p);
+        if (entry.type() == fs::regular_file)
+            BOOST_TEST_EQ(entry.file_size(), fs::file_size(p));
+        if (entry.has_parent())
+            BOOST_TEST(entry.parent().type() == fs::directory_file);
+        paths.push_back(p);
+    }
+    std::sort(paths.begin(), paths.end());
+    BOOST_TEST(paths == expected);
+
+    // save and load the snapshot
+    const fs::path snapshot_file(dir.string() + ".snapshot");
+    snapshot.save(snapshot_file);
+
+    fs::directory_snapshot loaded;
+    loaded.load(snapshot_file);
+    BOOST_TEST(loaded.is_mapped());
+    BOOST_TEST_EQ(loaded.root(), dir);
+    BOOST_TEST_EQ(loaded.size(), snapshot.size());
+    for (fs::directory_snapshot::const_iterator it = snapshot.begin(), loaded_it = loaded.begin(), end = snapshot.end(); it != end; ++it, ++loaded_it)
+    {
+        BOOST_TEST_EQ(snapshot.relative_path(*it), loaded.relative_path(*loaded_it));
+        BOOST_TEST_EQ(it->file_size(), loaded_it->file_size());
+        BOOST_TEST_EQ(it->last_write_time(), loaded_it->last_write_time());
+        BOOST_TEST(it->type() == loaded_it->type());
+    }
+
+    // saving over the file that is mapped does not affect the mapped snapshot
+    loaded.save(snapshot_file);
+    {
+        fs::directory_snapshot reloaded;
+        reloaded.load(snapshot_file);
+        BOOST_TEST_EQ(reloaded.size(), loaded.size());
+        for (fs::directory_snapshot::const_iterator it = loaded.begin(), reloaded_it = reloaded.begin(), end = loaded.end(); it != end; ++it, ++reloaded_it)
+            BOOST_TEST_EQ(loaded.relative_path(*it), reloaded.relative_path(*reloaded_it));
+
+        // no temporary files are left behind
+        const fs::path::string_type prefix = snapshot_file.filename().native();
+        unsigned int snapshot_file_count = 0u;
+        for (fs::directory_iterator it(snapshot_file.parent_path()), end; it != end; ++it)
+        {
+            if (it->path().filename().native().compare(0u, prefix.size(), prefix) == 0)
+                ++snapshot_file_count;
+        }
+        BOOST_TEST_EQ(snapshot_file_count, 1u);
+    }
+
+    // rescan without changes does not read any directories
+    fs::directory_snapshot rescanned = loaded.rescan();
+    BOOST_TEST_EQ(rescanned.size(), snapshot.size());
+    BOOST_TEST_EQ(rescanned.listed_directory_count(), 0u);
+
+    // rescan after adding a file only reads the modified directory
+    create_file(dir / "d1" / "snapshot_file", "abc");
+    fs::last_write_time(dir / "d1", fs::last_write_time(dir / "d1") - 1000);
+    rescanned = rescanned.rescan();
+    BOOST_TEST_EQ(rescanned.size(), snapshot.size() + 1u);
+    BOOST_TEST_EQ(rescanned.listed_directory_count(), 1u);
+    bool found = false;
+    for (fs::directory_snapshot::const_iterator it = rescanned.begin(), end = rescanned.end(); it != end; ++it)
+    {
+        if (it->filename() == "snapshot_file")
+        {
+            found = true;
+            BOOST_TEST_EQ(rescanned.full_path(*it), dir / "d1" / "snapshot_file");
+            BOOST_TEST_EQ(it->file_size(), 3u);
+        }
+    }
+    BOOST_TEST(found);
+
+    // diff reports the added file
+    std::vector< std::pair< fs::snapshot_change, fs::path > > changes;
+    auto collect_changes = [&changes, &snapshot, &rescanned](fs::snapshot_change change, fs::directory_snapshot_entry const* old_entry, fs::directory_snapshot_entry const* new_entry)
+    {
+        if (new_entry)
+            changes.push_back(std::make_pair(change, rescanned.relative_path(*new_entry)));
+        else
+            changes.push_back(std::make_pair(change, snapshot.relative_path(*old_entry)));
+    };
+    fs::diff(snapshot, rescanned, collect_changes);
+    BOOST_TEST_EQ(changes.size(), 1u);
+    BOOST_TEST(changes.size() == 1u && changes[0].first == fs::snapshot_change::added && changes[0].second == fs::path("d1") / "snapshot_file");
+
+    changes.clear();
+    fs::diff(snapshot, snapshot, collect_changes);
+    BOOST_TEST(changes.empty());
+
+    // diff reports removed and added files
+    fs::remove(dir / "d1" / "snapshot_file");
+    create_file(dir / "d1" / "snapshot_file2", "abcd");
+    fs::last_write_time(dir / "d1", fs::last_write_time(dir / "d1") - 1000);
+    fs::directory_snapshot updated = rescanned.rescan();
+    changes.clear();
+    fs::diff(rescanned, updated, [&changes, &rescanned, &updated](fs::snapshot_change change, fs::directory_snapshot_entry const* old_entry, fs::directory_snapshot_entry const* new_entry)
+    {
+        if (change == fs::snapshot_change::removed)
+            changes.push_back(std::make_pair(change, rescanned.relative_path(*old_entry)));
+        else
+            changes.push_back(std::make_pair(change, updated.relative_path(*new_entry)));
+    });
+    std::sort(changes.begin(), changes.end(), [](std::pair< fs::snapshot_change, fs::path > const& left, std::pair< fs::snapshot_change, fs::path > const& right) { return left.second < right.second; });
+    BOOST_TEST_EQ(changes.size(), 2u);
+    BOOST_TEST(changes.size() == 2u && changes[0].first == fs::snapshot_change::removed && changes[0].second == fs::path("d1") / "snapshot_file");
+    BOOST_TEST(changes.size() == 2u && changes[1].first == fs::snapshot_change::added && changes[1].second == fs::path("d1") / "snapshot_file2");
+
+    // rewriting a file does not change its directory, so the file is only reported modified when its attributes are refreshed
+    create_file(dir / "d1" / "snapshot_file2", "abcdefgh");
+    fs::directory_snapshot rewritten = updated.rescan();
+    BOOST_TEST_EQ(rewritten.listed_directory_count(), 0u);
+    changes.clear();
+    fs::diff(updated, rewritten, collect_changes);
+    BOOST_TEST(changes.empty());
+    rewritten = updated.rescan(fs::snapshot_rescan_options::refresh_file_attributes);
+    BOOST_TEST_EQ(rewritten.listed_directory_count(), 0u);
+    changes.clear();
+    fs::diff(updated, rewritten, [&changes, &rewritten](fs::snapshot_change change, fs::directory_snapshot_entry const*, fs::directory_snapshot_entry const* new_entry)
+    {
+        changes.push_back(std::make_pair(change, rewritten.relative_path(*new_entry)));
+    });
+    BOOST_TEST_EQ(changes.size(), 1u);
+    BOOST_TEST(changes.size() == 1u && changes[0].first == fs::snapshot_change::modified && changes[0].second == fs::path("d1") / "snapshot_file2");
+    fs::remove(dir / "d1" / "snapshot_file2");
+
+    // error reporting
+    error_code ec;
+    fs::directory_snapshot broken;
+    broken.load(dir / "f0", ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(broken.empty());
+    broken.assign(dir / "no-such-dir", fs::directory_options::none, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(broken.empty());
+    BOOST_TEST(CHECK_EXCEPTION(
+        [&broken]() { broken.assign(dir / "no-such-dir"); },
+        ENOENT));
+
+    fs::remove(snapshot_file);
+
+    cout << "  directory_snapshot_tests complete" << endl;
+}
+
+//  directory_watcher_tests  --------------------------------------------------------//
+
+#if defined(linux) || defined(__linux) || defined(__linux__)
+
+//! Waits until an event with the given changes is reported for the path
+bool wait_for_watch_event(fs::directory_watcher& watcher, fs::path const& p, fs::directory_change changes)
+{
+    std::vector< fs::directory_watch_event > events;
+    for (unsigned int i = 0u; i < 20u; ++i)
+    {
+        watcher.wait_for(events, std::chrono::milliseconds(250));
+        for (std::size_t j = 0u; j < events.size(); ++j)
+        {
+            if (events[j].path() == p && (events[j].changes() & changes) == changes)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+#endif
+
+void directory_watcher_tests()
+{
+    cout << "directory_watcher_tests..." << endl;
+
+    const fs::path root = dir / "watched";
+    fs::create_directory(root);
+    fs::create_directory(root / "sub");
+
+#if defined(linux) || defined(__linux) || defined(__linux__)
+    fs::directory_watcher watcher(root);
+    BOOST_TEST(watcher.is_open());
+    BOOST_TEST_EQ(watcher.root(), root);
+    BOOST_TEST_EQ(watcher.watch_count(), 2u);
+    BOOST_TEST(watcher.native_handle() >= 0);
+
+    // no events
+    std::vector< fs::directory_watch_event > events;
+    BOOST_TEST_EQ(watcher.wait_for(events, std::chrono::milliseconds(0)), 0u);
+
+    create_file(root / "sub" / "f1", "abc");
+    BOOST_TEST(wait_for_watch_event(watcher, root / "sub" / "f1", fs::directory_change::added));
+
+    // new subdirectories are watched as well
+    fs::create_directory(root / "new_sub");
+    BOOST_TEST(wait_for_watch_event(watcher, root / "new_sub", fs::directory_change::added));
+    BOOST_TEST_EQ(watcher.watch_count(), 3u);
+    create_file(root / "new_sub" / "f2", "abc");
+    BOOST_TEST(wait_for_watch_event(watcher, root / "new_sub" / "f2", fs::directory_change::added));
+
+    fs::remove(root / "sub" / "f1");
+    BOOST_TEST(wait_for_watch_event(watcher, root / "sub" / "f1", fs::directory_change::removed));
+
+    watcher.close();
+    BOOST_TEST(!watcher.is_open());
+
+    error_code ec;
+    watcher.open(dir / "no-such-dir", fs::directory_options::none, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(!watcher.is_open());
+#else
+    error_code ec;
+    fs::directory_watcher watcher(root, fs::directory_options::none, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST(!watcher.is_open());
+#endif
+
+    fs::remove_all(root);
+
+    cout << "  directory_watcher_tests complete" << endl;
+}
+
 //  iterator_status_tests  -----------------------------------------------------------//
 
 void iterator_status_tests()
@@ -810,6 +1816,118 @@ void iterator_status_tests()
     }
 }
 
+//  directory_entry_attributes_tests  ------------------------------------------------//
+
+void directory_entry_attributes_tests()
+{
+    cout << "directory_entry_attributes_tests..." << endl;
+
+    error_code ec;
+    for (fs::directory_iterator it(dir, fs::directory_options::cache_entry_attributes);
+         it != fs::directory_iterator(); ++it)
+    {
+        if (it->path().filename() == "f1")
+        {
+            if (platform == "POSIX")
+                BOOST_TEST(it->cached_attributes() == fs::entry_attributes::all);
+            BOOST_TEST(fs::is_regular_file(it->status()));
+            BOOST_TEST_EQ(it->file_size(), fs::file_size(f1));
+            BOOST_TEST(it->last_write_time() == fs::last_write_time(f1));
+            BOOST_TEST_EQ(it->hard_link_count(), fs::hard_link_count(f1));
+        }
+        else if (it->path().filename() == "d1")
+        {
+            if (platform == "POSIX")
+                BOOST_TEST(it->cached_attributes() == (fs::entry_attributes::all & ~fs::entry_attributes::file_size));
+            BOOST_TEST(fs::is_directory(it->status()));
+            BOOST_TEST(it->last_write_time() == fs::last_write_time(d1));
+            it->file_size(ec);
+            BOOST_TEST(!!ec);
+        }
+        else if (it->path().filename() == "dangling_symlink")
+        {
+            BOOST_TEST(it->cached_attributes() == fs::entry_attributes::none);
+            BOOST_TEST(it->status().type() == fs::file_not_found);
+            it->last_write_time(ec);
+            BOOST_TEST(!!ec);
+        }
+    }
+
+    // attributes are not cached by default
+    {
+        fs::directory_iterator it(dir);
+        BOOST_TEST(it != fs::directory_iterator());
+        BOOST_TEST(it->cached_attributes() == fs::entry_attributes::none);
+    }
+
+    // attributes of the entries of a batch obtained in inode order and concurrently
+    const fs::directory_options batch_attributes_options[] =
+    {
+        fs::directory_options::inode_ordered_attributes,
+        fs::directory_options::prefetch_attributes,
+        fs::directory_options::inode_ordered_attributes | fs::directory_options::prefetch_attributes
+    };
+    for (std::size_t opt_index = 0u; opt_index < sizeof(batch_attributes_options) / sizeof(*batch_attributes_options); ++opt_index)
+    {
+        fs::directory_entry batch[4];
+        std::size_t count = 0u;
+        bool f1_found = false;
+        fs::directory_iterator it(dir, batch_attributes_options[opt_index]);
+        while (true)
+        {
+            const std::size_t n = it.next_batch(batch, sizeof(batch) / sizeof(*batch));
+            if (n == 0u)
+                break;
+
+            for (std::size_t i = 0u; i < n; ++i)
+            {
+                BOOST_TEST(batch[i].status().type() == fs::status(batch[i].path(), ec).type());
+                if (batch[i].path().filename() == "f1")
+                {
+                    f1_found = true;
+                    if (platform == "POSIX")
+                        BOOST_TEST(batch[i].cached_attributes() == fs::entry_attributes::all);
+                    BOOST_TEST_EQ(batch[i].file_size(), fs::file_size(f1));
+                    BOOST_TEST_EQ(batch[i].hard_link_count(), fs::hard_link_count(f1));
+                }
+            }
+            count += n;
+        }
+        BOOST_TEST(f1_found);
+        BOOST_TEST_EQ(count, static_cast< std::size_t >(std::distance(fs::directory_iterator(dir), fs::directory_iterator())));
+    }
+
+    fs::directory_entry e(f1);
+    BOOST_TEST(e.cached_attributes() == fs::entry_attributes::none);
+    e.refresh(fs::entry_attributes::file_size | fs::entry_attributes::hard_link_count);
+    BOOST_TEST(e.cached_attributes() == (fs::entry_attributes::file_size | fs::entry_attributes::hard_link_count));
+    BOOST_TEST_EQ(e.file_size(), 7u);
+    BOOST_TEST_EQ(e.hard_link_count(), fs::hard_link_count(f1));
+
+    // refresh() discards cached attributes
+    e.refresh();
+    BOOST_TEST(e.cached_attributes() == fs::entry_attributes::none);
+    BOOST_TEST_EQ(e.file_size(), 7u);
+    BOOST_TEST(e.cached_attributes() == fs::entry_attributes::file_size);
+
+    if (platform == "POSIX")
+    {
+        fs::directory_entry e2(f1);
+        e2.refresh(fs::entry_attributes::inode | fs::entry_attributes::allocated_size, ec);
+        BOOST_TEST(!ec);
+        BOOST_TEST(e2.inode() != 0u);
+        BOOST_TEST(e2.inode() != static_cast< boost::uintmax_t >(-1));
+        e2.allocated_size();
+    }
+
+    e.assign(d1);
+    e.refresh(fs::entry_attributes::all, ec);
+    BOOST_TEST(!!ec);
+    BOOST_TEST((e.cached_attributes() & fs::entry_attributes::file_size) == fs::entry_attributes::none);
+
+    cout << "  directory_entry_attributes_tests complete" << endl;
+}
+
 //  recursive_iterator_status_tests  -------------------------------------------------//
 
 void recursive_iterator_status_tests()
@@ -2049,6 +3167,233 @@ void copy_file_tests(const fs::path& f1x, const fs::path& d1x)
     BOOST_TEST(file_copied);
     verify_file(d1x / "f2", "file-f1");
 
+    fs::remove(d1x / "f2");
+    file_copied = false;
+    copy_ex_ok = true;
+    try
+    {
+        file_copied = fs::copy_file(f1x, d1x / "f2", fs::copy_options::reflink_or_copy);
+    }
+    catch (const fs::filesystem_error&)
+    {
+        copy_ex_ok = false;
+    }
+    BOOST_TEST(copy_ex_ok);
+    BOOST_TEST(file_copied);
+    verify_file(d1x / "f2", "file-f1");
+
+    // Cloning may not be supported by the filesystem, but a successful clone must have the same contents
+    fs::remove(d1x / "f2");
+    {
+        error_code ec;
+        file_copied = fs::copy_file(f1x, d1x / "f2", fs::copy_options::reflink, ec);
+        BOOST_TEST(file_copied == !ec);
+        if (file_copied)
+            verify_file(d1x / "f2", "file-f1");
+        else
+        {
+            cout << " reflink not supported: " << ec.message() << endl;
+            fs::copy_file(f1x, d1x / "f2", fs::copy_options::overwrite_existing);
+        }
+    }
+
+    // Test progress reporting and cancellation
+    {
+        const fs::path progress_from = d1x / "progress-from";
+        const fs::path progress_to = d1x / "progress-to";
+        {
+            std::ofstream f(BOOST_FILESYSTEM_C_STR(progress_from), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            const std::string chunk(4096u, 'x');
+            for (unsigned int i = 0u; i < 256u; ++i)
+                f << chunk;
+        }
+
+        fs::remove(progress_to);
+        boost::uintmax_t file_bytes_copied = 0u, files_copied = 0u;
+        fs::copy_strategy strategy = fs::copy_strategy::none;
+        file_copied = fs::copy_file(progress_from, progress_to, fs::copy_options::none, [&](fs::copy_progress const& progress) -> bool
+        {
+            BOOST_TEST_EQ(progress.from, progress_from);
+            BOOST_TEST_EQ(progress.to, progress_to);
+            BOOST_TEST_EQ(progress.file_size, 1024u * 1024u);
+            BOOST_TEST(progress.file_bytes_copied >= file_bytes_copied);
+            BOOST_TEST_EQ(progress.file_bytes_copied, progress.total_bytes_copied);
+            file_bytes_copied = progress.file_bytes_copied;
+            files_copied = progress.files_copied;
+            strategy = progress.strategy;
+            return true;
+        });
+        BOOST_TEST(file_copied);
+        BOOST_TEST_EQ(file_bytes_copied, 1024u * 1024u);
+        BOOST_TEST_EQ(files_copied, 1u);
+        BOOST_TEST(strategy != fs::copy_strategy::none);
+        BOOST_TEST_EQ(fs::file_size(progress_to), 1024u * 1024u);
+
+        fs::remove(progress_to);
+        error_code ec;
+        file_copied = fs::copy_file(progress_from, progress_to, fs::copy_options::none, [](fs::copy_progress const&) { return false; }, ec);
+        BOOST_TEST(!file_copied);
+        BOOST_TEST(ec == boost::system::errc::operation_canceled);
+
+        fs::remove(progress_from);
+        fs::remove(progress_to);
+    }
+
+    // Test copying a sparse file. The contents and the size of the copy must be the same, regardless of whether holes are supported.
+    fs::remove(d1x / "f2");
+    file_copied = fs::copy_file(f1x, d1x / "f2", fs::copy_options::preserve_sparse);
+    BOOST_TEST(file_copied);
+    verify_file(d1x / "f2", "file-f1");
+    {
+        const fs::path sparse_from = d1x / "sparse-from";
+        const fs::path sparse_to = d1x / "sparse-to";
+        {
+            std::ofstream f(BOOST_FILESYSTEM_C_STR(sparse_from), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            f << "begin";
+            f.seekp(1024 * 1024);
+            f << "middle";
+            f.seekp(2 * 1024 * 1024 + 1);
+            f << "end";
+        }
+        fs::resize_file(sparse_from, 4u * 1024u * 1024u);
+
+        fs::remove(sparse_to);
+        file_copied = fs::copy_file(sparse_from, sparse_to, fs::copy_options::preserve_sparse);
+        BOOST_TEST(file_copied);
+        BOOST_TEST_EQ(fs::file_size(sparse_to), fs::file_size(sparse_from));
+
+        std::ifstream from_stream(BOOST_FILESYSTEM_C_STR(sparse_from), std::ios_base::in | std::ios_base::binary);
+        std::ifstream to_stream(BOOST_FILESYSTEM_C_STR(sparse_to), std::ios_base::in | std::ios_base::binary);
+        const std::string from_contents((std::istreambuf_iterator< char >(from_stream)), std::istreambuf_iterator< char >());
+        const std::string to_contents((std::istreambuf_iterator< char >(to_stream)), std::istreambuf_iterator< char >());
+        BOOST_TEST_EQ(from_contents.size(), to_contents.size());
+        BOOST_TEST(from_contents == to_contents);
+
+        fs::remove(sparse_from);
+        fs::remove(sparse_to);
+    }
+
+    // Test copying a file in chunks using multiple threads. Use a size that is not a multiple of the chunk size.
+    fs::remove(d1x / "f2");
+    file_copied = fs::copy_file(f1x, d1x / "f2", fs::copy_options::parallel_chunks);
+    BOOST_TEST(file_copied);
+    verify_file(d1x / "f2", "file-f1");
+    {
+        const fs::path chunked_from = d1x / "chunked-from";
+        const fs::path chunked_to = d1x / "chunked-to";
+        const boost::uintmax_t chunked_size = 40u * 1024u * 1024u + 123u;
+        {
+            std::ofstream f(BOOST_FILESYSTEM_C_STR(chunked_from), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+            std::string block(64u * 1024u, '\0');
+            for (boost::uintmax_t offset = 0u; offset < chunked_size; offset += block.size())
+            {
+                for (std::size_t i = 0u; i < block.size(); ++i)
+                    block[i] = static_cast< char >((offset + i) * 31u / 7u);
+                f.write(block.data(), static_cast< std::streamsize >(std::min< boost::uintmax_t >(block.size(), chunked_size - offset)));
+            }
+        }
+
+        fs::remove(chunked_to);
+        boost::uintmax_t total_bytes_copied = 0u;
+        file_copied = fs::copy_file(chunked_from, chunked_to, fs::copy_options::parallel_chunks, [&](fs::copy_progress const& progress) -> bool
+        {
+            BOOST_TEST(progress.total_bytes_copied >= total_bytes_copied);
+            BOOST_TEST_EQ(progress.file_bytes_copied, progress.total_bytes_copied);
+            total_bytes_copied = progress.total_bytes_copied;
+            return true;
+        });
+        BOOST_TEST(file_copied);
+        BOOST_TEST_EQ(total_bytes_copied, chunked_size);
+        BOOST_TEST_EQ(fs::file_size(chunked_to), chunked_size);
+
+        std::ifstream from_stream(BOOST_FILESYSTEM_C_STR(chunked_from), std::ios_base::in | std::ios_base::binary);
+        std::ifstream to_stream(BOOST_FILESYSTEM_C_STR(chunked_to), std::ios_base::in | std::ios_base::binary);
+        const std::string from_contents((std::istreambuf_iterator< char >(from_stream)), std::istreambuf_iterator< char >());
+        const std::string to_contents((std::istreambuf_iterator< char >(to_stream)), std::istreambuf_iterator< char >());
+        BOOST_TEST_EQ(from_contents.size(), to_contents.size());
+        BOOST_TEST(from_contents == to_contents);
+
+        fs::remove(chunked_to);
+        error_code ec;
+        file_copied = fs::copy_file(chunked_from, chunked_to, fs::copy_options::parallel_chunks, [](fs::copy_progress const&) { return false; }, ec);
+        BOOST_TEST(!file_copied);
+        BOOST_TEST(ec == boost::system::errc::operation_canceled);
+
+        // Chunks are also copied concurrently with preserve_sparse, both for files without holes and for the data regions of sparse files
+        for (unsigned int pass = 0u; pass < 2u; ++pass)
+        {
+            if (pass > 0u)
+            {
+                fs::resize_file(chunked_from, chunked_size + 32u * 1024u * 1024u);
+                std::ofstream f(BOOST_FILESYSTEM_C_STR(chunked_from), std::ios_base::in | std::ios_base::out | std::ios_base::binary);
+                f.seekp(static_cast< std::streamoff >(chunked_size + 32u * 1024u * 1024u));
+                f << "end";
+            }
+
+            fs::remove(chunked_to);
+            file_copied = fs::copy_file(chunked_from, chunked_to, fs::copy_options::preserve_sparse | fs::copy_options::parallel_chunks);
+            BOOST_TEST(file_copied);
+            BOOST_TEST_EQ(fs::file_size(chunked_to), fs::file_size(chunked_from));
+
+            std::ifstream sparse_from_stream(BOOST_FILESYSTEM_C_STR(chunked_from), std::ios_base::in | std::ios_base::binary);
+            std::ifstream sparse_to_stream(BOOST_FILESYSTEM_C_STR(chunked_to), std::ios_base::in | std::ios_base::binary);
+            const std::string sparse_from_contents((std::istreambuf_iterator< char >(sparse_from_stream)), std::istreambuf_iterator< char >());
+            const std::string sparse_to_contents((std::istreambuf_iterator< char >(sparse_to_stream)), std::istreambuf_iterator< char >());
+            BOOST_TEST_EQ(sparse_from_contents.size(), sparse_to_contents.size());
+            BOOST_TEST(sparse_from_contents == sparse_to_contents);
+        }
+
+        fs::remove(chunked_from);
+        fs::remove(chunked_to);
+    }
+
+    // Test copying a file bypassing the file cache. Use a size that is not a multiple of the direct I/O alignment.
+    fs::remove(d1x / "f2");
+    file_copied = fs::copy_file(f1x, d1x / "f2", fs::copy_options::no_cache);
+    BOOST_TEST(file_copied);
+    verify_file(d1x / "f2", "file-f1");
+    {
+        // Sizes that end in the middle of an aligned block, right after a block and right before the end of a buffer
+        const boost::uintmax_t no_cache_sizes[] = { 12u * 1024u * 1024u + 123u, 9u * 1024u * 1024u + 4097u, 10u * 1024u * 1024u - 1u };
+        const fs::path no_cache_from = d1x / "no-cache-from";
+        const fs::path no_cache_to = d1x / "no-cache-to";
+        for (std::size_t size_index = 0u; size_index < sizeof(no_cache_sizes) / sizeof(*no_cache_sizes); ++size_index)
+        {
+            const boost::uintmax_t no_cache_size = no_cache_sizes[size_index];
+            {
+                std::ofstream f(BOOST_FILESYSTEM_C_STR(no_cache_from), std::ios_base::out | std::ios_base::binary | std::ios_base::trunc);
+                std::string block(64u * 1024u, '\0');
+                for (boost::uintmax_t offset = 0u; offset < no_cache_size; offset += block.size())
+                {
+                    for (std::size_t i = 0u; i < block.size(); ++i)
+                        block[i] = static_cast< char >((offset + i) * 31u / 7u);
+                    f.write(block.data(), static_cast< std::streamsize >(std::min< boost::uintmax_t >(block.size(), no_cache_size - offset)));
+                }
+            }
+
+            fs::remove(no_cache_to);
+            boost::uintmax_t total_bytes_copied = 0u;
+            file_copied = fs::copy_file(no_cache_from, no_cache_to, fs::copy_options::no_cache, [&](fs::copy_progress const& progress) -> bool
+            {
+                total_bytes_copied = progress.total_bytes_copied;
+                return true;
+            });
+            BOOST_TEST(file_copied);
+            BOOST_TEST_EQ(total_bytes_copied, no_cache_size);
+            BOOST_TEST_EQ(fs::file_size(no_cache_to), no_cache_size);
+
+            std::ifstream from_stream(BOOST_FILESYSTEM_C_STR(no_cache_from), std::ios_base::in | std::ios_base::binary);
+            std::ifstream to_stream(BOOST_FILESYSTEM_C_STR(no_cache_to), std::ios_base::in | std::ios_base::binary);
+            const std::string from_contents((std::istreambuf_iterator< char >(from_stream)), std::istreambuf_iterator< char >());
+            const std::string to_contents((std::istreambuf_iterator< char >(to_stream)), std::istreambuf_iterator< char >());
+            BOOST_TEST_EQ(from_contents.size(), to_contents.size());
+            BOOST_TEST(from_contents == to_contents);
+        }
+
+        fs::remove(no_cache_from);
+        fs::remove(no_cache_to);
+    }
+
     // Test copy_file with special files with generated content. Such files have zero size,
     // but have contents.
     if (fs::is_regular_file("/proc/self/cmdline"))
@@ -3035,8 +4380,20 @@ int cpp_main(int argc, char* argv[])
         symlink_is_empty_tests();
     }
     iterator_status_tests(); // lots of cases by now, so a good time to test
+    directory_entry_attributes_tests();
                              //  dump_tree(dir);
     recursive_directory_iterator_tests();
+    parallel_walk_tests();
+    disk_usage_tests();
+    directory_reader_tests();
+#if defined(BOOST_FILESYSTEM_DETAIL_HAS_COROUTINES)
+    coroutine_tests();
+#endif
+    async_tests();
+    directory_tree_tests();
+    glob_tests();
+    directory_snapshot_tests();
+    directory_watcher_tests();
     recursive_iterator_status_tests(); // lots of cases by now, so a good time to test
     rename_tests();
     remove_tests(dir);